@@ -30,8 +30,51 @@ static inline uint64_t file_get_monotonic_ns(void)
 	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 }
 
-static inline FileMode file_adaptive_choose(FileAdaptiveState *state)
+/*
+ * FILE_MODE_AUTO decision table (fileAdaptive.c), filled by
+ * fun_file_calibrate or fun_file_set_calibration.  FILE_MODE_AUTO cells
+ * defer to the EMA rule below.
+ */
+extern FileMode file_calibrated_mode[FILE_ACCESS_COUNT][FILE_PATTERN_COUNT]
+								   [FILE_SIZE_BUCKET_COUNT];
+
+static inline uint32_t file_size_bucket(uint64_t bytes)
+{
+	if (bytes <= (16ULL << 10))
+		return 0;
+	if (bytes <= (256ULL << 10))
+		return 1;
+	if (bytes <= (4ULL << 20))
+		return 2;
+	return 3;
+}
+
+/* Sequential when the request starts where the last one ended. */
+static inline FilePattern file_adaptive_pattern(FileAdaptiveState *state,
+												FileAccess access,
+												uint64_t offset,
+												uint64_t bytes)
+{
+	if (!state)
+		return FILE_PATTERN_SEQUENTIAL;
+	FilePattern pattern = (access == FILE_ACCESS_APPEND ||
+						   offset == state->next_offset) ?
+							  FILE_PATTERN_SEQUENTIAL :
+							  FILE_PATTERN_RANDOM;
+	state->next_offset = offset + bytes;
+	return pattern;
+}
+
+static inline FileMode file_adaptive_choose(FileAdaptiveState *state,
+											FileAccess access, uint64_t offset,
+											uint64_t bytes)
 {
+	FilePattern pattern = file_adaptive_pattern(state, access, offset, bytes);
+	FileMode calibrated = __atomic_load_n(
+		&file_calibrated_mode[access][pattern][file_size_bucket(bytes)],
+		__ATOMIC_RELAXED);
+	if (calibrated != FILE_MODE_AUTO)
+		return calibrated;
 	if (!state || state->last_op_ns == 0)
 		return FILE_MODE_MMAP;
 	return (state->iops_ema >= FILE_IOPS_DB_THRESHOLD) ? FILE_MODE_RING_BASED :
@@ -4,7 +4,9 @@
 #include "fundamental/error/error.h"
 #include "syscall_nums.h"
 #include "page_size.h"
-#include "ring_layout.h"
+#include "fileRing.h"
+#include "fileCache.h"
+#include "fileDirect.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -33,7 +35,7 @@ struct stat {
 	unsigned long __unused[3];
 };
 
-/* io_uring struct definitions are in ring_layout.h */
+/* io_uring struct definitions are in ring_layout.h (via fileRing.h) */
 
 /* MMap append: open → fstat+ftruncate → mmap → memcpy */
 typedef struct {
@@ -47,38 +49,15 @@ typedef struct {
 	bool mapped;
 } MMapAppendState;
 
-/* Ring append: io_uring_setup → open(O_APPEND) → write(off=-1) → poll cqe */
+/* Ring append: open(O_APPEND) → write(off=-1) on the shared ring → reap */
 typedef struct {
 	Append parameters;
-	int ring_fd;
 	int file_fd;
-	void *sq_ring;
-	void *cq_ring;
-	void *sqes;
-	uint64_t sq_ring_size;
-	uint64_t cq_ring_size;
-	uint64_t sqes_size;
-	uint32_t *sq_tail;
-	uint32_t *sq_mask;
-	uint32_t *sq_array;
-	uint32_t *cq_head;
-	uint32_t *cq_tail_ptr;
-	uint32_t *cq_mask;
-	struct io_uring_cqe *cqes_base;
-	bool ring_initialized;
 	bool file_opened;
-	bool io_submitted;
-	bool cqe_consumed;
+	FileRingRequest request;
 	uint64_t bytes_transferred;
 } RingAppendState;
 
-/* Write memory barrier — ensures prior stores are visible before head update. */
-#define smp_store_release(p, v)                \
-	do {                                       \
-		__asm__ __volatile__("" ::: "memory"); \
-		*(p) = (v);                            \
-	} while (0)
-
 static inline long syscall1(long n, long a1)
 {
 	long ret;
@@ -143,8 +122,8 @@ static AsyncStatus poll_mmap_append(AsyncResult *result)
 	AsyncStatus final_status = ASYNC_COMPLETED;
 
 	if (!state->file_opened) {
-		int fd = (int)syscall3(SYS_open, (long)state->parameters.file_path,
-							   O_RDWR | O_CREAT, 0644);
+		int fd =
+			file_cache_open(state->parameters.file_path, O_RDWR | O_CREAT);
 		if (fd < 0) {
 			result->error =
 				fun_error_result(-fd, "Failed to open file for append");
@@ -169,8 +148,19 @@ static AsyncStatus poll_mmap_append(AsyncResult *result)
 			goto cleanup;
 		}
 		uint64_t new_size = append_offset + state->parameters.bytes_to_append;
-		if (syscall2(SYS_ftruncate, state->file_descriptor, (long)new_size) <
-			0) {
+		/*
+		 * Allocate the range rather than leaving a hole for the page
+		 * faults to fill, so the tail lands in one extent.
+		 */
+		long grown = 0;
+		if (state->parameters.bytes_to_append > 0)
+			grown = syscall4(SYS_fallocate, state->file_descriptor, 0,
+							 (long)append_offset,
+							 (long)state->parameters.bytes_to_append);
+		if (grown == -EOPNOTSUPP)
+			grown = syscall2(SYS_ftruncate, state->file_descriptor,
+							 (long)new_size);
+		if (grown < 0) {
 			result->error = fun_error_result(1, "Failed to extend file");
 			final_status = ASYNC_ERROR;
 			goto cleanup;
@@ -226,7 +216,7 @@ cleanup:
 		syscall2(SYS_munmap, (long)state->mapped_address,
 				 (long)state->view_size);
 	if (state->file_opened)
-		syscall1(SYS_close, state->file_descriptor);
+		file_cache_close(state->file_descriptor);
 	fun_memory_free((Memory *)&state);
 	if (final_status == ASYNC_COMPLETED)
 		file_adaptive_update(adaptive, bytes);
@@ -262,80 +252,9 @@ static AsyncStatus poll_ring_append(AsyncResult *result)
 	uint64_t bytes = state->parameters.bytes_to_append;
 	AsyncStatus final_status = ASYNC_COMPLETED;
 
-	if (!state->ring_initialized) {
-		struct io_uring_params params = { 0 };
-
-		int ring_fd = (int)syscall2(SYS_io_uring_setup, 1, (long)&params);
-		if (ring_fd < 0) {
-			result->error = fun_error_result(-ring_fd, "io_uring_setup failed");
-			return ASYNC_ERROR;
-		}
-		state->ring_fd = ring_fd;
-
-		uint64_t sq_ring_size =
-			params.sq_off.array + params.sq_entries * sizeof(uint32_t);
-		uint64_t cq_ring_size = params.cq_off.cqes +
-								params.cq_entries * sizeof(struct io_uring_cqe);
-		uint64_t sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
-
-		state->sq_ring_size = sq_ring_size;
-		state->cq_ring_size = cq_ring_size;
-		state->sqes_size = sqes_size;
-
-		void *sq_ring = (void *)syscall6(SYS_mmap, 0, (long)sq_ring_size,
-										 PROT_READ | PROT_WRITE,
-										 MAP_SHARED | MAP_POPULATE, ring_fd,
-										 (long)IORING_OFF_SQ_RING);
-		if ((long)sq_ring < 0) {
-			syscall1(SYS_close, ring_fd);
-			result->error = fun_error_result(1, "Failed to mmap SQ ring");
-			return ASYNC_ERROR;
-		}
-		state->sq_ring = sq_ring;
-
-		void *cq_ring = (void *)syscall6(SYS_mmap, 0, (long)cq_ring_size,
-										 PROT_READ | PROT_WRITE,
-										 MAP_SHARED | MAP_POPULATE, ring_fd,
-										 (long)IORING_OFF_CQ_RING);
-		if ((long)cq_ring < 0) {
-			syscall2(SYS_munmap, (long)sq_ring, (long)sq_ring_size);
-			syscall1(SYS_close, ring_fd);
-			result->error = fun_error_result(1, "Failed to mmap CQ ring");
-			return ASYNC_ERROR;
-		}
-		state->cq_ring = cq_ring;
-
-		void *sqes = (void *)syscall6(SYS_mmap, 0, (long)sqes_size,
-									  PROT_READ | PROT_WRITE,
-									  MAP_SHARED | MAP_POPULATE, ring_fd,
-									  (long)IORING_OFF_SQES);
-		if ((long)sqes < 0) {
-			syscall2(SYS_munmap, (long)cq_ring, (long)cq_ring_size);
-			syscall2(SYS_munmap, (long)sq_ring, (long)sq_ring_size);
-			syscall1(SYS_close, ring_fd);
-			result->error = fun_error_result(1, "Failed to mmap SQEs");
-			return ASYNC_ERROR;
-		}
-		state->sqes = sqes;
-
-		state->sq_tail = (uint32_t *)((char *)sq_ring + params.sq_off.tail);
-		state->sq_mask =
-			(uint32_t *)((char *)sq_ring + params.sq_off.ring_mask);
-		state->sq_array = (uint32_t *)((char *)sq_ring + params.sq_off.array);
-		state->cq_head = (uint32_t *)((char *)cq_ring + params.cq_off.head);
-		state->cq_tail_ptr = (uint32_t *)((char *)cq_ring + params.cq_off.tail);
-		state->cq_mask =
-			(uint32_t *)((char *)cq_ring + params.cq_off.ring_mask);
-		state->cqes_base =
-			(struct io_uring_cqe *)((char *)cq_ring + params.cq_off.cqes);
-
-		state->ring_initialized = true;
-		return ASYNC_PENDING;
-	}
-
 	if (!state->file_opened) {
-		int fd = (int)syscall3(SYS_open, (long)state->parameters.file_path,
-							   O_WRONLY | O_CREAT | O_APPEND, 0644);
+		int fd = file_cache_open(state->parameters.file_path,
+								 O_WRONLY | O_CREAT | O_APPEND);
 		if (fd < 0) {
 			result->error =
 				fun_error_result(-fd, "Failed to open file for append");
@@ -344,93 +263,55 @@ static AsyncStatus poll_ring_append(AsyncResult *result)
 		}
 		state->file_fd = fd;
 		state->file_opened = true;
-		return ASYNC_PENDING;
 	}
 
-	if (!state->io_submitted) {
+	if (!state->request.submitted) {
 		uint64_t bytes_remaining =
 			state->parameters.bytes_to_append - state->bytes_transferred;
-		const char *buf_ptr =
-			(const char *)state->parameters.input + state->bytes_transferred;
-
-		uint32_t sq_tail = *state->sq_tail;
-		uint32_t sq_index = sq_tail & *state->sq_mask;
-
-		struct io_uring_sqe *sqe =
-			(struct io_uring_sqe *)state->sqes + sq_index;
-		sqe->opcode = IORING_OP_WRITE;
-		sqe->flags = 0;
-		sqe->ioprio = 0;
-		sqe->fd = state->file_fd;
-		sqe->off = (uint64_t)-1; /* O_APPEND: kernel determines position */
-		sqe->addr = (uint64_t)(long)buf_ptr;
-		sqe->len = (uint32_t)bytes_remaining;
-		sqe->rw_flags = 0;
-		sqe->user_data = 1;
-		sqe->buf_index = 0;
-
-		state->sq_array[sq_index] = sq_index;
-		smp_store_release(state->sq_tail, sq_tail + 1);
-
-		long ret = syscall4(SYS_io_uring_enter, state->ring_fd, 1, 1,
-							IORING_ENTER_GETEVENTS);
+		if (bytes_remaining > FILE_RING_MAX_IO_BYTES)
+			bytes_remaining = FILE_RING_MAX_IO_BYTES;
+
+		struct io_uring_sqe sqe = { 0 };
+		sqe.opcode = IORING_OP_WRITE;
+		sqe.fd = state->file_fd;
+		sqe.off = (uint64_t)-1; /* O_APPEND: kernel determines position */;
+		sqe.addr = (uint64_t)(long)((const char *)state->parameters.input +
+									state->bytes_transferred);
+		sqe.len = (uint32_t)bytes_remaining;
+
+		long ret = file_ring_submit(&sqe, &state->request);
+		if (ret == 1)
+			return ASYNC_PENDING; /* ring full: retry on next poll */
 		if (ret < 0) {
-			result->error = fun_error_result(-ret, "io_uring_enter failed");
+			result->error = fun_error_result(-ret, "io_uring submit failed");
 			final_status = ASYNC_ERROR;
 			goto cleanup;
 		}
-		state->io_submitted = true;
-		return ASYNC_PENDING;
 	}
 
-	if (state->cqe_consumed)
-		goto cleanup;
-
-	{
-		uint32_t cq_head = *state->cq_head;
-		if (cq_head == *state->cq_tail_ptr) {
-			return ASYNC_PENDING;
-		}
-
-		struct io_uring_cqe *cqe = &state->cqes_base[cq_head & *state->cq_mask];
-
-		if (cqe->flags & IORING_CQE_F_MORE) {
-			smp_store_release(state->cq_head, cq_head + 1);
-			return ASYNC_PENDING;
-		}
-
-		smp_store_release(state->cq_head, cq_head + 1);
-
-		if (cqe->res < 0) {
-			result->error =
-				fun_error_result(-cqe->res, "io_uring append failed");
-			final_status = ASYNC_ERROR;
-			goto cleanup;
-		}
+	if (!file_ring_reap(&state->request))
+		return ASYNC_PENDING;
 
-		state->bytes_transferred += (uint64_t)cqe->res;
+	if (state->request.res < 0) {
+		result->error =
+			fun_error_result(-state->request.res, "io_uring append failed");
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
 
-		if (state->bytes_transferred < state->parameters.bytes_to_append) {
-			/* Partial write — resubmit for the remaining bytes. */
-			state->io_submitted = false;
-			return ASYNC_PENDING;
-		}
+	state->bytes_transferred += (uint64_t)state->request.res;
 
-		state->cqe_consumed = true;
-		result->error = ERROR_RESULT_NO_ERROR;
+	if (state->bytes_transferred < state->parameters.bytes_to_append) {
+		/* Partial write — resubmit for the remaining bytes. */
+		state->request = (FileRingRequest){ 0 };
+		return ASYNC_PENDING;
 	}
 
+	result->error = ERROR_RESULT_NO_ERROR;
+
 cleanup:
-	if (state->sqes)
-		syscall2(SYS_munmap, (long)state->sqes, (long)state->sqes_size);
-	if (state->cq_ring)
-		syscall2(SYS_munmap, (long)state->cq_ring, (long)state->cq_ring_size);
-	if (state->sq_ring)
-		syscall2(SYS_munmap, (long)state->sq_ring, (long)state->sq_ring_size);
-	if (state->ring_fd >= 0)
-		syscall1(SYS_close, state->ring_fd);
 	if (state->file_opened)
-		syscall1(SYS_close, state->file_fd);
+		file_cache_close(state->file_fd);
 	fun_memory_free((Memory *)&state);
 	if (final_status == ASYNC_COMPLETED)
 		file_adaptive_update(adaptive, bytes);
@@ -447,25 +328,9 @@ static AsyncResult create_ring_append(Append parameters)
 	RingAppendState *state = (RingAppendState *)mem_result.value;
 	*state = (RingAppendState){
 		.parameters = parameters,
-		.ring_fd = -1,
 		.file_fd = -1,
-		.sq_ring = NULL,
-		.cq_ring = NULL,
-		.sqes = NULL,
-		.sq_ring_size = 0,
-		.cq_ring_size = 0,
-		.sqes_size = 0,
-		.sq_tail = NULL,
-		.sq_mask = NULL,
-		.sq_array = NULL,
-		.cq_head = NULL,
-		.cq_tail_ptr = NULL,
-		.cq_mask = NULL,
-		.cqes_base = NULL,
-		.ring_initialized = false,
 		.file_opened = false,
-		.io_submitted = false,
-		.cqe_consumed = false,
+		.request = { 0 },
 		.bytes_transferred = 0,
 	};
 
@@ -486,10 +351,13 @@ AsyncResult fun_append_memory_to_file(Append parameters)
 
 	FileMode mode = parameters.mode;
 	if (mode == FILE_MODE_AUTO)
-		mode = file_adaptive_choose(parameters.adaptive);
+		mode = file_adaptive_choose(parameters.adaptive, FILE_ACCESS_APPEND,
+									0, parameters.bytes_to_append);
 
 	if (mode == FILE_MODE_RING_BASED)
 		return create_ring_append(parameters);
+	if (mode == FILE_MODE_DIRECT)
+		return create_direct_append(parameters);
 
 	return create_mmap_append(parameters);
 }
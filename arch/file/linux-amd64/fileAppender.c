@@ -0,0 +1,258 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+#include "ring_layout.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Group commit: appends queue an AppendEntry; the first poll to find the
+ * queue non-empty with no commit running becomes the committer.  It takes
+ * the queue, drops the lock, writes the batch with one writev on the
+ * O_APPEND descriptor (so each commit lands contiguously even if other
+ * writers append to the file), flushes once, then marks every entry done.
+ * Entries belong to their AsyncResult and are freed by its poll.
+ */
+
+struct AppenderState;
+
+typedef struct AppendEntry {
+	struct AppendEntry *next;
+	struct AppenderState *appender;
+	const char *input;
+	uint64_t bytes;
+	ErrorResult error; /* valid once done */
+	bool done;
+} AppendEntry;
+
+typedef struct AppenderState {
+	int fd;
+	FileDurabilityMode durability;
+	int32_t lock;
+	AppendEntry *head; /* queued for the next commit */
+	AppendEntry *tail;
+	uint32_t outstanding; /* entries whose owner has not completed yet */
+	bool committing;
+	/* only the committer touches this */
+	struct iovec iov[FILE_APPENDER_MAX_BATCH];
+} AppenderState;
+
+static inline long syscall0(long n)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static void appender_lock(AppenderState *appender)
+{
+	for (;;) {
+		int32_t expected = 0;
+		if (__atomic_compare_exchange_n(&appender->lock, &expected, 1, 0,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			return;
+		while (__atomic_load_n(&appender->lock, __ATOMIC_RELAXED))
+			__builtin_ia32_pause();
+	}
+}
+
+static void appender_unlock(AppenderState *appender)
+{
+	__atomic_store_n(&appender->lock, 0, __ATOMIC_RELEASE);
+}
+
+/* Write iov[0..count) completely, resuming after short writes. */
+static long appender_write(AppenderState *appender, uint32_t count)
+{
+	struct iovec *iov = appender->iov;
+	while (count > 0) {
+		long ret = syscall3(SYS_writev, appender->fd, (long)iov, count);
+		if (ret == -EINTR)
+			continue;
+		if (ret < 0)
+			return ret;
+		uint64_t written = (uint64_t)ret;
+		while (count > 0 && written >= iov->iov_len) {
+			written -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if (count > 0) {
+			iov->iov_base = (char *)iov->iov_base + written;
+			iov->iov_len -= written;
+		}
+	}
+	return 0;
+}
+
+/* Called and returns with the lock held; drops it around the I/O. */
+static void appender_commit_locked(AppenderState *appender)
+{
+	AppendEntry *batch = appender->head;
+	AppendEntry *last = batch;
+	uint32_t count = 1;
+	appender->iov[0] = (struct iovec){ (void *)batch->input, batch->bytes };
+	while (last->next && count < FILE_APPENDER_MAX_BATCH) {
+		last = last->next;
+		appender->iov[count++] =
+			(struct iovec){ (void *)last->input, last->bytes };
+	}
+	appender->head = last->next;
+	if (!appender->head)
+		appender->tail = NULL;
+	last->next = NULL;
+	appender->committing = true;
+	appender_unlock(appender);
+
+	long ret = appender_write(appender, count);
+	if (ret == 0 && appender->durability == FILE_DURABILITY_SYNC)
+		ret = syscall1(SYS_fdatasync, appender->fd);
+	else if (ret == 0 && appender->durability == FILE_DURABILITY_FULL)
+		ret = syscall1(SYS_fsync, appender->fd);
+	ErrorResult error = ret < 0 ?
+							fun_error_result(-ret, "Group commit failed") :
+							ERROR_RESULT_NO_ERROR;
+
+	appender_lock(appender);
+	for (AppendEntry *entry = batch; entry; entry = entry->next) {
+		entry->error = error;
+		entry->done = true;
+	}
+	appender->committing = false;
+}
+
+static AsyncStatus poll_appender(AsyncResult *result)
+{
+	AppendEntry *entry = (AppendEntry *)result->state;
+	AppenderState *appender = entry->appender;
+
+	appender_lock(appender);
+	if (!entry->done && !appender->committing && appender->head)
+		appender_commit_locked(appender);
+	if (!entry->done) {
+		bool waiting = appender->committing;
+		appender_unlock(appender);
+		/* Another thread is flushing; let it run rather than spin. */
+		if (waiting)
+			syscall0(SYS_sched_yield);
+		return ASYNC_PENDING;
+	}
+	appender->outstanding--;
+	appender_unlock(appender);
+
+	result->error = entry->error;
+	fun_memory_free((Memory *)&entry);
+	return fun_error_is_ok(result->error) ? ASYNC_COMPLETED : ASYNC_ERROR;
+}
+
+ErrorResult fun_file_appender_open(String file_path,
+								   FileDurabilityMode durability,
+								   FileAppender *out_appender)
+{
+	if (!file_path || !out_appender)
+		return ERROR_RESULT_NULL_POINTER;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(AppenderState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+
+	int fd = (int)syscall3(SYS_open, (long)file_path,
+						   O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (fd < 0) {
+		fun_memory_free(&allocation.value);
+		return fun_error_result(-fd, "Failed to open file for append");
+	}
+
+	AppenderState *appender = (AppenderState *)allocation.value;
+	appender->fd = fd;
+	appender->durability = durability;
+	appender->lock = 0;
+	appender->head = NULL;
+	appender->tail = NULL;
+	appender->outstanding = 0;
+	appender->committing = false;
+	out_appender->state = appender;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+AsyncResult fun_file_appender_append(FileAppender appender, Memory input,
+									 uint64_t bytes_to_append)
+{
+	AppenderState *state = (AppenderState *)appender.state;
+	if (!state || !input)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (bytes_to_append == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(AppendEntry));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	AppendEntry *entry = (AppendEntry *)allocation.value;
+	*entry = (AppendEntry){ .appender = state,
+							.input = (const char *)input,
+							.bytes = bytes_to_append };
+
+	/* Queue now, not on first poll, so a burst of appends shares a commit. */
+	appender_lock(state);
+	if (state->tail)
+		state->tail->next = entry;
+	else
+		state->head = entry;
+	state->tail = entry;
+	state->outstanding++;
+	appender_unlock(state);
+
+	return (AsyncResult){ .state = entry,
+						  .poll = poll_appender,
+						  .status = ASYNC_PENDING };
+}
+
+ErrorResult fun_file_appender_close(FileAppender *appender)
+{
+	if (!appender || !appender->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	AppenderState *state = (AppenderState *)appender->state;
+	appender_lock(state);
+	bool busy = state->outstanding > 0;
+	appender_unlock(state);
+	if (busy)
+		return ERROR_RESULT_FILE_APPENDER_BUSY;
+
+	long ret = syscall1(SYS_close, state->fd);
+	fun_memory_free(&appender->state);
+	appender->state = NULL;
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to close file");
+	return ERROR_RESULT_NO_ERROR;
+}
@@ -0,0 +1,228 @@
+#include "fileCache.h"
+#include "fileRing.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+/* Longer paths are opened directly and never cached. */
+#define FILE_CACHE_PATH_MAX 256
+
+typedef struct {
+	char path[FILE_CACHE_PATH_MAX]; /* empty when the slot is free */
+	uint64_t path_hash;
+	int fd;
+	int flags;
+	uint32_t users; /* operations currently holding fd */
+	uint64_t last_used;
+} FileCacheEntry;
+
+static FileCacheEntry *g_entries = NULL;
+static uint32_t g_capacity = 0;
+static uint64_t g_tick = 0;
+static int32_t g_cache_lock = 0;
+
+static void cache_lock(void)
+{
+	for (;;) {
+		int32_t expected = 0;
+		if (__atomic_compare_exchange_n(&g_cache_lock, &expected, 1, 0,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			return;
+		while (__atomic_load_n(&g_cache_lock, __ATOMIC_RELAXED))
+			__builtin_ia32_pause();
+	}
+}
+
+static void cache_unlock(void)
+{
+	__atomic_store_n(&g_cache_lock, 0, __ATOMIC_RELEASE);
+}
+
+/* FNV-1a; also measures the path. */
+static uint64_t path_hash(String path, size_t *length)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	size_t i = 0;
+	for (; path[i]; i++) {
+		hash ^= (uint8_t)path[i];
+		hash *= 1099511628211ULL;
+	}
+	*length = i;
+	return hash;
+}
+
+static bool path_equal(const char *a, String b)
+{
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+static FileCacheEntry *cache_find_locked(String path, uint64_t hash,
+										 int flags)
+{
+	for (uint32_t i = 0; i < g_capacity; i++) {
+		FileCacheEntry *entry = &g_entries[i];
+		if (entry->path[0] && entry->path_hash == hash &&
+			entry->flags == flags && path_equal(entry->path, path))
+			return entry;
+	}
+	return NULL;
+}
+
+/* A free slot, else the least recently used idle one; NULL if all busy. */
+static FileCacheEntry *cache_victim_locked(void)
+{
+	FileCacheEntry *victim = NULL;
+	for (uint32_t i = 0; i < g_capacity; i++) {
+		FileCacheEntry *entry = &g_entries[i];
+		if (!entry->path[0])
+			return entry;
+		if (entry->users == 0 &&
+			(!victim || entry->last_used < victim->last_used))
+			victim = entry;
+	}
+	return victim;
+}
+
+int file_cache_open(String path, int flags)
+{
+	size_t length;
+	uint64_t hash = path_hash(path, &length);
+	bool cacheable = length > 0 && length < FILE_CACHE_PATH_MAX;
+
+	if (cacheable) {
+		cache_lock();
+		FileCacheEntry *entry = cache_find_locked(path, hash, flags);
+		if (entry) {
+			entry->users++;
+			entry->last_used = ++g_tick;
+			cache_unlock();
+			return entry->fd;
+		}
+		cacheable = g_capacity > 0;
+		cache_unlock();
+	}
+
+	/* Open outside the lock; open can block on slow filesystems. */
+	int fd = (int)syscall3(SYS_open, (long)path, flags, 0644);
+	if (fd < 0 || !cacheable)
+		return fd;
+
+	int evicted_fd = -1;
+	bool inserted = false;
+	cache_lock();
+	FileCacheEntry *entry = cache_find_locked(path, hash, flags);
+	if (entry) {
+		/* Another thread cached the path meanwhile; use its descriptor. */
+		entry->users++;
+		entry->last_used = ++g_tick;
+		evicted_fd = fd;
+		fd = entry->fd;
+	} else if ((entry = cache_victim_locked()) != NULL) {
+		if (entry->path[0])
+			evicted_fd = entry->fd;
+		for (size_t i = 0; i <= length; i++)
+			entry->path[i] = path[i];
+		entry->path_hash = hash;
+		entry->fd = fd;
+		entry->flags = flags;
+		entry->users = 1;
+		entry->last_used = ++g_tick;
+		inserted = true;
+	}
+	cache_unlock();
+
+	if (evicted_fd >= 0) {
+		file_ring_unregister_file(evicted_fd);
+		syscall1(SYS_close, evicted_fd);
+	}
+	/* Cached descriptors live long enough to pay for a fixed-file slot. */
+	if (inserted)
+		file_ring_register_file(fd);
+	return fd;
+}
+
+void file_cache_close(int fd)
+{
+	cache_lock();
+	for (uint32_t i = 0; i < g_capacity; i++) {
+		FileCacheEntry *entry = &g_entries[i];
+		if (entry->path[0] && entry->fd == fd) {
+			entry->users--;
+			cache_unlock();
+			return;
+		}
+	}
+	cache_unlock();
+
+	/* Not cached: an open descriptor's number cannot be in the table. */
+	syscall1(SYS_close, fd);
+}
+
+ErrorResult fun_file_cache_set_capacity(uint32_t capacity)
+{
+	if (capacity > FILE_CACHE_MAX_CAPACITY)
+		return ERROR_RESULT_FILE_CACHE_INVALID_CAPACITY;
+
+	/* Allocate first so a failure leaves the old cache in place. */
+	FileCacheEntry *entries = NULL;
+	if (capacity > 0) {
+		MemoryResult allocation =
+			fun_memory_allocate(capacity * sizeof(FileCacheEntry));
+		if (fun_error_is_error(allocation.error))
+			return allocation.error;
+		entries = (FileCacheEntry *)allocation.value;
+		for (uint32_t i = 0; i < capacity; i++)
+			entries[i] = (FileCacheEntry){ .fd = -1 };
+	}
+
+	cache_lock();
+	for (uint32_t i = 0; i < g_capacity; i++) {
+		if (g_entries[i].path[0] && g_entries[i].users > 0) {
+			cache_unlock();
+			if (entries)
+				fun_memory_free((Memory *)&entries);
+			return ERROR_RESULT_FILE_CACHE_BUSY;
+		}
+	}
+	FileCacheEntry *old_entries = g_entries;
+	uint32_t old_capacity = g_capacity;
+	g_entries = entries;
+	g_capacity = capacity;
+	cache_unlock();
+
+	for (uint32_t i = 0; i < old_capacity; i++) {
+		if (old_entries[i].path[0]) {
+			file_ring_unregister_file(old_entries[i].fd);
+			syscall1(SYS_close, old_entries[i].fd);
+		}
+	}
+	if (old_entries)
+		fun_memory_free((Memory *)&old_entries);
+	return ERROR_RESULT_NO_ERROR;
+}
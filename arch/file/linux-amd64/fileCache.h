@@ -0,0 +1,16 @@
+#pragma once
+#include "fundamental/file/file.h"
+
+/*
+ * Descriptor cache behind the path-based file calls.
+ *
+ * file_cache_open returns a descriptor for path opened with flags (mode
+ * 0644 when creating), reusing a cached one when the cache is enabled and
+ * holds the same path and flags.  Every descriptor it returns, cached or
+ * not, must be given back with file_cache_close, which keeps cached
+ * descriptors open for the next caller and closes the rest.
+ *
+ * Returns the descriptor or a negative errno.
+ */
+int file_cache_open(String path, int flags);
+void file_cache_close(int fd);
@@ -0,0 +1,283 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+struct stat {
+	unsigned long st_dev;
+	unsigned long st_ino;
+	unsigned long st_nlink;
+	unsigned int st_mode;
+	unsigned int st_uid;
+	unsigned int st_gid;
+	unsigned long st_rdev;
+	unsigned long st_size;
+	unsigned long st_blksize;
+	unsigned long st_blocks;
+	unsigned long st_atime;
+	unsigned long st_atime_nsec;
+	unsigned long st_mtime;
+	unsigned long st_mtime_nsec;
+	unsigned long st_ctime;
+	unsigned long st_ctime_nsec;
+	unsigned long __unused[3];
+};
+
+typedef struct {
+	FileCopy parameters;
+	bool whole_file;
+	bool files_opened;
+	bool use_sendfile; /* copy_file_range refused this pair of files */
+	bool same_file; /* a range copy within one file */
+	int source_fd;
+	int destination_fd;
+	uint64_t total; /* whole file: source size at open */
+	uint64_t copied;
+	int64_t source_position; /* advanced by the kernel */
+	int64_t destination_position;
+} CopyState;
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5,
+							long a6)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	register long r9 __asm__("r9") = a6;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8),
+						   "r"(r9)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static ErrorResult copy_open(CopyState *state)
+{
+	FileCopy *parameters = &state->parameters;
+	int source_fd =
+		(int)syscall3(SYS_open, (long)parameters->source_path, O_RDONLY, 0);
+	if (source_fd < 0)
+		return fun_error_result(-source_fd, "Failed to open copy source");
+	state->source_fd = source_fd;
+
+	int destination_fd = (int)syscall3(
+		SYS_open, (long)parameters->destination_path, O_WRONLY | O_CREAT, 0644);
+	if (destination_fd < 0)
+		return fun_error_result(-destination_fd,
+								"Failed to open copy destination");
+	state->destination_fd = destination_fd;
+	state->files_opened = true;
+
+	/* Check before writing: the destination may be the source. */
+	struct stat source_stat;
+	struct stat destination_stat;
+	long ret = syscall2(SYS_fstat, source_fd, (long)&source_stat);
+	if (ret == 0)
+		ret = syscall2(SYS_fstat, destination_fd, (long)&destination_stat);
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to stat copy files");
+	state->same_file = source_stat.st_dev == destination_stat.st_dev &&
+					   source_stat.st_ino == destination_stat.st_ino;
+
+	if (!state->whole_file) {
+		/* Neither copy_file_range nor sendfile copies overlap safely. */
+		if (state->same_file &&
+			parameters->source_offset <
+				parameters->destination_offset + parameters->bytes &&
+			parameters->destination_offset <
+				parameters->source_offset + parameters->bytes)
+			return ERROR_RESULT_FILE_COPY_OVERLAP;
+		return ERROR_RESULT_NO_ERROR;
+	}
+	if (state->same_file)
+		return ERROR_RESULT_FILE_COPY_SAME_FILE;
+
+	ret = syscall2(SYS_ftruncate, destination_fd, 0);
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to truncate copy destination");
+	state->total = source_stat.st_size;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/* Bytes moved, 0 at end of source, or a negative errno. */
+static long copy_step(CopyState *state, uint64_t bytes)
+{
+	if (!state->use_sendfile) {
+		long ret = syscall6(SYS_copy_file_range, state->source_fd,
+							(long)&state->source_position,
+							state->destination_fd,
+							(long)&state->destination_position, (long)bytes, 0);
+		/*
+		 * Different filesystems (before 5.19 for most), no kernel support,
+		 * or a filesystem that declines: sendfile still avoids the copy
+		 * through user memory.  Within one file EINVAL is a real error,
+		 * not a refusal.
+		 */
+		if (ret != -EXDEV && ret != -ENOSYS && ret != -EOPNOTSUPP &&
+			(ret != -EINVAL || state->same_file))
+			return ret;
+		/* sendfile writes at the destination's file position. */
+		long seek = syscall3(SYS_lseek, state->destination_fd,
+							 (long)state->destination_position, SEEK_SET);
+		if (seek < 0)
+			return seek;
+		state->use_sendfile = true;
+	}
+	return syscall4(SYS_sendfile, state->destination_fd, state->source_fd,
+					(long)&state->source_position, (long)bytes);
+}
+
+static AsyncStatus poll_copy(AsyncResult *result)
+{
+	CopyState *state = (CopyState *)result->state;
+	FileCopy *parameters = &state->parameters;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->files_opened) {
+		result->error = copy_open(state);
+		if (fun_error_is_error(result->error)) {
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+
+	if (state->copied < state->total) {
+		uint64_t bytes = state->total - state->copied;
+		if (bytes > FILE_COPY_STEP_BYTES)
+			bytes = FILE_COPY_STEP_BYTES;
+		long ret = copy_step(state, bytes);
+		if (ret == -EINTR || ret == -EAGAIN)
+			return ASYNC_PENDING;
+		if (ret < 0) {
+			result->error = fun_error_result(-ret, "File copy failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (ret == 0) {
+			/* A whole-file copy takes what is there; a range is exact. */
+			if (!state->whole_file) {
+				result->error = ERROR_RESULT_FILE_UNEXPECTED_EOF;
+				final_status = ASYNC_ERROR;
+				goto cleanup;
+			}
+			state->total = state->copied;
+		}
+		state->copied += (uint64_t)ret;
+		if (parameters->bytes_copied)
+			*parameters->bytes_copied = state->copied;
+		if (state->copied < state->total)
+			return ASYNC_PENDING;
+	}
+
+	long ret = 0;
+	if (parameters->durability_mode == FILE_DURABILITY_SYNC)
+		ret = syscall1(SYS_fdatasync, state->destination_fd);
+	else if (parameters->durability_mode == FILE_DURABILITY_FULL)
+		ret = syscall1(SYS_fsync, state->destination_fd);
+	if (ret < 0) {
+		result->error = fun_error_result(-ret, "Failed to sync copy");
+		final_status = ASYNC_ERROR;
+	}
+
+cleanup:
+	if (state->source_fd >= 0)
+		syscall1(SYS_close, state->source_fd);
+	if (state->destination_fd >= 0)
+		syscall1(SYS_close, state->destination_fd);
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+static AsyncResult create_copy(FileCopy parameters, bool whole_file)
+{
+	if (!parameters.source_path || !parameters.destination_path)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (!whole_file &&
+		(parameters.source_offset > (uint64_t)INT64_MAX ||
+		 parameters.destination_offset > (uint64_t)INT64_MAX ||
+		 parameters.bytes > (uint64_t)INT64_MAX - parameters.source_offset ||
+		 parameters.bytes >
+			 (uint64_t)INT64_MAX - parameters.destination_offset))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	if (parameters.bytes_copied)
+		*parameters.bytes_copied = 0;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(CopyState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	CopyState *state = (CopyState *)allocation.value;
+	*state = (CopyState){
+		.parameters = parameters,
+		.whole_file = whole_file,
+		.source_fd = -1,
+		.destination_fd = -1,
+		.total = whole_file ? 0 : parameters.bytes,
+		.source_position = whole_file ? 0 : (int64_t)parameters.source_offset,
+		.destination_position =
+			whole_file ? 0 : (int64_t)parameters.destination_offset,
+	};
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_copy,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult fun_file_copy(FileCopy parameters)
+{
+	return create_copy(parameters, true);
+}
+
+AsyncResult fun_file_copy_range(FileCopy parameters)
+{
+	return create_copy(parameters, false);
+}
@@ -0,0 +1,392 @@
+#include "fileDirect.h"
+#include "fileAdaptive.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+#include "page_size.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+struct stat {
+	unsigned long st_dev;
+	unsigned long st_ino;
+	unsigned long st_nlink;
+	unsigned int st_mode;
+	unsigned int st_uid;
+	unsigned int st_gid;
+	unsigned long st_rdev;
+	unsigned long st_size;
+	unsigned long st_blksize;
+	unsigned long st_blocks;
+	unsigned long st_atime;
+	unsigned long st_atime_nsec;
+	unsigned long st_mtime;
+	unsigned long st_mtime_nsec;
+	unsigned long st_ctime;
+	unsigned long st_ctime_nsec;
+	unsigned long __unused[3];
+};
+
+typedef enum {
+	DIRECT_READ,
+	DIRECT_WRITE,
+	DIRECT_APPEND,
+} DirectOperation;
+
+typedef struct {
+	DirectOperation operation;
+	String file_path;
+	Memory buffer; /* destination for reads, source for writes */
+	uint64_t bytes;
+	uint64_t offset; /* appends: resolved to the file size at open */
+	FileDurabilityMode durability_mode;
+	FileAdaptiveState *adaptive;
+	int fd;
+	bool file_opened;
+	bool direct; /* false when the filesystem refused O_DIRECT */
+	uint64_t original_size; /* writes: size before, to trim block padding */
+	uint64_t written_end; /* writes: furthest byte written, padding included */
+	uint64_t bytes_transferred;
+	Memory bounce_allocation;
+	char *bounce; /* bounce_allocation rounded up to the alignment */
+} DirectState;
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+uint64_t fun_file_direct_alignment(void)
+{
+	return get_page_size();
+}
+
+static long direct_open(DirectState *state)
+{
+	int flags = state->operation == DIRECT_READ ? O_RDONLY :
+												  O_RDWR | O_CREAT;
+	long fd = syscall3(SYS_open, (long)state->file_path, flags | O_DIRECT,
+					   0644);
+	state->direct = fd >= 0;
+	if (fd == -EINVAL)
+		fd = syscall3(SYS_open, (long)state->file_path, flags, 0644);
+	if (fd < 0)
+		return fd;
+	state->fd = (int)fd;
+	state->file_opened = true;
+
+	if (state->operation != DIRECT_READ) {
+		struct stat file_stat;
+		long ret = syscall2(SYS_fstat, state->fd, (long)&file_stat);
+		if (ret < 0)
+			return ret;
+		state->original_size = file_stat.st_size;
+		if (state->operation == DIRECT_APPEND)
+			state->offset = state->original_size;
+	}
+	return 0;
+}
+
+static long direct_bounce(DirectState *state)
+{
+	if (state->bounce)
+		return 0;
+	uint64_t alignment = get_page_size();
+	MemoryResult allocation =
+		fun_memory_allocate(FILE_DIRECT_BOUNCE_BYTES + alignment);
+	if (fun_error_is_error(allocation.error))
+		return -ENOMEM;
+	state->bounce_allocation = allocation.value;
+	uintptr_t address = (uintptr_t)allocation.value;
+	state->bounce =
+		(char *)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	return 0;
+}
+
+/* Read alignment bytes at block into bounce + at, zero-filling past EOF. */
+static long direct_read_block(DirectState *state, uint64_t at, uint64_t block)
+{
+	uint64_t alignment = get_page_size();
+	long ret = syscall4(SYS_pread64, state->fd, (long)(state->bounce + at),
+						(long)alignment, (long)block);
+	if (ret < 0)
+		return ret;
+	if ((uint64_t)ret < alignment)
+		fun_memory_fill(state->bounce + at + ret, alignment - ret, 0);
+	return 0;
+}
+
+/* One chunk; returns bytes moved, 0 at end of file, or a negative errno. */
+static long direct_read_step(DirectState *state)
+{
+	uint64_t alignment = get_page_size();
+	uint64_t position = state->offset + state->bytes_transferred;
+	uint64_t remaining = state->bytes - state->bytes_transferred;
+	char *output = (char *)state->buffer + state->bytes_transferred;
+
+	if (position % alignment == 0 && (uintptr_t)output % alignment == 0 &&
+		remaining >= alignment) {
+		uint64_t length = remaining - remaining % alignment;
+		if (length > FILE_DIRECT_MAX_IO_BYTES)
+			length = FILE_DIRECT_MAX_IO_BYTES;
+		return syscall4(SYS_pread64, state->fd, (long)output, (long)length,
+						(long)position);
+	}
+
+	long ret = direct_bounce(state);
+	if (ret < 0)
+		return ret;
+
+	uint64_t block = position - position % alignment;
+	uint64_t head = position - block;
+	uint64_t span = head + remaining;
+	span = (span + alignment - 1) & ~(alignment - 1);
+	if (span > FILE_DIRECT_BOUNCE_BYTES)
+		span = FILE_DIRECT_BOUNCE_BYTES;
+
+	ret = syscall4(SYS_pread64, state->fd, (long)state->bounce, (long)span,
+				   (long)block);
+	if (ret <= 0 || (uint64_t)ret <= head)
+		return ret < 0 ? ret : 0;
+
+	uint64_t count = (uint64_t)ret - head;
+	if (count > remaining)
+		count = remaining;
+	fun_memory_copy(state->bounce + head, output, count);
+	return (long)count;
+}
+
+/* One chunk; returns bytes of the caller's data written or a negative errno. */
+static long direct_write_step(DirectState *state)
+{
+	uint64_t alignment = get_page_size();
+	uint64_t position = state->offset + state->bytes_transferred;
+	uint64_t remaining = state->bytes - state->bytes_transferred;
+	const char *input =
+		(const char *)state->buffer + state->bytes_transferred;
+
+	if (position % alignment == 0 && (uintptr_t)input % alignment == 0 &&
+		remaining >= alignment) {
+		uint64_t length = remaining - remaining % alignment;
+		if (length > FILE_DIRECT_MAX_IO_BYTES)
+			length = FILE_DIRECT_MAX_IO_BYTES;
+		long ret = syscall4(SYS_pwrite64, state->fd, (long)input,
+							(long)length, (long)position);
+		if (ret > 0 && position + ret > state->written_end)
+			state->written_end = position + ret;
+		return ret;
+	}
+
+	long ret = direct_bounce(state);
+	if (ret < 0)
+		return ret;
+
+	uint64_t block = position - position % alignment;
+	uint64_t head = position - block;
+	uint64_t span = head + remaining;
+	span = (span + alignment - 1) & ~(alignment - 1);
+	if (span > FILE_DIRECT_BOUNCE_BYTES)
+		span = FILE_DIRECT_BOUNCE_BYTES;
+	uint64_t count = span - head;
+	if (count > remaining)
+		count = remaining;
+
+	/* Keep the bytes around the caller's data in partially covered blocks. */
+	if (head > 0 && (ret = direct_read_block(state, 0, block)) < 0)
+		return ret;
+	uint64_t tail = span - alignment;
+	if ((head + count) % alignment != 0 && (head == 0 || tail > 0) &&
+		(ret = direct_read_block(state, tail, block + tail)) < 0)
+		return ret;
+
+	fun_memory_copy((Memory)input, state->bounce + head, count);
+	ret = syscall4(SYS_pwrite64, state->fd, (long)state->bounce, (long)span,
+				   (long)block);
+	if (ret < 0)
+		return ret;
+	if ((uint64_t)ret <= head)
+		return -EIO;
+	if (block + ret > state->written_end)
+		state->written_end = block + ret;
+	if ((uint64_t)ret - head < count)
+		count = (uint64_t)ret - head;
+	return (long)count;
+}
+
+/* Trim block padding, then flush as durability_mode asks. */
+static long direct_finish_write(DirectState *state)
+{
+	uint64_t end = state->offset + state->bytes;
+	if (end < state->original_size)
+		end = state->original_size;
+	if (state->written_end > end) {
+		long ret = syscall2(SYS_ftruncate, state->fd, (long)end);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (state->durability_mode == FILE_DURABILITY_SYNC)
+		return syscall1(SYS_fdatasync, state->fd);
+	if (state->durability_mode == FILE_DURABILITY_FULL)
+		return syscall1(SYS_fsync, state->fd);
+	return 0;
+}
+
+static AsyncStatus poll_direct(AsyncResult *result)
+{
+	DirectState *state = (DirectState *)result->state;
+	FileAdaptiveState *adaptive = state->adaptive;
+	uint64_t bytes = state->bytes;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->file_opened) {
+		long ret = direct_open(state);
+		if (ret < 0) {
+			result->error = fun_error_result(-ret, "Failed to open file");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (state->bytes > 0)
+			return ASYNC_PENDING;
+	}
+
+	if (state->bytes_transferred < state->bytes) {
+		long ret = state->operation == DIRECT_READ ?
+					   direct_read_step(state) :
+					   direct_write_step(state);
+		if (ret == -EINTR)
+			return ASYNC_PENDING;
+		if (ret < 0) {
+			result->error = fun_error_result(
+				-ret, state->operation == DIRECT_READ ? "Direct read failed" :
+														"Direct write failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (ret == 0) {
+			result->error = ERROR_RESULT_FILE_UNEXPECTED_EOF;
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		state->bytes_transferred += (uint64_t)ret;
+		if (state->bytes_transferred < state->bytes)
+			return ASYNC_PENDING;
+	}
+
+	if (state->operation != DIRECT_READ) {
+		long ret = direct_finish_write(state);
+		if (ret < 0) {
+			result->error = fun_error_result(-ret, "Direct write failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+
+	/* Buffered fallback: at least leave nothing behind in the cache. */
+	if (!state->direct)
+		syscall4(SYS_fadvise, state->fd, (long)state->offset,
+				 (long)state->bytes, POSIX_FADV_DONTNEED);
+
+	result->error = ERROR_RESULT_NO_ERROR;
+
+cleanup:
+	if (state->file_opened)
+		syscall1(SYS_close, state->fd);
+	if (state->bounce_allocation)
+		fun_memory_free(&state->bounce_allocation);
+	fun_memory_free((Memory *)&state);
+	if (final_status == ASYNC_COMPLETED)
+		file_adaptive_update(adaptive, bytes);
+	return final_status;
+}
+
+static AsyncResult create_direct(DirectState initial)
+{
+	MemoryResult allocation = fun_memory_allocate(sizeof(DirectState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	DirectState *state = (DirectState *)allocation.value;
+	*state = initial;
+	state->fd = -1;
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_direct,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult create_direct_read(Read parameters)
+{
+	return create_direct((DirectState){ .operation = DIRECT_READ,
+										.file_path = parameters.file_path,
+										.buffer = parameters.output,
+										.bytes = parameters.bytes_to_read,
+										.offset = parameters.offset,
+										.adaptive = parameters.adaptive });
+}
+
+AsyncResult create_direct_write(Write parameters)
+{
+	return create_direct(
+		(DirectState){ .operation = DIRECT_WRITE,
+					   .file_path = parameters.file_path,
+					   .buffer = parameters.input,
+					   .bytes = parameters.bytes_to_write,
+					   .offset = parameters.offset,
+					   .durability_mode = parameters.durability_mode,
+					   .adaptive = parameters.adaptive });
+}
+
+/*
+ * The end of file is sampled at open, so unlike the O_APPEND paths two
+ * concurrent direct appends to one file may overwrite each other.
+ */
+AsyncResult create_direct_append(Append parameters)
+{
+	return create_direct(
+		(DirectState){ .operation = DIRECT_APPEND,
+					   .file_path = parameters.file_path,
+					   .buffer = parameters.input,
+					   .bytes = parameters.bytes_to_append,
+					   .durability_mode = parameters.durability_mode,
+					   .adaptive = parameters.adaptive });
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "fundamental/file/file.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * FILE_MODE_DIRECT: pread / pwrite on an O_DIRECT descriptor, one chunk
+ * per poll.
+ *
+ * Chunks that are aligned in file offset, memory address and length go
+ * straight between the caller's buffer and the device.  The rest goes
+ * through an aligned bounce buffer: reads fetch the covering blocks and
+ * copy out the requested bytes; writes read back any partially covered
+ * head / tail block, patch it, and write whole blocks, then trim the file
+ * if the last block ran past the requested end.
+ *
+ * Filesystems without O_DIRECT support (tmpfs, some FUSE) refuse the
+ * open with EINVAL; the operation then runs buffered and drops its range
+ * from the page cache with POSIX_FADV_DONTNEED when done.
+ *
+ * Direct descriptors are not kept in the descriptor cache: a stream
+ * touches each file once, and the cached descriptors are buffered.
+ */
+
+/* Largest aligned transfer issued straight from the caller's buffer. */
+#define FILE_DIRECT_MAX_IO_BYTES (64ULL << 20)
+/* Size of the bounce buffer, allocated only when a chunk is unaligned. */
+#define FILE_DIRECT_BOUNCE_BYTES (1ULL << 20)
+
+AsyncResult create_direct_read(Read parameters);
+AsyncResult create_direct_write(Write parameters);
+AsyncResult create_direct_append(Append parameters);
@@ -0,0 +1,382 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+#include "page_size.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+struct stat {
+	unsigned long st_dev;
+	unsigned long st_ino;
+	unsigned long st_nlink;
+	unsigned int st_mode;
+	unsigned int st_uid;
+	unsigned int st_gid;
+	unsigned long st_rdev;
+	unsigned long st_size;
+	unsigned long st_blksize;
+	unsigned long st_blocks;
+	unsigned long st_atime;
+	unsigned long st_atime_nsec;
+	unsigned long st_mtime;
+	unsigned long st_mtime_nsec;
+	unsigned long st_ctime;
+	unsigned long st_ctime_nsec;
+	unsigned long __unused[3];
+};
+
+/* Largest single read/write; the kernel caps transfers near 2 GiB anyway. */
+#define FILE_HANDLE_MAX_IO_BYTES (1ULL << 30)
+
+typedef struct {
+	int fd;
+	uint32_t flags; /* FileOpenFlags the handle was opened with */
+	/* FILE_OPEN_PREALLOCATE only */
+	uint64_t chunk; /* growth step and window length */
+	uint64_t logical_size; /* bytes appended so far */
+	uint64_t allocated_size; /* size of the file while open */
+	uint64_t window_offset; /* file offset of window, page aligned */
+	char *window; /* shared mapping of [window_offset, +chunk) */
+} FileHandleState;
+
+static uint64_t preallocation_chunk = FILE_PREALLOCATION_DEFAULT_CHUNK;
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5,
+							long a6)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	register long r9 __asm__("r9") = a6;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8),
+						   "r"(r9)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+ErrorResult fun_file_set_preallocation_chunk(uint64_t bytes)
+{
+	if (bytes == 0 || bytes > FILE_PREALLOCATION_MAX_CHUNK)
+		return ERROR_RESULT_FILE_INVALID_PREALLOCATION;
+	uint64_t page = get_page_size();
+	bytes = (bytes + page - 1) / page * page;
+	__atomic_store_n(&preallocation_chunk, bytes, __ATOMIC_RELAXED);
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/*
+ * Move the window to the page holding logical_size, first allocating the
+ * file up to the window's end.  fallocate gives the range real blocks, so
+ * stores into the mapping cannot fault on a full disk; filesystems without
+ * it fall back to ftruncate and a sparse tail.
+ */
+static long slide_window(FileHandleState *state)
+{
+	if (state->window) {
+		syscall2(SYS_munmap, (long)state->window, (long)state->chunk);
+		state->window = NULL;
+	}
+
+	uint64_t page = get_page_size();
+	uint64_t window_offset = state->logical_size / page * page;
+	uint64_t window_end = window_offset + state->chunk;
+	if (window_end > state->allocated_size) {
+		long ret;
+		do {
+			ret = syscall4(SYS_fallocate, state->fd, 0,
+						   (long)state->allocated_size,
+						   (long)(window_end - state->allocated_size));
+		} while (ret == -EINTR);
+		if (ret == -EOPNOTSUPP)
+			ret = syscall2(SYS_ftruncate, state->fd, (long)window_end);
+		if (ret < 0)
+			return ret;
+		state->allocated_size = window_end;
+	}
+
+	long mapping = syscall6(SYS_mmap, 0, (long)state->chunk,
+							PROT_READ | PROT_WRITE, MAP_SHARED, state->fd,
+							(long)window_offset);
+	if (mapping < 0 && mapping >= -4095)
+		return mapping;
+	state->window = (char *)mapping;
+	state->window_offset = window_offset;
+	return 0;
+}
+
+/* Copy an append into the window, sliding it as each chunk fills. */
+static ErrorResult append_preallocated(FileHandleState *state,
+									   const char *input, uint64_t bytes)
+{
+	if (bytes > UINT64_MAX - state->logical_size)
+		return ERROR_RESULT_INTEGER_OVERFLOW;
+
+	uint64_t done = 0;
+	while (done < bytes) {
+		uint64_t window_end = state->window_offset + state->chunk;
+		if (!state->window || state->logical_size >= window_end) {
+			long ret = slide_window(state);
+			if (ret < 0)
+				return fun_error_result(-ret, "Failed to grow file");
+			window_end = state->window_offset + state->chunk;
+		}
+		uint64_t chunk = bytes - done;
+		if (chunk > window_end - state->logical_size)
+			chunk = window_end - state->logical_size;
+		fun_memory_copy(
+			(Memory)(input + done),
+			(Memory)(state->window +
+					 (state->logical_size - state->window_offset)),
+			chunk);
+		state->logical_size += chunk;
+		done += chunk;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_open(String filePath, uint32_t flags,
+						  FileHandle *outHandle)
+{
+	if (!filePath || !outHandle)
+		return ERROR_RESULT_NULL_POINTER;
+
+	bool read = flags & FILE_OPEN_READ;
+	bool write = flags & (FILE_OPEN_WRITE | FILE_OPEN_APPEND);
+	bool preallocate = flags & FILE_OPEN_PREALLOCATE;
+	if ((!read && !write) || ((flags & FILE_OPEN_TRUNCATE) && !write) ||
+		(preallocate && !(flags & FILE_OPEN_APPEND)))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+
+	int open_flags = read && write ? O_RDWR : write ? O_WRONLY : O_RDONLY;
+	if (write)
+		open_flags |= O_CREAT;
+	/* The window is a shared read-write mapping, positioned by hand. */
+	if (preallocate)
+		open_flags = O_RDWR | O_CREAT;
+	else if (flags & FILE_OPEN_APPEND)
+		open_flags |= O_APPEND;
+	if (flags & FILE_OPEN_TRUNCATE)
+		open_flags |= O_TRUNC;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(FileHandleState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+
+	int fd = (int)syscall3(SYS_open, (long)filePath, open_flags, 0644);
+	if (fd < 0) {
+		fun_memory_free(&allocation.value);
+		return fun_error_result(-fd, "Failed to open file");
+	}
+
+	FileHandleState *state = (FileHandleState *)allocation.value;
+	*state = (FileHandleState){ .fd = fd, .flags = flags };
+	if (preallocate) {
+		struct stat file_stat;
+		long ret = syscall2(SYS_fstat, fd, (long)&file_stat);
+		if (ret < 0) {
+			syscall1(SYS_close, fd);
+			fun_memory_free(&allocation.value);
+			return fun_error_result(-ret, "Failed to get file size");
+		}
+		state->chunk = __atomic_load_n(&preallocation_chunk, __ATOMIC_RELAXED);
+		state->logical_size = file_stat.st_size;
+		state->allocated_size = file_stat.st_size;
+	}
+	outHandle->state = state;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_read_at(FileHandle handle, Memory output,
+							 uint64_t bytes_to_read, uint64_t offset)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !output)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!(state->flags & FILE_OPEN_READ))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (offset > (uint64_t)INT64_MAX ||
+		bytes_to_read > (uint64_t)INT64_MAX - offset)
+		return ERROR_RESULT_INTEGER_OVERFLOW;
+	/* Past the appended data is preallocated zeroes, not file contents. */
+	if (state->chunk && offset + bytes_to_read > state->logical_size)
+		return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+
+	uint64_t done = 0;
+	while (done < bytes_to_read) {
+		uint64_t chunk = bytes_to_read - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		long ret = syscall4(SYS_pread64, state->fd,
+							(long)((char *)output + done), (long)chunk,
+							(long)(offset + done));
+		if (ret == -EINTR)
+			continue;
+		if (ret < 0)
+			return fun_error_result(-ret, "File read failed");
+		if (ret == 0)
+			return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+		done += (uint64_t)ret;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_write_at(FileHandle handle, Memory input,
+							  uint64_t bytes_to_write, uint64_t offset)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !input)
+		return ERROR_RESULT_NULL_POINTER;
+	/* pwrite on an O_APPEND descriptor ignores the offset. */
+	if (!(state->flags & FILE_OPEN_WRITE) || (state->flags & FILE_OPEN_APPEND))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (offset > (uint64_t)INT64_MAX ||
+		bytes_to_write > (uint64_t)INT64_MAX - offset)
+		return ERROR_RESULT_INTEGER_OVERFLOW;
+
+	uint64_t done = 0;
+	while (done < bytes_to_write) {
+		uint64_t chunk = bytes_to_write - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		long ret = syscall4(SYS_pwrite64, state->fd,
+							(long)((const char *)input + done), (long)chunk,
+							(long)(offset + done));
+		if (ret == -EINTR)
+			continue;
+		if (ret < 0)
+			return fun_error_result(-ret, "File write failed");
+		done += (uint64_t)ret;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_append(FileHandle handle, Memory input,
+							uint64_t bytes_to_append)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !input)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!(state->flags & FILE_OPEN_APPEND))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (state->chunk)
+		return append_preallocated(state, (const char *)input,
+								   bytes_to_append);
+
+	uint64_t done = 0;
+	while (done < bytes_to_append) {
+		uint64_t chunk = bytes_to_append - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		long ret = syscall3(SYS_write, state->fd,
+							(long)((const char *)input + done), (long)chunk);
+		if (ret == -EINTR)
+			continue;
+		if (ret < 0)
+			return fun_error_result(-ret, "File append failed");
+		done += (uint64_t)ret;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+CanReturnError(uint64_t) fun_file_handle_size(FileHandle handle)
+{
+	uint64_tResult result = { .value = 0, .error = ERROR_RESULT_NO_ERROR };
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (state->chunk) {
+		result.value = state->logical_size;
+		return result;
+	}
+
+	struct stat file_stat;
+	long ret = syscall2(SYS_fstat, state->fd, (long)&file_stat);
+	if (ret < 0) {
+		result.error = fun_error_result(-ret, "Failed to get file size");
+		return result;
+	}
+	result.value = file_stat.st_size;
+	return result;
+}
+
+ErrorResult fun_file_sync(FileHandle handle)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	/* Stores through the shared window are page cache; fsync covers them. */
+	long ret = syscall1(SYS_fsync, state->fd);
+	if (ret < 0)
+		return fun_error_result(-ret, "fsync failed");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_close(FileHandle *handle)
+{
+	if (!handle || !handle->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	FileHandleState *state = (FileHandleState *)handle->state;
+	long trimmed = 0;
+	if (state->window)
+		syscall2(SYS_munmap, (long)state->window, (long)state->chunk);
+	if (state->chunk && state->allocated_size != state->logical_size)
+		trimmed = syscall2(SYS_ftruncate, state->fd, (long)state->logical_size);
+	long ret = syscall1(SYS_close, state->fd);
+	fun_memory_free(&handle->state);
+	handle->state = NULL;
+	if (trimmed < 0)
+		return fun_error_result(-trimmed, "Failed to trim preallocation");
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to close file");
+	return ERROR_RESULT_NO_ERROR;
+}
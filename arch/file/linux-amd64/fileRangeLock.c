@@ -0,0 +1,317 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * OFD record locks belong to the open file description, so the blocking
+ * F_OFD_SETLKW can run on a helper thread and the lock it takes is still
+ * ours.  The helper wakes the polling thread through a futex as soon as
+ * the kernel grants the lock.
+ *
+ * A blocked F_OFD_SETLKW cannot be cancelled without signals.  A waiter
+ * that times out is abandoned instead: the helper keeps waiting, drops
+ * the lock the moment it gets it, and is joined later by whichever call
+ * into this file comes next.
+ */
+
+extern int arch_thread_create(void (*fn)(void *), void *arg, void **out_handle);
+extern void arch_thread_join(void *handle);
+
+#define FILE_RANGE_LOCK_POLL_NS 1000000L
+
+enum {
+	WAITER_NONE = 0,
+	WAITER_WAITING,
+	WAITER_DONE,
+	WAITER_ABANDONED,
+};
+
+struct timespec_local {
+	long tv_sec;
+	long tv_nsec;
+};
+
+/* struct flock as the kernel lays it out on 64-bit targets. */
+struct file_flock {
+	short l_type;
+	short l_whence;
+	int64_t l_start;
+	int64_t l_len;
+	int32_t l_pid; /* must be 0 for OFD locks */
+};
+
+typedef struct RangeLockState {
+	FileRangeLock parameters;
+	struct file_flock request;
+	int fd;
+	bool started;
+	long deadline_ms;
+	void *thread;
+	int waiter_state;
+	long waiter_result;
+	int finished; /* helper no longer touches the state */
+	struct RangeLockState *next_abandoned;
+} RangeLockState;
+
+static int abandoned_lock;
+static RangeLockState *abandoned_head;
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static long get_monotonic_ms(void)
+{
+	struct timespec_local ts;
+	syscall2(SYS_clock_gettime, CLOCK_MONOTONIC, (long)&ts);
+	return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+static void abandoned_acquire(void)
+{
+	int expected = 0;
+	while (!__atomic_compare_exchange_n(&abandoned_lock, &expected, 1, 0,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		expected = 0;
+}
+
+static void abandoned_release(void)
+{
+	__atomic_store_n(&abandoned_lock, 0, __ATOMIC_RELEASE);
+}
+
+/* Join and free the helpers of timed-out waiters that have finished. */
+static void reap_abandoned(void)
+{
+	if (!__atomic_load_n(&abandoned_head, __ATOMIC_RELAXED))
+		return;
+
+	RangeLockState *finished = NULL;
+	abandoned_acquire();
+	RangeLockState **link = &abandoned_head;
+	while (*link) {
+		RangeLockState *state = *link;
+		if (__atomic_load_n(&state->finished, __ATOMIC_ACQUIRE)) {
+			*link = state->next_abandoned;
+			state->next_abandoned = finished;
+			finished = state;
+		} else {
+			link = &state->next_abandoned;
+		}
+	}
+	abandoned_release();
+
+	while (finished) {
+		RangeLockState *next = finished->next_abandoned;
+		arch_thread_join(finished->thread);
+		fun_memory_free((Memory *)&finished);
+		finished = next;
+	}
+}
+
+static void range_lock_waiter(void *argument)
+{
+	RangeLockState *state = (RangeLockState *)argument;
+	long ret;
+	do {
+		ret = syscall3(SYS_fcntl, state->fd, F_OFD_SETLKW,
+					   (long)&state->request);
+	} while (ret == -EINTR);
+	state->waiter_result = ret;
+
+	int expected = WAITER_WAITING;
+	if (__atomic_compare_exchange_n(&state->waiter_state, &expected,
+									WAITER_DONE, 0, __ATOMIC_ACQ_REL,
+									__ATOMIC_ACQUIRE)) {
+		syscall3(SYS_futex, (long)&state->waiter_state, FUTEX_WAKE_PRIVATE, 1);
+	} else {
+		/* Nobody wants the lock any more; closing the fd releases it. */
+		syscall1(SYS_close, state->fd);
+	}
+	__atomic_store_n(&state->finished, 1, __ATOMIC_RELEASE);
+}
+
+static void range_lock_abandon(RangeLockState *state)
+{
+	abandoned_acquire();
+	state->next_abandoned = abandoned_head;
+	abandoned_head = state;
+	abandoned_release();
+}
+
+static ErrorResult range_lock_start(RangeLockState *state)
+{
+	FileRangeLock *parameters = &state->parameters;
+	int flags = parameters->mode == FILE_LOCK_SHARED ? O_RDONLY : O_RDWR;
+	int fd = (int)syscall2(SYS_open, (long)parameters->file_path, flags);
+	if (fd < 0)
+		return fun_error_result(-fd, "Failed to open file for locking");
+	state->fd = fd;
+	state->started = true;
+	if (parameters->timeout_ms != FILE_LOCK_WAIT_FOREVER)
+		state->deadline_ms = get_monotonic_ms() + parameters->timeout_ms;
+
+	long ret = syscall3(SYS_fcntl, fd, F_OFD_SETLK, (long)&state->request);
+	if (ret == 0)
+		return ERROR_RESULT_NO_ERROR;
+	if (ret != -EAGAIN && ret != -EACCES)
+		return fun_error_result(-ret, "Failed to acquire range lock");
+	if (parameters->timeout_ms == 0)
+		return ERROR_RESULT_LOCK_TIMEOUT;
+
+	state->waiter_state = WAITER_WAITING;
+	if (arch_thread_create(range_lock_waiter, state, &state->thread) != 0) {
+		state->waiter_state = WAITER_NONE;
+		return ERROR_RESULT_THREAD_POOL_CREATE_FAILED;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static AsyncStatus poll_range_lock(AsyncResult *result)
+{
+	RangeLockState *state = (RangeLockState *)result->state;
+
+	if (!state->started) {
+		result->error = range_lock_start(state);
+		if (fun_error_is_error(result->error))
+			goto fail;
+	}
+
+	if (state->waiter_state != WAITER_NONE) {
+		if (__atomic_load_n(&state->waiter_state, __ATOMIC_ACQUIRE) ==
+			WAITER_WAITING) {
+			struct timespec_local wait = { 0, FILE_RANGE_LOCK_POLL_NS };
+			syscall4(SYS_futex, (long)&state->waiter_state,
+					 FUTEX_WAIT_PRIVATE, WAITER_WAITING, (long)&wait);
+		}
+
+		int expected = WAITER_WAITING;
+		if (__atomic_load_n(&state->waiter_state, __ATOMIC_ACQUIRE) ==
+			WAITER_WAITING) {
+			if (state->parameters.timeout_ms == FILE_LOCK_WAIT_FOREVER ||
+				get_monotonic_ms() < state->deadline_ms)
+				return ASYNC_PENDING;
+			/* The helper owns the state once it is abandoned. */
+			if (__atomic_compare_exchange_n(
+					&state->waiter_state, &expected, WAITER_ABANDONED, 0,
+					__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				range_lock_abandon(state);
+				result->error = ERROR_RESULT_LOCK_TIMEOUT;
+				return ASYNC_ERROR;
+			}
+		}
+
+		arch_thread_join(state->thread);
+		state->thread = NULL;
+		state->waiter_state = WAITER_NONE;
+		if (state->waiter_result < 0) {
+			result->error = fun_error_result(-state->waiter_result,
+											 "Failed to acquire range lock");
+			goto fail;
+		}
+	}
+
+	state->parameters.out_lock->state = state;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+
+fail:
+	if (state->fd >= 0)
+		syscall1(SYS_close, state->fd);
+	fun_memory_free((Memory *)&state);
+	return ASYNC_ERROR;
+}
+
+AsyncResult fun_file_lock_range(FileRangeLock parameters)
+{
+	if (!parameters.file_path || !parameters.out_lock)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (parameters.offset > (uint64_t)INT64_MAX ||
+		parameters.length > (uint64_t)INT64_MAX - parameters.offset)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	parameters.out_lock->state = NULL;
+	reap_abandoned();
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(RangeLockState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	RangeLockState *state = (RangeLockState *)allocation.value;
+	*state = (RangeLockState){
+		.parameters = parameters,
+		.request = { .l_type = parameters.mode == FILE_LOCK_SHARED ? F_RDLCK :
+																	  F_WRLCK,
+					 .l_whence = SEEK_SET,
+					 .l_start = (int64_t)parameters.offset,
+					 .l_len = (int64_t)parameters.length },
+		.fd = -1,
+	};
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_range_lock,
+						  .status = ASYNC_PENDING };
+}
+
+ErrorResult fun_file_unlock_range(FileLockHandle *lock)
+{
+	if (!lock || !lock->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	RangeLockState *state = (RangeLockState *)lock->state;
+	state->request.l_type = F_UNLCK;
+	long ret = syscall3(SYS_fcntl, state->fd, F_OFD_SETLK,
+						(long)&state->request);
+	syscall1(SYS_close, state->fd);
+	fun_memory_free((Memory *)&state);
+	lock->state = NULL;
+	reap_abandoned();
+
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to release range lock");
+	return ERROR_RESULT_NO_ERROR;
+}
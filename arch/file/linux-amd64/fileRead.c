@@ -1,5 +1,6 @@
 #include "fileRead.h"
 #include "fileAdaptive.h"
+#include "fileDirect.h"
 
 AsyncResult fun_read_file_in_memory(Read parameters)
 {
@@ -7,6 +8,10 @@ AsyncResult fun_read_file_in_memory(Read parameters)
 		return (AsyncResult){ .status = ASYNC_ERROR,
 							  .error = ERROR_RESULT_NULL_POINTER };
 
+	/* An aligned slice of a larger allocation has no size header. */
+	if (parameters.mode == FILE_MODE_DIRECT)
+		return create_direct_read(parameters);
+
 	size_tResult size_result = fun_memory_size(parameters.output);
 	if (fun_error_is_error(size_result.error) ||
 		size_result.value < parameters.bytes_to_read)
@@ -15,7 +20,9 @@ AsyncResult fun_read_file_in_memory(Read parameters)
 
 	FileMode mode = parameters.mode;
 	if (mode == FILE_MODE_AUTO)
-		mode = file_adaptive_choose(parameters.adaptive);
+		mode = file_adaptive_choose(parameters.adaptive, FILE_ACCESS_READ,
+									parameters.offset,
+									parameters.bytes_to_read);
 
 	if (mode == FILE_MODE_RING_BASED)
 		return create_ring_read(parameters);
@@ -1,6 +1,7 @@
 #include "fundamental/file/file.h"
 #include "fundamental/memory/memory.h"
-#include "ring_layout.h"
+#include "fileRing.h"
+#include "fileCache.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -17,30 +18,10 @@ typedef struct {
 
 typedef struct {
 	Read parameters;
-	/* ring file descriptors */
-	int ring_fd;
 	int file_fd;
-	/* ring mmaps and their sizes (for munmap on cleanup) */
-	void *sq_ring;
-	void *cq_ring;
-	void *sqes;
-	uint64_t sq_ring_size;
-	uint64_t cq_ring_size;
-	uint64_t sqes_size;
-	/* pointers derived from ring mmap + params offsets */
-	uint32_t *sq_tail;
-	uint32_t *sq_mask;
-	uint32_t *sq_array;
-	uint32_t *cq_head;
-	uint32_t *cq_tail_ptr;
-	uint32_t *cq_mask;
-	struct io_uring_cqe *cqes_base;
-	/* state flags */
-	bool ring_initialized;
 	bool file_opened;
-	bool io_submitted;
-	bool cqe_consumed;
-	void *mapped_buffer;
+	/* completion slot in the shared ring (see fileRing.h) */
+	FileRingRequest request;
 	/* tracks bytes read so far for partial-completion re-submission */
 	uint64_t bytes_transferred;
 } RingReadState;
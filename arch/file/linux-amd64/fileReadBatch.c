@@ -0,0 +1,235 @@
+#include "fileRead.h"
+#include "overflow_check.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+	FileRingRequest request;
+	uint64_t bytes_transferred;
+	int fd;
+	bool owns_fd; /* false when borrowed from an earlier read of the path */
+	bool finished;
+	ErrorResult error;
+} BatchSlot;
+
+typedef struct {
+	Read *reads;
+	size_t count;
+	size_t remaining; /* slots not yet finished */
+	bool opened;
+	/* count entries each, after the slots: one submission's worth */
+	struct io_uring_sqe *sqes;
+	FileRingRequest **requests;
+	BatchSlot slots[];
+} BatchReadState;
+
+static bool path_equal(String a, String b)
+{
+	if (a == b)
+		return true;
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+static void slot_finish(BatchReadState *state, BatchSlot *slot,
+						ErrorResult error)
+{
+	slot->finished = true;
+	slot->error = error;
+	state->remaining--;
+}
+
+/* Open each distinct path once; later reads of it borrow the descriptor. */
+static void batch_open(BatchReadState *state)
+{
+	for (size_t i = 0; i < state->count; i++) {
+		Read *read = &state->reads[i];
+		BatchSlot *slot = &state->slots[i];
+
+		if (!read->file_path || !read->output) {
+			slot_finish(state, slot, ERROR_RESULT_NULL_POINTER);
+			continue;
+		}
+		if (read->bytes_to_read == 0) {
+			slot_finish(state, slot, ERROR_RESULT_NO_ERROR);
+			continue;
+		}
+		uint64_t end;
+		if (!check_overflow_add(read->offset, read->bytes_to_read, &end)) {
+			slot_finish(state, slot, ERROR_RESULT_INTEGER_OVERFLOW);
+			continue;
+		}
+
+		for (size_t j = 0; j < i; j++) {
+			if (state->slots[j].fd >= 0 &&
+				path_equal(state->reads[j].file_path, read->file_path)) {
+				slot->fd = state->slots[j].fd;
+				break;
+			}
+		}
+		if (slot->fd >= 0)
+			continue;
+
+		int fd = file_cache_open(read->file_path, O_RDONLY);
+		if (fd < 0) {
+			slot_finish(state, slot,
+						fun_error_result(-fd, "Failed to open file"));
+			continue;
+		}
+		slot->fd = fd;
+		slot->owns_fd = true;
+	}
+}
+
+/* Submit every slot that is neither finished nor in flight with one
+ * io_uring_enter.  What the ring has no room for goes on a later poll. */
+static long batch_submit(BatchReadState *state)
+{
+	size_t queued = 0;
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->finished || slot->request.submitted)
+			continue;
+
+		Read *read = &state->reads[i];
+		uint64_t bytes_remaining =
+			read->bytes_to_read - slot->bytes_transferred;
+		if (bytes_remaining > FILE_RING_MAX_IO_BYTES)
+			bytes_remaining = FILE_RING_MAX_IO_BYTES;
+
+		struct io_uring_sqe *sqe = &state->sqes[queued];
+		*sqe = (struct io_uring_sqe){ 0 };
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = slot->fd;
+		sqe->off = read->offset + slot->bytes_transferred;
+		sqe->addr =
+			(uint64_t)(long)((char *)read->output + slot->bytes_transferred);
+		sqe->len = (uint32_t)bytes_remaining;
+		state->requests[queued++] = &slot->request;
+	}
+	if (queued == 0)
+		return 0;
+
+	long ret = file_ring_submit_batch(state->sqes, state->requests, queued);
+	return ret < 0 ? ret : 0;
+}
+
+static AsyncStatus poll_read_batch(AsyncResult *result)
+{
+	BatchReadState *state = (BatchReadState *)result->state;
+
+	if (!state->opened) {
+		batch_open(state);
+		state->opened = true;
+	}
+
+	long ret = batch_submit(state);
+	if (ret < 0) {
+		/* Fail what never reached the ring; in-flight reads still finish. */
+		ErrorResult error = fun_error_result(-ret, "io_uring submit failed");
+		for (size_t i = 0; i < state->count; i++) {
+			BatchSlot *slot = &state->slots[i];
+			if (!slot->finished && !slot->request.submitted)
+				slot_finish(state, slot, error);
+		}
+	}
+
+	FileRingRequest *wait = NULL;
+	for (size_t i = 0; i < state->count && !wait; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (!slot->finished && slot->request.submitted)
+			wait = &slot->request;
+	}
+	if (wait)
+		file_ring_reap(wait);
+
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->finished || !slot->request.done)
+			continue;
+
+		int32_t res = slot->request.res;
+		if (res < 0) {
+			slot_finish(state, slot,
+						fun_error_result(-res, "io_uring read failed"));
+			continue;
+		}
+		if (res == 0) {
+			slot_finish(state, slot,
+						fun_error_result(1, "io_uring read: unexpected EOF"));
+			continue;
+		}
+
+		slot->bytes_transferred += (uint64_t)res;
+		if (slot->bytes_transferred < state->reads[i].bytes_to_read) {
+			/* Partial read — resubmit for the remaining bytes. */
+			slot->request = (FileRingRequest){ 0 };
+			continue;
+		}
+		slot_finish(state, slot, ERROR_RESULT_NO_ERROR);
+	}
+
+	if (state->remaining > 0)
+		return ASYNC_PENDING;
+
+	AsyncStatus final_status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->owns_fd)
+			file_cache_close(slot->fd);
+		if (state->reads[i].batch_error)
+			*state->reads[i].batch_error = slot->error;
+		if (fun_error_is_error(slot->error) &&
+			final_status == ASYNC_COMPLETED) {
+			result->error = slot->error;
+			final_status = ASYNC_ERROR;
+		}
+	}
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+AsyncResult fun_read_files_batch(Read *reads, size_t n)
+{
+	if (n == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+	if (!reads)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+
+	uint64_t entry_size = sizeof(BatchSlot) + sizeof(struct io_uring_sqe) +
+						  sizeof(FileRingRequest *);
+	uint64_t entries_size;
+	uint64_t state_size;
+	if (!check_overflow_mul(n, entry_size, &entries_size) ||
+		!check_overflow_add(sizeof(BatchReadState), entries_size, &state_size))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+
+	MemoryResult mem_result = fun_memory_allocate(state_size);
+	if (fun_error_is_error(mem_result.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = mem_result.error };
+
+	BatchReadState *state = (BatchReadState *)mem_result.value;
+	state->reads = reads;
+	state->count = n;
+	state->remaining = n;
+	state->opened = false;
+	state->sqes = (struct io_uring_sqe *)&state->slots[n];
+	state->requests = (FileRingRequest **)&state->sqes[n];
+	for (size_t i = 0; i < n; i++)
+		state->slots[i] = (BatchSlot){ .fd = -1 };
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_read_batch,
+						  .status = ASYNC_PENDING };
+}
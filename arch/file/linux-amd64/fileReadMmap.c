@@ -84,8 +84,7 @@ AsyncStatus poll_mmap(AsyncResult *result)
 	AsyncStatus final_status = ASYNC_COMPLETED;
 
 	if (!state->fd_valid) {
-		int fd = (int)syscall2(SYS_open, (long)state->parameters.file_path,
-							   O_RDONLY);
+		int fd = file_cache_open(state->parameters.file_path, O_RDONLY);
 		if (fd < 0) {
 			result->error = fun_error_result(-fd, "Failed to open file");
 			final_status = ASYNC_ERROR;
@@ -157,7 +156,7 @@ cleanup:
 			sys_munmap(state->mapped_address, view_size);
 		}
 		if (state->fd_valid)
-			syscall1(SYS_close, state->file_descriptor);
+			file_cache_close(state->file_descriptor);
 		fun_memory_free((Memory *)&state);
 	}
 	if (final_status == ASYNC_COMPLETED)
@@ -0,0 +1,544 @@
+#include "fileRing.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5,
+							long a6)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	register long r9 __asm__("r9") = a6;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8),
+						   "r"(r9)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+#define FILE_RING_EAGAIN 11
+#define FILE_RING_EBUSY 16
+#define FILE_RING_EINTR 4
+
+/* Longest a reaper sleeps before draining again (see file_ring_reap). */
+#define FILE_RING_WAIT_NS 1000000
+
+typedef struct {
+	int ring_fd;
+	/* ring mmaps and their sizes (for munmap on teardown) */
+	void *sq_ring;
+	void *cq_ring;
+	void *sqes;
+	uint64_t sq_ring_size;
+	uint64_t cq_ring_size;
+	uint64_t sqes_size;
+	/* pointers derived from ring mmap + params offsets */
+	uint32_t *sq_head;
+	uint32_t *sq_tail;
+	uint32_t *sq_array;
+	uint32_t *cq_head;
+	uint32_t *cq_tail;
+	struct io_uring_cqe *cqes;
+	uint32_t sq_mask;
+	uint32_t sq_entries;
+	uint32_t cq_mask;
+	/* submitted requests whose CQE has not been reaped yet; kept at or
+	 * below cq_entries so the CQ can never overflow */
+	uint32_t in_flight;
+	uint32_t cq_entries;
+	/* the kernel takes a timeout on GETEVENTS (IORING_FEAT_EXT_ARG) */
+	bool wait_timeout;
+} FileRing;
+
+static FileRing g_ring = { .ring_fd = -1 };
+static uint32_t g_ring_depth = FILE_RING_DEFAULT_DEPTH;
+static int32_t g_ring_lock = 0;
+
+/*
+ * Registrations outlive the ring: they are applied again whenever the ring
+ * is rebuilt (see fun_file_ring_set_depth).  The *_registered flags say
+ * whether the current ring holds them.
+ */
+typedef struct {
+	uint64_t base;
+	uint64_t length;
+	uint16_t index; /* position in g_buffer_iovecs, i.e. sqe->buf_index */
+} RegisteredBuffer;
+
+static struct iovec g_buffer_iovecs[FILE_RING_MAX_REGISTERED_BUFFERS];
+/* sorted by base address */
+static RegisteredBuffer g_buffers[FILE_RING_MAX_REGISTERED_BUFFERS];
+static uint32_t g_buffer_count = 0;
+static bool g_buffers_registered = false;
+
+static int32_t g_fixed_fds[FILE_RING_FIXED_FILES] = {
+	[0 ... FILE_RING_FIXED_FILES - 1] = -1
+};
+static uint32_t g_fixed_count = 0;
+static bool g_files_registered = false;
+
+static void ring_lock(void)
+{
+	for (;;) {
+		int32_t expected = 0;
+		if (__atomic_compare_exchange_n(&g_ring_lock, &expected, 1, 0,
+										__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			return;
+		while (__atomic_load_n(&g_ring_lock, __ATOMIC_RELAXED))
+			__builtin_ia32_pause();
+	}
+}
+
+static void ring_unlock(void)
+{
+	__atomic_store_n(&g_ring_lock, 0, __ATOMIC_RELEASE);
+}
+
+static void ring_teardown_locked(void)
+{
+	if (g_ring.sqes)
+		syscall2(SYS_munmap, (long)g_ring.sqes, (long)g_ring.sqes_size);
+	if (g_ring.cq_ring)
+		syscall2(SYS_munmap, (long)g_ring.cq_ring, (long)g_ring.cq_ring_size);
+	if (g_ring.sq_ring)
+		syscall2(SYS_munmap, (long)g_ring.sq_ring, (long)g_ring.sq_ring_size);
+	if (g_ring.ring_fd >= 0)
+		syscall1(SYS_close, g_ring.ring_fd);
+	g_ring = (FileRing){ .ring_fd = -1 };
+	g_buffers_registered = false;
+	g_files_registered = false;
+}
+
+static long ring_register_buffers_locked(void)
+{
+	long ret = syscall4(SYS_io_uring_register, g_ring.ring_fd,
+						IORING_REGISTER_BUFFERS, (long)g_buffer_iovecs,
+						g_buffer_count);
+	g_buffers_registered = ret == 0;
+	return ret;
+}
+
+/* Register the whole (sparse) fixed-file table; -1 marks empty slots. */
+static void ring_register_files_locked(void)
+{
+	long ret = syscall4(SYS_io_uring_register, g_ring.ring_fd,
+						IORING_REGISTER_FILES, (long)g_fixed_fds,
+						FILE_RING_FIXED_FILES);
+	g_files_registered = ret == 0;
+}
+
+static long ring_update_file_locked(uint32_t slot, int32_t fd)
+{
+	struct io_uring_files_update update = { .offset = slot,
+											.fds = (uint64_t)(uintptr_t)&fd };
+	return syscall4(SYS_io_uring_register, g_ring.ring_fd,
+					IORING_REGISTER_FILES_UPDATE, (long)&update, 1);
+}
+
+static long ring_setup_locked(void)
+{
+	struct io_uring_params params = { 0 };
+
+	int ring_fd =
+		(int)syscall2(SYS_io_uring_setup, (long)g_ring_depth, (long)&params);
+	if (ring_fd < 0)
+		return ring_fd;
+	g_ring.ring_fd = ring_fd;
+
+	/* Compute ring sizes from kernel-populated offsets. */
+	g_ring.sq_ring_size =
+		params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	g_ring.cq_ring_size =
+		params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	g_ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	void *sq_ring = (void *)syscall6(SYS_mmap, 0, (long)g_ring.sq_ring_size,
+									 PROT_READ | PROT_WRITE,
+									 MAP_SHARED | MAP_POPULATE, ring_fd,
+									 (long)IORING_OFF_SQ_RING);
+	if ((long)sq_ring < 0) {
+		ring_teardown_locked();
+		return (long)sq_ring;
+	}
+	g_ring.sq_ring = sq_ring;
+
+	void *cq_ring = (void *)syscall6(SYS_mmap, 0, (long)g_ring.cq_ring_size,
+									 PROT_READ | PROT_WRITE,
+									 MAP_SHARED | MAP_POPULATE, ring_fd,
+									 (long)IORING_OFF_CQ_RING);
+	if ((long)cq_ring < 0) {
+		ring_teardown_locked();
+		return (long)cq_ring;
+	}
+	g_ring.cq_ring = cq_ring;
+
+	void *sqes = (void *)syscall6(SYS_mmap, 0, (long)g_ring.sqes_size,
+								  PROT_READ | PROT_WRITE,
+								  MAP_SHARED | MAP_POPULATE, ring_fd,
+								  (long)IORING_OFF_SQES);
+	if ((long)sqes < 0) {
+		ring_teardown_locked();
+		return (long)sqes;
+	}
+	g_ring.sqes = sqes;
+
+	/* Derive typed pointers from mmap base + kernel-provided offsets. */
+	g_ring.sq_head = (uint32_t *)((char *)sq_ring + params.sq_off.head);
+	g_ring.sq_tail = (uint32_t *)((char *)sq_ring + params.sq_off.tail);
+	g_ring.sq_array = (uint32_t *)((char *)sq_ring + params.sq_off.array);
+	g_ring.sq_mask = *(uint32_t *)((char *)sq_ring + params.sq_off.ring_mask);
+	g_ring.cq_head = (uint32_t *)((char *)cq_ring + params.cq_off.head);
+	g_ring.cq_tail = (uint32_t *)((char *)cq_ring + params.cq_off.tail);
+	g_ring.cq_mask = *(uint32_t *)((char *)cq_ring + params.cq_off.ring_mask);
+	g_ring.cqes = (struct io_uring_cqe *)((char *)cq_ring + params.cq_off.cqes);
+	g_ring.sq_entries = params.sq_entries;
+	g_ring.cq_entries = params.cq_entries;
+	g_ring.in_flight = 0;
+	g_ring.wait_timeout = (params.features & IORING_FEAT_EXT_ARG) != 0;
+
+	/* Failures here only cost the fixed forms; plain SQEs still work. */
+	ring_register_files_locked();
+	if (g_buffer_count > 0)
+		ring_register_buffers_locked();
+	return 0;
+}
+
+/* Index of the registered buffer holding [addr, addr + len), or -1. */
+static int32_t ring_find_buffer_locked(uint64_t addr, uint32_t len)
+{
+	uint32_t low = 0;
+	uint32_t high = g_buffer_count;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		if (g_buffers[mid].base <= addr)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low == 0)
+		return -1;
+	RegisteredBuffer *buffer = &g_buffers[low - 1];
+	if (addr - buffer->base > buffer->length ||
+		len > buffer->length - (addr - buffer->base))
+		return -1;
+	return buffer->index;
+}
+
+/* Switch an SQE to registered buffers / fixed files where they apply. */
+static void ring_prepare_sqe_locked(struct io_uring_sqe *sqe)
+{
+	if (g_buffers_registered && (sqe->opcode == IORING_OP_READ ||
+								 sqe->opcode == IORING_OP_WRITE)) {
+		int32_t index = ring_find_buffer_locked(sqe->addr, sqe->len);
+		if (index >= 0) {
+			sqe->opcode = sqe->opcode == IORING_OP_READ ?
+							  IORING_OP_READ_FIXED :
+							  IORING_OP_WRITE_FIXED;
+			sqe->buf_index = (uint16_t)index;
+		}
+	}
+	if (g_files_registered && g_fixed_count > 0 &&
+		!(sqe->flags & IOSQE_FIXED_FILE)) {
+		for (uint32_t slot = 0; slot < FILE_RING_FIXED_FILES; slot++) {
+			if (g_fixed_fds[slot] == sqe->fd) {
+				sqe->fd = (int32_t)slot;
+				sqe->flags |= IOSQE_FIXED_FILE;
+				break;
+			}
+		}
+	}
+}
+
+/* Hand every available CQE to the request named by its user_data. */
+static void ring_drain_locked(void)
+{
+	uint32_t head = *g_ring.cq_head;
+	uint32_t tail = __atomic_load_n(g_ring.cq_tail, __ATOMIC_ACQUIRE);
+
+	while (head != tail) {
+		struct io_uring_cqe *cqe = &g_ring.cqes[head & g_ring.cq_mask];
+		FileRingRequest *request =
+			(FileRingRequest *)(uintptr_t)cqe->user_data;
+		/* Multishot notifications (F_MORE) are followed by a final CQE. */
+		if (request && !(cqe->flags & IORING_CQE_F_MORE)) {
+			request->res = cqe->res;
+			request->done = true;
+			g_ring.in_flight--;
+		}
+		head++;
+	}
+	__atomic_store_n(g_ring.cq_head, head, __ATOMIC_RELEASE);
+}
+
+long file_ring_submit_batch(const struct io_uring_sqe *sqes,
+							FileRingRequest *const *requests, size_t count)
+{
+	ring_lock();
+
+	if (g_ring.ring_fd < 0) {
+		long ret = ring_setup_locked();
+		if (ret < 0) {
+			ring_unlock();
+			return ret;
+		}
+	}
+
+	if (g_ring.in_flight + count > g_ring.cq_entries)
+		ring_drain_locked();
+
+	/* Queue as many as both the SQ and the CQ budget allow. */
+	uint32_t sq_tail = *g_ring.sq_tail;
+	uint32_t sq_free = g_ring.sq_entries -
+					   (sq_tail - __atomic_load_n(g_ring.sq_head,
+												  __ATOMIC_ACQUIRE));
+	uint32_t cq_free = g_ring.cq_entries - g_ring.in_flight;
+	size_t queue = count;
+	if (queue > sq_free)
+		queue = sq_free;
+	if (queue > cq_free)
+		queue = cq_free;
+	if (queue == 0) {
+		ring_unlock();
+		return 0;
+	}
+
+	for (size_t i = 0; i < queue; i++) {
+		uint32_t sq_index = (sq_tail + (uint32_t)i) & g_ring.sq_mask;
+		struct io_uring_sqe *slot =
+			(struct io_uring_sqe *)g_ring.sqes + sq_index;
+		*slot = sqes[i];
+		slot->user_data = (uint64_t)(uintptr_t)requests[i];
+		ring_prepare_sqe_locked(slot);
+		g_ring.sq_array[sq_index] = sq_index;
+		requests[i]->res = 0;
+		requests[i]->done = false;
+	}
+	__atomic_store_n(g_ring.sq_tail, sq_tail + (uint32_t)queue,
+					 __ATOMIC_RELEASE);
+
+	/* One enter for the whole batch, without waiting: small cached reads
+	 * usually complete inline, and file_ring_reap waits only if they did
+	 * not. */
+	long ret = syscall4(SYS_io_uring_enter, g_ring.ring_fd, (long)queue, 0, 0);
+	if (ret < 0) {
+		/* Nothing was consumed; take the SQEs back. */
+		__atomic_store_n(g_ring.sq_tail, sq_tail, __ATOMIC_RELEASE);
+		ring_unlock();
+		if (ret == -FILE_RING_EAGAIN || ret == -FILE_RING_EBUSY ||
+			ret == -FILE_RING_EINTR)
+			return 0;
+		return ret;
+	}
+
+	/* The kernel consumes from the head; give back what it left. */
+	if ((size_t)ret < queue)
+		__atomic_store_n(g_ring.sq_tail, sq_tail + (uint32_t)ret,
+						 __ATOMIC_RELEASE);
+	for (long i = 0; i < ret; i++)
+		requests[i]->submitted = true;
+	g_ring.in_flight += (uint32_t)ret;
+	ring_unlock();
+	return ret;
+}
+
+long file_ring_submit(const struct io_uring_sqe *sqe, FileRingRequest *request)
+{
+	long ret = file_ring_submit_batch(sqe, &request, 1);
+	if (ret < 0)
+		return ret;
+	return ret == 1 ? 0 : 1;
+}
+
+bool file_ring_reap(FileRingRequest *request)
+{
+	ring_lock();
+	ring_drain_locked();
+	bool done = request->done;
+	int ring_fd = g_ring.ring_fd;
+	bool wait_timeout = g_ring.wait_timeout;
+	ring_unlock();
+	if (done)
+		return true;
+
+	/*
+	 * Sleep without the lock, but only for a bounded time: another thread
+	 * may drain our CQE between the unlock above and the kernel's check of
+	 * the CQ, after which nothing may wake an unbounded wait.  Kernels
+	 * without the timed wait are not waited on; the caller polls again.
+	 */
+	if (!wait_timeout)
+		return false;
+	struct __kernel_timespec timeout = { .tv_nsec = FILE_RING_WAIT_NS };
+	struct io_uring_getevents_arg arg = { .ts = (uint64_t)(uintptr_t)&timeout };
+	syscall6(SYS_io_uring_enter, ring_fd, 0, 1,
+			 IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, (long)&arg,
+			 sizeof(arg));
+
+	ring_lock();
+	ring_drain_locked();
+	done = request->done;
+	ring_unlock();
+	return done;
+}
+
+ErrorResult fun_file_ring_set_depth(uint32_t depth)
+{
+	if (depth == 0 || depth > FILE_RING_MAX_DEPTH)
+		return ERROR_RESULT_FILE_RING_INVALID_DEPTH;
+
+	ErrorResult result = ERROR_RESULT_NO_ERROR;
+	ring_lock();
+	if (g_ring.ring_fd >= 0 && g_ring.in_flight > 0) {
+		result = ERROR_RESULT_FILE_RING_BUSY;
+	} else {
+		/* An idle ring is rebuilt at the new depth on next use. */
+		if (g_ring.ring_fd >= 0 && g_ring.sq_entries != depth)
+			ring_teardown_locked();
+		g_ring_depth = depth;
+	}
+	ring_unlock();
+	return result;
+}
+
+ErrorResult fun_file_ring_register_buffers(const Memory *buffers,
+										   const uint64_t *sizes,
+										   uint32_t count)
+{
+	if (!buffers || !sizes)
+		return ERROR_RESULT_NULL_POINTER;
+	if (count == 0 || count > FILE_RING_MAX_REGISTERED_BUFFERS)
+		return ERROR_RESULT_FILE_RING_INVALID_BUFFER;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!buffers[i])
+			return ERROR_RESULT_NULL_POINTER;
+		if (sizes[i] == 0 || sizes[i] > FILE_RING_MAX_REGISTERED_BUFFER_SIZE ||
+			sizes[i] > UINT64_MAX - (uint64_t)(uintptr_t)buffers[i])
+			return ERROR_RESULT_FILE_RING_INVALID_BUFFER;
+	}
+
+	ring_lock();
+	if (g_ring.ring_fd >= 0 && g_ring.in_flight > 0) {
+		ring_unlock();
+		return ERROR_RESULT_FILE_RING_BUSY;
+	}
+	if (g_ring.ring_fd < 0) {
+		/* Set up first, so setup does not register the old set. */
+		g_buffer_count = 0;
+		long ret = ring_setup_locked();
+		if (ret < 0) {
+			ring_unlock();
+			return fun_error_result(-ret, "io_uring setup failed");
+		}
+	}
+	if (g_buffers_registered) {
+		syscall4(SYS_io_uring_register, g_ring.ring_fd,
+				 IORING_UNREGISTER_BUFFERS, 0, 0);
+		g_buffers_registered = false;
+	}
+
+	/* Insertion sort by base address for ring_find_buffer_locked. */
+	for (uint32_t i = 0; i < count; i++) {
+		g_buffer_iovecs[i] =
+			(struct iovec){ .iov_base = buffers[i], .iov_len = sizes[i] };
+		RegisteredBuffer entry = { .base = (uint64_t)(uintptr_t)buffers[i],
+								   .length = sizes[i],
+								   .index = (uint16_t)i };
+		uint32_t j = i;
+		while (j > 0 && g_buffers[j - 1].base > entry.base) {
+			g_buffers[j] = g_buffers[j - 1];
+			j--;
+		}
+		g_buffers[j] = entry;
+	}
+	g_buffer_count = count;
+
+	long ret = ring_register_buffers_locked();
+	if (ret < 0)
+		g_buffer_count = 0;
+	ring_unlock();
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to register ring buffers");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_ring_unregister_buffers(void)
+{
+	ring_lock();
+	if (g_ring.ring_fd >= 0 && g_ring.in_flight > 0) {
+		ring_unlock();
+		return ERROR_RESULT_FILE_RING_BUSY;
+	}
+	if (g_buffers_registered)
+		syscall4(SYS_io_uring_register, g_ring.ring_fd,
+				 IORING_UNREGISTER_BUFFERS, 0, 0);
+	g_buffers_registered = false;
+	g_buffer_count = 0;
+	ring_unlock();
+	return ERROR_RESULT_NO_ERROR;
+}
+
+void file_ring_register_file(int fd)
+{
+	ring_lock();
+	for (uint32_t slot = 0; slot < FILE_RING_FIXED_FILES; slot++) {
+		if (g_fixed_fds[slot] >= 0)
+			continue;
+		/* Without a ring yet, the slot is picked up at setup. */
+		if (g_files_registered && ring_update_file_locked(slot, fd) < 0)
+			break;
+		g_fixed_fds[slot] = fd;
+		g_fixed_count++;
+		break;
+	}
+	ring_unlock();
+}
+
+void file_ring_unregister_file(int fd)
+{
+	ring_lock();
+	for (uint32_t slot = 0; slot < FILE_RING_FIXED_FILES; slot++) {
+		if (g_fixed_fds[slot] != fd)
+			continue;
+		if (g_files_registered)
+			ring_update_file_locked(slot, -1);
+		g_fixed_fds[slot] = -1;
+		g_fixed_count--;
+		break;
+	}
+	ring_unlock();
+}
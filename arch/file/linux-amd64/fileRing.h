@@ -0,0 +1,70 @@
+#pragma once
+#include "fundamental/file/file.h"
+#include "ring_layout.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Shared io_uring for FILE_MODE_RING_BASED operations.
+ *
+ * One ring per process, created on first use with the depth set by
+ * fun_file_ring_set_depth (default FILE_RING_DEFAULT_DEPTH) and kept for
+ * the life of the process.  Every ring read / write / append submits
+ * into it; completions are routed back through user_data, which points
+ * at the caller's FileRingRequest.  Submission and completion reaping
+ * are serialised by a spinlock, so operations from several threads may
+ * share the ring.
+ *
+ * Buffers registered with fun_file_ring_register_buffers and fixed files
+ * (below) are applied at submission: file_ring_submit_batch rewrites a
+ * READ / WRITE SQE into its fixed form when they cover it.
+ */
+
+/* Largest length put in one SQE; longer transfers resubmit the rest. */
+#define FILE_RING_MAX_IO_BYTES (1ULL << 30)
+
+typedef struct {
+	int32_t res; /* cqe->res, valid once done */
+	bool submitted;
+	bool done;
+} FileRingRequest;
+
+/*
+ * Queue one SQE (copied; user_data is overwritten) and hand it to the
+ * kernel.  Returns 0 when submitted, 1 when the ring is at capacity
+ * (retry on the next poll), or a negative errno.  The request must stay
+ * alive until file_ring_reap reports it done.
+ */
+long file_ring_submit(const struct io_uring_sqe *sqe, FileRingRequest *request);
+
+/*
+ * Queue up to count SQEs (sqes[i] completes into requests[i]) and submit
+ * them with a single io_uring_enter.  Returns how many were submitted,
+ * always a prefix of the array; 0 when the ring is at capacity (retry on
+ * the next poll), or a negative errno.
+ */
+long file_ring_submit_batch(const struct io_uring_sqe *sqes,
+							FileRingRequest *const *requests, size_t count);
+
+/*
+ * Move every available completion to its request.  When request is still
+ * outstanding afterwards, waits a bounded time for more completions, as
+ * another thread may reap ours first.  Returns true once request->done;
+ * callers poll again on false.
+ */
+bool file_ring_reap(FileRingRequest *request);
+
+/*
+ * Fixed files.  A long-lived descriptor (the descriptor cache's) may be
+ * put in the ring's fixed-file table; SQEs naming it are then submitted
+ * with IOSQE_FIXED_FILE, saving the per-operation file lookup.  Best
+ * effort: when the table is full or the kernel lacks support the
+ * descriptor is simply used as is.  Unregister before closing it, and
+ * only while no ring operation on it is in flight.
+ */
+#define FILE_RING_FIXED_FILES 64
+
+void file_ring_register_file(int fd);
+void file_ring_unregister_file(int fd);
@@ -0,0 +1,150 @@
+#include "fundamental/file/file.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+#include "page_size.h"
+#include "fileCache.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+struct stat {
+	unsigned long st_dev;
+	unsigned long st_ino;
+	unsigned long st_nlink;
+	unsigned int st_mode;
+	unsigned int st_uid;
+	unsigned int st_gid;
+	unsigned long st_rdev;
+	unsigned long st_size;
+	unsigned long st_blksize;
+	unsigned long st_blocks;
+	unsigned long st_atime;
+	unsigned long st_atime_nsec;
+	unsigned long st_mtime;
+	unsigned long st_mtime_nsec;
+	unsigned long st_ctime;
+	unsigned long st_ctime_nsec;
+	unsigned long __unused[3];
+};
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5,
+							long a6)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	register long r9 __asm__("r9") = a6;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8),
+						   "r"(r9)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+ErrorResult fun_file_map_view(String file_path, uint64_t offset,
+							  uint64_t length, uint32_t flags,
+							  FileView *out_view)
+{
+	if (!file_path || !out_view)
+		return ERROR_RESULT_NULL_POINTER;
+	if ((flags & FILE_VIEW_SEQUENTIAL) && (flags & FILE_VIEW_RANDOM))
+		return ERROR_RESULT_FILE_VIEW_INVALID_FLAGS;
+	*out_view = (FileView){ 0 };
+
+	int fd = file_cache_open(file_path, O_RDONLY);
+	if (fd < 0)
+		return fun_error_result(-fd, "Failed to open file");
+
+	struct stat file_stat;
+	long ret = syscall2(SYS_fstat, fd, (long)&file_stat);
+	if (ret < 0) {
+		file_cache_close(fd);
+		return fun_error_result(-ret, "Failed to get file size");
+	}
+
+	uint64_t file_size = file_stat.st_size;
+	if (offset > file_size) {
+		file_cache_close(fd);
+		return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+	}
+	if (length == 0)
+		length = file_size - offset;
+	else if (length > file_size - offset) {
+		file_cache_close(fd);
+		return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+	}
+	if (length == 0) {
+		file_cache_close(fd);
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	uint64_t granularity = get_page_size();
+	uint64_t aligned_offset = offset - offset % granularity;
+	uint64_t mapping_length = length + (offset - aligned_offset);
+
+	int prot = PROT_READ;
+	if (flags & FILE_VIEW_PRIVATE)
+		prot |= PROT_WRITE;
+	int map_flags = MAP_PRIVATE;
+	if (flags & FILE_VIEW_POPULATE)
+		map_flags |= MAP_POPULATE;
+
+	long mapping = syscall6(SYS_mmap, 0, (long)mapping_length, prot,
+							map_flags, fd, (long)aligned_offset);
+	/* The mapping keeps the file referenced; the descriptor can go. */
+	file_cache_close(fd);
+	if (mapping < 0 && mapping >= -4095)
+		return fun_error_result(-mapping, "Failed to mmap file");
+
+	/* Hints are advisory; a refused one leaves a working view. */
+	if (flags & FILE_VIEW_SEQUENTIAL)
+		syscall3(SYS_madvise, mapping, (long)mapping_length, MADV_SEQUENTIAL);
+	if (flags & FILE_VIEW_RANDOM)
+		syscall3(SYS_madvise, mapping, (long)mapping_length, MADV_RANDOM);
+	if ((flags & FILE_VIEW_WILLNEED) && !(flags & FILE_VIEW_POPULATE))
+		syscall3(SYS_madvise, mapping, (long)mapping_length, MADV_WILLNEED);
+
+	*out_view = (FileView){ .data = (const char *)mapping +
+									(offset - aligned_offset),
+							.length = length,
+							.mapping = (void *)mapping };
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_unmap_view(FileView *view)
+{
+	if (!view)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!view->mapping)
+		return ERROR_RESULT_NO_ERROR;
+
+	uint64_t mapping_length =
+		(uint64_t)(view->data - (const char *)view->mapping) + view->length;
+	long ret = syscall2(SYS_munmap, (long)view->mapping, (long)mapping_length);
+	*view = (FileView){ 0 };
+	if (ret < 0)
+		return fun_error_result(-ret, "Failed to unmap file view");
+	return ERROR_RESULT_NO_ERROR;
+}
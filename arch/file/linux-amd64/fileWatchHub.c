@@ -0,0 +1,629 @@
+#include "fundamental/file/file.h"
+#include "fundamental/filesystem/filesystem.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * One inotify instance carries every watch.  Files are watched through
+ * their parent directory, so an editor replacing a file by rename is
+ * still seen.  The epoll set holds the inotify fd and a timerfd armed for
+ * the earliest debounce deadline, which makes the epoll fd readable
+ * exactly when dispatch has something to do.
+ *
+ * Changed paths wait in an open-addressing table keyed by path hash, so a
+ * burst of events on one path costs one slot and one callback.
+ */
+
+#define FILE_WATCH_MASK                                                    \
+	(IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |      \
+	 IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+#define FILE_WATCH_EVENT_BUFFER 16384
+#define FILE_WATCH_MAX_LOAD (FILE_WATCH_MAX_PENDING * 3 / 4)
+#define FILE_WATCH_MAX_COMPONENTS 256
+
+typedef struct {
+	int wd; /* -1 once the kernel dropped the watch */
+	int next_same_wd; /* index of the next watch sharing wd, or -1 */
+	FileChangeCallback callback;
+	uint32_t name_offset; /* file watches: start of the name in path */
+	bool is_file;
+	bool recursive;
+	char path[FILE_WATCH_PATH_SIZE];
+} HubWatch;
+
+typedef struct {
+	uint64_t hash; /* 0 marks a free slot */
+	uint64_t deadline_ms;
+	FileChangeCallback callback;
+	char path[FILE_WATCH_PATH_SIZE];
+} HubPending;
+
+typedef struct {
+	int inotify_fd;
+	int timer_fd;
+	int epoll_fd;
+	uint32_t debounce_ms;
+	HubWatch *watches;
+	uint32_t watch_count;
+	uint32_t watch_capacity;
+	int *first_by_wd; /* wd -> first watch index, -1 if none */
+	uint32_t wd_capacity;
+	HubPending *pending;
+	uint32_t pending_count;
+	uint64_t armed_deadline_ms; /* 0 while the timer is disarmed */
+} HubState;
+
+struct timespec_local {
+	long tv_sec;
+	long tv_nsec;
+};
+
+struct itimerspec_local {
+	struct timespec_local it_interval;
+	struct timespec_local it_value;
+};
+
+struct epoll_event_local {
+	uint32_t events;
+	uint64_t data;
+} __attribute__((packed));
+
+struct inotify_event {
+	int wd;
+	uint32_t mask;
+	uint32_t cookie;
+	uint32_t len;
+	char name[];
+};
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall2(long n, long a1, long a2)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5,
+							long a6)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	register long r9 __asm__("r9") = a6;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8),
+						   "r"(r9)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static uint64_t get_monotonic_ms(void)
+{
+	struct timespec_local ts;
+	syscall2(SYS_clock_gettime, CLOCK_MONOTONIC, (long)&ts);
+	return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static size_t string_length_local(const char *s)
+{
+	size_t length = 0;
+	while (s[length] != '\0')
+		length++;
+	return length;
+}
+
+static bool string_equal_local(const char *a, const char *b)
+{
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+/* dir + '/' + name into out; false if it does not fit. */
+static bool join_path(const char *dir, const char *name, char *out)
+{
+	size_t dir_length = string_length_local(dir);
+	size_t name_length = string_length_local(name);
+	if (dir_length + 1 + name_length >= FILE_WATCH_PATH_SIZE)
+		return false;
+	fun_memory_copy((Memory)dir, out, dir_length);
+	out[dir_length] = '/';
+	fun_memory_copy((Memory)name, out + dir_length + 1, name_length + 1);
+	return true;
+}
+
+static uint64_t hash_path(const char *path)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (; *path; path++)
+		hash = (hash ^ (uint8_t)*path) * 1099511628211ULL;
+	return hash ? hash : 1;
+}
+
+static void hub_arm_timer(HubState *hub, uint64_t deadline_ms)
+{
+	if (deadline_ms == hub->armed_deadline_ms)
+		return;
+	struct itimerspec_local timer = { 0 };
+	timer.it_value.tv_sec = (long)(deadline_ms / 1000);
+	timer.it_value.tv_nsec = (long)(deadline_ms % 1000) * 1000000L;
+	syscall4(SYS_timerfd_settime, hub->timer_fd, TFD_TIMER_ABSTIME,
+			 (long)&timer, 0);
+	hub->armed_deadline_ms = deadline_ms;
+}
+
+/* Remove slot by shifting later members of its probe run back. */
+static void pending_remove(HubState *hub, uint32_t slot)
+{
+	const uint32_t mask = FILE_WATCH_MAX_PENDING - 1;
+	uint32_t next = slot;
+	for (;;) {
+		next = (next + 1) & mask;
+		if (hub->pending[next].hash == 0)
+			break;
+		uint32_t home = (uint32_t)hub->pending[next].hash & mask;
+		bool movable = slot <= next ? (home <= slot || home > next) :
+									  (home <= slot && home > next);
+		if (movable) {
+			hub->pending[slot] = hub->pending[next];
+			slot = next;
+		}
+	}
+	hub->pending[slot].hash = 0;
+	hub->pending_count--;
+}
+
+/*
+ * Run the callbacks of every path due by now (all of them when flush is
+ * set) and re-arm the timer for the earliest one left.
+ */
+static uint32_t hub_fire(HubState *hub, uint64_t now, bool flush)
+{
+	uint32_t fired = 0;
+	uint64_t next_deadline = 0;
+	char path[FILE_WATCH_PATH_SIZE];
+
+	for (uint32_t slot = 0; slot < FILE_WATCH_MAX_PENDING;) {
+		HubPending *entry = &hub->pending[slot];
+		if (entry->hash == 0) {
+			slot++;
+			continue;
+		}
+		if (!flush && entry->deadline_ms > now) {
+			if (next_deadline == 0 || entry->deadline_ms < next_deadline)
+				next_deadline = entry->deadline_ms;
+			slot++;
+			continue;
+		}
+		/* The slot may be refilled by the shift; look at it again. */
+		FileChangeCallback callback = entry->callback;
+		fun_memory_copy(entry->path, path,
+						string_length_local(entry->path) + 1);
+		pending_remove(hub, slot);
+		callback(path);
+		fired++;
+	}
+
+	hub_arm_timer(hub, next_deadline);
+	return fired;
+}
+
+static uint32_t hub_queue(HubState *hub, const char *path,
+						  FileChangeCallback callback, uint64_t now)
+{
+	uint32_t fired = 0;
+	if (hub->pending_count >= FILE_WATCH_MAX_LOAD)
+		fired = hub_fire(hub, now, true);
+
+	const uint32_t mask = FILE_WATCH_MAX_PENDING - 1;
+	uint64_t hash = hash_path(path);
+	uint32_t slot = (uint32_t)hash & mask;
+	while (hub->pending[slot].hash != 0) {
+		HubPending *entry = &hub->pending[slot];
+		if (entry->hash == hash && entry->callback == callback &&
+			string_equal_local(entry->path, path)) {
+			entry->deadline_ms = now + hub->debounce_ms;
+			return fired;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	HubPending *entry = &hub->pending[slot];
+	entry->hash = hash;
+	entry->deadline_ms = now + hub->debounce_ms;
+	entry->callback = callback;
+	fun_memory_copy((Memory)path, entry->path, string_length_local(path) + 1);
+	hub->pending_count++;
+	return fired;
+}
+
+/* fun_memory_reallocate does not allocate from NULL. */
+static MemoryResult hub_grow(Memory memory, size_t size)
+{
+	return memory ? fun_memory_reallocate(memory, size) :
+					fun_memory_allocate(size);
+}
+
+static ErrorResult hub_reserve(HubState *hub, int wd)
+{
+	if (hub->watch_count == hub->watch_capacity) {
+		uint32_t capacity = hub->watch_capacity ? hub->watch_capacity * 2 : 16;
+		MemoryResult grown =
+			hub_grow(hub->watches, (size_t)capacity * sizeof(HubWatch));
+		if (fun_error_is_error(grown.error))
+			return grown.error;
+		hub->watches = (HubWatch *)grown.value;
+		hub->watch_capacity = capacity;
+	}
+
+	if ((uint32_t)wd >= hub->wd_capacity) {
+		uint32_t capacity = hub->wd_capacity ? hub->wd_capacity : 16;
+		while (capacity <= (uint32_t)wd)
+			capacity *= 2;
+		MemoryResult grown =
+			hub_grow(hub->first_by_wd, (size_t)capacity * sizeof(int));
+		if (fun_error_is_error(grown.error))
+			return grown.error;
+		hub->first_by_wd = (int *)grown.value;
+		for (uint32_t i = hub->wd_capacity; i < capacity; i++)
+			hub->first_by_wd[i] = -1;
+		hub->wd_capacity = capacity;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static ErrorResult hub_add_watch(HubState *hub, const char *watch_path,
+								 const char *path, bool is_file,
+								 bool recursive, FileChangeCallback callback)
+{
+	uint32_t flags = FILE_WATCH_MASK | (is_file ? 0 : IN_ONLYDIR);
+	int wd = (int)syscall3(SYS_inotify_add_watch, hub->inotify_fd,
+						   (long)watch_path, flags);
+	if (wd < 0)
+		return fun_error_result(-wd, "Failed to add inotify watch");
+
+	ErrorResult reserved = hub_reserve(hub, wd);
+	if (fun_error_is_error(reserved))
+		return reserved;
+
+	size_t length = string_length_local(path);
+	HubWatch *watch = &hub->watches[hub->watch_count];
+	watch->wd = wd;
+	watch->next_same_wd = hub->first_by_wd[wd];
+	watch->callback = callback;
+	watch->is_file = is_file;
+	watch->recursive = recursive;
+	watch->name_offset = 0;
+	fun_memory_copy((Memory)path, watch->path, length + 1);
+	if (is_file) {
+		uint32_t name = (uint32_t)length;
+		while (name > 0 && path[name - 1] != '/')
+			name--;
+		watch->name_offset = name;
+	}
+	hub->first_by_wd[wd] = (int)hub->watch_count++;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/* Watch root and, through the directory walker, every directory below. */
+static ErrorResult hub_add_tree(HubState *hub, const char *root,
+								FileChangeCallback callback)
+{
+	ErrorResult error = hub_add_watch(hub, root, root, false, true, callback);
+	if (fun_error_is_error(error))
+		return error;
+
+	MemoryResult walk_memory =
+		fun_memory_allocate(fun_filesystem_walk_memory_size());
+	if (fun_error_is_error(walk_memory.error))
+		return walk_memory.error;
+
+	char root_copy[FILE_WATCH_PATH_SIZE];
+	fun_memory_copy((Memory)root, root_copy, string_length_local(root) + 1);
+	const char *components[FILE_WATCH_MAX_COMPONENTS];
+	Path root_path = { .components = components };
+	error = fun_path_from_string(root_copy, &root_path);
+
+	FunWalkState walk;
+	if (fun_error_is_ok(error))
+		error = fun_filesystem_walk_init(&walk, walk_memory.value, root_path);
+	if (fun_error_is_ok(error)) {
+		char directory[FILE_WATCH_PATH_SIZE];
+		FileEntry entry;
+		for (;;) {
+			boolResult next = fun_filesystem_walk_next(&walk, &entry, false);
+			if (fun_error_is_error(next.error)) {
+				error = next.error;
+				break;
+			}
+			if (!next.value)
+				break;
+			if (!entry.is_directory)
+				continue;
+			error = fun_path_to_string(entry.path, directory,
+									   sizeof(directory));
+			if (fun_error_is_ok(error))
+				error = hub_add_watch(hub, directory, directory, false, true,
+									  callback);
+			if (fun_error_is_error(error))
+				break;
+		}
+		fun_filesystem_walk_close(&walk);
+	}
+
+	fun_memory_free(&walk_memory.value);
+	return error;
+}
+
+static void hub_drop_wd(HubState *hub, int wd)
+{
+	if (wd < 0 || (uint32_t)wd >= hub->wd_capacity)
+		return;
+	for (int index = hub->first_by_wd[wd]; index >= 0;
+		 index = hub->watches[index].next_same_wd)
+		hub->watches[index].wd = -1;
+	hub->first_by_wd[wd] = -1;
+}
+
+static uint32_t hub_handle_event(HubState *hub, struct inotify_event *event,
+								 uint64_t now)
+{
+	uint32_t fired = 0;
+	char path[FILE_WATCH_PATH_SIZE];
+
+	if (event->mask & IN_Q_OVERFLOW) {
+		for (uint32_t i = 0; i < hub->watch_count; i++)
+			if (hub->watches[i].wd >= 0)
+				fired += hub_queue(hub, hub->watches[i].path,
+								   hub->watches[i].callback, now);
+		return fired;
+	}
+	if (event->wd < 0 || (uint32_t)event->wd >= hub->wd_capacity)
+		return 0;
+	if (event->mask & IN_IGNORED) {
+		hub_drop_wd(hub, event->wd);
+		return 0;
+	}
+
+	/* Indices, not pointers: adding a subdirectory may move the array. */
+	for (int index = hub->first_by_wd[event->wd]; index >= 0;
+		 index = hub->watches[index].next_same_wd) {
+		HubWatch *watch = &hub->watches[index];
+		if (watch->is_file) {
+			if (event->len &&
+				string_equal_local(event->name,
+								   watch->path + watch->name_offset))
+				fired += hub_queue(hub, watch->path, watch->callback, now);
+			continue;
+		}
+		if (!event->len) {
+			fired += hub_queue(hub, watch->path, watch->callback, now);
+			continue;
+		}
+		if (!join_path(watch->path, event->name, path))
+			continue;
+		fired += hub_queue(hub, path, watch->callback, now);
+		if (watch->recursive && (event->mask & IN_ISDIR) &&
+			(event->mask & (IN_CREATE | IN_MOVED_TO)))
+			hub_add_tree(hub, path, watch->callback);
+	}
+	return fired;
+}
+
+static void hub_close_fds(HubState *hub)
+{
+	if (hub->epoll_fd >= 0)
+		syscall1(SYS_close, hub->epoll_fd);
+	if (hub->timer_fd >= 0)
+		syscall1(SYS_close, hub->timer_fd);
+	if (hub->inotify_fd >= 0)
+		syscall1(SYS_close, hub->inotify_fd);
+}
+
+ErrorResult fun_file_watch_hub_open(uint32_t debounce_ms,
+									FileWatchHub *out_hub)
+{
+	if (!out_hub)
+		return ERROR_RESULT_NULL_POINTER;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(HubState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+	HubState *hub = (HubState *)allocation.value;
+	*hub = (HubState){ .inotify_fd = -1,
+					   .timer_fd = -1,
+					   .epoll_fd = -1,
+					   .debounce_ms = debounce_ms };
+
+	MemoryResult pending =
+		fun_memory_allocate(FILE_WATCH_MAX_PENDING * sizeof(HubPending));
+	if (fun_error_is_error(pending.error)) {
+		fun_memory_free(&allocation.value);
+		return pending.error;
+	}
+	hub->pending = (HubPending *)pending.value;
+	for (uint32_t i = 0; i < FILE_WATCH_MAX_PENDING; i++)
+		hub->pending[i].hash = 0;
+
+	long ret = syscall1(SYS_inotify_init1, IN_NONBLOCK | IN_CLOEXEC);
+	if (ret >= 0) {
+		hub->inotify_fd = (int)ret;
+		ret = syscall2(SYS_timerfd_create, CLOCK_MONOTONIC,
+					   TFD_NONBLOCK | TFD_CLOEXEC);
+	}
+	if (ret >= 0) {
+		hub->timer_fd = (int)ret;
+		ret = syscall1(SYS_epoll_create1, EPOLL_CLOEXEC);
+	}
+	if (ret >= 0) {
+		hub->epoll_fd = (int)ret;
+		struct epoll_event_local event = { .events = EPOLLIN,
+										   .data = (uint64_t)hub->inotify_fd };
+		ret = syscall4(SYS_epoll_ctl, hub->epoll_fd, EPOLL_CTL_ADD,
+					   hub->inotify_fd, (long)&event);
+		if (ret >= 0) {
+			event.data = (uint64_t)hub->timer_fd;
+			ret = syscall4(SYS_epoll_ctl, hub->epoll_fd, EPOLL_CTL_ADD,
+						   hub->timer_fd, (long)&event);
+		}
+	}
+	if (ret < 0) {
+		hub_close_fds(hub);
+		fun_memory_free((Memory *)&hub->pending);
+		fun_memory_free(&allocation.value);
+		return fun_error_result(-ret, "Failed to create notification hub");
+	}
+
+	out_hub->state = hub;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_watch_hub_add(FileWatchHub hub, FileWatch watch)
+{
+	HubState *state = (HubState *)hub.state;
+	if (!state || !watch.path || !watch.callback)
+		return ERROR_RESULT_NULL_POINTER;
+
+	size_t length = string_length_local(watch.path);
+	if (length == 0)
+		return ERROR_RESULT_PATH_INVALID;
+	if (length >= FILE_WATCH_PATH_SIZE)
+		return ERROR_RESULT_PATH_TOO_LONG;
+	char path[FILE_WATCH_PATH_SIZE];
+	fun_memory_copy((Memory)watch.path, path, length + 1);
+	while (length > 1 && path[length - 1] == '/')
+		path[--length] = '\0';
+
+	long probe = syscall3(SYS_inotify_add_watch, state->inotify_fd,
+						  (long)path, FILE_WATCH_MASK | IN_ONLYDIR);
+	if (probe != -ENOTDIR && watch.recursive)
+		return hub_add_tree(state, path, watch.callback);
+	if (probe != -ENOTDIR)
+		return hub_add_watch(state, path, path, false, false, watch.callback);
+	if (watch.recursive)
+		return ERROR_RESULT_NOT_DIRECTORY;
+
+	/* A file: watch its directory for the name. */
+	char directory[FILE_WATCH_PATH_SIZE];
+	fun_memory_copy(path, directory, length + 1);
+	while (length > 0 && directory[length - 1] != '/')
+		length--;
+	if (length == 0) {
+		directory[0] = '.';
+		directory[1] = '\0';
+	} else {
+		directory[length > 1 ? length - 1 : 1] = '\0';
+	}
+	return hub_add_watch(state, directory, path, true, false, watch.callback);
+}
+
+uint32_tResult fun_file_watch_hub_dispatch(FileWatchHub hub,
+										   int32_t timeout_ms)
+{
+	uint32_tResult result = { .value = 0, .error = ERROR_RESULT_NO_ERROR };
+	HubState *state = (HubState *)hub.state;
+	if (!state) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	struct epoll_event_local events[2];
+	long ready = syscall6(SYS_epoll_pwait, state->epoll_fd, (long)events, 2,
+						  timeout_ms, 0, 8);
+	if (ready < 0 && ready != -EINTR) {
+		result.error = fun_error_result(-ready, "Failed to wait for changes");
+		return result;
+	}
+
+	/* A one-shot timerfd that fired is disarmed. */
+	uint64_t expirations;
+	if (syscall3(SYS_read, state->timer_fd, (long)&expirations,
+				 sizeof(expirations)) == sizeof(expirations))
+		state->armed_deadline_ms = 0;
+
+	uint64_t now = get_monotonic_ms();
+	char buffer[FILE_WATCH_EVENT_BUFFER]
+		__attribute__((aligned(__alignof__(struct inotify_event))));
+	for (;;) {
+		long bytes =
+			syscall3(SYS_read, state->inotify_fd, (long)buffer, sizeof(buffer));
+		if (bytes == -EINTR)
+			continue;
+		if (bytes <= 0)
+			break;
+		for (long offset = 0; offset < bytes;) {
+			struct inotify_event *event =
+				(struct inotify_event *)(buffer + offset);
+			result.value += hub_handle_event(state, event, now);
+			offset += (long)sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	result.value += hub_fire(state, now, false);
+	return result;
+}
+
+int64_t fun_file_watch_hub_descriptor(FileWatchHub hub)
+{
+	HubState *state = (HubState *)hub.state;
+	return state ? state->epoll_fd : -1;
+}
+
+ErrorResult fun_file_watch_hub_close(FileWatchHub *hub)
+{
+	if (!hub || !hub->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	HubState *state = (HubState *)hub->state;
+	hub_close_fds(state);
+	if (state->watches)
+		fun_memory_free((Memory *)&state->watches);
+	if (state->first_by_wd)
+		fun_memory_free((Memory *)&state->first_by_wd);
+	fun_memory_free((Memory *)&state->pending);
+	fun_memory_free(&hub->state);
+	hub->state = NULL;
+	return ERROR_RESULT_NO_ERROR;
+}
@@ -1,5 +1,6 @@
 #include "fileWrite.h"
 #include "fileAdaptive.h"
+#include "fileDirect.h"
 
 AsyncResult fun_write_memory_to_file(Write parameters)
 {
@@ -13,10 +14,14 @@ AsyncResult fun_write_memory_to_file(Write parameters)
 
 	FileMode mode = parameters.mode;
 	if (mode == FILE_MODE_AUTO)
-		mode = file_adaptive_choose(parameters.adaptive);
+		mode = file_adaptive_choose(parameters.adaptive, FILE_ACCESS_WRITE,
+									parameters.offset,
+									parameters.bytes_to_write);
 
 	if (mode == FILE_MODE_RING_BASED)
 		return create_ring_write(parameters);
+	if (mode == FILE_MODE_DIRECT)
+		return create_direct_write(parameters);
 
 	MemoryResult allocation = fun_memory_allocate(sizeof(MMapWriteState));
 	if (fun_error_is_error(allocation.error))
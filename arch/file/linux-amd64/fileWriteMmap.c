@@ -100,8 +100,8 @@ AsyncStatus poll_mmap_write(AsyncResult *result)
 	AsyncStatus final_status = ASYNC_COMPLETED;
 
 	if (!state->fd_valid) {
-		int fd = (int)syscall3(SYS_open, (long)state->parameters.file_path,
-							   O_RDWR | O_CREAT, 0644);
+		int fd =
+			file_cache_open(state->parameters.file_path, O_RDWR | O_CREAT);
 		if (fd < 0) {
 			result->error = fun_error_result(-fd, "Failed to open/create file");
 			final_status = ASYNC_ERROR;
@@ -201,7 +201,7 @@ cleanup:
 		sys_munmap(state->mapped_address, view_size);
 	}
 	if (state->fd_valid)
-		syscall1(SYS_close, state->file_descriptor);
+		file_cache_close(state->file_descriptor);
 	fun_memory_free((Memory *)&state);
 	if (final_status == ASYNC_COMPLETED)
 		file_adaptive_update(adaptive, bytes);
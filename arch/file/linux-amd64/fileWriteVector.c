@@ -0,0 +1,256 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "syscall_nums.h"
+#include "fileRing.h"
+#include "fileCache.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Gather writes: the caller's segments are copied into an iovec array
+ * (the descriptors only, never the data) that trails the state, and the
+ * whole array goes to the kernel at once - pwritev / writev, or one
+ * IORING_OP_WRITEV on the shared ring.  A short write advances the array
+ * past what was written and resubmits the rest.
+ */
+
+typedef struct {
+	String file_path;
+	FileMode mode;
+	FileDurabilityMode durability_mode;
+	bool append;
+	uint64_t offset; /* next file offset, unused when appending */
+	int file_fd;
+	bool file_opened;
+	FileRingRequest request;
+	struct iovec *iov; /* first unwritten segment */
+	uint32_t count; /* segments left from iov on */
+} VectorWriteState;
+
+static inline long syscall1(long n, long a1)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall3(long n, long a1, long a2, long a3)
+{
+	long ret;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+static inline long syscall5(long n, long a1, long a2, long a3, long a4,
+							long a5)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	register long r8 __asm__("r8") = a5;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
+/* Drop the first written bytes from the remaining segments. */
+static void vector_advance(VectorWriteState *state, uint64_t written)
+{
+	state->offset += written;
+	while (state->count > 0 && written >= state->iov->iov_len) {
+		written -= state->iov->iov_len;
+		state->iov++;
+		state->count--;
+	}
+	if (state->count > 0) {
+		state->iov->iov_base = (char *)state->iov->iov_base + written;
+		state->iov->iov_len -= written;
+	}
+}
+
+static long vector_write_once(VectorWriteState *state)
+{
+	if (state->append)
+		return syscall3(SYS_writev, state->file_fd, (long)state->iov,
+						state->count);
+	/* pos_h is ignored on 64-bit kernels; pass 0 all the same. */
+	return syscall5(SYS_pwritev, state->file_fd, (long)state->iov,
+					state->count, (long)state->offset, 0);
+}
+
+/*
+ * Submit the remaining segments to the ring, or reap the submission.
+ * Returns 1 while the write is in flight, 0 once it has landed, or a
+ * negative errno.
+ */
+static long vector_ring_step(VectorWriteState *state)
+{
+	if (!state->request.submitted) {
+		struct io_uring_sqe sqe = { 0 };
+		sqe.opcode = IORING_OP_WRITEV;
+		sqe.fd = state->file_fd;
+		sqe.off = state->append ? (uint64_t)-1 : state->offset;
+		sqe.addr = (uint64_t)(long)state->iov;
+		sqe.len = state->count;
+
+		long ret = file_ring_submit(&sqe, &state->request);
+		if (ret != 0)
+			return ret;
+	}
+
+	if (!file_ring_reap(&state->request))
+		return 1;
+	if (state->request.res < 0)
+		return state->request.res;
+
+	vector_advance(state, (uint64_t)state->request.res);
+	state->request = (FileRingRequest){ 0 };
+	return state->count > 0;
+}
+
+static AsyncStatus poll_vector_write(AsyncResult *result)
+{
+	VectorWriteState *state = (VectorWriteState *)result->state;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->file_opened) {
+		int flags = state->append ? O_WRONLY | O_CREAT | O_APPEND :
+									O_RDWR | O_CREAT;
+		int fd = file_cache_open(state->file_path, flags);
+		if (fd < 0) {
+			result->error = fun_error_result(-fd, "Failed to open file");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		state->file_fd = fd;
+		state->file_opened = true;
+	}
+
+	if (state->mode == FILE_MODE_RING_BASED) {
+		long ret = vector_ring_step(state);
+		if (ret == 1)
+			return ASYNC_PENDING;
+		if (ret < 0) {
+			result->error = fun_error_result(-ret, "io_uring writev failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	} else {
+		while (state->count > 0) {
+			long ret = vector_write_once(state);
+			if (ret == -EINTR)
+				continue;
+			if (ret < 0) {
+				result->error = fun_error_result(-ret, "writev failed");
+				final_status = ASYNC_ERROR;
+				goto cleanup;
+			}
+			vector_advance(state, (uint64_t)ret);
+		}
+	}
+
+	if (state->durability_mode == FILE_DURABILITY_SYNC ||
+		state->durability_mode == FILE_DURABILITY_FULL) {
+		long sync = state->durability_mode == FILE_DURABILITY_FULL ?
+						SYS_fsync :
+						SYS_fdatasync;
+		if (syscall1(sync, state->file_fd) < 0) {
+			result->error = fun_error_result(1, "fsync failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+
+	result->error = ERROR_RESULT_NO_ERROR;
+
+cleanup:
+	if (state->file_opened)
+		file_cache_close(state->file_fd);
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+static AsyncResult create_vector_write(String file_path,
+									   const FileSegment *segments,
+									   uint32_t segment_count, uint64_t offset,
+									   bool append, FileMode mode,
+									   FileDurabilityMode durability_mode)
+{
+	if (!file_path || (!segments && segment_count > 0))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (segment_count > FILE_MAX_SEGMENTS)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_FILE_TOO_MANY_SEGMENTS };
+
+	uint64_t total = 0;
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < segment_count; i++) {
+		if (segments[i].bytes == 0)
+			continue;
+		if (!segments[i].data)
+			return (AsyncResult){ .status = ASYNC_ERROR,
+								  .error = ERROR_RESULT_NULL_POINTER };
+		if (segments[i].bytes > UINT64_MAX - total)
+			return (AsyncResult){ .status = ASYNC_ERROR,
+								  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+		total += segments[i].bytes;
+		count++;
+	}
+	if (!append && total > UINT64_MAX - offset)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	if (count == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+
+	MemoryResult mem_result = fun_memory_allocate(
+		sizeof(VectorWriteState) + count * sizeof(struct iovec));
+	if (fun_error_is_error(mem_result.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = mem_result.error };
+
+	VectorWriteState *state = (VectorWriteState *)mem_result.value;
+	*state = (VectorWriteState){ .file_path = file_path,
+								 .mode = mode,
+								 .durability_mode = durability_mode,
+								 .append = append,
+								 .offset = offset,
+								 .file_fd = -1,
+								 .iov = (struct iovec *)(state + 1),
+								 .count = count };
+	struct iovec *iov = state->iov;
+	for (uint32_t i = 0; i < segment_count; i++) {
+		if (segments[i].bytes > 0)
+			*iov++ = (struct iovec){ segments[i].data, segments[i].bytes };
+	}
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_vector_write,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult fun_write_vector_to_file(WriteVector parameters)
+{
+	return create_vector_write(parameters.file_path, parameters.segments,
+							   parameters.segment_count, parameters.offset,
+							   false, parameters.mode,
+							   parameters.durability_mode);
+}
+
+AsyncResult fun_append_vector_to_file(AppendVector parameters)
+{
+	return create_vector_write(parameters.file_path, parameters.segments,
+							   parameters.segment_count, 0, true,
+							   parameters.mode, parameters.durability_mode);
+}
@@ -36,7 +36,8 @@ struct io_cqring_offsets {
 };
 
 /*
- * Submission Queue Entry.
+ * Submission Queue Entry.  Must stay 64 bytes: the kernel indexes the
+ * SQE array with that stride.
  */
 struct io_uring_sqe {
 	uint8_t opcode;
@@ -49,7 +50,9 @@ struct io_uring_sqe {
 	int32_t rw_flags;
 	uint64_t user_data;
 	uint16_t buf_index;
-	uint16_t __pad2[3];
+	uint16_t personality;
+	int32_t splice_fd_in;
+	uint64_t __pad2[2];
 };
 
 /*
@@ -76,3 +79,41 @@ struct io_uring_params {
 	struct io_sqring_offsets sq_off;
 	struct io_cqring_offsets cq_off;
 };
+
+/*
+ * Buffer descriptor for IORING_REGISTER_BUFFERS.
+ */
+struct iovec {
+	void *iov_base;
+	uint64_t iov_len;
+};
+
+/*
+ * Argument of IORING_REGISTER_FILES_UPDATE: replace nr_args entries of the
+ * fixed-file table starting at offset with the descriptors at fds (-1
+ * clears an entry).
+ */
+struct io_uring_files_update {
+	uint32_t offset;
+	uint32_t resv;
+	uint64_t fds;
+};
+
+/*
+ * Timeout for io_uring_enter.
+ */
+struct __kernel_timespec {
+	int64_t tv_sec;
+	int64_t tv_nsec;
+};
+
+/*
+ * Argument of io_uring_enter with IORING_ENTER_EXT_ARG: bounds a
+ * GETEVENTS wait by ts (a struct __kernel_timespec pointer).
+ */
+struct io_uring_getevents_arg {
+	uint64_t sigmask;
+	uint32_t sigmask_sz;
+	uint32_t pad;
+	uint64_t ts;
+};
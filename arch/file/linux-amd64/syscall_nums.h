@@ -18,19 +18,29 @@
 #define SYS_open 2
 #define SYS_close 3
 #define SYS_fstat 5
+#define SYS_pread64 17
+#define SYS_pwrite64 18
+#define SYS_writev 20
+#define SYS_pwritev 296
+#define SYS_sched_yield 24
 #define SYS_nanosleep 35
-#define SYS_lseek 62
+#define SYS_lseek 8
 #define SYS_mmap 9
 #define SYS_mprotect 10
 #define SYS_munmap 11
 #define SYS_msync 26
+#define SYS_madvise 28
 #define SYS_fcntl 72
 #define SYS_flock 73
 #define SYS_fsync 74
 #define SYS_fdatasync 75
 #define SYS_ftruncate 77
+#define SYS_fallocate 285
+#define SYS_futex 202
 #define SYS_getdents 217
 #define SYS_fadvise 221
+#define SYS_sendfile 40
+#define SYS_copy_file_range 326
 
 /* ============================================================================
  * File Opening Flags (fcntl.h)
@@ -46,6 +56,7 @@
 #define O_DIRECT 040000
 #define O_DIRECTORY 0400000
 #define O_NOFOLLOW 0400000
+#define SEEK_SET 0
 
 /* ============================================================================
  * Memory Protection Flags (sys/mman.h)
@@ -62,7 +73,7 @@
 #define MAP_PRIVATE 0x2
 #define MAP_FIXED 0x10
 #define MAP_ANONYMOUS 0x20
-#define MAP_POPULATE 0x80000
+#define MAP_POPULATE 0x8000
 
 /* ============================================================================
  * File Locking Flags (sys/file.h)
@@ -72,6 +83,18 @@
 #define LOCK_NB 4 /* Non-blocking */
 #define LOCK_UN 8 /* Unlock */
 
+/* Open file description record locks (fcntl.h) */
+#define F_OFD_GETLK 36
+#define F_OFD_SETLK 37
+#define F_OFD_SETLKW 38
+#define F_RDLCK 0
+#define F_WRLCK 1
+#define F_UNLCK 2
+
+/* Futex operations (linux/futex.h) */
+#define FUTEX_WAIT_PRIVATE 128
+#define FUTEX_WAKE_PRIVATE 129
+
 /* ============================================================================
  * Sync Flags (sys/mman.h, unistd.h)
  * ============================================================================ */
@@ -93,6 +116,15 @@
 #define SYS_io_uring_enter 426
 #define SYS_io_uring_register 427
 
+/* ============================================================================
+ * io_uring_register Opcodes
+ * ============================================================================ */
+#define IORING_REGISTER_BUFFERS 0
+#define IORING_UNREGISTER_BUFFERS 1
+#define IORING_REGISTER_FILES 2
+#define IORING_UNREGISTER_FILES 3
+#define IORING_REGISTER_FILES_UPDATE 6
+
 /* ============================================================================
  * io_uring Operations
  * ============================================================================ */
@@ -153,6 +185,11 @@
 #define IORING_ENTER_SQ_WAIT 0x04
 #define IORING_ENTER_EXT_ARG 0x08
 
+/* ============================================================================
+ * io_uring Feature Flags (io_uring_params.features)
+ * ============================================================================ */
+#define IORING_FEAT_EXT_ARG (1U << 8)
+
 /* ============================================================================
  * io_uring SQE Flags
  * ============================================================================ */
@@ -193,6 +230,7 @@
 #define SYS_inotify_init 253
 #define SYS_inotify_add_watch 254
 #define SYS_inotify_rm_watch 255
+#define SYS_inotify_init1 294
 
 /* ============================================================================
  * Inotify Events
@@ -215,6 +253,42 @@
 #define IN_UNMOUNT 0x00002000
 #define IN_Q_OVERFLOW 0x00004000
 #define IN_IGNORED 0x00008000
+#define IN_ONLYDIR 0x01000000
+#define IN_ISDIR 0x40000000
+#define IN_NONBLOCK 04000
+#define IN_CLOEXEC 02000000
+
+/* ============================================================================
+ * epoll and timerfd (for notification hubs)
+ * ============================================================================ */
+#define SYS_epoll_create1 291
+#define SYS_epoll_ctl 233
+#define SYS_epoll_pwait 281
+#define SYS_timerfd_create 283
+#define SYS_timerfd_settime 286
+#define EPOLL_CLOEXEC 02000000
+#define EPOLL_CTL_ADD 1
+#define EPOLLIN 0x001
+#define TFD_NONBLOCK 04000
+#define TFD_CLOEXEC 02000000
+#define TFD_TIMER_ABSTIME 1
+
+/* ============================================================================
+ * madvise Advice
+ * ============================================================================ */
+#define MADV_NORMAL 0
+#define MADV_RANDOM 1
+#define MADV_SEQUENTIAL 2
+#define MADV_WILLNEED 3
+
+/* ============================================================================
+ * fadvise Advice
+ * ============================================================================ */
+#define POSIX_FADV_NORMAL 0
+#define POSIX_FADV_RANDOM 1
+#define POSIX_FADV_SEQUENTIAL 2
+#define POSIX_FADV_WILLNEED 3
+#define POSIX_FADV_DONTNEED 4
 
 /* ============================================================================
  * Time Syscalls
@@ -226,7 +300,16 @@
 /* ============================================================================
  * Error Numbers
  * ============================================================================ */
+#define EINTR 4
+#define EIO 5
 #define EAGAIN 11
+#define ENOMEM 12
+#define EACCES 13
 #define EWOULDBLOCK 11
+#define EXDEV 18
+#define ENOTDIR 20
+#define EINVAL 22
+#define ENOSYS 38
+#define EOPNOTSUPP 95
 
 #endif /* FUNDAMENTAL_FILE_SYSCALL_NUMS_LINUX_AMD64_H */
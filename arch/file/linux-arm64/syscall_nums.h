@@ -16,6 +16,8 @@
  * ============================================================================ */
 #define SYS_read 63
 #define SYS_write 64
+#define SYS_writev 66
+#define SYS_pwritev 70
 #define SYS_open 56
 #define SYS_close 57
 #define SYS_fstat 80
@@ -28,9 +30,13 @@
 #define SYS_fsync 82
 #define SYS_fdatasync 83
 #define SYS_ftruncate 46
+#define SYS_fallocate 47
+#define SYS_futex 98
 #define SYS_getdents 61
 #define SYS_getdents64 61
 #define SYS_fadvise 223
+#define SYS_sendfile 71
+#define SYS_copy_file_range 285
 
 /* ============================================================================
  * File Opening Flags (fcntl.h)
@@ -62,7 +68,7 @@
 #define MAP_PRIVATE 0x2
 #define MAP_FIXED 0x10
 #define MAP_ANONYMOUS 0x20
-#define MAP_POPULATE 0x80000
+#define MAP_POPULATE 0x8000
 
 /* ============================================================================
  * File Locking Flags (sys/file.h)
@@ -72,6 +78,18 @@
 #define LOCK_NB 4 /* Non-blocking */
 #define LOCK_UN 8 /* Unlock */
 
+/* Open file description record locks (fcntl.h) */
+#define F_OFD_GETLK 36
+#define F_OFD_SETLK 37
+#define F_OFD_SETLKW 38
+#define F_RDLCK 0
+#define F_WRLCK 1
+#define F_UNLCK 2
+
+/* Futex operations (linux/futex.h) */
+#define FUTEX_WAIT_PRIVATE 128
+#define FUTEX_WAKE_PRIVATE 129
+
 /* ============================================================================
  * Sync Flags (sys/mman.h, unistd.h)
  * ============================================================================ */
@@ -192,9 +210,9 @@
 /* ============================================================================
  * Inotify Syscalls (for file notifications)
  * ============================================================================ */
-#define SYS_inotify_init 269
-#define SYS_inotify_add_watch 268
-#define SYS_inotify_rm_watch 270
+#define SYS_inotify_init1 26
+#define SYS_inotify_add_watch 27
+#define SYS_inotify_rm_watch 28
 
 /* ============================================================================
  * Inotify Events
@@ -217,5 +235,24 @@
 #define IN_UNMOUNT 0x00002000
 #define IN_Q_OVERFLOW 0x00004000
 #define IN_IGNORED 0x00008000
+#define IN_ONLYDIR 0x01000000
+#define IN_ISDIR 0x40000000
+#define IN_NONBLOCK 04000
+#define IN_CLOEXEC 02000000
+
+/* ============================================================================
+ * epoll and timerfd (for notification hubs)
+ * ============================================================================ */
+#define SYS_epoll_create1 20
+#define SYS_epoll_ctl 21
+#define SYS_epoll_pwait 22
+#define SYS_timerfd_create 85
+#define SYS_timerfd_settime 86
+#define EPOLL_CLOEXEC 02000000
+#define EPOLL_CTL_ADD 1
+#define EPOLLIN 0x001
+#define TFD_NONBLOCK 04000
+#define TFD_CLOEXEC 02000000
+#define TFD_TIMER_ABSTIME 1
 
 #endif /* FUNDAMENTAL_FILE_SYSCALL_NUMS_LINUX_ARM64_H */
@@ -0,0 +1,28 @@
+#include "fundamental/file/file.h"
+#include "fundamental/error/error.h"
+#include "fileAdaptive.h"
+
+/* Zero is FILE_MODE_AUTO: uncalibrated until told otherwise. */
+FileMode file_calibrated_mode[FILE_ACCESS_COUNT][FILE_PATTERN_COUNT]
+							[FILE_SIZE_BUCKET_COUNT];
+
+#define FILE_CALIBRATION_CELLS \
+	(FILE_ACCESS_COUNT * FILE_PATTERN_COUNT * FILE_SIZE_BUCKET_COUNT)
+
+ErrorResult fun_file_set_calibration(const FileCalibration *calibration)
+{
+	const FileMode *modes = calibration ? &calibration->mode[0][0][0] : NULL;
+	FileMode *table = &file_calibrated_mode[0][0][0];
+
+	for (uint32_t cell = 0; modes && cell < FILE_CALIBRATION_CELLS; cell++) {
+		if (modes[cell] != FILE_MODE_AUTO && modes[cell] != FILE_MODE_MMAP &&
+			modes[cell] != FILE_MODE_RING_BASED)
+			return ERROR_RESULT_FILE_INVALID_CALIBRATION;
+	}
+
+	for (uint32_t cell = 0; cell < FILE_CALIBRATION_CELLS; cell++) {
+		FileMode mode = modes ? modes[cell] : FILE_MODE_AUTO;
+		table[cell] = mode;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
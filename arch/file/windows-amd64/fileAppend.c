@@ -5,11 +5,9 @@
 #include <windows.h>
 
 #define WINAPI_FAMILY WINAPI_FAMILY_DESKTOP_APP
-#undef NTDDI_VERSION
-#define NTDDI_VERSION NTDDI_WIN10_NI
 
-#include "ioringcompat.h"
-#include <ioringapi.h>
+#include "fileRing.h"
+#include "fileDirect.h"
 
 // ------------------------------------------------------------------
 // mmap-based append
@@ -149,77 +147,33 @@ cleanup:
 // ring-based append
 // ------------------------------------------------------------------
 
-typedef struct {
-	HIORING io_ring;
-	IORING_INFO info;
-} IoRingAppendContext;
-
 typedef struct {
 	Append parameters;
-	IoRingAppendContext *global_context;
 	HANDLE file_handle;
-	uint64_t request_id;
-	AsyncStatus async_status;
+	FileRingRequest request;
 } RingAppendState;
 
-static IoRingAppendContext global_append_context = { 0 };
-static uint64_t next_append_request_id = 0;
-
 static AsyncStatus poll_ring_append(AsyncResult *result)
 {
 	RingAppendState *state = result->state;
-	IORING_CQE cqe;
-
-	if (state->async_status != ASYNC_PENDING) {
-		AsyncStatus status = state->async_status;
-		FileAdaptiveState *adaptive = state->parameters.adaptive;
-		uint64_t bytes = state->parameters.bytes_to_append;
-		if (state->file_handle != INVALID_HANDLE_VALUE)
-			CloseHandle(state->file_handle);
-		void *mem = state;
-		fun_memory_free(&mem);
-		if (status == ASYNC_COMPLETED)
-			file_adaptive_update(adaptive, bytes);
-		return status;
-	}
+	if (!file_ring_reap(&state->request))
+		return ASYNC_PENDING;
 
-	if (SUCCEEDED(PopIoRingCompletion(state->global_context->io_ring, &cqe))) {
-		AsyncStatus status = cqe.ResultCode >= 0 ? ASYNC_COMPLETED :
-												   ASYNC_ERROR;
-		state->async_status = status;
-		if (cqe.UserData == state->request_id) {
-			FileAdaptiveState *adaptive = state->parameters.adaptive;
-			uint64_t bytes = state->parameters.bytes_to_append;
-			if (state->file_handle != INVALID_HANDLE_VALUE)
-				CloseHandle(state->file_handle);
-			void *mem = state;
-			fun_memory_free(&mem);
-			if (status == ASYNC_COMPLETED)
-				file_adaptive_update(adaptive, bytes);
-			return status;
-		}
-	}
-	return ASYNC_PENDING;
+	AsyncStatus status = SUCCEEDED(state->request.result) ? ASYNC_COMPLETED :
+															ASYNC_ERROR;
+	FileAdaptiveState *adaptive = state->parameters.adaptive;
+	uint64_t bytes = state->parameters.bytes_to_append;
+	if (state->file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(state->file_handle);
+	void *mem = state;
+	fun_memory_free(&mem);
+	if (status == ASYNC_COMPLETED)
+		file_adaptive_update(adaptive, bytes);
+	return status;
 }
 
 static AsyncResult create_ring_append(Append parameters)
 {
-	if (!global_append_context.io_ring) {
-		IORING_CREATE_FLAGS flags = {
-			.Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE,
-			.Required = IORING_CREATE_REQUIRED_FLAGS_NONE
-		};
-		HRESULT hr = CreateIoRing(IORING_VERSION_1, flags, 0, 0,
-								  &global_append_context.io_ring);
-		if (FAILED(hr))
-			return (AsyncResult){
-				.status = ASYNC_ERROR,
-				.error = { .code = hr, .message = "CreateIoRing failed" }
-			};
-		GetIoRingInfo(global_append_context.io_ring,
-					  &global_append_context.info);
-	}
-
 	MemoryResult mem_result = fun_memory_allocate(sizeof(RingAppendState));
 	if (fun_error_is_error(mem_result.error))
 		return (AsyncResult){ .status = ASYNC_ERROR,
@@ -227,9 +181,8 @@ static AsyncResult create_ring_append(Append parameters)
 
 	HANDLE file = INVALID_HANDLE_VALUE;
 	RingAppendState *state = (RingAppendState *)mem_result.value;
-	state->global_context = &global_append_context;
-	state->request_id = next_append_request_id++;
-	state->async_status = ASYNC_PENDING;
+	state->request = (FileRingRequest){ 0 };
+	state->file_handle = INVALID_HANDLE_VALUE;
 	state->parameters = parameters;
 
 	// Open with FILE_APPEND_DATA so the OS handles the offset atomically
@@ -241,18 +194,26 @@ static AsyncResult create_ring_append(Append parameters)
 	state->file_handle = file;
 
 	IORING_HANDLE_REF file_ref = IoRingHandleRefFromHandle(file);
-	IORING_BUFFER_REF buffer_ref = IoRingBufferRefFromPointer(parameters.input);
+
+	HIORING ring = file_ring_lock();
+	if (!ring)
+		goto cleanup;
+
+	IORING_BUFFER_REF buffer_ref = file_ring_buffer_ref(
+		parameters.input, (UINT32)parameters.bytes_to_append);
 
 	// offset = -1 means append (FILE_USE_FILE_POINTER_POSITION)
-	HRESULT hr = BuildIoRingWriteFile(state->global_context->io_ring, file_ref,
-									  buffer_ref, parameters.bytes_to_append,
-									  (UINT64)-1, FILE_WRITE_FLAGS_NONE,
-									  state->request_id, IOSQE_FLAGS_NONE);
-	if (FAILED(hr))
+	HRESULT hr = BuildIoRingWriteFile(ring, file_ref, buffer_ref,
+									  parameters.bytes_to_append, (UINT64)-1,
+									  FILE_WRITE_FLAGS_NONE,
+									  (UINT_PTR)&state->request,
+									  IOSQE_FLAGS_NONE);
+	if (FAILED(hr)) {
+		file_ring_unlock();
 		goto cleanup;
+	}
 
-	UINT32 submitted;
-	hr = SubmitIoRing(state->global_context->io_ring, 0, 1, &submitted);
+	hr = file_ring_submit_unlock();
 	if (FAILED(hr))
 		goto cleanup;
 
@@ -288,10 +249,13 @@ AsyncResult fun_append_memory_to_file(Append parameters)
 
 	FileMode mode = parameters.mode;
 	if (mode == FILE_MODE_AUTO)
-		mode = file_adaptive_choose(parameters.adaptive);
+		mode = file_adaptive_choose(parameters.adaptive, FILE_ACCESS_APPEND,
+									0, parameters.bytes_to_append);
 
 	if (mode == FILE_MODE_RING_BASED)
 		return create_ring_append(parameters);
+	if (mode == FILE_MODE_DIRECT)
+		return create_direct_append(parameters);
 
 	MemoryResult mem_result = fun_memory_allocate(sizeof(MMapAppendState));
 	if (fun_error_is_error(mem_result.error))
@@ -0,0 +1,211 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <stdbool.h>
+
+/*
+ * Group commit as on Linux.  WriteFileGather needs page-sized, unbuffered
+ * segments, so the committer issues one WriteFile per entry and groups
+ * the expensive part, FlushFileBuffers, into one call per commit.
+ */
+
+/* WriteFile takes a DWORD length; stay well below it. */
+#define FILE_APPENDER_MAX_IO_BYTES (1ULL << 30)
+
+struct AppenderState;
+
+typedef struct AppendEntry {
+	struct AppendEntry *next;
+	struct AppenderState *appender;
+	const char *input;
+	uint64_t bytes;
+	ErrorResult error; /* valid once done */
+	bool done;
+} AppendEntry;
+
+typedef struct AppenderState {
+	HANDLE file_handle;
+	FileDurabilityMode durability;
+	volatile LONG lock;
+	AppendEntry *head; /* queued for the next commit */
+	AppendEntry *tail;
+	uint32_t outstanding; /* entries whose owner has not completed yet */
+	bool committing;
+} AppenderState;
+
+static void appender_lock(AppenderState *appender)
+{
+	while (InterlockedCompareExchange(&appender->lock, 1, 0) != 0)
+		YieldProcessor();
+}
+
+static void appender_unlock(AppenderState *appender)
+{
+	InterlockedExchange(&appender->lock, 0);
+}
+
+static DWORD appender_write(AppenderState *appender, AppendEntry *entry)
+{
+	uint64_t done = 0;
+	while (done < entry->bytes) {
+		uint64_t chunk = entry->bytes - done;
+		if (chunk > FILE_APPENDER_MAX_IO_BYTES)
+			chunk = FILE_APPENDER_MAX_IO_BYTES;
+		DWORD transferred = 0;
+		if (!WriteFile(appender->file_handle, entry->input + done,
+					   (DWORD)chunk, &transferred, NULL))
+			return GetLastError();
+		done += transferred;
+	}
+	return ERROR_SUCCESS;
+}
+
+/* Called and returns with the lock held; drops it around the I/O. */
+static void appender_commit_locked(AppenderState *appender)
+{
+	AppendEntry *batch = appender->head;
+	AppendEntry *last = batch;
+	uint32_t count = 1;
+	while (last->next && count < FILE_APPENDER_MAX_BATCH) {
+		last = last->next;
+		count++;
+	}
+	appender->head = last->next;
+	if (!appender->head)
+		appender->tail = NULL;
+	last->next = NULL;
+	appender->committing = true;
+	appender_unlock(appender);
+
+	DWORD error = ERROR_SUCCESS;
+	for (AppendEntry *entry = batch; entry && error == ERROR_SUCCESS;
+		 entry = entry->next)
+		error = appender_write(appender, entry);
+	if (error == ERROR_SUCCESS &&
+		appender->durability != FILE_DURABILITY_ASYNC &&
+		!FlushFileBuffers(appender->file_handle))
+		error = GetLastError();
+	ErrorResult result = error != ERROR_SUCCESS ?
+							 fun_error_result(error, "Group commit failed") :
+							 ERROR_RESULT_NO_ERROR;
+
+	appender_lock(appender);
+	for (AppendEntry *entry = batch; entry; entry = entry->next) {
+		entry->error = result;
+		entry->done = true;
+	}
+	appender->committing = false;
+}
+
+static AsyncStatus poll_appender(AsyncResult *result)
+{
+	AppendEntry *entry = (AppendEntry *)result->state;
+	AppenderState *appender = entry->appender;
+
+	appender_lock(appender);
+	if (!entry->done && !appender->committing && appender->head)
+		appender_commit_locked(appender);
+	if (!entry->done) {
+		bool waiting = appender->committing;
+		appender_unlock(appender);
+		/* Another thread is flushing; let it run rather than spin. */
+		if (waiting)
+			SwitchToThread();
+		return ASYNC_PENDING;
+	}
+	appender->outstanding--;
+	appender_unlock(appender);
+
+	result->error = entry->error;
+	fun_memory_free((Memory *)&entry);
+	return fun_error_is_ok(result->error) ? ASYNC_COMPLETED : ASYNC_ERROR;
+}
+
+ErrorResult fun_file_appender_open(String file_path,
+								   FileDurabilityMode durability,
+								   FileAppender *out_appender)
+{
+	if (!file_path || !out_appender)
+		return ERROR_RESULT_NULL_POINTER;
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, file_path, -1, wide_path, MAX_PATH) ==
+		0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(AppenderState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+
+	HANDLE file = CreateFileW(wide_path, FILE_APPEND_DATA | SYNCHRONIZE,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							  OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		fun_memory_free(&allocation.value);
+		return fun_error_result(GetLastError(),
+								"Failed to open file for append");
+	}
+
+	AppenderState *appender = (AppenderState *)allocation.value;
+	*appender = (AppenderState){ .file_handle = file,
+								 .durability = durability };
+	out_appender->state = appender;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+AsyncResult fun_file_appender_append(FileAppender appender, Memory input,
+									 uint64_t bytes_to_append)
+{
+	AppenderState *state = (AppenderState *)appender.state;
+	if (!state || !input)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (bytes_to_append == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(AppendEntry));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	AppendEntry *entry = (AppendEntry *)allocation.value;
+	*entry = (AppendEntry){ .appender = state,
+							.input = (const char *)input,
+							.bytes = bytes_to_append };
+
+	appender_lock(state);
+	if (state->tail)
+		state->tail->next = entry;
+	else
+		state->head = entry;
+	state->tail = entry;
+	state->outstanding++;
+	appender_unlock(state);
+
+	return (AsyncResult){ .state = entry,
+						  .poll = poll_appender,
+						  .status = ASYNC_PENDING };
+}
+
+ErrorResult fun_file_appender_close(FileAppender *appender)
+{
+	if (!appender || !appender->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	AppenderState *state = (AppenderState *)appender->state;
+	appender_lock(state);
+	bool busy = state->outstanding > 0;
+	appender_unlock(state);
+	if (busy)
+		return ERROR_RESULT_FILE_APPENDER_BUSY;
+
+	BOOL closed = CloseHandle(state->file_handle);
+	fun_memory_free(&appender->state);
+	appender->state = NULL;
+	if (!closed)
+		return fun_error_result(GetLastError(), "Failed to close file");
+	return ERROR_RESULT_NO_ERROR;
+}
@@ -0,0 +1,181 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+#include "fundamental/async/async.h"
+#include "fileAdaptive.h"
+
+#include <stdbool.h>
+
+/*
+ * One representative size per bucket, and how many timed operations to
+ * average there.  Larger sizes need fewer runs to swamp timer noise and
+ * would otherwise append tens of megabytes to the scratch file.
+ */
+static const uint64_t calibration_bytes[FILE_SIZE_BUCKET_COUNT] = {
+	4ULL << 10, 64ULL << 10, 1ULL << 20, 8ULL << 20
+};
+static const uint32_t calibration_runs[FILE_SIZE_BUCKET_COUNT] = {
+	32, 16, 6, 2
+};
+
+/*
+ * A pass touches runs + 1 request-sized slots of the scratch file: in
+ * order for the sequential pattern, and stepping this many slots at a time
+ * for the random one.  It is coprime with every runs + 1 above, so the
+ * random pass still visits each slot once.
+ */
+#define CALIBRATION_STRIDE 5
+
+static ErrorResult calibration_run_once(String path, FileAccess access,
+										FileMode mode, Memory buffer,
+										uint64_t offset, uint64_t bytes)
+{
+	AsyncResult result;
+	if (access == FILE_ACCESS_READ)
+		result = fun_read_file_in_memory((Read){ .file_path = path,
+												 .output = buffer,
+												 .bytes_to_read = bytes,
+												 .offset = offset,
+												 .mode = mode });
+	else if (access == FILE_ACCESS_WRITE)
+		result = fun_write_memory_to_file((Write){ .file_path = path,
+												   .input = buffer,
+												   .bytes_to_write = bytes,
+												   .offset = offset,
+												   .mode = mode });
+	else
+		result = fun_append_memory_to_file((Append){ .file_path = path,
+													 .input = buffer,
+													 .bytes_to_append = bytes,
+													 .mode = mode });
+	fun_async_await(&result, -1);
+	return result.error;
+}
+
+/* Write every slot so the read passes find data, not a hole or EOF. */
+static ErrorResult calibration_fill(String path, Memory buffer,
+								   uint32_t bucket)
+{
+	uint64_t bytes = calibration_bytes[bucket];
+	ErrorResult error = ERROR_RESULT_NO_ERROR;
+	for (uint32_t slot = 0;
+		 slot <= calibration_runs[bucket] && fun_error_is_ok(error); slot++)
+		error = calibration_run_once(path, FILE_ACCESS_WRITE, FILE_MODE_MMAP,
+									 buffer, slot * bytes, bytes);
+	return error;
+}
+
+/* Mean ns per operation after one untimed warm-up; 0 on failure. */
+static uint64_t calibration_time(String path, FileAccess access,
+								 FilePattern pattern, FileMode mode,
+								 Memory buffer, uint32_t bucket,
+								 ErrorResult *first_error)
+{
+	uint64_t bytes = calibration_bytes[bucket];
+	uint32_t runs = calibration_runs[bucket];
+	uint32_t stride = pattern == FILE_PATTERN_RANDOM ? CALIBRATION_STRIDE : 1;
+	ErrorResult error =
+		calibration_run_once(path, access, mode, buffer, 0, bytes);
+	/* Windows has no call to drop cached pages: reads time the cache. */
+
+	uint64_t start = file_get_monotonic_ns();
+	for (uint32_t run = 1; run <= runs && fun_error_is_ok(error); run++) {
+		uint64_t slot = (uint64_t)run * stride % (runs + 1);
+		error = calibration_run_once(path, access, mode, buffer, slot * bytes,
+									 bytes);
+	}
+	uint64_t elapsed = file_get_monotonic_ns() - start;
+
+	if (fun_error_is_error(error)) {
+		if (fun_error_is_ok(*first_error))
+			*first_error = error;
+		return 0;
+	}
+	return elapsed / runs > 0 ? elapsed / runs : 1;
+}
+
+ErrorResult fun_file_calibrate(String scratch_path,
+							   FileCalibration *out_calibration)
+{
+	if (!scratch_path)
+		return ERROR_RESULT_NULL_POINTER;
+
+	uint64_t largest = calibration_bytes[FILE_SIZE_BUCKET_COUNT - 1];
+	MemoryResult allocation = fun_memory_allocate(largest);
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+	fun_memory_fill(allocation.value, largest, 0x5a);
+
+	FileCalibration calibration = { 0 };
+	ErrorResult first_error = ERROR_RESULT_NO_ERROR;
+	bool calibrated = false;
+
+	/*
+	 * Writes first, then a fill so every slot holds data for the reads.
+	 * Appends have no offset: their one measurement fills both rows.
+	 */
+	static const FileAccess order[FILE_ACCESS_COUNT] = {
+		FILE_ACCESS_WRITE, FILE_ACCESS_READ, FILE_ACCESS_APPEND
+	};
+	for (uint32_t bucket = 0; bucket < FILE_SIZE_BUCKET_COUNT; bucket++) {
+		for (uint32_t i = 0; i < FILE_ACCESS_COUNT; i++) {
+			FileAccess access = order[i];
+			if (access == FILE_ACCESS_READ) {
+				ErrorResult error = calibration_fill(
+					scratch_path, allocation.value, bucket);
+				if (fun_error_is_error(error) && fun_error_is_ok(first_error))
+					first_error = error;
+			}
+			uint32_t patterns =
+				access == FILE_ACCESS_APPEND ? 1 : FILE_PATTERN_COUNT;
+			for (uint32_t pattern = 0; pattern < patterns; pattern++) {
+				uint64_t mmap_ns = calibration_time(
+					scratch_path, access, pattern, FILE_MODE_MMAP,
+					allocation.value, bucket, &first_error);
+				uint64_t ring_ns = calibration_time(
+					scratch_path, access, pattern, FILE_MODE_RING_BASED,
+					allocation.value, bucket, &first_error);
+				calibration.mmap_ns[access][pattern][bucket] = mmap_ns;
+				calibration.ring_ns[access][pattern][bucket] = ring_ns;
+
+				FileMode mode = FILE_MODE_AUTO;
+				if (mmap_ns && (!ring_ns || mmap_ns <= ring_ns))
+					mode = FILE_MODE_MMAP;
+				else if (ring_ns)
+					mode = FILE_MODE_RING_BASED;
+				calibration.mode[access][pattern][bucket] = mode;
+				calibrated = calibrated || mode != FILE_MODE_AUTO;
+			}
+			if (access == FILE_ACCESS_APPEND) {
+				uint32_t seq = FILE_PATTERN_SEQUENTIAL;
+				uint32_t rnd = FILE_PATTERN_RANDOM;
+				calibration.mode[access][rnd][bucket] =
+					calibration.mode[access][seq][bucket];
+				calibration.mmap_ns[access][rnd][bucket] =
+					calibration.mmap_ns[access][seq][bucket];
+				calibration.ring_ns[access][rnd][bucket] =
+					calibration.ring_ns[access][seq][bucket];
+			}
+		}
+	}
+	fun_memory_free(&allocation.value);
+
+	/* Leave the file empty; the caller decides whether to delete it. */
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, scratch_path, -1, wide_path,
+							MAX_PATH) != 0) {
+		HANDLE file = CreateFileW(wide_path, GENERIC_WRITE,
+								  FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+								  TRUNCATE_EXISTING, FILE_ATTRIBUTE_NORMAL,
+								  NULL);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+	}
+
+	if (!calibrated)
+		return first_error;
+	if (out_calibration)
+		*out_calibration = calibration;
+	return fun_file_set_calibration(&calibration);
+}
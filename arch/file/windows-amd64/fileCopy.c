@@ -0,0 +1,286 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <stdbool.h>
+
+/*
+ * Whole files go through CopyFileExW, which lets the filesystem or the
+ * SMB server do the work (block cloning on ReFS, offloaded copy on SMB).
+ * It runs to completion inside one poll, reporting progress from its
+ * callback.  Windows has no general in-kernel range copy, so ranges are
+ * copied through a bounce buffer, FILE_COPY_STEP_BYTES per poll.
+ */
+
+#define FILE_COPY_BOUNCE_BYTES (1ULL << 20)
+
+typedef struct {
+	FileCopy parameters;
+	bool files_opened;
+	HANDLE source;
+	HANDLE destination;
+	uint64_t copied;
+	Memory bounce;
+} CopyState;
+
+static DWORD CALLBACK copy_progress(LARGE_INTEGER total_size,
+									LARGE_INTEGER transferred,
+									LARGE_INTEGER stream_size,
+									LARGE_INTEGER stream_transferred,
+									DWORD stream_number, DWORD reason,
+									HANDLE source, HANDLE destination,
+									LPVOID context)
+{
+	uint64_t *bytes_copied = (uint64_t *)context;
+	if (bytes_copied)
+		*bytes_copied = (uint64_t)transferred.QuadPart;
+	return PROGRESS_CONTINUE;
+}
+
+static bool copy_wide_path(String path, wchar_t *wide_path)
+{
+	return MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, MAX_PATH) !=
+		   0;
+}
+
+static bool copy_file_identity(const wchar_t *path,
+							   BY_HANDLE_FILE_INFORMATION *info)
+{
+	HANDLE file = CreateFileW(path, FILE_READ_ATTRIBUTES,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE |
+								  FILE_SHARE_DELETE,
+							  NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	BOOL found = GetFileInformationByHandle(file, info);
+	CloseHandle(file);
+	return found;
+}
+
+/* Paths differ in spelling, links and case; compare the files instead. */
+static bool copy_same_file(const wchar_t *source, const wchar_t *destination)
+{
+	BY_HANDLE_FILE_INFORMATION a;
+	BY_HANDLE_FILE_INFORMATION b;
+	return copy_file_identity(source, &a) &&
+		   copy_file_identity(destination, &b) &&
+		   a.dwVolumeSerialNumber == b.dwVolumeSerialNumber &&
+		   a.nFileIndexHigh == b.nFileIndexHigh &&
+		   a.nFileIndexLow == b.nFileIndexLow;
+}
+
+static ErrorResult copy_flush(String path)
+{
+	wchar_t wide_path[MAX_PATH];
+	if (!copy_wide_path(path, wide_path))
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+	HANDLE file = CreateFileW(wide_path, GENERIC_WRITE,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return fun_error_result(GetLastError(), "Failed to open copy");
+	BOOL flushed = FlushFileBuffers(file);
+	DWORD error = flushed ? ERROR_SUCCESS : GetLastError();
+	CloseHandle(file);
+	if (!flushed)
+		return fun_error_result(error, "Failed to sync copy");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static AsyncStatus poll_copy_file(AsyncResult *result)
+{
+	CopyState *state = (CopyState *)result->state;
+	FileCopy *parameters = &state->parameters;
+	wchar_t source_path[MAX_PATH];
+	wchar_t destination_path[MAX_PATH];
+
+	if (!copy_wide_path(parameters->source_path, source_path) ||
+		!copy_wide_path(parameters->destination_path, destination_path))
+		result->error =
+			fun_error_result(GetLastError(), "Failed to convert file path");
+	else if (copy_same_file(source_path, destination_path))
+		result->error = ERROR_RESULT_FILE_COPY_SAME_FILE;
+	else if (!CopyFileExW(source_path, destination_path, copy_progress,
+						  parameters->bytes_copied, NULL, 0))
+		result->error = fun_error_result(GetLastError(), "File copy failed");
+	else if (parameters->durability_mode != FILE_DURABILITY_ASYNC)
+		result->error = copy_flush(parameters->destination_path);
+
+	fun_memory_free((Memory *)&state);
+	return fun_error_is_ok(result->error) ? ASYNC_COMPLETED : ASYNC_ERROR;
+}
+
+static ErrorResult copy_open_range(CopyState *state)
+{
+	wchar_t wide_path[MAX_PATH];
+	if (!copy_wide_path(state->parameters.source_path, wide_path))
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+	state->source = CreateFileW(wide_path, GENERIC_READ,
+								FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+								NULL);
+	if (state->source == INVALID_HANDLE_VALUE)
+		return fun_error_result(GetLastError(), "Failed to open copy source");
+
+	if (!copy_wide_path(state->parameters.destination_path, wide_path))
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+	state->destination = CreateFileW(wide_path, GENERIC_WRITE,
+									 FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+									 OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (state->destination == INVALID_HANDLE_VALUE)
+		return fun_error_result(GetLastError(),
+								"Failed to open copy destination");
+
+	/* The bounce buffer would read bytes it already overwrote. */
+	BY_HANDLE_FILE_INFORMATION a;
+	BY_HANDLE_FILE_INFORMATION b;
+	FileCopy *parameters = &state->parameters;
+	if (GetFileInformationByHandle(state->source, &a) &&
+		GetFileInformationByHandle(state->destination, &b) &&
+		a.dwVolumeSerialNumber == b.dwVolumeSerialNumber &&
+		a.nFileIndexHigh == b.nFileIndexHigh &&
+		a.nFileIndexLow == b.nFileIndexLow &&
+		parameters->source_offset <
+			parameters->destination_offset + parameters->bytes &&
+		parameters->destination_offset <
+			parameters->source_offset + parameters->bytes)
+		return ERROR_RESULT_FILE_COPY_OVERLAP;
+
+	MemoryResult allocation = fun_memory_allocate(FILE_COPY_BOUNCE_BYTES);
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+	state->bounce = allocation.value;
+	state->files_opened = true;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/* Copy up to bytes through the bounce buffer; 0 at end of source. */
+static DWORD copy_range_step(CopyState *state, uint64_t bytes,
+							 uint64_t *moved)
+{
+	FileCopy *parameters = &state->parameters;
+	*moved = 0;
+	while (*moved < bytes) {
+		uint64_t chunk = bytes - *moved;
+		if (chunk > FILE_COPY_BOUNCE_BYTES)
+			chunk = FILE_COPY_BOUNCE_BYTES;
+		uint64_t read_at = parameters->source_offset + state->copied + *moved;
+		OVERLAPPED overlapped = { 0 };
+		overlapped.Offset = (DWORD)read_at;
+		overlapped.OffsetHigh = (DWORD)(read_at >> 32);
+		DWORD transferred = 0;
+		if (!ReadFile(state->source, state->bounce, (DWORD)chunk, &transferred,
+					  &overlapped)) {
+			DWORD error = GetLastError();
+			return error == ERROR_HANDLE_EOF ? ERROR_SUCCESS : error;
+		}
+		if (transferred == 0)
+			return ERROR_SUCCESS;
+
+		uint64_t write_at =
+			parameters->destination_offset + state->copied + *moved;
+		overlapped = (OVERLAPPED){ 0 };
+		overlapped.Offset = (DWORD)write_at;
+		overlapped.OffsetHigh = (DWORD)(write_at >> 32);
+		DWORD written = 0;
+		if (!WriteFile(state->destination, state->bounce, transferred,
+					   &written, &overlapped))
+			return GetLastError();
+		*moved += written;
+	}
+	return ERROR_SUCCESS;
+}
+
+static AsyncStatus poll_copy_range(AsyncResult *result)
+{
+	CopyState *state = (CopyState *)result->state;
+	FileCopy *parameters = &state->parameters;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->files_opened) {
+		result->error = copy_open_range(state);
+		if (fun_error_is_error(result->error)) {
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+
+	if (state->copied < parameters->bytes) {
+		uint64_t bytes = parameters->bytes - state->copied;
+		if (bytes > FILE_COPY_STEP_BYTES)
+			bytes = FILE_COPY_STEP_BYTES;
+		uint64_t moved = 0;
+		DWORD error = copy_range_step(state, bytes, &moved);
+		state->copied += moved;
+		if (parameters->bytes_copied)
+			*parameters->bytes_copied = state->copied;
+		if (error != ERROR_SUCCESS) {
+			result->error = fun_error_result(error, "File copy failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (moved < bytes) {
+			result->error = ERROR_RESULT_FILE_UNEXPECTED_EOF;
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (state->copied < parameters->bytes)
+			return ASYNC_PENDING;
+	}
+
+	if (parameters->durability_mode != FILE_DURABILITY_ASYNC &&
+		!FlushFileBuffers(state->destination)) {
+		result->error = fun_error_result(GetLastError(), "Failed to sync copy");
+		final_status = ASYNC_ERROR;
+	}
+
+cleanup:
+	if (state->source != INVALID_HANDLE_VALUE)
+		CloseHandle(state->source);
+	if (state->destination != INVALID_HANDLE_VALUE)
+		CloseHandle(state->destination);
+	if (state->bounce)
+		fun_memory_free(&state->bounce);
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+static AsyncResult create_copy(FileCopy parameters, bool whole_file)
+{
+	if (!parameters.source_path || !parameters.destination_path)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (!whole_file &&
+		(parameters.bytes > UINT64_MAX - parameters.source_offset ||
+		 parameters.bytes > UINT64_MAX - parameters.destination_offset))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	if (parameters.bytes_copied)
+		*parameters.bytes_copied = 0;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(CopyState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	CopyState *state = (CopyState *)allocation.value;
+	*state = (CopyState){ .parameters = parameters,
+						  .source = INVALID_HANDLE_VALUE,
+						  .destination = INVALID_HANDLE_VALUE };
+
+	return (AsyncResult){ .state = state,
+						  .poll = whole_file ? poll_copy_file :
+											   poll_copy_range,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult fun_file_copy(FileCopy parameters)
+{
+	return create_copy(parameters, true);
+}
+
+AsyncResult fun_file_copy_range(FileCopy parameters)
+{
+	return create_copy(parameters, false);
+}
@@ -0,0 +1,360 @@
+#include "fileDirect.h"
+#include "fileAdaptive.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <windows.h>
+
+typedef enum {
+	DIRECT_READ,
+	DIRECT_WRITE,
+	DIRECT_APPEND,
+} DirectOperation;
+
+typedef struct {
+	DirectOperation operation;
+	String file_path;
+	Memory buffer; /* destination for reads, source for writes */
+	uint64_t bytes;
+	uint64_t offset; /* appends: resolved to the file size at open */
+	FileDurabilityMode durability_mode;
+	FileAdaptiveState *adaptive;
+	HANDLE file_handle;
+	uint64_t original_size; /* writes: size before, to trim block padding */
+	uint64_t written_end; /* writes: furthest byte written, padding included */
+	uint64_t bytes_transferred;
+	Memory bounce_allocation;
+	char *bounce; /* bounce_allocation rounded up to the alignment */
+} DirectState;
+
+uint64_t fun_file_direct_alignment(void)
+{
+	static uint64_t cached = 0;
+	if (cached == 0) {
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		cached = info.dwPageSize ? info.dwPageSize : 4096;
+	}
+	return cached;
+}
+
+/* ReadFile / WriteFile at position; reading at or past EOF yields 0 bytes. */
+static BOOL direct_transfer(DirectState *state, bool write, void *memory,
+							uint64_t length, uint64_t position,
+							DWORD *transferred)
+{
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = (DWORD)position;
+	overlapped.OffsetHigh = (DWORD)(position >> 32);
+	*transferred = 0;
+	BOOL ok = write ? WriteFile(state->file_handle, memory, (DWORD)length,
+								transferred, &overlapped) :
+					  ReadFile(state->file_handle, memory, (DWORD)length,
+							   transferred, &overlapped);
+	if (!ok && !write && GetLastError() == ERROR_HANDLE_EOF) {
+		*transferred = 0;
+		return TRUE;
+	}
+	return ok;
+}
+
+static DWORD direct_open(DirectState *state)
+{
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, state->file_path, -1, wide_path,
+							MAX_PATH) == 0)
+		return GetLastError();
+
+	bool read = state->operation == DIRECT_READ;
+	DWORD access = read ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+	DWORD disposition = read ? OPEN_EXISTING : OPEN_ALWAYS;
+	state->file_handle =
+		CreateFileW(wide_path, access, FILE_SHARE_READ | FILE_SHARE_WRITE,
+					NULL, disposition,
+					FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, NULL);
+	if (state->file_handle == INVALID_HANDLE_VALUE &&
+		GetLastError() == ERROR_INVALID_PARAMETER)
+		state->file_handle = CreateFileW(
+			wide_path, access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+			disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (state->file_handle == INVALID_HANDLE_VALUE)
+		return GetLastError();
+
+	if (!read) {
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(state->file_handle, &size))
+			return GetLastError();
+		state->original_size = (uint64_t)size.QuadPart;
+		if (state->operation == DIRECT_APPEND)
+			state->offset = state->original_size;
+	}
+	return ERROR_SUCCESS;
+}
+
+static bool direct_bounce(DirectState *state)
+{
+	if (state->bounce)
+		return true;
+	uint64_t alignment = fun_file_direct_alignment();
+	MemoryResult allocation =
+		fun_memory_allocate(FILE_DIRECT_BOUNCE_BYTES + alignment);
+	if (fun_error_is_error(allocation.error))
+		return false;
+	state->bounce_allocation = allocation.value;
+	uintptr_t address = (uintptr_t)allocation.value;
+	state->bounce =
+		(char *)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	return true;
+}
+
+/* Read alignment bytes at block into bounce + at, zero-filling past EOF. */
+static DWORD direct_read_block(DirectState *state, uint64_t at, uint64_t block)
+{
+	uint64_t alignment = fun_file_direct_alignment();
+	DWORD transferred;
+	if (!direct_transfer(state, false, state->bounce + at, alignment, block,
+						 &transferred))
+		return GetLastError();
+	if (transferred < alignment)
+		fun_memory_fill(state->bounce + at + transferred,
+						alignment - transferred, 0);
+	return ERROR_SUCCESS;
+}
+
+/* One chunk; *count receives bytes moved (0 at end of file). */
+static DWORD direct_read_step(DirectState *state, uint64_t *count)
+{
+	uint64_t alignment = fun_file_direct_alignment();
+	uint64_t position = state->offset + state->bytes_transferred;
+	uint64_t remaining = state->bytes - state->bytes_transferred;
+	char *output = (char *)state->buffer + state->bytes_transferred;
+	DWORD transferred;
+
+	if (position % alignment == 0 && (uintptr_t)output % alignment == 0 &&
+		remaining >= alignment) {
+		uint64_t length = remaining - remaining % alignment;
+		if (length > FILE_DIRECT_MAX_IO_BYTES)
+			length = FILE_DIRECT_MAX_IO_BYTES;
+		if (!direct_transfer(state, false, output, length, position,
+							 &transferred))
+			return GetLastError();
+		*count = transferred;
+		return ERROR_SUCCESS;
+	}
+
+	if (!direct_bounce(state))
+		return ERROR_NOT_ENOUGH_MEMORY;
+
+	uint64_t block = position - position % alignment;
+	uint64_t head = position - block;
+	uint64_t span = head + remaining;
+	span = (span + alignment - 1) & ~(alignment - 1);
+	if (span > FILE_DIRECT_BOUNCE_BYTES)
+		span = FILE_DIRECT_BOUNCE_BYTES;
+
+	if (!direct_transfer(state, false, state->bounce, span, block,
+						 &transferred))
+		return GetLastError();
+	*count = 0;
+	if (transferred > head) {
+		*count = transferred - head;
+		if (*count > remaining)
+			*count = remaining;
+		fun_memory_copy(state->bounce + head, output, *count);
+	}
+	return ERROR_SUCCESS;
+}
+
+/* One chunk; *count receives bytes of the caller's data written. */
+static DWORD direct_write_step(DirectState *state, uint64_t *count)
+{
+	uint64_t alignment = fun_file_direct_alignment();
+	uint64_t position = state->offset + state->bytes_transferred;
+	uint64_t remaining = state->bytes - state->bytes_transferred;
+	char *input = (char *)state->buffer + state->bytes_transferred;
+	DWORD transferred;
+
+	if (position % alignment == 0 && (uintptr_t)input % alignment == 0 &&
+		remaining >= alignment) {
+		uint64_t length = remaining - remaining % alignment;
+		if (length > FILE_DIRECT_MAX_IO_BYTES)
+			length = FILE_DIRECT_MAX_IO_BYTES;
+		if (!direct_transfer(state, true, input, length, position,
+							 &transferred))
+			return GetLastError();
+		if (position + transferred > state->written_end)
+			state->written_end = position + transferred;
+		*count = transferred;
+		return ERROR_SUCCESS;
+	}
+
+	if (!direct_bounce(state))
+		return ERROR_NOT_ENOUGH_MEMORY;
+
+	uint64_t block = position - position % alignment;
+	uint64_t head = position - block;
+	uint64_t span = head + remaining;
+	span = (span + alignment - 1) & ~(alignment - 1);
+	if (span > FILE_DIRECT_BOUNCE_BYTES)
+		span = FILE_DIRECT_BOUNCE_BYTES;
+	*count = span - head;
+	if (*count > remaining)
+		*count = remaining;
+
+	/* Keep the bytes around the caller's data in partially covered blocks. */
+	DWORD error;
+	if (head > 0 && (error = direct_read_block(state, 0, block)))
+		return error;
+	uint64_t tail = span - alignment;
+	if ((head + *count) % alignment != 0 && (head == 0 || tail > 0) &&
+		(error = direct_read_block(state, tail, block + tail)))
+		return error;
+
+	fun_memory_copy(input, state->bounce + head, *count);
+	if (!direct_transfer(state, true, state->bounce, span, block,
+						 &transferred))
+		return GetLastError();
+	if (transferred <= head)
+		return ERROR_WRITE_FAULT;
+	if (block + transferred > state->written_end)
+		state->written_end = block + transferred;
+	if (transferred - head < *count)
+		*count = transferred - head;
+	return ERROR_SUCCESS;
+}
+
+/* Trim block padding, then flush as durability_mode asks. */
+static DWORD direct_finish_write(DirectState *state)
+{
+	uint64_t end = state->offset + state->bytes;
+	if (end < state->original_size)
+		end = state->original_size;
+	if (state->written_end > end) {
+		FILE_END_OF_FILE_INFO info = { .EndOfFile.QuadPart =
+										   (LONGLONG)end };
+		if (!SetFileInformationByHandle(state->file_handle, FileEndOfFileInfo,
+										&info, sizeof(info)))
+			return GetLastError();
+	}
+
+	if (state->durability_mode != FILE_DURABILITY_ASYNC &&
+		!FlushFileBuffers(state->file_handle))
+		return GetLastError();
+	return ERROR_SUCCESS;
+}
+
+static AsyncStatus poll_direct(AsyncResult *result)
+{
+	DirectState *state = (DirectState *)result->state;
+	FileAdaptiveState *adaptive = state->adaptive;
+	uint64_t bytes = state->bytes;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (state->file_handle == INVALID_HANDLE_VALUE) {
+		DWORD error = direct_open(state);
+		if (error != ERROR_SUCCESS) {
+			result->error = fun_error_result(error, "Failed to open file");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (state->bytes > 0)
+			return ASYNC_PENDING;
+	}
+
+	if (state->bytes_transferred < state->bytes) {
+		uint64_t count = 0;
+		DWORD error = state->operation == DIRECT_READ ?
+						  direct_read_step(state, &count) :
+						  direct_write_step(state, &count);
+		if (error != ERROR_SUCCESS) {
+			result->error = fun_error_result(
+				error, state->operation == DIRECT_READ ?
+						   "Direct read failed" :
+						   "Direct write failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		if (count == 0) {
+			result->error = ERROR_RESULT_FILE_UNEXPECTED_EOF;
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+		state->bytes_transferred += count;
+		if (state->bytes_transferred < state->bytes)
+			return ASYNC_PENDING;
+	}
+
+	if (state->operation != DIRECT_READ) {
+		DWORD error = direct_finish_write(state);
+		if (error != ERROR_SUCCESS) {
+			result->error = fun_error_result(error, "Direct write failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+
+	result->error = ERROR_RESULT_NO_ERROR;
+
+cleanup:
+	if (state->file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(state->file_handle);
+	if (state->bounce_allocation)
+		fun_memory_free(&state->bounce_allocation);
+	fun_memory_free((Memory *)&state);
+	if (final_status == ASYNC_COMPLETED)
+		file_adaptive_update(adaptive, bytes);
+	return final_status;
+}
+
+static AsyncResult create_direct(DirectState initial)
+{
+	MemoryResult allocation = fun_memory_allocate(sizeof(DirectState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	DirectState *state = (DirectState *)allocation.value;
+	*state = initial;
+	state->file_handle = INVALID_HANDLE_VALUE;
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_direct,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult create_direct_read(Read parameters)
+{
+	return create_direct((DirectState){ .operation = DIRECT_READ,
+										.file_path = parameters.file_path,
+										.buffer = parameters.output,
+										.bytes = parameters.bytes_to_read,
+										.offset = parameters.offset,
+										.adaptive = parameters.adaptive });
+}
+
+AsyncResult create_direct_write(Write parameters)
+{
+	return create_direct(
+		(DirectState){ .operation = DIRECT_WRITE,
+					   .file_path = parameters.file_path,
+					   .buffer = parameters.input,
+					   .bytes = parameters.bytes_to_write,
+					   .offset = parameters.offset,
+					   .durability_mode = parameters.durability_mode,
+					   .adaptive = parameters.adaptive });
+}
+
+/*
+ * The end of file is sampled at open, so two concurrent direct appends
+ * to one file may overwrite each other.
+ */
+AsyncResult create_direct_append(Append parameters)
+{
+	return create_direct(
+		(DirectState){ .operation = DIRECT_APPEND,
+					   .file_path = parameters.file_path,
+					   .buffer = parameters.input,
+					   .bytes = parameters.bytes_to_append,
+					   .durability_mode = parameters.durability_mode,
+					   .adaptive = parameters.adaptive });
+}
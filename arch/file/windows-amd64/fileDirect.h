@@ -0,0 +1,23 @@
+#pragma once
+#include "fundamental/file/file.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * FILE_MODE_DIRECT: ReadFile / WriteFile at explicit offsets on a handle
+ * opened with FILE_FLAG_NO_BUFFERING, one chunk per poll.  Aligned chunks
+ * use the caller's buffer; unaligned heads and tails go through an
+ * aligned bounce buffer with read-modify-write of partial blocks, and the
+ * file is trimmed back when the last block ran past the requested end.
+ * When the volume refuses unbuffered I/O the operation runs buffered.
+ */
+
+/* Largest aligned transfer issued straight from the caller's buffer. */
+#define FILE_DIRECT_MAX_IO_BYTES (64ULL << 20)
+/* Size of the bounce buffer, allocated only when a chunk is unaligned. */
+#define FILE_DIRECT_BOUNCE_BYTES (1ULL << 20)
+
+AsyncResult create_direct_read(Read parameters);
+AsyncResult create_direct_write(Write parameters);
+AsyncResult create_direct_append(Append parameters);
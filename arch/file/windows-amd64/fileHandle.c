@@ -0,0 +1,271 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+/* ReadFile / WriteFile take a DWORD length; stay well below it. */
+#define FILE_HANDLE_MAX_IO_BYTES (1ULL << 30)
+
+typedef struct {
+	HANDLE file_handle;
+	uint32_t flags; /* FileOpenFlags the handle was opened with */
+	/* FILE_OPEN_PREALLOCATE only */
+	uint64_t chunk; /* growth step */
+	uint64_t logical_size; /* end of file; the next append goes here */
+	uint64_t allocated_size; /* reserved with FileAllocationInfo */
+} FileHandleState;
+
+static volatile LONG64 g_preallocation_chunk = FILE_PREALLOCATION_DEFAULT_CHUNK;
+
+ErrorResult fun_file_set_preallocation_chunk(uint64_t bytes)
+{
+	if (bytes == 0 || bytes > FILE_PREALLOCATION_MAX_CHUNK)
+		return ERROR_RESULT_FILE_INVALID_PREALLOCATION;
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	uint64_t page = si.dwPageSize;
+	bytes = (bytes + page - 1) / page * page;
+	InterlockedExchange64(&g_preallocation_chunk, (LONG64)bytes);
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/*
+ * Reserve clusters up to the next chunk boundary past end.  The file size
+ * is unchanged, so appends stay ordinary writes; NTFS releases whatever is
+ * left unused when the last handle closes.
+ */
+static DWORD reserve_allocation(FileHandleState *state, uint64_t end)
+{
+	if (end <= state->allocated_size)
+		return ERROR_SUCCESS;
+	uint64_t target = (end + state->chunk - 1) / state->chunk * state->chunk;
+	FILE_ALLOCATION_INFO info = { 0 };
+	info.AllocationSize.QuadPart = (LONGLONG)target;
+	if (!SetFileInformationByHandle(state->file_handle, FileAllocationInfo,
+									&info, sizeof(info)))
+		return GetLastError();
+	state->allocated_size = target;
+	return ERROR_SUCCESS;
+}
+
+ErrorResult fun_file_open(String filePath, uint32_t flags,
+						  FileHandle *outHandle)
+{
+	if (!filePath || !outHandle)
+		return ERROR_RESULT_NULL_POINTER;
+
+	bool read = flags & FILE_OPEN_READ;
+	bool write = flags & (FILE_OPEN_WRITE | FILE_OPEN_APPEND);
+	bool preallocate = flags & FILE_OPEN_PREALLOCATE;
+	if ((!read && !write) || ((flags & FILE_OPEN_TRUNCATE) && !write) ||
+		(preallocate && !(flags & FILE_OPEN_APPEND)))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+
+	DWORD access = 0;
+	if (read)
+		access |= GENERIC_READ;
+	/* FileAllocationInfo needs write access, not just append. */
+	if (preallocate)
+		access |= GENERIC_WRITE;
+	else if (flags & FILE_OPEN_APPEND)
+		access |= FILE_APPEND_DATA | SYNCHRONIZE;
+	else if (write)
+		access |= GENERIC_WRITE;
+
+	DWORD disposition = OPEN_EXISTING;
+	if (write)
+		disposition = (flags & FILE_OPEN_TRUNCATE) ? CREATE_ALWAYS :
+													  OPEN_ALWAYS;
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, filePath, -1, wide_path, MAX_PATH) ==
+		0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(FileHandleState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+
+	HANDLE file = CreateFileW(wide_path, access,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							  disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		fun_memory_free(&allocation.value);
+		return fun_error_result(GetLastError(), "Failed to open file");
+	}
+
+	FileHandleState *state = (FileHandleState *)allocation.value;
+	*state = (FileHandleState){ .file_handle = file, .flags = flags };
+	if (preallocate) {
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			DWORD error = GetLastError();
+			CloseHandle(file);
+			fun_memory_free(&allocation.value);
+			return fun_error_result(error, "Failed to get file size");
+		}
+		state->chunk = (uint64_t)InterlockedCompareExchange64(
+			&g_preallocation_chunk, 0, 0);
+		state->logical_size = (uint64_t)size.QuadPart;
+		state->allocated_size = (uint64_t)size.QuadPart;
+	}
+	outHandle->state = state;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_read_at(FileHandle handle, Memory output,
+							 uint64_t bytes_to_read, uint64_t offset)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !output)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!(state->flags & FILE_OPEN_READ))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (bytes_to_read > UINT64_MAX - offset)
+		return ERROR_RESULT_INTEGER_OVERFLOW;
+
+	uint64_t done = 0;
+	while (done < bytes_to_read) {
+		uint64_t chunk = bytes_to_read - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		uint64_t position = offset + done;
+		OVERLAPPED overlapped = { 0 };
+		overlapped.Offset = (DWORD)position;
+		overlapped.OffsetHigh = (DWORD)(position >> 32);
+		DWORD transferred = 0;
+		if (!ReadFile(state->file_handle, (char *)output + done, (DWORD)chunk,
+					  &transferred, &overlapped)) {
+			DWORD error = GetLastError();
+			if (error == ERROR_HANDLE_EOF)
+				return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+			return fun_error_result(error, "File read failed");
+		}
+		if (transferred == 0)
+			return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+		done += transferred;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_write_at(FileHandle handle, Memory input,
+							  uint64_t bytes_to_write, uint64_t offset)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !input)
+		return ERROR_RESULT_NULL_POINTER;
+	/* An append-only handle has no positional write access. */
+	if (!(state->flags & FILE_OPEN_WRITE) || (state->flags & FILE_OPEN_APPEND))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (bytes_to_write > UINT64_MAX - offset)
+		return ERROR_RESULT_INTEGER_OVERFLOW;
+
+	uint64_t done = 0;
+	while (done < bytes_to_write) {
+		uint64_t chunk = bytes_to_write - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		uint64_t position = offset + done;
+		OVERLAPPED overlapped = { 0 };
+		overlapped.Offset = (DWORD)position;
+		overlapped.OffsetHigh = (DWORD)(position >> 32);
+		DWORD transferred = 0;
+		if (!WriteFile(state->file_handle, (const char *)input + done,
+					   (DWORD)chunk, &transferred, &overlapped))
+			return fun_error_result(GetLastError(), "File write failed");
+		done += transferred;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_append(FileHandle handle, Memory input,
+							uint64_t bytes_to_append)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state || !input)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!(state->flags & FILE_OPEN_APPEND))
+		return ERROR_RESULT_FILE_HANDLE_MODE;
+	if (state->chunk) {
+		if (bytes_to_append > UINT64_MAX - state->logical_size)
+			return ERROR_RESULT_INTEGER_OVERFLOW;
+		DWORD error = reserve_allocation(state, state->logical_size +
+													bytes_to_append);
+		if (error != ERROR_SUCCESS)
+			return fun_error_result(error, "Failed to grow file");
+	}
+
+	uint64_t done = 0;
+	while (done < bytes_to_append) {
+		uint64_t chunk = bytes_to_append - done;
+		if (chunk > FILE_HANDLE_MAX_IO_BYTES)
+			chunk = FILE_HANDLE_MAX_IO_BYTES;
+		/* A PREALLOCATE handle has write access, so position by hand. */
+		OVERLAPPED overlapped = { 0 };
+		overlapped.Offset = (DWORD)state->logical_size;
+		overlapped.OffsetHigh = (DWORD)(state->logical_size >> 32);
+		DWORD transferred = 0;
+		if (!WriteFile(state->file_handle, (const char *)input + done,
+					   (DWORD)chunk, &transferred,
+					   state->chunk ? &overlapped : NULL))
+			return fun_error_result(GetLastError(), "File append failed");
+		done += transferred;
+		state->logical_size += transferred;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+CanReturnError(uint64_t) fun_file_handle_size(FileHandle handle)
+{
+	uint64_tResult result = { .value = 0, .error = ERROR_RESULT_NO_ERROR };
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(state->file_handle, &size)) {
+		result.error =
+			fun_error_result(GetLastError(), "Failed to get file size");
+		return result;
+	}
+	result.value = (uint64_t)size.QuadPart;
+	return result;
+}
+
+ErrorResult fun_file_sync(FileHandle handle)
+{
+	FileHandleState *state = (FileHandleState *)handle.state;
+	if (!state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	if (!FlushFileBuffers(state->file_handle))
+		return fun_error_result(GetLastError(), "FlushFileBuffers failed");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_close(FileHandle *handle)
+{
+	if (!handle || !handle->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	FileHandleState *state = (FileHandleState *)handle->state;
+	BOOL closed = CloseHandle(state->file_handle);
+	DWORD error = closed ? 0 : GetLastError();
+	fun_memory_free(&handle->state);
+	handle->state = NULL;
+	if (!closed)
+		return fun_error_result(error, "Failed to close file");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_cache_set_capacity(uint32_t capacity)
+{
+	if (capacity > FILE_CACHE_MAX_CAPACITY)
+		return ERROR_RESULT_FILE_CACHE_INVALID_CAPACITY;
+	/* The path-based calls open a handle each time; 0 is already so. */
+	if (capacity > 0)
+		return ERROR_RESULT_FILE_CACHE_UNSUPPORTED;
+	return ERROR_RESULT_NO_ERROR;
+}
@@ -0,0 +1,166 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <stdbool.h>
+
+/*
+ * LockFileEx locks belong to the handle, like OFD locks on Linux.  On an
+ * overlapped handle a contended LockFileEx returns ERROR_IO_PENDING and
+ * signals the OVERLAPPED event when the lock is granted, so no helper
+ * thread is needed and a timed-out waiter is cancelled with CancelIoEx.
+ */
+
+#define FILE_RANGE_LOCK_POLL_MS 1
+
+typedef struct {
+	FileRangeLock parameters;
+	HANDLE file_handle;
+	OVERLAPPED overlapped;
+	DWORD length_low;
+	DWORD length_high;
+	bool started;
+	bool waiting;
+	ULONGLONG deadline_ms;
+} RangeLockState;
+
+static void range_lock_close(RangeLockState *state)
+{
+	if (state->overlapped.hEvent)
+		CloseHandle(state->overlapped.hEvent);
+	if (state->file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(state->file_handle);
+	fun_memory_free((Memory *)&state);
+}
+
+static ErrorResult range_lock_start(RangeLockState *state)
+{
+	FileRangeLock *parameters = &state->parameters;
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, parameters->file_path, -1, wide_path,
+							MAX_PATH) == 0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+
+	bool shared = parameters->mode == FILE_LOCK_SHARED;
+	state->file_handle = CreateFileW(
+		wide_path, shared ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+		FILE_FLAG_OVERLAPPED, NULL);
+	if (state->file_handle == INVALID_HANDLE_VALUE)
+		return fun_error_result(GetLastError(),
+								"Failed to open file for locking");
+	state->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+	if (!state->overlapped.hEvent)
+		return fun_error_result(GetLastError(), "Failed to create lock event");
+	state->started = true;
+	state->deadline_ms = GetTickCount64() + parameters->timeout_ms;
+
+	DWORD flags = shared ? 0 : LOCKFILE_EXCLUSIVE_LOCK;
+	if (parameters->timeout_ms == 0)
+		flags |= LOCKFILE_FAIL_IMMEDIATELY;
+	if (LockFileEx(state->file_handle, flags, 0, state->length_low,
+				   state->length_high, &state->overlapped))
+		return ERROR_RESULT_NO_ERROR;
+
+	DWORD error = GetLastError();
+	if (error == ERROR_IO_PENDING) {
+		state->waiting = true;
+		return ERROR_RESULT_NO_ERROR;
+	}
+	if (error == ERROR_LOCK_VIOLATION)
+		return ERROR_RESULT_LOCK_TIMEOUT;
+	return fun_error_result(error, "Failed to acquire range lock");
+}
+
+static AsyncStatus poll_range_lock(AsyncResult *result)
+{
+	RangeLockState *state = (RangeLockState *)result->state;
+
+	if (!state->started) {
+		result->error = range_lock_start(state);
+		if (fun_error_is_error(result->error))
+			goto fail;
+	}
+
+	if (state->waiting) {
+		DWORD transferred = 0;
+		if (WaitForSingleObject(state->overlapped.hEvent,
+								FILE_RANGE_LOCK_POLL_MS) == WAIT_TIMEOUT) {
+			if (state->parameters.timeout_ms == FILE_LOCK_WAIT_FOREVER ||
+				GetTickCount64() < state->deadline_ms)
+				return ASYNC_PENDING;
+			CancelIoEx(state->file_handle, &state->overlapped);
+		}
+		/* The lock may be granted despite the cancel; then keep it. */
+		if (!GetOverlappedResult(state->file_handle, &state->overlapped,
+								 &transferred, TRUE)) {
+			DWORD error = GetLastError();
+			if (error == ERROR_OPERATION_ABORTED)
+				result->error = ERROR_RESULT_LOCK_TIMEOUT;
+			else
+				result->error =
+					fun_error_result(error, "Failed to acquire range lock");
+			goto fail;
+		}
+		state->waiting = false;
+	}
+
+	state->parameters.out_lock->state = state;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+
+fail:
+	range_lock_close(state);
+	return ASYNC_ERROR;
+}
+
+AsyncResult fun_file_lock_range(FileRangeLock parameters)
+{
+	if (!parameters.file_path || !parameters.out_lock)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (parameters.length > UINT64_MAX - parameters.offset)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	parameters.out_lock->state = NULL;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(RangeLockState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	/* A zero length covers everything from offset on, as on Linux. */
+	uint64_t length = parameters.length ? parameters.length :
+										  UINT64_MAX - parameters.offset;
+	RangeLockState *state = (RangeLockState *)allocation.value;
+	*state = (RangeLockState){ .parameters = parameters,
+							   .file_handle = INVALID_HANDLE_VALUE,
+							   .length_low = (DWORD)length,
+							   .length_high = (DWORD)(length >> 32) };
+	state->overlapped.Offset = (DWORD)parameters.offset;
+	state->overlapped.OffsetHigh = (DWORD)(parameters.offset >> 32);
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_range_lock,
+						  .status = ASYNC_PENDING };
+}
+
+ErrorResult fun_file_unlock_range(FileLockHandle *lock)
+{
+	if (!lock || !lock->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	RangeLockState *state = (RangeLockState *)lock->state;
+	OVERLAPPED overlapped = { .Offset = state->overlapped.Offset,
+							  .OffsetHigh = state->overlapped.OffsetHigh };
+	BOOL unlocked = UnlockFileEx(state->file_handle, 0, state->length_low,
+								 state->length_high, &overlapped);
+	DWORD error = unlocked ? ERROR_SUCCESS : GetLastError();
+	range_lock_close(state);
+	lock->state = NULL;
+
+	if (!unlocked)
+		return fun_error_result(error, "Failed to release range lock");
+	return ERROR_RESULT_NO_ERROR;
+}
@@ -1,5 +1,6 @@
 #include "fileRead.h"
 #include "fileAdaptive.h"
+#include "fileDirect.h"
 
 AsyncResult fun_read_file_in_memory(Read parameters)
 {
@@ -9,9 +10,14 @@ AsyncResult fun_read_file_in_memory(Read parameters)
 							  .error = ERROR_RESULT_NULL_POINTER };
 	}
 
+	if (parameters.mode == FILE_MODE_DIRECT)
+		return create_direct_read(parameters);
+
 	FileMode mode = parameters.mode;
 	if (mode == FILE_MODE_AUTO)
-		mode = file_adaptive_choose(parameters.adaptive);
+		mode = file_adaptive_choose(parameters.adaptive, FILE_ACCESS_READ,
+									parameters.offset,
+									parameters.bytes_to_read);
 
 	if (mode == FILE_MODE_RING_BASED)
 		return create_ring_read(parameters);
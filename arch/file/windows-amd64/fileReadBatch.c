@@ -0,0 +1,203 @@
+#include "fileRead.h"
+#include "fileRing.h"
+
+typedef struct {
+	FileRingRequest request;
+	HANDLE file_handle;
+	bool owns_handle; /* false when borrowed from an earlier read of the path */
+	bool submitted;
+	bool finished;
+	ErrorResult error;
+} BatchSlot;
+
+typedef struct {
+	Read *reads;
+	size_t count;
+	size_t remaining; /* slots not yet finished */
+	bool opened;
+	BatchSlot slots[];
+} BatchReadState;
+
+static bool path_equal(String a, String b)
+{
+	if (a == b)
+		return true;
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+static void slot_finish(BatchReadState *state, BatchSlot *slot,
+						ErrorResult error)
+{
+	slot->finished = true;
+	slot->error = error;
+	state->remaining--;
+}
+
+/* Open each distinct path once; later reads of it borrow the handle. */
+static void batch_open(BatchReadState *state)
+{
+	for (size_t i = 0; i < state->count; i++) {
+		Read *read = &state->reads[i];
+		BatchSlot *slot = &state->slots[i];
+
+		if (!read->file_path || !read->output) {
+			slot_finish(state, slot, ERROR_RESULT_NULL_POINTER);
+			continue;
+		}
+		if (read->bytes_to_read == 0) {
+			slot_finish(state, slot, ERROR_RESULT_NO_ERROR);
+			continue;
+		}
+		if (read->bytes_to_read > 0xFFFFFFFFULL) {
+			slot_finish(state, slot, ERROR_RESULT_INTEGER_OVERFLOW);
+			continue;
+		}
+
+		for (size_t j = 0; j < i; j++) {
+			if (state->slots[j].file_handle != INVALID_HANDLE_VALUE &&
+				path_equal(state->reads[j].file_path, read->file_path)) {
+				slot->file_handle = state->slots[j].file_handle;
+				break;
+			}
+		}
+		if (slot->file_handle != INVALID_HANDLE_VALUE)
+			continue;
+
+		HANDLE file = CreateFile(read->file_path, GENERIC_READ,
+								 FILE_SHARE_READ, NULL, OPEN_EXISTING,
+								 FILE_FLAG_OVERLAPPED, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			slot_finish(state, slot,
+						fun_error_result(1, "Failed to open file"));
+			continue;
+		}
+		slot->file_handle = file;
+		slot->owns_handle = true;
+	}
+}
+
+/* Build an entry for every slot not yet submitted, then submit them all
+ * at once.  Stops early when the submission queue is full. */
+static void batch_submit(BatchReadState *state)
+{
+	HIORING ring = file_ring_lock();
+	if (!ring) {
+		for (size_t i = 0; i < state->count; i++) {
+			BatchSlot *slot = &state->slots[i];
+			if (!slot->finished && !slot->submitted)
+				slot_finish(state, slot,
+							fun_error_result(1, "CreateIoRing failed"));
+		}
+		return;
+	}
+
+	size_t built = 0;
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->finished || slot->submitted)
+			continue;
+
+		Read *read = &state->reads[i];
+		HRESULT hr = BuildIoRingReadFile(
+			ring, IoRingHandleRefFromHandle(slot->file_handle),
+			file_ring_buffer_ref(read->output, (UINT32)read->bytes_to_read),
+			(UINT32)read->bytes_to_read, read->offset,
+			(UINT_PTR)&slot->request, IOSQE_FLAGS_NONE);
+		if (FAILED(hr))
+			break; /* queue full: the rest go on the next poll */
+		slot->submitted = true;
+		built++;
+	}
+
+	if (built > 0)
+		file_ring_submit_unlock();
+	else
+		file_ring_unlock();
+}
+
+static AsyncStatus poll_read_batch(AsyncResult *result)
+{
+	BatchReadState *state = (BatchReadState *)result->state;
+
+	if (!state->opened) {
+		batch_open(state);
+		state->opened = true;
+	}
+
+	batch_submit(state);
+
+	FileRingRequest *wait = NULL;
+	for (size_t i = 0; i < state->count && !wait; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (!slot->finished && slot->submitted)
+			wait = &slot->request;
+	}
+	if (wait)
+		file_ring_reap(wait);
+
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->finished || !slot->request.done)
+			continue;
+		slot_finish(state, slot,
+					SUCCEEDED(slot->request.result) ?
+						ERROR_RESULT_NO_ERROR :
+						fun_error_result(1, "IoRing read failed"));
+	}
+
+	if (state->remaining > 0)
+		return ASYNC_PENDING;
+
+	AsyncStatus final_status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	for (size_t i = 0; i < state->count; i++) {
+		BatchSlot *slot = &state->slots[i];
+		if (slot->owns_handle)
+			CloseHandle(slot->file_handle);
+		if (state->reads[i].batch_error)
+			*state->reads[i].batch_error = slot->error;
+		if (fun_error_is_error(slot->error) &&
+			final_status == ASYNC_COMPLETED) {
+			result->error = slot->error;
+			final_status = ASYNC_ERROR;
+		}
+	}
+	void *mem = state;
+	fun_memory_free(&mem);
+	return final_status;
+}
+
+AsyncResult fun_read_files_batch(Read *reads, size_t n)
+{
+	if (n == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+	if (!reads)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (n > (SIZE_MAX - sizeof(BatchReadState)) / sizeof(BatchSlot))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+
+	MemoryResult mem_result =
+		fun_memory_allocate(sizeof(BatchReadState) + n * sizeof(BatchSlot));
+	if (fun_error_is_error(mem_result.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = mem_result.error };
+
+	BatchReadState *state = (BatchReadState *)mem_result.value;
+	state->reads = reads;
+	state->count = n;
+	state->remaining = n;
+	state->opened = false;
+	for (size_t i = 0; i < n; i++)
+		state->slots[i] = (BatchSlot){ .file_handle = INVALID_HANDLE_VALUE };
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_read_batch,
+						  .status = ASYNC_PENDING };
+}
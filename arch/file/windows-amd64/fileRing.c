@@ -0,0 +1,186 @@
+#include "fileRing.h"
+
+static HIORING g_ring = NULL;
+static UINT32 g_ring_depth = FILE_RING_DEFAULT_DEPTH;
+static volatile LONG g_ring_lock = 0;
+
+typedef struct {
+	UINT64 base;
+	UINT32 length;
+	UINT32 index; /* position in g_buffer_infos */
+} RegisteredBuffer;
+
+static IORING_BUFFER_INFO g_buffer_infos[FILE_RING_MAX_REGISTERED_BUFFERS];
+/* sorted by base address */
+static RegisteredBuffer g_buffers[FILE_RING_MAX_REGISTERED_BUFFERS];
+static UINT32 g_buffer_count = 0;
+
+static void ring_lock(void)
+{
+	while (InterlockedCompareExchange(&g_ring_lock, 1, 0) != 0)
+		YieldProcessor();
+}
+
+HIORING file_ring_lock(void)
+{
+	ring_lock();
+	if (!g_ring) {
+		IORING_CREATE_FLAGS flags = {
+			.Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE,
+			.Required = IORING_CREATE_REQUIRED_FLAGS_NONE
+		};
+		HRESULT hr = CreateIoRing(IORING_VERSION_1, flags, g_ring_depth,
+								  g_ring_depth * 2, &g_ring);
+		if (FAILED(hr)) {
+			g_ring = NULL;
+			file_ring_unlock();
+			return NULL;
+		}
+	}
+	return g_ring;
+}
+
+void file_ring_unlock(void)
+{
+	InterlockedExchange(&g_ring_lock, 0);
+}
+
+HRESULT file_ring_submit_unlock(void)
+{
+	UINT32 submitted;
+	HRESULT hr = SubmitIoRing(g_ring, 0, 0, &submitted);
+	file_ring_unlock();
+	return hr;
+}
+
+bool file_ring_reap(FileRingRequest *request)
+{
+	IORING_CQE cqe;
+
+	ring_lock();
+	while (g_ring && PopIoRingCompletion(g_ring, &cqe) == S_OK) {
+		FileRingRequest *owner = (FileRingRequest *)cqe.UserData;
+		if (owner) {
+			owner->result = cqe.ResultCode;
+			owner->done = true;
+		}
+	}
+	bool done = request->done;
+	file_ring_unlock();
+	return done;
+}
+
+ErrorResult fun_file_ring_set_depth(uint32_t depth)
+{
+	if (depth == 0 || depth > FILE_RING_MAX_DEPTH)
+		return ERROR_RESULT_FILE_RING_INVALID_DEPTH;
+
+	ErrorResult result = ERROR_RESULT_NO_ERROR;
+	ring_lock();
+	if (g_ring)
+		result = ERROR_RESULT_FILE_RING_BUSY;
+	else
+		g_ring_depth = depth;
+	file_ring_unlock();
+	return result;
+}
+
+IORING_BUFFER_REF file_ring_buffer_ref(void *pointer, UINT32 length)
+{
+	UINT64 addr = (UINT64)(UINT_PTR)pointer;
+	UINT32 low = 0;
+	UINT32 high = g_buffer_count;
+	while (low < high) {
+		UINT32 mid = low + (high - low) / 2;
+		if (g_buffers[mid].base <= addr)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low > 0) {
+		RegisteredBuffer *buffer = &g_buffers[low - 1];
+		UINT64 offset = addr - buffer->base;
+		if (offset <= buffer->length && length <= buffer->length - offset)
+			return IoRingBufferRefFromIndexAndOffset(buffer->index,
+													 (UINT32)offset);
+	}
+	return IoRingBufferRefFromPointer(pointer);
+}
+
+/* Submit the registration entry and wait for its completion. */
+static HRESULT ring_register_locked(UINT32 count)
+{
+	FileRingRequest request = { 0 };
+	HRESULT hr = BuildIoRingRegisterBuffers(g_ring, count,
+											count ? g_buffer_infos : NULL,
+											(UINT_PTR)&request);
+	if (FAILED(hr))
+		return hr;
+
+	UINT32 submitted;
+	hr = SubmitIoRing(g_ring, 1, INFINITE, &submitted);
+	if (FAILED(hr))
+		return hr;
+
+	IORING_CQE cqe;
+	while (!request.done && PopIoRingCompletion(g_ring, &cqe) == S_OK) {
+		FileRingRequest *owner = (FileRingRequest *)cqe.UserData;
+		if (owner) {
+			owner->result = cqe.ResultCode;
+			owner->done = true;
+		}
+	}
+	return request.done ? request.result : E_FAIL;
+}
+
+ErrorResult fun_file_ring_register_buffers(const Memory *buffers,
+										   const uint64_t *sizes,
+										   uint32_t count)
+{
+	if (!buffers || !sizes)
+		return ERROR_RESULT_NULL_POINTER;
+	if (count == 0 || count > FILE_RING_MAX_REGISTERED_BUFFERS)
+		return ERROR_RESULT_FILE_RING_INVALID_BUFFER;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!buffers[i])
+			return ERROR_RESULT_NULL_POINTER;
+		if (sizes[i] == 0 || sizes[i] > FILE_RING_MAX_REGISTERED_BUFFER_SIZE)
+			return ERROR_RESULT_FILE_RING_INVALID_BUFFER;
+	}
+
+	if (!file_ring_lock())
+		return fun_error_result(1, "CreateIoRing failed");
+
+	/* Insertion sort by base address for file_ring_buffer_ref. */
+	for (uint32_t i = 0; i < count; i++) {
+		g_buffer_infos[i] = (IORING_BUFFER_INFO){ .Address = buffers[i],
+												  .Length = (UINT32)sizes[i] };
+		RegisteredBuffer entry = { .base = (UINT64)(UINT_PTR)buffers[i],
+								   .length = (UINT32)sizes[i],
+								   .index = i };
+		uint32_t j = i;
+		while (j > 0 && g_buffers[j - 1].base > entry.base) {
+			g_buffers[j] = g_buffers[j - 1];
+			j--;
+		}
+		g_buffers[j] = entry;
+	}
+
+	HRESULT hr = ring_register_locked(count);
+	g_buffer_count = SUCCEEDED(hr) ? count : 0;
+	file_ring_unlock();
+	if (FAILED(hr))
+		return fun_error_result(1, "Failed to register ring buffers");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_ring_unregister_buffers(void)
+{
+	ring_lock();
+	/* IoRing has no unregister; an empty set replaces the old one. */
+	if (g_ring && g_buffer_count > 0)
+		ring_register_locked(0);
+	g_buffer_count = 0;
+	file_ring_unlock();
+	return ERROR_RESULT_NO_ERROR;
+}
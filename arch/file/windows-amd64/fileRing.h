@@ -0,0 +1,43 @@
+#pragma once
+#include "fundamental/file/file.h"
+
+#include <windows.h>
+
+#undef NTDDI_VERSION
+#define NTDDI_VERSION NTDDI_WIN10_NI
+
+#include "ioringcompat.h"
+#include <ioringapi.h>
+
+/*
+ * Shared IoRing for FILE_MODE_RING_BASED operations.
+ *
+ * One ring per process, created on first use with the depth set by
+ * fun_file_ring_set_depth.  Completions are routed back through UserData,
+ * which points at the caller's FileRingRequest, so an operation never
+ * swallows another operation's completion.
+ */
+
+typedef struct {
+	HRESULT result; /* cqe.ResultCode, valid once done */
+	bool done;
+} FileRingRequest;
+
+/*
+ * Lock the ring (creating it on first use) so the caller can build one
+ * entry.  Returns NULL, unlocked, if the ring could not be created.
+ * Follow with file_ring_submit_unlock, or file_ring_unlock on failure.
+ */
+HIORING file_ring_lock(void);
+void file_ring_unlock(void);
+HRESULT file_ring_submit_unlock(void);
+
+/* Route every available completion; true once request->done. */
+bool file_ring_reap(FileRingRequest *request);
+
+/*
+ * Reference to length bytes at pointer: a registered buffer (index and
+ * offset) when one registered with fun_file_ring_register_buffers holds
+ * them, else the plain pointer.  Call with the ring locked.
+ */
+IORING_BUFFER_REF file_ring_buffer_ref(void *pointer, UINT32 length);
@@ -0,0 +1,112 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/error/error.h"
+
+#include <stdbool.h>
+
+static uint64_t view_granularity(void)
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return si.dwAllocationGranularity;
+}
+
+ErrorResult fun_file_map_view(String file_path, uint64_t offset,
+							  uint64_t length, uint32_t flags,
+							  FileView *out_view)
+{
+	if (!file_path || !out_view)
+		return ERROR_RESULT_NULL_POINTER;
+	if ((flags & FILE_VIEW_SEQUENTIAL) && (flags & FILE_VIEW_RANDOM))
+		return ERROR_RESULT_FILE_VIEW_INVALID_FLAGS;
+	*out_view = (FileView){ 0 };
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, file_path, -1, wide_path, MAX_PATH) ==
+		0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+
+	/* The cache manager takes the access pattern from the open flags. */
+	DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+	if (flags & FILE_VIEW_SEQUENTIAL)
+		attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+	if (flags & FILE_VIEW_RANDOM)
+		attributes |= FILE_FLAG_RANDOM_ACCESS;
+
+	HANDLE file = CreateFileW(wide_path, GENERIC_READ,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE |
+								  FILE_SHARE_DELETE,
+							  NULL, OPEN_EXISTING, attributes, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return fun_error_result(GetLastError(), "Failed to open file");
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		DWORD error = GetLastError();
+		CloseHandle(file);
+		return fun_error_result(error, "Failed to get file size");
+	}
+
+	uint64_t file_size = (uint64_t)size.QuadPart;
+	if (offset > file_size ||
+		(length != 0 && length > file_size - offset)) {
+		CloseHandle(file);
+		return ERROR_RESULT_FILE_UNEXPECTED_EOF;
+	}
+	if (length == 0)
+		length = file_size - offset;
+	if (length == 0) {
+		CloseHandle(file);
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	bool copy_on_write = flags & FILE_VIEW_PRIVATE;
+	HANDLE mapping_handle = CreateFileMappingW(
+		file, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0,
+		NULL);
+	DWORD error = mapping_handle ? ERROR_SUCCESS : GetLastError();
+	CloseHandle(file);
+	if (!mapping_handle)
+		return fun_error_result(error, "CreateFileMappingW failed");
+
+	uint64_t granularity = view_granularity();
+	uint64_t aligned_offset = offset - offset % granularity;
+	uint64_t mapping_length = length + (offset - aligned_offset);
+	void *mapping = MapViewOfFile(
+		mapping_handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ,
+		(DWORD)(aligned_offset >> 32), (DWORD)aligned_offset,
+		(SIZE_T)mapping_length);
+	error = mapping ? ERROR_SUCCESS : GetLastError();
+	/* The view keeps the section alive; the handles can go. */
+	CloseHandle(mapping_handle);
+	if (!mapping)
+		return fun_error_result(error, "MapViewOfFile failed");
+
+	/* No MAP_POPULATE: prefetching the range is the nearest equivalent. */
+	if (flags & (FILE_VIEW_WILLNEED | FILE_VIEW_POPULATE)) {
+		WIN32_MEMORY_RANGE_ENTRY range = { .VirtualAddress = mapping,
+										   .NumberOfBytes =
+											   (SIZE_T)mapping_length };
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+
+	*out_view = (FileView){ .data = (const char *)mapping +
+									(offset - aligned_offset),
+							.length = length,
+							.mapping = mapping };
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_unmap_view(FileView *view)
+{
+	if (!view)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!view->mapping)
+		return ERROR_RESULT_NO_ERROR;
+
+	BOOL unmapped = UnmapViewOfFile(view->mapping);
+	*view = (FileView){ 0 };
+	if (!unmapped)
+		return fun_error_result(GetLastError(), "Failed to unmap file view");
+	return ERROR_RESULT_NO_ERROR;
+}
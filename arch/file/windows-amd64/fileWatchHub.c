@@ -0,0 +1,430 @@
+#include <windows.h>
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <stdbool.h>
+
+/*
+ * Every watched directory has an overlapped ReadDirectoryChangesW
+ * outstanding on one I/O completion port, so a single wait covers all
+ * watches.  Recursion is native (bWatchSubtree); files are watched
+ * through their directory and filtered by name.  Debouncing works as on
+ * Linux, with the port wait clipped to the earliest deadline instead of a
+ * timer.
+ */
+
+#define FILE_WATCH_NOTIFY_FILTER                                           \
+	(FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |          \
+	 FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE |             \
+	 FILE_NOTIFY_CHANGE_LAST_WRITE)
+#define FILE_WATCH_EVENT_BUFFER 16384
+#define FILE_WATCH_MAX_LOAD (FILE_WATCH_MAX_PENDING * 3 / 4)
+
+/* Allocated one by one: the kernel writes into overlapped and buffer. */
+typedef struct {
+	OVERLAPPED overlapped;
+	HANDLE directory;
+	FileChangeCallback callback;
+	uint32_t name_offset; /* file watches: start of the name in path */
+	bool is_file;
+	bool recursive;
+	bool active; /* a read is outstanding */
+	char path[FILE_WATCH_PATH_SIZE];
+	DWORD buffer[FILE_WATCH_EVENT_BUFFER / sizeof(DWORD)];
+} HubWatch;
+
+typedef struct {
+	uint64_t hash; /* 0 marks a free slot */
+	ULONGLONG deadline_ms;
+	FileChangeCallback callback;
+	char path[FILE_WATCH_PATH_SIZE];
+} HubPending;
+
+typedef struct {
+	HANDLE port;
+	uint32_t debounce_ms;
+	HubWatch **watches;
+	uint32_t watch_count;
+	uint32_t watch_capacity;
+	HubPending *pending;
+	uint32_t pending_count;
+	ULONGLONG next_deadline_ms; /* 0 when nothing is pending */
+} HubState;
+
+static size_t string_length_local(const char *s)
+{
+	size_t length = 0;
+	while (s[length] != '\0')
+		length++;
+	return length;
+}
+
+static bool string_equal_local(const char *a, const char *b)
+{
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+static uint64_t hash_path(const char *path)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (; *path; path++)
+		hash = (hash ^ (uint8_t)*path) * 1099511628211ULL;
+	return hash ? hash : 1;
+}
+
+/* Remove slot by shifting later members of its probe run back. */
+static void pending_remove(HubState *hub, uint32_t slot)
+{
+	const uint32_t mask = FILE_WATCH_MAX_PENDING - 1;
+	uint32_t next = slot;
+	for (;;) {
+		next = (next + 1) & mask;
+		if (hub->pending[next].hash == 0)
+			break;
+		uint32_t home = (uint32_t)hub->pending[next].hash & mask;
+		bool movable = slot <= next ? (home <= slot || home > next) :
+									  (home <= slot && home > next);
+		if (movable) {
+			hub->pending[slot] = hub->pending[next];
+			slot = next;
+		}
+	}
+	hub->pending[slot].hash = 0;
+	hub->pending_count--;
+}
+
+static uint32_t hub_fire(HubState *hub, ULONGLONG now, bool flush)
+{
+	uint32_t fired = 0;
+	ULONGLONG next_deadline = 0;
+	char path[FILE_WATCH_PATH_SIZE];
+
+	for (uint32_t slot = 0; slot < FILE_WATCH_MAX_PENDING;) {
+		HubPending *entry = &hub->pending[slot];
+		if (entry->hash == 0) {
+			slot++;
+			continue;
+		}
+		if (!flush && entry->deadline_ms > now) {
+			if (next_deadline == 0 || entry->deadline_ms < next_deadline)
+				next_deadline = entry->deadline_ms;
+			slot++;
+			continue;
+		}
+		/* The slot may be refilled by the shift; look at it again. */
+		FileChangeCallback callback = entry->callback;
+		fun_memory_copy(entry->path, path,
+						string_length_local(entry->path) + 1);
+		pending_remove(hub, slot);
+		callback(path);
+		fired++;
+	}
+
+	hub->next_deadline_ms = next_deadline;
+	return fired;
+}
+
+static uint32_t hub_queue(HubState *hub, const char *path,
+						  FileChangeCallback callback, ULONGLONG now)
+{
+	uint32_t fired = 0;
+	if (hub->pending_count >= FILE_WATCH_MAX_LOAD)
+		fired = hub_fire(hub, now, true);
+
+	const uint32_t mask = FILE_WATCH_MAX_PENDING - 1;
+	uint64_t hash = hash_path(path);
+	uint32_t slot = (uint32_t)hash & mask;
+	while (hub->pending[slot].hash != 0) {
+		HubPending *entry = &hub->pending[slot];
+		if (entry->hash == hash && entry->callback == callback &&
+			string_equal_local(entry->path, path)) {
+			entry->deadline_ms = now + hub->debounce_ms;
+			return fired;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	HubPending *entry = &hub->pending[slot];
+	entry->hash = hash;
+	entry->deadline_ms = now + hub->debounce_ms;
+	entry->callback = callback;
+	fun_memory_copy((Memory)path, entry->path, string_length_local(path) + 1);
+	hub->pending_count++;
+	if (hub->next_deadline_ms == 0 ||
+		entry->deadline_ms < hub->next_deadline_ms)
+		hub->next_deadline_ms = entry->deadline_ms;
+	return fired;
+}
+
+static bool hub_read(HubWatch *watch)
+{
+	watch->overlapped = (OVERLAPPED){ 0 };
+	watch->active = ReadDirectoryChangesW(
+		watch->directory, watch->buffer, sizeof(watch->buffer),
+		watch->recursive, FILE_WATCH_NOTIFY_FILTER, NULL, &watch->overlapped,
+		NULL);
+	return watch->active;
+}
+
+static void hub_free_watch(HubWatch *watch)
+{
+	if (watch->directory != INVALID_HANDLE_VALUE) {
+		if (watch->active) {
+			DWORD bytes;
+			CancelIoEx(watch->directory, &watch->overlapped);
+			GetOverlappedResult(watch->directory, &watch->overlapped, &bytes,
+								TRUE);
+		}
+		CloseHandle(watch->directory);
+	}
+	fun_memory_free((Memory *)&watch);
+}
+
+static ErrorResult hub_add_watch(HubState *hub, const char *directory,
+								 const char *path, bool is_file,
+								 bool recursive, FileChangeCallback callback)
+{
+	if (hub->watch_count == hub->watch_capacity) {
+		uint32_t capacity = hub->watch_capacity ? hub->watch_capacity * 2 : 16;
+		size_t size = (size_t)capacity * sizeof(HubWatch *);
+		MemoryResult grown = hub->watches ?
+								 fun_memory_reallocate(hub->watches, size) :
+								 fun_memory_allocate(size);
+		if (fun_error_is_error(grown.error))
+			return grown.error;
+		hub->watches = (HubWatch **)grown.value;
+		hub->watch_capacity = capacity;
+	}
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, directory, -1, wide_path, MAX_PATH) ==
+		0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(HubWatch));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+	HubWatch *watch = (HubWatch *)allocation.value;
+	watch->callback = callback;
+	watch->is_file = is_file;
+	watch->recursive = recursive;
+	watch->active = false;
+	watch->name_offset = 0;
+	size_t length = string_length_local(path);
+	fun_memory_copy((Memory)path, watch->path, length + 1);
+	if (is_file) {
+		uint32_t name = (uint32_t)length;
+		while (name > 0 && path[name - 1] != '/' && path[name - 1] != '\\')
+			name--;
+		watch->name_offset = name;
+	}
+
+	watch->directory = CreateFileW(
+		wide_path, FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		NULL);
+	DWORD error = ERROR_SUCCESS;
+	if (watch->directory == INVALID_HANDLE_VALUE ||
+		!CreateIoCompletionPort(watch->directory, hub->port, (ULONG_PTR)watch,
+								0) ||
+		!hub_read(watch))
+		error = GetLastError();
+	if (error != ERROR_SUCCESS) {
+		hub_free_watch(watch);
+		return fun_error_result(error, "Failed to watch directory");
+	}
+
+	hub->watches[hub->watch_count++] = watch;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static uint32_t hub_handle_changes(HubState *hub, HubWatch *watch,
+								   DWORD bytes, ULONGLONG now)
+{
+	uint32_t fired = 0;
+	/* Zero bytes: the buffer overflowed and the changes are lost. */
+	if (bytes == 0)
+		return hub_queue(hub, watch->path, watch->callback, now);
+
+	char path[FILE_WATCH_PATH_SIZE];
+	size_t prefix = watch->is_file ? watch->name_offset :
+									 string_length_local(watch->path) + 1;
+	fun_memory_copy(watch->path, path, prefix);
+	if (!watch->is_file)
+		path[prefix - 1] = '\\';
+
+	FILE_NOTIFY_INFORMATION *info = (FILE_NOTIFY_INFORMATION *)watch->buffer;
+	for (;;) {
+		int length = WideCharToMultiByte(
+			CP_UTF8, 0, info->FileName,
+			(int)(info->FileNameLength / sizeof(WCHAR)), path + prefix,
+			(int)(FILE_WATCH_PATH_SIZE - prefix - 1), NULL, NULL);
+		if (length > 0) {
+			path[prefix + length] = '\0';
+			if (!watch->is_file ||
+				string_equal_local(path + prefix,
+								   watch->path + watch->name_offset))
+				fired += hub_queue(hub, watch->is_file ? watch->path : path,
+								   watch->callback, now);
+		}
+		if (info->NextEntryOffset == 0)
+			break;
+		info = (FILE_NOTIFY_INFORMATION *)((char *)info +
+										   info->NextEntryOffset);
+	}
+	return fired;
+}
+
+ErrorResult fun_file_watch_hub_open(uint32_t debounce_ms,
+									FileWatchHub *out_hub)
+{
+	if (!out_hub)
+		return ERROR_RESULT_NULL_POINTER;
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(HubState));
+	if (fun_error_is_error(allocation.error))
+		return allocation.error;
+	HubState *hub = (HubState *)allocation.value;
+	*hub = (HubState){ .debounce_ms = debounce_ms };
+
+	MemoryResult pending =
+		fun_memory_allocate(FILE_WATCH_MAX_PENDING * sizeof(HubPending));
+	if (fun_error_is_error(pending.error)) {
+		fun_memory_free(&allocation.value);
+		return pending.error;
+	}
+	hub->pending = (HubPending *)pending.value;
+	for (uint32_t i = 0; i < FILE_WATCH_MAX_PENDING; i++)
+		hub->pending[i].hash = 0;
+
+	hub->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+	if (!hub->port) {
+		DWORD error = GetLastError();
+		fun_memory_free((Memory *)&hub->pending);
+		fun_memory_free(&allocation.value);
+		return fun_error_result(error, "Failed to create notification hub");
+	}
+
+	out_hub->state = hub;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_file_watch_hub_add(FileWatchHub hub, FileWatch watch)
+{
+	HubState *state = (HubState *)hub.state;
+	if (!state || !watch.path || !watch.callback)
+		return ERROR_RESULT_NULL_POINTER;
+
+	size_t length = string_length_local(watch.path);
+	if (length == 0)
+		return ERROR_RESULT_PATH_INVALID;
+	if (length >= FILE_WATCH_PATH_SIZE)
+		return ERROR_RESULT_PATH_TOO_LONG;
+	char path[FILE_WATCH_PATH_SIZE];
+	fun_memory_copy((Memory)watch.path, path, length + 1);
+	while (length > 1 && (path[length - 1] == '/' || path[length - 1] == '\\'))
+		path[--length] = '\0';
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, MAX_PATH) == 0)
+		return fun_error_result(GetLastError(), "Failed to convert file path");
+	DWORD attributes = GetFileAttributesW(wide_path);
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+		return fun_error_result(GetLastError(), "Failed to find watch path");
+
+	if (attributes & FILE_ATTRIBUTE_DIRECTORY)
+		return hub_add_watch(state, path, path, false, watch.recursive,
+							 watch.callback);
+	if (watch.recursive)
+		return ERROR_RESULT_NOT_DIRECTORY;
+
+	/* A file: watch its directory for the name. */
+	char directory[FILE_WATCH_PATH_SIZE];
+	fun_memory_copy(path, directory, length + 1);
+	while (length > 0 && directory[length - 1] != '/' &&
+		   directory[length - 1] != '\\')
+		length--;
+	if (length == 0) {
+		directory[0] = '.';
+		directory[1] = '\0';
+	} else {
+		directory[length] = '\0';
+	}
+	return hub_add_watch(state, directory, path, true, false, watch.callback);
+}
+
+uint32_tResult fun_file_watch_hub_dispatch(FileWatchHub hub,
+										   int32_t timeout_ms)
+{
+	uint32_tResult result = { .value = 0, .error = ERROR_RESULT_NO_ERROR };
+	HubState *state = (HubState *)hub.state;
+	if (!state) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	/* Wake for the earliest debounce deadline if it comes first. */
+	DWORD wait = timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms;
+	if (state->next_deadline_ms) {
+		ULONGLONG now = GetTickCount64();
+		DWORD until = state->next_deadline_ms > now ?
+						  (DWORD)(state->next_deadline_ms - now) :
+						  0;
+		if (until < wait)
+			wait = until;
+	}
+
+	for (;;) {
+		DWORD bytes = 0;
+		ULONG_PTR key = 0;
+		OVERLAPPED *overlapped = NULL;
+		BOOL ok = GetQueuedCompletionStatus(state->port, &bytes, &key,
+											&overlapped, wait);
+		if (!overlapped)
+			break;
+		wait = 0;
+		HubWatch *watch = (HubWatch *)key;
+		if (!ok) {
+			/* The directory went away; report it and stop reading. */
+			watch->active = false;
+			result.value += hub_queue(state, watch->path, watch->callback,
+									  GetTickCount64());
+			continue;
+		}
+		result.value +=
+			hub_handle_changes(state, watch, bytes, GetTickCount64());
+		hub_read(watch);
+	}
+
+	result.value += hub_fire(state, GetTickCount64(), false);
+	return result;
+}
+
+int64_t fun_file_watch_hub_descriptor(FileWatchHub hub)
+{
+	HubState *state = (HubState *)hub.state;
+	return state ? (int64_t)(intptr_t)state->port : -1;
+}
+
+ErrorResult fun_file_watch_hub_close(FileWatchHub *hub)
+{
+	if (!hub || !hub->state)
+		return ERROR_RESULT_NULL_POINTER;
+
+	HubState *state = (HubState *)hub->state;
+	for (uint32_t i = 0; i < state->watch_count; i++)
+		hub_free_watch(state->watches[i]);
+	CloseHandle(state->port);
+	if (state->watches)
+		fun_memory_free((Memory *)&state->watches);
+	fun_memory_free((Memory *)&state->pending);
+	fun_memory_free(&hub->state);
+	hub->state = NULL;
+	return ERROR_RESULT_NO_ERROR;
+}
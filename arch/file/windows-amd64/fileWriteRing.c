@@ -4,78 +4,32 @@
 #include <windows.h>
 
 #define WINAPI_FAMILY WINAPI_FAMILY_DESKTOP_APP
-#undef NTDDI_VERSION
-#define NTDDI_VERSION NTDDI_WIN10_NI
 
-#include "ioringcompat.h"
-#include <ioringapi.h>
-
-typedef struct {
-	HIORING io_ring;
-	IORING_CREATE_FLAGS flags;
-	IORING_INFO info;
-} IoRingWriteContext;
+#include "fileRing.h"
 
 typedef struct {
 	Write parameters;
-	IoRingWriteContext *global_context;
 	HANDLE file_handle;
-	uint64_t request_id;
-	AsyncStatus async_status;
+	FileRingRequest request;
 } RingWriteState;
 
-static IoRingWriteContext global_write_context = { 0 };
-static uint64_t next_write_request_id = 0;
-
-static inline ErrorResult initialize_write_io_ring(IoRingWriteContext *ctx)
-{
-	IORING_CREATE_FLAGS flags =
-		(IORING_CREATE_FLAGS){ .Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE,
-							   .Required = IORING_CREATE_REQUIRED_FLAGS_NONE };
-
-	HRESULT hr = CreateIoRing(IORING_VERSION_1, flags, 0, 0, &ctx->io_ring);
-	if (FAILED(hr))
-		return (ErrorResult){ .code = hr };
-
-	GetIoRingInfo(ctx->io_ring, &ctx->info);
-	return ERROR_RESULT_NO_ERROR;
-}
-
 static AsyncStatus poll_ring_write(AsyncResult *result)
 {
 	RingWriteState *state = result->state;
-	IORING_CQE cqe;
-
-	if (state->async_status != ASYNC_PENDING) {
-		AsyncStatus status = state->async_status;
-		FileAdaptiveState *adaptive = state->parameters.adaptive;
-		uint64_t bytes = state->parameters.bytes_to_write;
-		if (state->file_handle != INVALID_HANDLE_VALUE)
-			CloseHandle(state->file_handle);
-		void *mem = state;
-		fun_memory_free(&mem);
-		if (status == ASYNC_COMPLETED)
-			file_adaptive_update(adaptive, bytes);
-		return status;
-	}
-
-	if (SUCCEEDED(PopIoRingCompletion(state->global_context->io_ring, &cqe))) {
-		AsyncStatus status = cqe.ResultCode >= 0 ? ASYNC_COMPLETED :
-												   ASYNC_ERROR;
-		state->async_status = status;
-		if (cqe.UserData == state->request_id) {
-			FileAdaptiveState *adaptive = state->parameters.adaptive;
-			uint64_t bytes = state->parameters.bytes_to_write;
-			if (state->file_handle != INVALID_HANDLE_VALUE)
-				CloseHandle(state->file_handle);
-			void *mem = state;
-			fun_memory_free(&mem);
-			if (status == ASYNC_COMPLETED)
-				file_adaptive_update(adaptive, bytes);
-			return status;
-		}
-	}
-	return ASYNC_PENDING;
+	if (!file_ring_reap(&state->request))
+		return ASYNC_PENDING;
+
+	AsyncStatus status = SUCCEEDED(state->request.result) ? ASYNC_COMPLETED :
+															ASYNC_ERROR;
+	FileAdaptiveState *adaptive = state->parameters.adaptive;
+	uint64_t bytes = state->parameters.bytes_to_write;
+	if (state->file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(state->file_handle);
+	void *mem = state;
+	fun_memory_free(&mem);
+	if (status == ASYNC_COMPLETED)
+		file_adaptive_update(adaptive, bytes);
+	return status;
 }
 
 AsyncResult create_ring_write(Write parameters)
@@ -87,17 +41,10 @@ AsyncResult create_ring_write(Write parameters)
 
 	HANDLE file = INVALID_HANDLE_VALUE;
 	RingWriteState *state = (RingWriteState *)mem_result.value;
-	state->global_context = &global_write_context;
-	state->request_id = next_write_request_id++;
-	state->async_status = ASYNC_PENDING;
+	state->request = (FileRingRequest){ 0 };
+	state->file_handle = INVALID_HANDLE_VALUE;
 	state->parameters = parameters;
 
-	if (!state->global_context->io_ring) {
-		ErrorResult init = initialize_write_io_ring(state->global_context);
-		if (fun_error_is_error(init))
-			goto cleanup;
-	}
-
 	file = CreateFile(parameters.file_path, GENERIC_WRITE, 0, NULL, OPEN_ALWAYS,
 					  FILE_FLAG_OVERLAPPED, NULL);
 	if (file == INVALID_HANDLE_VALUE)
@@ -106,17 +53,25 @@ AsyncResult create_ring_write(Write parameters)
 	state->file_handle = file;
 
 	IORING_HANDLE_REF file_ref = IoRingHandleRefFromHandle(file);
-	IORING_BUFFER_REF buffer_ref = IoRingBufferRefFromPointer(parameters.input);
 
-	HRESULT hr = BuildIoRingWriteFile(state->global_context->io_ring, file_ref,
-									  buffer_ref, parameters.bytes_to_write,
+	HIORING ring = file_ring_lock();
+	if (!ring)
+		goto cleanup;
+
+	IORING_BUFFER_REF buffer_ref = file_ring_buffer_ref(
+		parameters.input, (UINT32)parameters.bytes_to_write);
+
+	HRESULT hr = BuildIoRingWriteFile(ring, file_ref, buffer_ref,
+									  parameters.bytes_to_write,
 									  parameters.offset, FILE_WRITE_FLAGS_NONE,
-									  state->request_id, IOSQE_FLAGS_NONE);
-	if (FAILED(hr))
+									  (UINT_PTR)&state->request,
+									  IOSQE_FLAGS_NONE);
+	if (FAILED(hr)) {
+		file_ring_unlock();
 		goto cleanup;
+	}
 
-	UINT32 submitted;
-	hr = SubmitIoRing(state->global_context->io_ring, 0, 1, &submitted);
+	hr = file_ring_submit_unlock();
 	if (FAILED(hr))
 		goto cleanup;
 
@@ -0,0 +1,152 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/error/error.h"
+
+#include <windows.h>
+
+/*
+ * WriteFileGather only takes page-sized, page-aligned segments on an
+ * unbuffered handle, so it cannot carry arbitrary records.  Segments go
+ * out with one positioned WriteFile each instead, still without staging
+ * copies.  Appends open the file with FILE_APPEND_DATA alone, which makes
+ * every WriteFile land at the end of the file; another appender may get
+ * between two segments of the same call.
+ */
+
+typedef struct {
+	String file_path;
+	const FileSegment *segments;
+	uint32_t segment_count;
+	uint64_t offset;
+	bool append;
+	FileDurabilityMode durability_mode;
+} VectorWriteState;
+
+static ErrorResult vector_write_segment(HANDLE file_handle,
+										VectorWriteState *state,
+										const char *data, uint64_t bytes)
+{
+	while (bytes > 0) {
+		DWORD chunk = bytes > 0x40000000 ? 0x40000000 : (DWORD)bytes;
+		OVERLAPPED overlapped = { 0 };
+		if (state->append) {
+			overlapped.Offset = 0xFFFFFFFF;
+			overlapped.OffsetHigh = 0xFFFFFFFF;
+		} else {
+			overlapped.Offset = (DWORD)state->offset;
+			overlapped.OffsetHigh = (DWORD)(state->offset >> 32);
+		}
+		DWORD written = 0;
+		if (!WriteFile(file_handle, data, chunk, &written, &overlapped))
+			return fun_error_result(GetLastError(), "WriteFile failed");
+		data += written;
+		bytes -= written;
+		state->offset += written;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static AsyncStatus poll_vector_write(AsyncResult *result)
+{
+	VectorWriteState *state = (VectorWriteState *)result->state;
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+
+	wchar_t wide_path[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, state->file_path, -1, wide_path,
+							MAX_PATH) == 0) {
+		result->error =
+			fun_error_result(GetLastError(), "Path conversion failed");
+		goto done;
+	}
+
+	file_handle = CreateFileW(wide_path,
+							  state->append ? FILE_APPEND_DATA :
+											  GENERIC_WRITE,
+							  FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							  OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		result->error = fun_error_result(GetLastError(), "Failed to open file");
+		goto done;
+	}
+
+	result->error = ERROR_RESULT_NO_ERROR;
+	for (uint32_t i = 0; i < state->segment_count; i++) {
+		result->error = vector_write_segment(file_handle, state,
+											 state->segments[i].data,
+											 state->segments[i].bytes);
+		if (fun_error_is_error(result->error))
+			goto done;
+	}
+
+	if (state->durability_mode != FILE_DURABILITY_ASYNC &&
+		!FlushFileBuffers(file_handle))
+		result->error = fun_error_result(GetLastError(), "Flush failed");
+
+done:
+	if (file_handle != INVALID_HANDLE_VALUE)
+		CloseHandle(file_handle);
+	fun_memory_free((Memory *)&state);
+	return fun_error_is_error(result->error) ? ASYNC_ERROR : ASYNC_COMPLETED;
+}
+
+static AsyncResult create_vector_write(String file_path,
+									   const FileSegment *segments,
+									   uint32_t segment_count, uint64_t offset,
+									   bool append,
+									   FileDurabilityMode durability_mode)
+{
+	if (!file_path || (!segments && segment_count > 0))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	if (segment_count > FILE_MAX_SEGMENTS)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_FILE_TOO_MANY_SEGMENTS };
+
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < segment_count; i++) {
+		if (segments[i].bytes > 0 && !segments[i].data)
+			return (AsyncResult){ .status = ASYNC_ERROR,
+								  .error = ERROR_RESULT_NULL_POINTER };
+		if (segments[i].bytes > UINT64_MAX - total)
+			return (AsyncResult){ .status = ASYNC_ERROR,
+								  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+		total += segments[i].bytes;
+	}
+	if (!append && total > UINT64_MAX - offset)
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	if (total == 0)
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+
+	MemoryResult allocation = fun_memory_allocate(sizeof(VectorWriteState));
+	if (fun_error_is_error(allocation.error))
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = allocation.error };
+
+	VectorWriteState *state = (VectorWriteState *)allocation.value;
+	*state = (VectorWriteState){ .file_path = file_path,
+								 .segments = segments,
+								 .segment_count = segment_count,
+								 .offset = offset,
+								 .append = append,
+								 .durability_mode = durability_mode };
+
+	return (AsyncResult){ .state = state,
+						  .poll = poll_vector_write,
+						  .status = ASYNC_PENDING };
+}
+
+AsyncResult fun_write_vector_to_file(WriteVector parameters)
+{
+	return create_vector_write(parameters.file_path, parameters.segments,
+							   parameters.segment_count, parameters.offset,
+							   false, parameters.durability_mode);
+}
+
+AsyncResult fun_append_vector_to_file(AppendVector parameters)
+{
+	return create_vector_write(parameters.file_path, parameters.segments,
+							   parameters.segment_count, 0, true,
+							   parameters.durability_mode);
+}
@@ -212,24 +212,24 @@ CanReturnError(void)
 		return result;
 	}
 
-	if ((destination < source && destination + sizeInBytes > source) ||
-		(source < destination && source + sizeInBytes > destination)) {
-		uint8_t *dest = (uint8_t *)destination;
-		const uint8_t *src = (const uint8_t *)source;
-
-		if (dest > src) {
-			for (size_t i = sizeInBytes; i > 0; --i) {
-				dest[i - 1] = src[i - 1];
-			}
-		} else {
-			for (size_t i = 0; i < sizeInBytes; ++i) {
-				dest[i] = src[i];
-			}
+	uint8_t *dest = (uint8_t *)destination;
+	const uint8_t *src = (const uint8_t *)source;
+
+	/*
+	 * Each word is read whole before it is stored, so copying away from
+	 * the overlap is safe a word at a time.
+	 */
+	if (dest > src && src + sizeInBytes > dest) {
+		while (sizeInBytes >= 8) {
+			sizeInBytes -= 8;
+			*(uint64_t *)(dest + sizeInBytes) =
+				*(const uint64_t *)(src + sizeInBytes);
+		}
+		while (sizeInBytes > 0) {
+			--sizeInBytes;
+			dest[sizeInBytes] = src[sizeInBytes];
 		}
 	} else {
-		uint8_t *dest = (uint8_t *)destination;
-		const uint8_t *src = (const uint8_t *)source;
-
 		while (sizeInBytes >= 8) {
 			*(uint64_t *)dest = *(const uint64_t *)src;
 			dest += 8;
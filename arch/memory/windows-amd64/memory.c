@@ -122,29 +122,24 @@ CanReturnError(void)
 	}
 
 	// Check for overlap
-	if ((destination < source && destination + sizeInBytes > source) ||
-		(source < destination && source + sizeInBytes > destination)) {
-		// Handle overlapping memory regions
-		uint8_t *dest = (uint8_t *)destination;
-		const uint8_t *src = (const uint8_t *)source;
-
-		if (dest > src) {
-			// Copy from end to start
-			for (size_t i = sizeInBytes; i > 0; --i) {
-				dest[i - 1] = src[i - 1];
-			}
-		} else {
-			// Copy from start to end
-			for (size_t i = 0; i < sizeInBytes; ++i) {
-				dest[i] = src[i];
-			}
+	uint8_t *dest = (uint8_t *)destination;
+	const uint8_t *src = (const uint8_t *)source;
+
+	// Words are read whole before they are stored, so copying in the
+	// direction away from the overlap is safe a word at a time.
+	if (dest > src && src + sizeInBytes > dest) {
+		// Destination overlaps the tail of the source: copy from the end
+		while (sizeInBytes >= 8) {
+			sizeInBytes -= 8;
+			*(uint64_t *)(dest + sizeInBytes) =
+				*(const uint64_t *)(src + sizeInBytes);
+		}
+		while (sizeInBytes > 0) {
+			--sizeInBytes;
+			dest[sizeInBytes] = src[sizeInBytes];
 		}
 	} else {
-		// Non-overlapping regions, use optimized copy
-		uint8_t *dest = (uint8_t *)destination;
-		const uint8_t *src = (const uint8_t *)source;
-
-		// Copy 8 bytes at a time if possible
+		// Disjoint, or destination before source: copy from the start
 		while (sizeInBytes >= 8) {
 			*(uint64_t *)dest = *(const uint64_t *)src;
 			dest += 8;
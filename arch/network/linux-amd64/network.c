@@ -4,12 +4,18 @@
 #include "fundamental/network/network.h"
 
 /* ---- Syscall numbers ---- */
+#define SYS_open 2
 #define SYS_close 3
+#define SYS_fstat 5
 #define SYS_poll 7
+#define SYS_sendfile 40
 #define SYS_socket 41
 #define SYS_connect 42
 #define SYS_sendto 44
 #define SYS_recvfrom 45
+#define SYS_sendmsg 46
+#define SYS_recvmsg 47
+#define SYS_setsockopt 54
 #define SYS_getsockopt 55
 #define SYS_fcntl 72
 
@@ -24,12 +30,28 @@
 #define SOL_SOCKET 1
 #define SO_ERROR 4
 #define MSG_NOSIGNAL 0x4000
+#define MSG_PEEK 0x2
+#define MSG_DONTWAIT 0x40
+#define MSG_ERRQUEUE 0x2000
+#define MSG_ZEROCOPY 0x4000000
+#define SO_ZEROCOPY 60
+#define SOL_IP 0
+#define SOL_IPV6 41
+#define IP_RECVERR 11
+#define IPV6_RECVERR 25
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#define O_RDONLY 0
+#define O_CLOEXEC 02000000
 #define POLLOUT 4
 #define POLLERR 8
 #define POLLHUP 16
 #define EINPROGRESS 115
 #define EAGAIN 11
 #define EWOULDBLOCK 11
+#define ENOBUFS 105
+
+/* Segments handed to one sendmsg call; the core loops for the rest */
+#define NETWORK_SENDV_MAX_SEGMENTS 64
 
 /* ---- Types ---- */
 typedef unsigned int socklen_t;
@@ -60,6 +82,44 @@ struct pollfd {
 	short revents;
 };
 
+struct iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+struct msghdr {
+	void *msg_name;
+	socklen_t msg_namelen;
+	struct iovec *msg_iov;
+	size_t msg_iovlen;
+	void *msg_control;
+	size_t msg_controllen;
+	int msg_flags;
+};
+
+struct cmsghdr {
+	size_t cmsg_len;
+	int cmsg_level;
+	int cmsg_type;
+};
+
+struct sock_extended_err {
+	uint32_t ee_errno;
+	uint8_t ee_origin;
+	uint8_t ee_type;
+	uint8_t ee_code;
+	uint8_t ee_pad;
+	uint32_t ee_info; /* first notified send sequence number */
+	uint32_t ee_data; /* last notified send sequence number */
+};
+
+/* Only st_size is used; the rest is padding to the kernel's 144 bytes */
+struct kernel_stat {
+	unsigned char _pad0[48];
+	long st_size;
+	unsigned char _pad1[88];
+};
+
 /* ---- Syscall helpers ---- */
 static inline long syscall1(long n, long a1)
 {
@@ -91,6 +151,17 @@ static inline long syscall3(long n, long a1, long a2, long a3)
 	return ret;
 }
 
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
 static inline long syscall5(long n, long a1, long a2, long a3, long a4, long a5)
 {
 	long ret;
@@ -241,6 +312,141 @@ int fun_network_arch_tcp_send(intptr_t fd, const void *data, size_t len,
 	return 0;
 }
 
+int fun_network_arch_tcp_sendv(intptr_t fd, const NetworkBuffer *buffers,
+							   size_t count, size_t first_offset, size_t *sent)
+{
+	struct iovec iov[NETWORK_SENDV_MAX_SEGMENTS];
+	size_t n_iov = 0;
+	for (size_t i = 0; i < count && n_iov < NETWORK_SENDV_MAX_SEGMENTS;
+		 i++) {
+		size_t skip = (i == 0) ? first_offset : 0;
+		if (buffers[i].length <= skip)
+			continue;
+		iov[n_iov].iov_base = (uint8_t *)buffers[i].data + skip;
+		iov[n_iov].iov_len = buffers[i].length - skip;
+		n_iov++;
+	}
+	if (n_iov == 0) {
+		*sent = 0;
+		return 0;
+	}
+
+	struct msghdr msg;
+	zero_bytes(&msg, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = n_iov;
+
+	long n = syscall3(SYS_sendmsg, fd, (long)&msg, MSG_NOSIGNAL);
+	if (n < 0) {
+		if (n == -EAGAIN || n == -EWOULDBLOCK)
+			return 1;
+		return -1;
+	}
+	*sent = (size_t)n;
+	return 0;
+}
+
+int fun_network_arch_tcp_enable_zerocopy(intptr_t fd)
+{
+	int one = 1;
+	long rc = syscall5(SYS_setsockopt, fd, SOL_SOCKET, SO_ZEROCOPY,
+					   (long)&one, sizeof(one));
+	return rc == 0 ? 0 : -1;
+}
+
+int fun_network_arch_tcp_send_zerocopy(intptr_t fd, const void *data,
+									   size_t len, size_t *sent)
+{
+	long n = syscall6(SYS_sendto, fd, (long)data, (long)len,
+					  MSG_NOSIGNAL | MSG_ZEROCOPY, 0, 0);
+	if (n < 0) {
+		/* ENOBUFS: optmem exhausted by unreaped notifications */
+		if (n == -EAGAIN || n == -EWOULDBLOCK || n == -ENOBUFS)
+			return 1;
+		return -1;
+	}
+	*sent = (size_t)n;
+	return 0;
+}
+
+int fun_network_arch_tcp_reap_zerocopy(intptr_t fd, size_t *completed)
+{
+	*completed = 0;
+	for (;;) {
+		/* cmsghdr + sock_extended_err + room for an offender address */
+		uint64_t control[16];
+		struct msghdr msg;
+		zero_bytes(&msg, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		long n = syscall3(SYS_recvmsg, fd, (long)&msg,
+						  MSG_ERRQUEUE | MSG_DONTWAIT);
+		if (n < 0) {
+			if (n == -EAGAIN || n == -EWOULDBLOCK)
+				return 0; /* error queue drained */
+			return -1;
+		}
+
+		/* One extended error per message; walk the control buffer */
+		uint8_t *p = (uint8_t *)control;
+		uint8_t *end = p + msg.msg_controllen;
+		while (p + sizeof(struct cmsghdr) <= end) {
+			struct cmsghdr *cm = (struct cmsghdr *)p;
+			if (cm->cmsg_len < sizeof(struct cmsghdr) ||
+				p + cm->cmsg_len > end)
+				break;
+			if ((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+				(cm->cmsg_level == SOL_IPV6 &&
+				 cm->cmsg_type == IPV6_RECVERR)) {
+				struct sock_extended_err *ee =
+					(struct sock_extended_err *)(cm + 1);
+				if (ee->ee_origin == SO_EE_ORIGIN_ZEROCOPY &&
+					ee->ee_errno == 0)
+					*completed += (size_t)(ee->ee_data - ee->ee_info) + 1;
+			}
+			p += (cm->cmsg_len + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+		}
+	}
+}
+
+int fun_network_arch_file_open(const char *path, intptr_t *out_fd,
+							   uint64_t *out_size)
+{
+	long fd = syscall3(SYS_open, (long)path, O_RDONLY | O_CLOEXEC, 0);
+	if (fd < 0)
+		return -1;
+
+	struct kernel_stat st;
+	if (syscall2(SYS_fstat, fd, (long)&st) != 0 || st.st_size < 0) {
+		syscall1(SYS_close, fd);
+		return -1;
+	}
+
+	*out_fd = (intptr_t)fd;
+	*out_size = (uint64_t)st.st_size;
+	return 0;
+}
+
+int fun_network_arch_tcp_send_file(intptr_t fd, intptr_t file_fd,
+								   uint64_t offset, size_t len, size_t *sent)
+{
+	long off = (long)offset;
+	long n = syscall4(SYS_sendfile, fd, file_fd, (long)&off, (long)len);
+	if (n < 0) {
+		if (n == -EAGAIN || n == -EWOULDBLOCK)
+			return 1;
+		return -1;
+	}
+	*sent = (size_t)n;
+	return 0;
+}
+
+void fun_network_arch_file_close(intptr_t file_fd)
+{
+	syscall1(SYS_close, file_fd);
+}
+
 int fun_network_arch_tcp_recv(intptr_t fd, void *data, size_t len,
 							  size_t *received)
 {
@@ -256,6 +462,22 @@ int fun_network_arch_tcp_recv(intptr_t fd, void *data, size_t len,
 	return 0;
 }
 
+/*
+ * Liveness probe for an idle socket: peek one byte without blocking.
+ * Would-block means the peer is still there and sent nothing; EOF, an
+ * error, or unsolicited data all make the socket unfit for reuse.
+ * Returns 0 = alive, -1 = not reusable.
+ */
+int fun_network_arch_tcp_check_alive(intptr_t fd)
+{
+	char byte;
+	long n = syscall6(SYS_recvfrom, fd, (long)&byte, 1, MSG_PEEK | MSG_DONTWAIT,
+					  0, 0);
+	if (n == -EAGAIN || n == -EWOULDBLOCK)
+		return 0;
+	return -1;
+}
+
 void fun_network_arch_tcp_close_fd(intptr_t fd)
 {
 	syscall1(SYS_close, fd);
@@ -12,6 +12,7 @@
 #define SYS_poll 7
 #define SYS_getsockname 51
 #define SYS_fcntl 72
+#define SYS_open 2
 
 #define AF_INET 2
 #define AF_INET6 10
@@ -22,12 +23,18 @@
 #define SOL_SOCKET 1
 #define SO_REUSEADDR 2
 #define TCP_NODELAY 1
+#define O_RDONLY 0
 #define O_NONBLOCK 2048
+#define O_CLOEXEC 02000000
 #define F_SETFL 4
-#define SOMAXCONN 128
 #define POLLIN 1
 #define EINTR 4
 #define EAGAIN 11
+#define ENOMEM 12
+#define ENFILE 23
+#define EMFILE 24
+#define ENOBUFS 105
+#define ECONNABORTED 103
 
 struct sockaddr_in {
 	uint16_t sin_family;
@@ -86,6 +93,12 @@ static int set_nonblocking(int fd)
 	return (flags < 0) ? -1 : 0;
 }
 
+static void open_spare_fd(struct NetworkServerConfig_s *config)
+{
+	long fd = syscall3(SYS_open, (long)"/dev/null", O_RDONLY | O_CLOEXEC, 0);
+	config->spare_fd = fd < 0 ? -1 : fd;
+}
+
 int fun_network_server_arch_tcp_setup(struct NetworkServerConfig_s *config)
 {
 	int domain = config->address.family == NETWORK_ADDRESS_IPV4 ? AF_INET :
@@ -126,7 +139,7 @@ int fun_network_server_arch_tcp_setup(struct NetworkServerConfig_s *config)
 		return -1;
 	}
 
-	if (syscall3(SYS_listen, fd, SOMAXCONN, 0) < 0) {
+	if (syscall3(SYS_listen, fd, config->backlog, 0) < 0) {
 		syscall3(SYS_close, fd, 0, 0);
 		return -1;
 	}
@@ -134,6 +147,7 @@ int fun_network_server_arch_tcp_setup(struct NetworkServerConfig_s *config)
 	set_nonblocking((int)fd);
 
 	config->listen_fd = fd;
+	open_spare_fd(config);
 	return 0;
 }
 
@@ -183,9 +197,44 @@ int fun_network_server_arch_udp_setup(struct NetworkServerConfig_s *config)
 	return 0;
 }
 
+/*
+ * Out of descriptors: give up the spare so the oldest queued connection
+ * can be accepted and closed at once, then take the spare back.  Without
+ * this the connection stays queued, the listener stays readable and every
+ * poll fails the same way.  Returns the accept result, or -EMFILE when no
+ * spare is held.
+ */
+static long shed_with_spare_fd(struct NetworkServerConfig_s *config)
+{
+	if (config->spare_fd < 0)
+		return -EMFILE;
+	syscall3(SYS_close, config->spare_fd, 0, 0);
+	config->spare_fd = -1;
+	long client =
+		syscall6(SYS_accept4, config->listen_fd, 0, 0, O_NONBLOCK, 0, 0);
+	if (client >= 0) {
+		syscall3(SYS_close, client, 0, 0);
+		config->shed++;
+	}
+	open_spare_fd(config);
+	return client;
+}
+
+/*
+ * Wait up to timeout_ms for the listen socket to become readable, then
+ * accept until the queue is empty or max_fds connections were taken.
+ * Connections that cannot be accepted for lack of descriptors are closed
+ * and counted as shed.  When memory runs out instead, the call sleeps for
+ * timeout_ms so the still-readable listener is not spun on, and the run
+ * of failures counts as one shed.
+ * Returns 0 (*out_count may be 0 on timeout), -1 on a listen socket error.
+ */
 int fun_network_server_arch_tcp_accept(struct NetworkServerConfig_s *config,
-									   int timeout_ms, intptr_t *out_fd)
+									   int timeout_ms, intptr_t *out_fds,
+									   size_t max_fds, size_t *out_count)
 {
+	*out_count = 0;
+
 	struct pollfd pfd;
 	pfd.fd = (int)config->listen_fd;
 	pfd.events = POLLIN;
@@ -200,20 +249,47 @@ int fun_network_server_arch_tcp_accept(struct NetworkServerConfig_s *config,
 	if (rc == 0)
 		return 0;
 
-	long client =
-		syscall6(SYS_accept4, config->listen_fd, 0, 0, O_NONBLOCK, 0, 0);
-	if (client < 0) {
-		if (client == -EAGAIN)
-			return 0;
-		return -1;
+	size_t shed = 0;
+	while (*out_count + shed < max_fds) {
+		long client =
+			syscall6(SYS_accept4, config->listen_fd, 0, 0, O_NONBLOCK, 0, 0);
+		if (client == -EMFILE || client == -ENFILE) {
+			client = shed_with_spare_fd(config);
+			if (client >= 0) {
+				config->accept_starved = 0;
+				shed++;
+				continue;
+			}
+		}
+		if (client < 0) {
+			/* Queue drained, or a connection reset before we took it */
+			if (client == -EAGAIN || client == -ECONNABORTED ||
+				client == -EINTR)
+				break;
+			if (client == -EMFILE || client == -ENFILE ||
+				client == -ENOBUFS || client == -ENOMEM) {
+				if (!config->accept_starved)
+					config->shed++;
+				config->accept_starved = 1;
+				/* Hand over what was accepted; back off on the next call.
+				 * No descriptors are polled: this only sleeps. */
+				if (*out_count == 0)
+					syscall6(SYS_poll, 0, 0, timeout_ms, 0, 0, 0);
+				break;
+			}
+			if (*out_count > 0)
+				break;
+			return -1;
+		}
+		config->accept_starved = 0;
+
+		int nodelay = 1;
+		syscall6(SYS_setsockopt, client, IPPROTO_TCP, TCP_NODELAY,
+				 (long)&nodelay, sizeof(nodelay), 0);
+
+		out_fds[(*out_count)++] = client;
 	}
-
-	int nodelay = 1;
-	syscall6(SYS_setsockopt, client, IPPROTO_TCP, TCP_NODELAY, (long)&nodelay,
-			 sizeof(nodelay), 0);
-
-	*out_fd = client;
-	return 1;
+	return 0;
 }
 
 int fun_network_server_arch_udp_recv(struct NetworkServerConfig_s *config,
@@ -270,6 +346,10 @@ void fun_network_server_arch_close(struct NetworkServerConfig_s *config)
 		syscall3(SYS_close, config->listen_fd, 0, 0);
 		config->listen_fd = -1;
 	}
+	if (config->spare_fd != -1) {
+		syscall3(SYS_close, config->spare_fd, 0, 0);
+		config->spare_fd = -1;
+	}
 }
 
 int fun_network_server_arch_get_port(struct NetworkServerConfig_s *config,
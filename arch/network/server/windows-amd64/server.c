@@ -75,7 +75,7 @@ int fun_network_server_arch_tcp_setup(struct NetworkServerConfig_s *config)
 		return -1;
 	}
 
-	if (listen(fd, SOMAXCONN) == SOCKET_ERROR) {
+	if (listen(fd, config->backlog) == SOCKET_ERROR) {
 		closesocket(fd);
 		return -1;
 	}
@@ -119,9 +119,11 @@ int fun_network_server_arch_udp_setup(struct NetworkServerConfig_s *config)
 }
 
 int fun_network_server_arch_tcp_accept(struct NetworkServerConfig_s *config,
-									   int timeout_ms, intptr_t *out_fd)
+									   int timeout_ms, intptr_t *out_fds,
+									   size_t max_fds, size_t *out_count)
 {
 	SOCKET fd = (SOCKET)config->listen_fd;
+	*out_count = 0;
 
 	fd_set readfds;
 	FD_ZERO(&readfds);
@@ -137,22 +139,41 @@ int fun_network_server_arch_tcp_accept(struct NetworkServerConfig_s *config,
 	if (rc == 0)
 		return 0;
 
-	SOCKET client = accept(fd, (struct sockaddr *)0, (int *)0);
-	if (client == INVALID_SOCKET) {
-		int err = WSAGetLastError();
-		if (err == WSAEWOULDBLOCK)
-			return 0;
-		return -1;
-	}
+	/* The listen socket is non-blocking: accept until the queue drains */
+	while (*out_count < max_fds) {
+		SOCKET client = accept(fd, (struct sockaddr *)0, (int *)0);
+		if (client == INVALID_SOCKET) {
+			int err = WSAGetLastError();
+			/*
+			 * Out of sockets or buffer space: the connection stays queued
+			 * and the listener stays readable, so back off for timeout_ms
+			 * rather than spin.  The run of failures counts as one shed.
+			 */
+			if (err == WSAEMFILE || err == WSAENOBUFS) {
+				if (!config->accept_starved)
+					config->shed++;
+				config->accept_starved = 1;
+				if (*out_count == 0)
+					Sleep((DWORD)timeout_ms);
+				break;
+			}
+			if (err == WSAEWOULDBLOCK || err == WSAECONNRESET ||
+				*out_count > 0)
+				break;
+			return -1;
+		}
 
-	int nodelay = 1;
-	setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay,
-			   sizeof(nodelay));
+		config->accept_starved = 0;
 
-	set_nonblocking(client);
+		int nodelay = 1;
+		setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char *)&nodelay,
+				   sizeof(nodelay));
 
-	*out_fd = (intptr_t)client;
-	return 1;
+		set_nonblocking(client);
+
+		out_fds[(*out_count)++] = (intptr_t)client;
+	}
+	return 0;
 }
 
 int fun_network_server_arch_udp_recv(struct NetworkServerConfig_s *config,
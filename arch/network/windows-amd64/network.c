@@ -175,6 +175,130 @@ int fun_network_arch_tcp_send(intptr_t fd, const void *data, size_t len,
 	return 0;
 }
 
+/* ------------------------------------------------------------------
+ * fun_network_arch_tcp_sendv
+ *
+ * Non-blocking gather send via WSASend.
+ * Returns 0 = ok (*sent set), 1 = would-block, -1 = error.
+ * ------------------------------------------------------------------ */
+
+#define NETWORK_SENDV_MAX_SEGMENTS 64
+
+int fun_network_arch_tcp_sendv(intptr_t fd, const NetworkBuffer *buffers,
+							   size_t count, size_t first_offset, size_t *sent)
+{
+	WSABUF wsabuf[NETWORK_SENDV_MAX_SEGMENTS];
+	DWORD n_buf = 0;
+	for (size_t i = 0; i < count && n_buf < NETWORK_SENDV_MAX_SEGMENTS;
+		 i++) {
+		size_t skip = (i == 0) ? first_offset : 0;
+		if (buffers[i].length <= skip)
+			continue;
+		wsabuf[n_buf].buf = (char *)buffers[i].data + skip;
+		wsabuf[n_buf].len = (ULONG)(buffers[i].length - skip);
+		n_buf++;
+	}
+	if (n_buf == 0) {
+		*sent = 0;
+		return 0;
+	}
+
+	DWORD n = 0;
+	if (WSASend((SOCKET)fd, wsabuf, n_buf, &n, 0, NULL, NULL) ==
+		SOCKET_ERROR) {
+		if (WSAGetLastError() == WSAEWOULDBLOCK)
+			return 1;
+		return -1;
+	}
+	*sent = (size_t)n;
+	return 0;
+}
+
+/* ------------------------------------------------------------------
+ * Zero-copy send
+ *
+ * Winsock has no MSG_ZEROCOPY equivalent for non-overlapped sockets;
+ * reporting it as unsupported makes the core fall back to plain send.
+ * ------------------------------------------------------------------ */
+
+int fun_network_arch_tcp_enable_zerocopy(intptr_t fd)
+{
+	(void)fd;
+	return -1;
+}
+
+int fun_network_arch_tcp_send_zerocopy(intptr_t fd, const void *data,
+									   size_t len, size_t *sent)
+{
+	return fun_network_arch_tcp_send(fd, data, len, sent);
+}
+
+int fun_network_arch_tcp_reap_zerocopy(intptr_t fd, size_t *completed)
+{
+	(void)fd;
+	*completed = 0;
+	return 0;
+}
+
+/* ------------------------------------------------------------------
+ * File send
+ *
+ * TransmitFile blocks on non-overlapped sockets, so the file range is
+ * staged through a stack buffer instead.  Only the bytes the socket
+ * accepted are reported, so the core re-reads the unsent tail.
+ * ------------------------------------------------------------------ */
+
+#define NETWORK_SEND_FILE_STAGING (64 * 1024)
+
+int fun_network_arch_file_open(const char *path, intptr_t *out_fd,
+							   uint64_t *out_size)
+{
+	HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+						   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (h == INVALID_HANDLE_VALUE)
+		return -1;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(h, &size)) {
+		CloseHandle(h);
+		return -1;
+	}
+
+	*out_fd = (intptr_t)h;
+	*out_size = (uint64_t)size.QuadPart;
+	return 0;
+}
+
+int fun_network_arch_tcp_send_file(intptr_t fd, intptr_t file_fd,
+								   uint64_t offset, size_t len, size_t *sent)
+{
+	char staging[NETWORK_SEND_FILE_STAGING];
+	if (len > sizeof(staging))
+		len = sizeof(staging);
+
+	OVERLAPPED ov;
+	memset(&ov, 0, sizeof(ov));
+	ov.Offset = (DWORD)(offset & 0xFFFFFFFFu);
+	ov.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD got = 0;
+	if (!ReadFile((HANDLE)file_fd, staging, (DWORD)len, &got, &ov)) {
+		if (GetLastError() != ERROR_HANDLE_EOF)
+			return -1;
+	}
+	if (got == 0) {
+		*sent = 0;
+		return 0;
+	}
+
+	return fun_network_arch_tcp_send(fd, staging, got, sent);
+}
+
+void fun_network_arch_file_close(intptr_t file_fd)
+{
+	CloseHandle((HANDLE)file_fd);
+}
+
 /* ------------------------------------------------------------------
  * fun_network_arch_tcp_recv
  *
@@ -202,6 +326,23 @@ int fun_network_arch_tcp_recv(intptr_t fd, void *data, size_t len,
 	return 0;
 }
 
+/* ------------------------------------------------------------------
+ * fun_network_arch_tcp_check_alive
+ *
+ * Peek one byte on the (non-blocking) socket.  Would-block means the
+ * peer is still connected and idle.
+ * Returns 0 = alive, -1 = closed, error or unsolicited data.
+ * ------------------------------------------------------------------ */
+
+int fun_network_arch_tcp_check_alive(intptr_t fd)
+{
+	char byte;
+	int n = recv((SOCKET)fd, &byte, 1, MSG_PEEK);
+	if (n == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK)
+		return 0;
+	return -1;
+}
+
 /* ------------------------------------------------------------------
  * fun_network_arch_tcp_close_fd
  * ------------------------------------------------------------------ */
@@ -4,11 +4,26 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+typedef struct StreamReadahead StreamReadahead;
+typedef struct StreamWriteBehind StreamWriteBehind;
+
 typedef struct {
 	FileStream *stream;
 	int file_descriptor;
 	uint64_t file_size;
 	bool file_opened;
+	StreamReadahead *readahead; /* NULL unless opened for readahead */
+	StreamWriteBehind *write_behind; /* NULL unless opened write-behind */
 } StreamReadState;
 
-AsyncStatus poll_stream_open(AsyncResult *result);
\ No newline at end of file
+AsyncStatus poll_stream_open(AsyncResult *result);
+
+/* Readahead streams (streamRead.c) */
+AsyncResult stream_readahead_read(FileStream *stream, uint64_t *bytes_read);
+void stream_readahead_close(StreamReadState *state);
+
+/* Write-behind streams (streamWrite.c) */
+AsyncResult stream_write_behind_write(FileStream *stream, Memory data,
+									  uint64_t data_size);
+AsyncResult stream_write_behind_seek(FileStream *stream, uint64_t position);
+void stream_write_behind_close(StreamReadState *state);
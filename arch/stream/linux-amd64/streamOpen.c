@@ -120,7 +120,9 @@ AsyncResult fun_stream_open(String file_path, StreamMode mode, Memory buffer,
 	*state = (StreamReadState){ .stream = stream,
 								.file_descriptor = -1,
 								.file_size = 0,
-								.file_opened = false };
+								.file_opened = false,
+								.readahead = NULL,
+								.write_behind = NULL };
 
 	stream->internal_state = state;
 
@@ -141,6 +143,9 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 			flags = O_RDONLY;
 		} else if (stream->mode == STREAM_MODE_WRITE) {
 			flags = O_WRONLY | O_CREAT | O_TRUNC;
+		} else if (state->write_behind) {
+			/* Writes in flight together carry their own offsets. */
+			flags = O_WRONLY | O_CREAT;
 		} else {
 			flags = O_WRONLY | O_CREAT | O_APPEND;
 		}
@@ -158,7 +163,7 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 
 		state->file_descriptor = fd;
 
-		if (stream->mode == STREAM_MODE_READ) {
+		if (stream->mode == STREAM_MODE_READ || state->write_behind) {
 			struct stat file_stat;
 			if (syscall2(SYS_fstat, fd, (long)&file_stat) < 0) {
 				syscall1(SYS_close, fd);
@@ -179,6 +184,12 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 void arch_stream_close_handle(void *internal_state)
 {
 	StreamReadState *state = (StreamReadState *)internal_state;
+	if (state && state->readahead) {
+		stream_readahead_close(state);
+	}
+	if (state && state->write_behind) {
+		stream_write_behind_close(state);
+	}
 	if (state && state->file_descriptor != -1) {
 		syscall1(SYS_close, state->file_descriptor);
 	}
@@ -1,4 +1,5 @@
 #include "stream.h"
+#include "../../file/linux-amd64/fileRing.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -12,6 +13,10 @@ typedef long off_t;
 #define SYS_read 0
 #define SYS_close 3
 #define SYS_lseek 8
+#define SYS_pread64 17
+
+#define IORING_OP_READ 22
+#define EINTR 4
 
 #define SEEK_SET 0
 
@@ -56,6 +61,17 @@ static int sys_close(int fd)
 	return (int)syscall1(SYS_close, fd);
 }
 
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
 AsyncStatus poll_stream_read(AsyncResult *result)
 {
 	StreamReadAsyncState *state = (StreamReadAsyncState *)result->state;
@@ -146,6 +162,11 @@ AsyncResult fun_stream_read(FileStream *stream, uint64_t *bytes_read)
 							  .error = ERROR_RESULT_NULL_POINTER };
 	}
 
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	if (stream_state && stream_state->readahead) {
+		return stream_readahead_read(stream, bytes_read);
+	}
+
 	MemoryResult state_result =
 		fun_memory_allocate(sizeof(StreamReadAsyncState));
 	if (fun_error_is_error(state_result.error)) {
@@ -170,4 +191,355 @@ AsyncResult fun_stream_read(FileStream *stream, uint64_t *bytes_read)
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+// ------------------------------------------------------------------
+// Readahead
+// ------------------------------------------------------------------
+
+/*
+ * The slots form a queue in file order: deliver is the next slot to hand
+ * to the caller and the in_flight slots after it have reads outstanding
+ * on the shared ring.  The slot before deliver belongs to the caller
+ * until the next fun_stream_read.  When the ring cannot be used at all,
+ * a slot is filled with pread on submission instead.
+ */
+
+typedef struct {
+	char *data;
+	uint64_t offset;
+	uint64_t length;
+	uint64_t filled;
+	FileRingRequest request;
+} ReadaheadSlot;
+
+struct StreamReadahead {
+	ReadaheadSlot slots[STREAM_READAHEAD_MAX_BUFFERS];
+	uint32_t slot_count;
+	uint32_t deliver;
+	uint32_t in_flight;
+	bool holding; /* the caller still has the slot before deliver */
+	uint64_t next_offset; /* first byte not yet assigned to a slot */
+	uint64_t seek_offset; /* target of the fun_stream_seek in progress */
+};
+
+typedef struct {
+	FileStream *stream;
+	uint64_t *bytes_read;
+	bool started;
+} StreamReadaheadAsyncState;
+
+/*
+ * Start reading the unfilled part of slot.  Returns 0 once started (or
+ * done synchronously), 1 when the ring is full, or a negative errno.
+ */
+static long readahead_submit(int fd, ReadaheadSlot *slot)
+{
+	uint64_t remaining = slot->length - slot->filled;
+	if (remaining > FILE_RING_MAX_IO_BYTES)
+		remaining = FILE_RING_MAX_IO_BYTES;
+
+	struct io_uring_sqe sqe = { 0 };
+	sqe.opcode = IORING_OP_READ;
+	sqe.fd = fd;
+	sqe.off = slot->offset + slot->filled;
+	sqe.addr = (uint64_t)(long)(slot->data + slot->filled);
+	sqe.len = (uint32_t)remaining;
+
+	slot->request = (FileRingRequest){ 0 };
+	long ret = file_ring_submit(&sqe, &slot->request);
+	if (ret >= 0)
+		return ret;
+
+	/* No ring: read now and let the slot look completed. */
+	do {
+		ret = syscall4(SYS_pread64, fd, (long)sqe.addr, (long)sqe.len,
+					   (long)sqe.off);
+	} while (ret == -EINTR);
+	slot->request = (FileRingRequest){ .res = (int32_t)ret,
+									   .submitted = true,
+									   .done = true };
+	return 0;
+}
+
+/* Give every free slot the next chunk of the file. */
+static long readahead_fill(StreamReadState *state)
+{
+	StreamReadahead *readahead = state->readahead;
+	uint64_t chunk = state->stream->buffer_size;
+
+	while (readahead->in_flight + readahead->holding <
+			   readahead->slot_count &&
+		   readahead->next_offset < state->file_size) {
+		uint32_t index = (readahead->deliver + readahead->in_flight) %
+						 readahead->slot_count;
+		ReadaheadSlot *slot = &readahead->slots[index];
+		uint64_t remaining = state->file_size - readahead->next_offset;
+		slot->offset = readahead->next_offset;
+		slot->length = remaining < chunk ? remaining : chunk;
+		slot->filled = 0;
+
+		long ret = readahead_submit(state->file_descriptor, slot);
+		if (ret == 1)
+			break; /* ring full: the next read tries again */
+		if (ret < 0)
+			return ret;
+		readahead->next_offset += slot->length;
+		readahead->in_flight++;
+	}
+	return 0;
+}
+
+static AsyncStatus poll_stream_readahead(AsyncResult *result)
+{
+	StreamReadaheadAsyncState *state =
+		(StreamReadaheadAsyncState *)result->state;
+	FileStream *stream = state->stream;
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	StreamReadahead *readahead = stream_state->readahead;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->started) {
+		/* The caller is done with the previous chunk. */
+		readahead->holding = false;
+		state->started = true;
+	}
+
+	long ret = readahead_fill(stream_state);
+	if (ret < 0) {
+		result->error = fun_error_result(-ret, "io_uring submit failed");
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
+
+	if (readahead->in_flight == 0) {
+		if (readahead->next_offset < stream_state->file_size)
+			return ASYNC_PENDING;
+		stream->end_of_stream = true;
+		stream->has_data_available = false;
+		*state->bytes_read = 0;
+		result->error = ERROR_RESULT_NO_ERROR;
+		goto cleanup;
+	}
+
+	ReadaheadSlot *slot = &readahead->slots[readahead->deliver];
+	if (!slot->request.submitted) {
+		ret = readahead_submit(stream_state->file_descriptor, slot);
+		if (ret == 1)
+			return ASYNC_PENDING;
+		if (ret < 0) {
+			result->error = fun_error_result(-ret, "io_uring submit failed");
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+	if (!file_ring_reap(&slot->request))
+		return ASYNC_PENDING;
+
+	if (slot->request.res <= 0) {
+		result->error =
+			slot->request.res < 0 ?
+				fun_error_result(-slot->request.res, "Failed to read file") :
+				ERROR_RESULT_FILE_UNEXPECTED_EOF;
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
+
+	slot->filled += (uint64_t)slot->request.res;
+	if (slot->filled < slot->length) {
+		/* Partial read - submit the rest of the slot on the next poll. */
+		slot->request = (FileRingRequest){ 0 };
+		return ASYNC_PENDING;
+	}
+
+	stream->buffer = slot->data;
+	stream->current_position = slot->offset + slot->length;
+	stream->bytes_processed += slot->length;
+	*state->bytes_read = slot->length;
+	readahead->deliver = (readahead->deliver + 1) % readahead->slot_count;
+	readahead->in_flight--;
+	readahead->holding = true;
+
+	if (stream->current_position >= stream_state->file_size) {
+		stream->end_of_stream = true;
+		stream->has_data_available = false;
+	}
+	result->error = ERROR_RESULT_NO_ERROR;
+
+cleanup:
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+AsyncResult stream_readahead_read(FileStream *stream, uint64_t *bytes_read)
+{
+	MemoryResult state_result =
+		fun_memory_allocate(sizeof(StreamReadaheadAsyncState));
+	if (fun_error_is_error(state_result.error)) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = state_result.error };
+	}
+
+	StreamReadaheadAsyncState *state =
+		(StreamReadaheadAsyncState *)state_result.value;
+	*state = (StreamReadaheadAsyncState){ .stream = stream,
+										  .bytes_read = bytes_read,
+										  .started = false };
+
+	return (AsyncResult){ .poll = poll_stream_readahead,
+						  .state = state,
+						  .status = ASYNC_PENDING,
+						  .error = ERROR_RESULT_NO_ERROR };
+}
+
+void stream_readahead_close(StreamReadState *state)
+{
+	StreamReadahead *readahead = state->readahead;
+
+	/* The kernel may still be writing into the slots. */
+	for (uint32_t i = 0; i < readahead->in_flight; i++) {
+		ReadaheadSlot *slot = &readahead->slots[(readahead->deliver + i) %
+												readahead->slot_count];
+		while (slot->request.submitted && !file_ring_reap(&slot->request))
+			;
+	}
+	fun_memory_free((Memory *)&state->readahead);
+}
+
+static AsyncStatus poll_stream_open_readahead(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_open(result);
+	if (status != ASYNC_COMPLETED)
+		return status;
+
+	/* Start the first chunks while the caller gets ready. */
+	FileStream *stream = (FileStream *)result->state;
+	long ret = readahead_fill((StreamReadState *)stream->internal_state);
+	if (ret < 0) {
+		result->error = fun_error_result(-ret, "io_uring submit failed");
+		return ASYNC_ERROR;
+	}
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_open_readahead(String file_path, Memory buffer,
+									  uint64_t buffer_size,
+									  uint32_t buffer_count)
+{
+	if (buffer_count < 2 || buffer_count > STREAM_READAHEAD_MAX_BUFFERS) {
+		return (AsyncResult){
+			.status = ASYNC_ERROR,
+			.error = ERROR_RESULT_STREAM_INVALID_BUFFER_COUNT
+		};
+	}
+	if (buffer_size > UINT64_MAX / buffer_count) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	}
+
+	AsyncResult result = fun_stream_open(file_path, STREAM_MODE_READ, buffer,
+										 buffer_size, FILE_MODE_RING_BASED);
+	if (result.status == ASYNC_ERROR) {
+		return result;
+	}
+
+	MemoryResult readahead_result =
+		fun_memory_allocate(sizeof(StreamReadahead));
+	if (fun_error_is_error(readahead_result.error)) {
+		fun_stream_close((FileStream *)result.state);
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = readahead_result.error };
+	}
+
+	StreamReadahead *readahead = (StreamReadahead *)readahead_result.value;
+	*readahead = (StreamReadahead){ .slot_count = buffer_count };
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		readahead->slots[i].data = (char *)buffer + i * buffer_size;
+	}
+
+	FileStream *stream = (FileStream *)result.state;
+	((StreamReadState *)stream->internal_state)->readahead = readahead;
+	result.poll = poll_stream_open_readahead;
+	return result;
+}
+
+// ------------------------------------------------------------------
+// Seeking
+// ------------------------------------------------------------------
+
+static AsyncStatus poll_stream_readahead_seek(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamReadahead *readahead = state->readahead;
+
+	/* Reads for the old position must land before their slots refill. */
+	while (readahead->in_flight > 0) {
+		ReadaheadSlot *slot = &readahead->slots[readahead->deliver];
+		if (slot->request.submitted && !file_ring_reap(&slot->request))
+			return ASYNC_PENDING;
+		slot->request = (FileRingRequest){ 0 };
+		readahead->deliver = (readahead->deliver + 1) % readahead->slot_count;
+		readahead->in_flight--;
+	}
+
+	readahead->holding = false;
+	readahead->next_offset = readahead->seek_offset;
+	stream->current_position = readahead->seek_offset;
+	stream->end_of_stream = false;
+	stream->has_data_available = true;
+
+	long ret = readahead_fill(state);
+	if (ret < 0) {
+		result->error = fun_error_result(-ret, "io_uring submit failed");
+		return ASYNC_ERROR;
+	}
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_seek(FileStream *stream, uint64_t position)
+{
+	if (!stream) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (!state || state->file_descriptor < 0) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  3, "Stream not properly opened") };
+	}
+	if (stream->mode == STREAM_MODE_APPEND) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_STREAM_NOT_SEEKABLE };
+	}
+	if (stream->mode == STREAM_MODE_READ && position > state->file_size) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  ERROR_CODE_INDEX_OUT_OF_BOUNDS,
+								  "Seek past the end of the file") };
+	}
+
+	if (state->write_behind) {
+		return stream_write_behind_seek(stream, position);
+	}
+	if (state->readahead) {
+		state->readahead->seek_offset = position;
+		AsyncResult result = { .poll = poll_stream_readahead_seek,
+							   .state = stream,
+							   .status = ASYNC_PENDING,
+							   .error = ERROR_RESULT_NO_ERROR };
+		result.status = poll_stream_readahead_seek(&result);
+		return result;
+	}
+
+	/* Plain streams position every read and write themselves. */
+	stream->current_position = position;
+	if (stream->mode == STREAM_MODE_READ) {
+		stream->end_of_stream = false;
+		stream->has_data_available = true;
+	}
+	return (AsyncResult){ .status = ASYNC_COMPLETED,
+						  .error = ERROR_RESULT_NO_ERROR };
+}
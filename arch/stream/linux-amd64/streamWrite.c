@@ -1,4 +1,5 @@
 #include "stream.h"
+#include "../../file/linux-amd64/fileRing.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -9,6 +10,10 @@ typedef long ssize_t;
 
 #define SYS_write 1
 #define SYS_lseek 8
+#define SYS_pwrite64 18
+
+#define IORING_OP_WRITE 23
+#define EINTR 4
 
 #define SEEK_SET 0
 
@@ -40,6 +45,17 @@ static long sys_lseek(int fd, long offset, int whence)
 	return syscall3(SYS_lseek, fd, offset, whence);
 }
 
+static inline long syscall4(long n, long a1, long a2, long a3, long a4)
+{
+	long ret;
+	register long r10 __asm__("r10") = a4;
+	__asm__ __volatile__("syscall"
+						 : "=a"(ret)
+						 : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10)
+						 : "rcx", "r11", "memory");
+	return ret;
+}
+
 static AsyncStatus poll_stream_write(AsyncResult *result)
 {
 	StreamWriteAsyncState *state = (StreamWriteAsyncState *)result->state;
@@ -113,6 +129,11 @@ AsyncResult fun_stream_write(FileStream *stream, Memory data,
 							  .error = ERROR_RESULT_NULL_POINTER };
 	}
 
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	if (stream_state && stream_state->write_behind) {
+		return stream_write_behind_write(stream, data, data_size);
+	}
+
 	// Allocate async state
 	MemoryResult state_result =
 		fun_memory_allocate(sizeof(StreamWriteAsyncState));
@@ -145,3 +166,353 @@ AsyncResult fun_stream_write(FileStream *stream, Memory data,
 
 	return result;
 }
+
+// ------------------------------------------------------------------
+// Write-behind
+// ------------------------------------------------------------------
+
+/*
+ * The slots form a queue in file order: oldest is the first slot handed
+ * to the kernel and the in_flight slots from it on have writes
+ * outstanding on the shared ring; the slot after them is being filled.
+ * Every slot carries its own file offset, so writes may complete in any
+ * order.  When the ring cannot be used at all, a slot is written with
+ * pwrite on hand-off instead.
+ */
+
+typedef struct {
+	char *data;
+	uint64_t offset;
+	uint64_t length; /* bytes filled */
+	uint64_t written;
+	FileRingRequest request;
+} WriteBehindSlot;
+
+struct StreamWriteBehind {
+	WriteBehindSlot slots[STREAM_WRITE_BEHIND_MAX_BUFFERS];
+	uint32_t slot_count;
+	uint64_t slot_size;
+	uint32_t oldest;
+	uint32_t in_flight;
+	uint64_t next_offset; /* file offset of the next byte accepted */
+	Memory data; /* rest of the fun_stream_write in progress */
+	uint64_t data_size;
+	ErrorResult error; /* first failed background write */
+	uint64_t seek_offset; /* target of the fun_stream_seek in progress */
+};
+
+/*
+ * Start writing the unwritten part of slot.  Returns 0 once started (or
+ * done synchronously), 1 when the ring is full, or a negative errno.
+ */
+static long write_behind_submit(int fd, WriteBehindSlot *slot)
+{
+	uint64_t remaining = slot->length - slot->written;
+	if (remaining > FILE_RING_MAX_IO_BYTES)
+		remaining = FILE_RING_MAX_IO_BYTES;
+
+	struct io_uring_sqe sqe = { 0 };
+	sqe.opcode = IORING_OP_WRITE;
+	sqe.fd = fd;
+	sqe.off = slot->offset + slot->written;
+	sqe.addr = (uint64_t)(long)(slot->data + slot->written);
+	sqe.len = (uint32_t)remaining;
+
+	slot->request = (FileRingRequest){ 0 };
+	long ret = file_ring_submit(&sqe, &slot->request);
+	if (ret >= 0)
+		return ret;
+
+	/* No ring: write now and let the slot look completed. */
+	do {
+		ret = syscall4(SYS_pwrite64, fd, (long)sqe.addr, (long)sqe.len,
+					   (long)sqe.off);
+	} while (ret == -EINTR);
+	slot->request = (FileRingRequest){ .res = (int32_t)ret,
+									   .submitted = true,
+									   .done = true };
+	return 0;
+}
+
+/* Submit the slots a full ring turned away earlier. */
+static void write_behind_resubmit(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+	for (uint32_t i = 0; i < write_behind->in_flight; i++) {
+		WriteBehindSlot *slot =
+			&write_behind->slots[(write_behind->oldest + i) %
+								 write_behind->slot_count];
+		if (!slot->request.submitted &&
+			write_behind_submit(state->file_descriptor, slot) == 1)
+			return;
+	}
+}
+
+/* Hand the slot being filled to the kernel. */
+static void write_behind_hand_off(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+	WriteBehindSlot *slot =
+		&write_behind->slots[(write_behind->oldest + write_behind->in_flight) %
+							 write_behind->slot_count];
+	slot->written = 0;
+	slot->request = (FileRingRequest){ 0 };
+	write_behind->in_flight++;
+	/* When the ring is full the slot is submitted again later. */
+	if (fun_error_is_ok(write_behind->error))
+		write_behind_submit(state->file_descriptor, slot);
+}
+
+/*
+ * Wait for the oldest slot to be written and free it.  Returns true once
+ * it is free; false while it is still being written.  A failed write
+ * frees the slot too and is kept in write_behind->error.
+ */
+static bool write_behind_reap(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+	WriteBehindSlot *slot = &write_behind->slots[write_behind->oldest];
+
+	if (fun_error_is_ok(write_behind->error)) {
+		if (!slot->request.submitted &&
+			write_behind_submit(state->file_descriptor, slot) == 1)
+			return false;
+		if (!file_ring_reap(&slot->request))
+			return false;
+		if (slot->request.res <= 0) {
+			write_behind->error =
+				slot->request.res < 0 ?
+					fun_error_result(-slot->request.res,
+									 "Failed to write file") :
+					fun_error_result(1, "Unable to write all data");
+		} else {
+			slot->written += (uint64_t)slot->request.res;
+			if (slot->written < slot->length) {
+				/* Partial write - submit the rest on the next poll. */
+				slot->request = (FileRingRequest){ 0 };
+				return false;
+			}
+		}
+	} else if (slot->request.submitted) {
+		/* Already failed: only wait until the kernel lets go. */
+		while (!file_ring_reap(&slot->request))
+			;
+	}
+
+	slot->length = 0;
+	slot->request = (FileRingRequest){ 0 };
+	write_behind->oldest =
+		(write_behind->oldest + 1) % write_behind->slot_count;
+	write_behind->in_flight--;
+	return true;
+}
+
+static AsyncStatus poll_stream_write_behind(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamWriteBehind *write_behind = state->write_behind;
+
+	write_behind_resubmit(state);
+	while (write_behind->data_size > 0) {
+		if (fun_error_is_error(write_behind->error)) {
+			write_behind->data_size = 0;
+			result->error = write_behind->error;
+			return ASYNC_ERROR;
+		}
+		if (write_behind->in_flight == write_behind->slot_count) {
+			/* Backpressure: every slot is still being written. */
+			if (!write_behind_reap(state))
+				return ASYNC_PENDING;
+			continue;
+		}
+
+		WriteBehindSlot *slot =
+			&write_behind->slots[(write_behind->oldest +
+								  write_behind->in_flight) %
+								 write_behind->slot_count];
+		if (slot->length == 0)
+			slot->offset = write_behind->next_offset;
+		uint64_t space = write_behind->slot_size - slot->length;
+		uint64_t count = write_behind->data_size < space ?
+							 write_behind->data_size :
+							 space;
+		fun_memory_copy(write_behind->data, slot->data + slot->length, count);
+		slot->length += count;
+		write_behind->data = (char *)write_behind->data + count;
+		write_behind->data_size -= count;
+		write_behind->next_offset += count;
+		stream->current_position += count;
+		stream->bytes_processed += count;
+
+		if (slot->length == write_behind->slot_size)
+			write_behind_hand_off(state);
+	}
+
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult stream_write_behind_write(FileStream *stream, Memory data,
+									  uint64_t data_size)
+{
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamWriteBehind *write_behind = state->write_behind;
+	write_behind->data = data;
+	write_behind->data_size = data_size;
+
+	/* Copies into a slot with room complete without allocating. */
+	AsyncResult result = { .poll = poll_stream_write_behind,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_write_behind(&result);
+	return result;
+}
+
+static AsyncStatus poll_stream_flush(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamWriteBehind *write_behind = state->write_behind;
+
+	if (write_behind->in_flight < write_behind->slot_count) {
+		WriteBehindSlot *slot =
+			&write_behind->slots[(write_behind->oldest +
+								  write_behind->in_flight) %
+								 write_behind->slot_count];
+		if (slot->length > 0)
+			write_behind_hand_off(state);
+	}
+	while (write_behind->in_flight > 0) {
+		if (!write_behind_reap(state))
+			return ASYNC_PENDING;
+	}
+
+	result->error = write_behind->error;
+	return fun_error_is_error(result->error) ? ASYNC_ERROR : ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_flush(FileStream *stream)
+{
+	if (!stream) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (!state || !state->write_behind) {
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+	}
+
+	AsyncResult result = { .poll = poll_stream_flush,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_flush(&result);
+	return result;
+}
+
+void stream_write_behind_close(StreamReadState *state)
+{
+	/* Flush what is left; the kernel must be done with the slots. */
+	AsyncResult flush = { .poll = poll_stream_flush,
+						  .state = state->stream,
+						  .status = ASYNC_PENDING };
+	while (poll_stream_flush(&flush) == ASYNC_PENDING)
+		;
+	fun_memory_free((Memory *)&state->write_behind);
+}
+
+static AsyncStatus poll_stream_write_behind_seek(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_flush(result);
+	if (status != ASYNC_COMPLETED)
+		return status;
+
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	state->write_behind->next_offset = state->write_behind->seek_offset;
+	stream->current_position = state->write_behind->seek_offset;
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult stream_write_behind_seek(FileStream *stream, uint64_t position)
+{
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	state->write_behind->seek_offset = position;
+
+	/* Bytes already accepted belong at the old position: flush them. */
+	AsyncResult result = { .poll = poll_stream_write_behind_seek,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_write_behind_seek(&result);
+	return result;
+}
+
+static AsyncStatus poll_stream_open_write_behind(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_open(result);
+	if (status != ASYNC_COMPLETED)
+		return status;
+
+	/* Appends continue from the end of the file as it was opened. */
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (stream->mode == STREAM_MODE_APPEND) {
+		state->write_behind->next_offset = state->file_size;
+		stream->current_position = state->file_size;
+	}
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_open_write_behind(String file_path, StreamMode mode,
+										 Memory buffer, uint64_t buffer_size,
+										 uint32_t buffer_count)
+{
+	if (mode != STREAM_MODE_WRITE && mode != STREAM_MODE_APPEND) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  1, "Write-behind needs a write mode") };
+	}
+	if (buffer_count < 2 || buffer_count > STREAM_WRITE_BEHIND_MAX_BUFFERS) {
+		return (AsyncResult){
+			.status = ASYNC_ERROR,
+			.error = ERROR_RESULT_STREAM_INVALID_BUFFER_COUNT
+		};
+	}
+	if (buffer_size > UINT64_MAX / buffer_count) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	}
+
+	AsyncResult result = fun_stream_open(file_path, mode, buffer, buffer_size,
+										 FILE_MODE_RING_BASED);
+	if (result.status == ASYNC_ERROR) {
+		return result;
+	}
+
+	MemoryResult write_behind_result =
+		fun_memory_allocate(sizeof(StreamWriteBehind));
+	if (fun_error_is_error(write_behind_result.error)) {
+		fun_stream_close((FileStream *)result.state);
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = write_behind_result.error };
+	}
+
+	StreamWriteBehind *write_behind =
+		(StreamWriteBehind *)write_behind_result.value;
+	*write_behind = (StreamWriteBehind){ .slot_count = buffer_count,
+										 .slot_size = buffer_size,
+										 .error = ERROR_RESULT_NO_ERROR };
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		write_behind->slots[i].data = (char *)buffer + i * buffer_size;
+	}
+
+	FileStream *stream = (FileStream *)result.state;
+	((StreamReadState *)stream->internal_state)->write_behind = write_behind;
+	result.poll = poll_stream_open_write_behind;
+	return result;
+}
@@ -2,11 +2,27 @@
 
 #include <windows.h>
 
+typedef struct StreamReadahead StreamReadahead;
+typedef struct StreamWriteBehind StreamWriteBehind;
+
 typedef struct {
 	FileStream *stream; // Parent stream reference
 	HANDLE file_handle; // Windows file handle
 	uint64_t file_size; // Total file size
 	bool file_opened; // Initialization state
+	StreamReadahead *readahead; // Overlapped reads, NULL unless readahead
+	StreamWriteBehind *write_behind; // NULL unless opened write-behind
 } StreamReadState;
 
 AsyncStatus poll_stream_open(AsyncResult *result);
+
+// Readahead streams (streamRead.c)
+AsyncResult stream_readahead_read(FileStream *stream, uint64_t *bytes_read);
+void stream_readahead_close(StreamReadState *state);
+
+// Write-behind streams (streamWrite.c)
+AsyncResult stream_write_behind_write(FileStream *stream, Memory data,
+									  uint64_t data_size);
+AsyncResult stream_write_behind_seek(FileStream *stream, uint64_t position);
+void stream_write_behind_close(StreamReadState *state);
+
@@ -40,7 +40,9 @@ AsyncResult fun_stream_open(String file_path, StreamMode mode, Memory buffer,
 	*state = (StreamReadState){ .stream = stream,
 								.file_handle = INVALID_HANDLE_VALUE,
 								.file_size = 0,
-								.file_opened = false };
+								.file_opened = false,
+								.readahead = NULL,
+								.write_behind = NULL };
 
 	stream->internal_state = state;
 
@@ -73,9 +75,11 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 		DWORD creation = (stream->mode == STREAM_MODE_WRITE) ? CREATE_ALWAYS :
 															   OPEN_EXISTING;
 
+		DWORD flags = state->readahead || state->write_behind ?
+						  FILE_FLAG_OVERLAPPED :
+						  FILE_ATTRIBUTE_NORMAL;
 		state->file_handle = CreateFileW(wide_path, access, FILE_SHARE_READ,
-										 NULL, creation, FILE_ATTRIBUTE_NORMAL,
-										 NULL);
+										 NULL, creation, flags, NULL);
 
 		if (state->file_handle == INVALID_HANDLE_VALUE) {
 			result->error =
@@ -83,8 +87,8 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 			return ASYNC_ERROR;
 		}
 
-		// Get file size for read operations
-		if (stream->mode == STREAM_MODE_READ) {
+		// Get file size for read operations and write-behind appends
+		if (stream->mode == STREAM_MODE_READ || state->write_behind) {
 			LARGE_INTEGER file_size;
 			if (!GetFileSizeEx(state->file_handle, &file_size)) {
 				CloseHandle(state->file_handle);
@@ -107,6 +111,12 @@ AsyncStatus poll_stream_open(AsyncResult *result)
 void arch_stream_close_handle(void *internal_state)
 {
 	StreamReadState *state = (StreamReadState *)internal_state;
+	if (state && state->readahead) {
+		stream_readahead_close(state);
+	}
+	if (state && state->write_behind) {
+		stream_write_behind_close(state);
+	}
 	if (state && state->file_handle != INVALID_HANDLE_VALUE) {
 		CloseHandle(state->file_handle);
 	}
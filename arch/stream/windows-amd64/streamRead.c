@@ -103,6 +103,12 @@ AsyncResult fun_stream_read(FileStream *stream, uint64_t *bytes_read)
 							  .error = ERROR_RESULT_NULL_POINTER };
 	}
 
+	// Readahead streams keep their own queue of overlapped reads
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	if (stream_state && stream_state->readahead) {
+		return stream_readahead_read(stream, bytes_read);
+	}
+
 	// Allocate async state
 	MemoryResult state_result =
 		fun_memory_allocate(sizeof(StreamReadAsyncState));
@@ -132,3 +138,357 @@ AsyncResult fun_stream_read(FileStream *stream, uint64_t *bytes_read)
 
 	return result;
 }
+
+// ------------------------------------------------------------------
+// Readahead
+// ------------------------------------------------------------------
+
+// Largest single ReadFile; a longer slot is read in several pieces
+#define STREAM_READAHEAD_MAX_IO_BYTES (1UL << 30)
+
+#define STREAM_READAHEAD_POLL_MS 1
+
+// Slots form a queue in file order: deliver is the next slot to hand to
+// the caller and the in_flight slots after it have overlapped reads
+// outstanding.  The slot before deliver belongs to the caller until the
+// next fun_stream_read.
+typedef struct {
+	char *data;
+	uint64_t offset;
+	uint64_t length;
+	uint64_t filled;
+	OVERLAPPED overlapped;
+	bool submitted;
+} ReadaheadSlot;
+
+struct StreamReadahead {
+	ReadaheadSlot slots[STREAM_READAHEAD_MAX_BUFFERS];
+	uint32_t slot_count;
+	uint32_t deliver;
+	uint32_t in_flight;
+	bool holding;
+	uint64_t next_offset;
+	uint64_t seek_offset; // Target of the fun_stream_seek in progress
+};
+
+typedef struct {
+	FileStream *stream;
+	uint64_t *bytes_read;
+	bool started;
+} StreamReadaheadAsyncState;
+
+static ErrorResult readahead_submit(HANDLE file_handle, ReadaheadSlot *slot)
+{
+	uint64_t remaining = slot->length - slot->filled;
+	if (remaining > STREAM_READAHEAD_MAX_IO_BYTES) {
+		remaining = STREAM_READAHEAD_MAX_IO_BYTES;
+	}
+
+	uint64_t offset = slot->offset + slot->filled;
+	slot->overlapped.Offset = (DWORD)offset;
+	slot->overlapped.OffsetHigh = (DWORD)(offset >> 32);
+	if (!ReadFile(file_handle, slot->data + slot->filled, (DWORD)remaining,
+				  NULL, &slot->overlapped) &&
+		GetLastError() != ERROR_IO_PENDING) {
+		return fun_error_result(GetLastError(), "Failed to read file");
+	}
+	slot->submitted = true;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+// Give every free slot the next chunk of the file
+static ErrorResult readahead_fill(StreamReadState *state)
+{
+	StreamReadahead *readahead = state->readahead;
+	uint64_t chunk = state->stream->buffer_size;
+
+	while (readahead->in_flight + readahead->holding <
+			   readahead->slot_count &&
+		   readahead->next_offset < state->file_size) {
+		uint32_t index = (readahead->deliver + readahead->in_flight) %
+						 readahead->slot_count;
+		ReadaheadSlot *slot = &readahead->slots[index];
+		uint64_t remaining = state->file_size - readahead->next_offset;
+		slot->offset = readahead->next_offset;
+		slot->length = remaining < chunk ? remaining : chunk;
+		slot->filled = 0;
+
+		ErrorResult error = readahead_submit(state->file_handle, slot);
+		if (fun_error_is_error(error)) {
+			return error;
+		}
+		readahead->next_offset += slot->length;
+		readahead->in_flight++;
+	}
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static AsyncStatus poll_stream_readahead(AsyncResult *result)
+{
+	StreamReadaheadAsyncState *state =
+		(StreamReadaheadAsyncState *)result->state;
+	FileStream *stream = state->stream;
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	StreamReadahead *readahead = stream_state->readahead;
+	AsyncStatus final_status = ASYNC_COMPLETED;
+
+	if (!state->started) {
+		// The caller is done with the previous chunk
+		readahead->holding = false;
+		state->started = true;
+	}
+
+	result->error = readahead_fill(stream_state);
+	if (fun_error_is_error(result->error)) {
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
+
+	if (readahead->in_flight == 0) {
+		stream->end_of_stream = true;
+		stream->has_data_available = false;
+		*state->bytes_read = 0;
+		goto cleanup;
+	}
+
+	ReadaheadSlot *slot = &readahead->slots[readahead->deliver];
+	if (!slot->submitted) {
+		result->error = readahead_submit(stream_state->file_handle, slot);
+		if (fun_error_is_error(result->error)) {
+			final_status = ASYNC_ERROR;
+			goto cleanup;
+		}
+	}
+	if (WaitForSingleObject(slot->overlapped.hEvent,
+							STREAM_READAHEAD_POLL_MS) == WAIT_TIMEOUT) {
+		return ASYNC_PENDING;
+	}
+
+	DWORD transferred = 0;
+	BOOL read = GetOverlappedResult(stream_state->file_handle,
+									&slot->overlapped, &transferred, FALSE);
+	slot->submitted = false;
+	if (!read && GetLastError() != ERROR_HANDLE_EOF) {
+		result->error = fun_error_result(GetLastError(), "Failed to read file");
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
+	if (transferred == 0) {
+		result->error = ERROR_RESULT_FILE_UNEXPECTED_EOF;
+		final_status = ASYNC_ERROR;
+		goto cleanup;
+	}
+
+	slot->filled += transferred;
+	if (slot->filled < slot->length) {
+		// Partial read - submit the rest of the slot on the next poll
+		return ASYNC_PENDING;
+	}
+
+	stream->buffer = slot->data;
+	stream->current_position = slot->offset + slot->length;
+	stream->bytes_processed += slot->length;
+	*state->bytes_read = slot->length;
+	readahead->deliver = (readahead->deliver + 1) % readahead->slot_count;
+	readahead->in_flight--;
+	readahead->holding = true;
+
+	if (stream->current_position >= stream_state->file_size) {
+		stream->end_of_stream = true;
+		stream->has_data_available = false;
+	}
+	result->error = ERROR_RESULT_NO_ERROR;
+
+cleanup:
+	fun_memory_free((Memory *)&state);
+	return final_status;
+}
+
+AsyncResult stream_readahead_read(FileStream *stream, uint64_t *bytes_read)
+{
+	MemoryResult state_result =
+		fun_memory_allocate(sizeof(StreamReadaheadAsyncState));
+	if (fun_error_is_error(state_result.error)) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = state_result.error };
+	}
+
+	StreamReadaheadAsyncState *state =
+		(StreamReadaheadAsyncState *)state_result.value;
+	*state = (StreamReadaheadAsyncState){ .stream = stream,
+										  .bytes_read = bytes_read,
+										  .started = false };
+
+	return (AsyncResult){ .poll = poll_stream_readahead,
+						  .state = state,
+						  .status = ASYNC_PENDING,
+						  .error = ERROR_RESULT_NO_ERROR };
+}
+
+void stream_readahead_close(StreamReadState *state)
+{
+	StreamReadahead *readahead = state->readahead;
+
+	// Reads still in flight write into the caller's buffer; stop them
+	for (uint32_t i = 0; i < readahead->slot_count; i++) {
+		ReadaheadSlot *slot = &readahead->slots[i];
+		if (slot->submitted) {
+			DWORD transferred;
+			CancelIoEx(state->file_handle, &slot->overlapped);
+			GetOverlappedResult(state->file_handle, &slot->overlapped,
+								&transferred, TRUE);
+		}
+		if (slot->overlapped.hEvent) {
+			CloseHandle(slot->overlapped.hEvent);
+		}
+	}
+	fun_memory_free((Memory *)&state->readahead);
+}
+
+static AsyncStatus poll_stream_open_readahead(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_open(result);
+	if (status != ASYNC_COMPLETED) {
+		return status;
+	}
+
+	// Start the first chunks while the caller gets ready
+	FileStream *stream = (FileStream *)result->state;
+	result->error = readahead_fill((StreamReadState *)stream->internal_state);
+	return fun_error_is_error(result->error) ? ASYNC_ERROR : ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_open_readahead(String file_path, Memory buffer,
+									  uint64_t buffer_size,
+									  uint32_t buffer_count)
+{
+	if (buffer_count < 2 || buffer_count > STREAM_READAHEAD_MAX_BUFFERS) {
+		return (AsyncResult){
+			.status = ASYNC_ERROR,
+			.error = ERROR_RESULT_STREAM_INVALID_BUFFER_COUNT
+		};
+	}
+	if (buffer_size > UINT64_MAX / buffer_count) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	}
+
+	AsyncResult result = fun_stream_open(file_path, STREAM_MODE_READ, buffer,
+										 buffer_size, FILE_MODE_RING_BASED);
+	if (result.status == ASYNC_ERROR) {
+		return result;
+	}
+	FileStream *stream = (FileStream *)result.state;
+
+	MemoryResult readahead_result =
+		fun_memory_allocate(sizeof(StreamReadahead));
+	if (fun_error_is_error(readahead_result.error)) {
+		fun_stream_close(stream);
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = readahead_result.error };
+	}
+
+	StreamReadahead *readahead = (StreamReadahead *)readahead_result.value;
+	*readahead = (StreamReadahead){ .slot_count = buffer_count };
+	((StreamReadState *)stream->internal_state)->readahead = readahead;
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		readahead->slots[i].data = (char *)buffer + i * buffer_size;
+		readahead->slots[i].overlapped.hEvent =
+			CreateEventW(NULL, TRUE, FALSE, NULL);
+		if (!readahead->slots[i].overlapped.hEvent) {
+			ErrorResult error = fun_error_result(GetLastError(),
+												 "Failed to create event");
+			fun_stream_close(stream);
+			return (AsyncResult){ .status = ASYNC_ERROR, .error = error };
+		}
+	}
+
+	result.poll = poll_stream_open_readahead;
+	return result;
+}
+
+// ------------------------------------------------------------------
+// Seeking
+// ------------------------------------------------------------------
+
+static AsyncStatus poll_stream_readahead_seek(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamReadahead *readahead = state->readahead;
+
+	// Reads for the old position are no use; stop them before refilling
+	while (readahead->in_flight > 0) {
+		ReadaheadSlot *slot = &readahead->slots[readahead->deliver];
+		if (slot->submitted) {
+			CancelIoEx(state->file_handle, &slot->overlapped);
+			if (WaitForSingleObject(slot->overlapped.hEvent,
+									STREAM_READAHEAD_POLL_MS) ==
+				WAIT_TIMEOUT) {
+				return ASYNC_PENDING;
+			}
+			DWORD transferred;
+			GetOverlappedResult(state->file_handle, &slot->overlapped,
+								&transferred, FALSE);
+			slot->submitted = false;
+		}
+		readahead->deliver = (readahead->deliver + 1) % readahead->slot_count;
+		readahead->in_flight--;
+	}
+
+	readahead->holding = false;
+	readahead->next_offset = readahead->seek_offset;
+	stream->current_position = readahead->seek_offset;
+	stream->end_of_stream = false;
+	stream->has_data_available = true;
+
+	result->error = readahead_fill(state);
+	return fun_error_is_error(result->error) ? ASYNC_ERROR : ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_seek(FileStream *stream, uint64_t position)
+{
+	if (!stream) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (!state || state->file_handle == INVALID_HANDLE_VALUE) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  3, "Stream not properly opened") };
+	}
+	if (stream->mode == STREAM_MODE_APPEND) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_STREAM_NOT_SEEKABLE };
+	}
+	if (stream->mode == STREAM_MODE_READ && position > state->file_size) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  ERROR_CODE_INDEX_OUT_OF_BOUNDS,
+								  "Seek past the end of the file") };
+	}
+
+	if (state->write_behind) {
+		return stream_write_behind_seek(stream, position);
+	}
+	if (state->readahead) {
+		state->readahead->seek_offset = position;
+		AsyncResult result = { .poll = poll_stream_readahead_seek,
+							   .state = stream,
+							   .status = ASYNC_PENDING,
+							   .error = ERROR_RESULT_NO_ERROR };
+		result.status = poll_stream_readahead_seek(&result);
+		return result;
+	}
+
+	// Plain streams position every read and write themselves
+	stream->current_position = position;
+	if (stream->mode == STREAM_MODE_READ) {
+		stream->end_of_stream = false;
+		stream->has_data_available = true;
+	}
+	return (AsyncResult){ .status = ASYNC_COMPLETED,
+						  .error = ERROR_RESULT_NO_ERROR };
+}
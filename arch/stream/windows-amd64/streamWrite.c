@@ -84,6 +84,12 @@ AsyncResult fun_stream_write(FileStream *stream, Memory data,
 							  .error = ERROR_RESULT_NULL_POINTER };
 	}
 
+	// Write-behind streams copy into their slots instead
+	StreamReadState *stream_state = (StreamReadState *)stream->internal_state;
+	if (stream_state && stream_state->write_behind) {
+		return stream_write_behind_write(stream, data, data_size);
+	}
+
 	// Allocate async state
 	MemoryResult state_result =
 		fun_memory_allocate(sizeof(StreamWriteAsyncState));
@@ -116,3 +122,352 @@ AsyncResult fun_stream_write(FileStream *stream, Memory data,
 
 	return result;
 }
+
+// ------------------------------------------------------------------
+// Write-behind
+// ------------------------------------------------------------------
+
+// Largest single WriteFile; a longer slot is written in several pieces
+#define STREAM_WRITE_BEHIND_MAX_IO_BYTES (1UL << 30)
+
+#define STREAM_WRITE_BEHIND_POLL_MS 1
+
+// Slots form a queue in file order: oldest is the first slot handed to
+// the kernel and the in_flight slots from it on have overlapped writes
+// outstanding; the slot after them is being filled.  Every slot carries
+// its own file offset, so writes may complete in any order.
+typedef struct {
+	char *data;
+	uint64_t offset;
+	uint64_t length; // Bytes filled
+	uint64_t written;
+	OVERLAPPED overlapped;
+	bool submitted;
+} WriteBehindSlot;
+
+struct StreamWriteBehind {
+	WriteBehindSlot slots[STREAM_WRITE_BEHIND_MAX_BUFFERS];
+	uint32_t slot_count;
+	uint64_t slot_size;
+	uint32_t oldest;
+	uint32_t in_flight;
+	uint64_t next_offset; // File offset of the next byte accepted
+	Memory data; // Rest of the fun_stream_write in progress
+	uint64_t data_size;
+	ErrorResult error; // First failed background write
+	uint64_t seek_offset; // Target of the fun_stream_seek in progress
+};
+
+static ErrorResult write_behind_submit(HANDLE file_handle,
+									   WriteBehindSlot *slot)
+{
+	uint64_t remaining = slot->length - slot->written;
+	if (remaining > STREAM_WRITE_BEHIND_MAX_IO_BYTES) {
+		remaining = STREAM_WRITE_BEHIND_MAX_IO_BYTES;
+	}
+
+	uint64_t offset = slot->offset + slot->written;
+	slot->overlapped.Offset = (DWORD)offset;
+	slot->overlapped.OffsetHigh = (DWORD)(offset >> 32);
+	if (!WriteFile(file_handle, slot->data + slot->written, (DWORD)remaining,
+				   NULL, &slot->overlapped) &&
+		GetLastError() != ERROR_IO_PENDING) {
+		return fun_error_result(GetLastError(), "Failed to write file");
+	}
+	slot->submitted = true;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static WriteBehindSlot *write_behind_current(StreamWriteBehind *write_behind)
+{
+	return &write_behind->slots[(write_behind->oldest +
+								 write_behind->in_flight) %
+								write_behind->slot_count];
+}
+
+// Hand the slot being filled to the kernel
+static void write_behind_hand_off(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+	WriteBehindSlot *slot = write_behind_current(write_behind);
+	slot->written = 0;
+	write_behind->in_flight++;
+	if (fun_error_is_ok(write_behind->error)) {
+		write_behind->error = write_behind_submit(state->file_handle, slot);
+	}
+}
+
+// Wait for the oldest slot to be written and free it.  Returns true once
+// it is free; false while it is still being written.  A failed write
+// frees the slot too and is kept in write_behind->error.
+static bool write_behind_reap(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+	WriteBehindSlot *slot = &write_behind->slots[write_behind->oldest];
+
+	if (fun_error_is_ok(write_behind->error)) {
+		if (!slot->submitted) {
+			write_behind->error = write_behind_submit(state->file_handle, slot);
+		}
+		if (slot->submitted) {
+			if (WaitForSingleObject(slot->overlapped.hEvent,
+									STREAM_WRITE_BEHIND_POLL_MS) ==
+				WAIT_TIMEOUT) {
+				return false;
+			}
+			DWORD transferred = 0;
+			slot->submitted = false;
+			if (!GetOverlappedResult(state->file_handle, &slot->overlapped,
+									 &transferred, FALSE)) {
+				write_behind->error = fun_error_result(GetLastError(),
+													   "Failed to write file");
+			} else if (transferred == 0) {
+				write_behind->error =
+					fun_error_result(1, "Unable to write all data");
+			} else {
+				slot->written += transferred;
+				if (slot->written < slot->length) {
+					// Partial write - submit the rest on the next poll
+					return false;
+				}
+			}
+		}
+	} else if (slot->submitted) {
+		// Already failed: only wait until the kernel lets go
+		DWORD transferred;
+		GetOverlappedResult(state->file_handle, &slot->overlapped,
+							&transferred, TRUE);
+		slot->submitted = false;
+	}
+
+	slot->length = 0;
+	write_behind->oldest =
+		(write_behind->oldest + 1) % write_behind->slot_count;
+	write_behind->in_flight--;
+	return true;
+}
+
+static AsyncStatus poll_stream_write_behind(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamWriteBehind *write_behind = state->write_behind;
+
+	while (write_behind->data_size > 0) {
+		if (fun_error_is_error(write_behind->error)) {
+			write_behind->data_size = 0;
+			result->error = write_behind->error;
+			return ASYNC_ERROR;
+		}
+		if (write_behind->in_flight == write_behind->slot_count) {
+			// Backpressure: every slot is still being written
+			if (!write_behind_reap(state)) {
+				return ASYNC_PENDING;
+			}
+			continue;
+		}
+
+		WriteBehindSlot *slot = write_behind_current(write_behind);
+		if (slot->length == 0) {
+			slot->offset = write_behind->next_offset;
+		}
+		uint64_t space = write_behind->slot_size - slot->length;
+		uint64_t count = write_behind->data_size < space ?
+							 write_behind->data_size :
+							 space;
+		fun_memory_copy(write_behind->data, slot->data + slot->length, count);
+		slot->length += count;
+		write_behind->data = (char *)write_behind->data + count;
+		write_behind->data_size -= count;
+		write_behind->next_offset += count;
+		stream->current_position += count;
+		stream->bytes_processed += count;
+
+		if (slot->length == write_behind->slot_size) {
+			write_behind_hand_off(state);
+		}
+	}
+
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult stream_write_behind_write(FileStream *stream, Memory data,
+									  uint64_t data_size)
+{
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	state->write_behind->data = data;
+	state->write_behind->data_size = data_size;
+
+	// Copies into a slot with room complete without allocating
+	AsyncResult result = { .poll = poll_stream_write_behind,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_write_behind(&result);
+	return result;
+}
+
+static AsyncStatus poll_stream_flush(AsyncResult *result)
+{
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	StreamWriteBehind *write_behind = state->write_behind;
+
+	if (write_behind->in_flight < write_behind->slot_count &&
+		write_behind_current(write_behind)->length > 0) {
+		write_behind_hand_off(state);
+	}
+	while (write_behind->in_flight > 0) {
+		if (!write_behind_reap(state)) {
+			return ASYNC_PENDING;
+		}
+	}
+
+	result->error = write_behind->error;
+	return fun_error_is_error(result->error) ? ASYNC_ERROR : ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_flush(FileStream *stream)
+{
+	if (!stream) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	// Other streams write synchronously; nothing is held back
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (!state || !state->write_behind) {
+		return (AsyncResult){ .status = ASYNC_COMPLETED,
+							  .error = ERROR_RESULT_NO_ERROR };
+	}
+
+	AsyncResult result = { .poll = poll_stream_flush,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_flush(&result);
+	return result;
+}
+
+void stream_write_behind_close(StreamReadState *state)
+{
+	StreamWriteBehind *write_behind = state->write_behind;
+
+	// Flush what is left; the kernel must be done with the slots
+	if (state->file_handle != INVALID_HANDLE_VALUE) {
+		AsyncResult flush = { .poll = poll_stream_flush,
+							  .state = state->stream,
+							  .status = ASYNC_PENDING };
+		while (poll_stream_flush(&flush) == ASYNC_PENDING) {
+		}
+	}
+	for (uint32_t i = 0; i < write_behind->slot_count; i++) {
+		if (write_behind->slots[i].overlapped.hEvent) {
+			CloseHandle(write_behind->slots[i].overlapped.hEvent);
+		}
+	}
+	fun_memory_free((Memory *)&state->write_behind);
+}
+
+static AsyncStatus poll_stream_write_behind_seek(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_flush(result);
+	if (status != ASYNC_COMPLETED) {
+		return status;
+	}
+
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	state->write_behind->next_offset = state->write_behind->seek_offset;
+	stream->current_position = state->write_behind->seek_offset;
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult stream_write_behind_seek(FileStream *stream, uint64_t position)
+{
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	state->write_behind->seek_offset = position;
+
+	// Bytes already accepted belong at the old position: flush them
+	AsyncResult result = { .poll = poll_stream_write_behind_seek,
+						   .state = stream,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = poll_stream_write_behind_seek(&result);
+	return result;
+}
+
+static AsyncStatus poll_stream_open_write_behind(AsyncResult *result)
+{
+	AsyncStatus status = poll_stream_open(result);
+	if (status != ASYNC_COMPLETED) {
+		return status;
+	}
+
+	// Appends continue from the end of the file as it was opened
+	FileStream *stream = (FileStream *)result->state;
+	StreamReadState *state = (StreamReadState *)stream->internal_state;
+	if (stream->mode == STREAM_MODE_APPEND) {
+		state->write_behind->next_offset = state->file_size;
+		stream->current_position = state->file_size;
+	}
+	return ASYNC_COMPLETED;
+}
+
+AsyncResult fun_stream_open_write_behind(String file_path, StreamMode mode,
+										 Memory buffer, uint64_t buffer_size,
+										 uint32_t buffer_count)
+{
+	if (mode != STREAM_MODE_WRITE && mode != STREAM_MODE_APPEND) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = fun_error_result(
+								  1, "Write-behind needs a write mode") };
+	}
+	if (buffer_count < 2 || buffer_count > STREAM_WRITE_BEHIND_MAX_BUFFERS) {
+		return (AsyncResult){
+			.status = ASYNC_ERROR,
+			.error = ERROR_RESULT_STREAM_INVALID_BUFFER_COUNT
+		};
+	}
+	if (buffer_size > UINT64_MAX / buffer_count) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_INTEGER_OVERFLOW };
+	}
+
+	AsyncResult result = fun_stream_open(file_path, mode, buffer, buffer_size,
+										 FILE_MODE_RING_BASED);
+	if (result.status == ASYNC_ERROR) {
+		return result;
+	}
+	FileStream *stream = (FileStream *)result.state;
+
+	MemoryResult write_behind_result =
+		fun_memory_allocate(sizeof(StreamWriteBehind));
+	if (fun_error_is_error(write_behind_result.error)) {
+		fun_stream_close(stream);
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = write_behind_result.error };
+	}
+
+	StreamWriteBehind *write_behind =
+		(StreamWriteBehind *)write_behind_result.value;
+	*write_behind = (StreamWriteBehind){ .slot_count = buffer_count,
+										 .slot_size = buffer_size,
+										 .error = ERROR_RESULT_NO_ERROR };
+	((StreamReadState *)stream->internal_state)->write_behind = write_behind;
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		write_behind->slots[i].data = (char *)buffer + i * buffer_size;
+		write_behind->slots[i].overlapped.hEvent =
+			CreateEventW(NULL, TRUE, FALSE, NULL);
+		if (!write_behind->slots[i].overlapped.hEvent) {
+			ErrorResult error = fun_error_result(GetLastError(),
+												 "Failed to create event");
+			fun_stream_close(stream);
+			return (AsyncResult){ .status = ASYNC_ERROR, .error = error };
+		}
+	}
+
+	result.poll = poll_stream_open_write_behind;
+	return result;
+}
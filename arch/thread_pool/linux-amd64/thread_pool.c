@@ -82,9 +82,16 @@ int arch_thread_create(void (*fn)(void *), void *arg, void **out_handle)
 	struct linux_thread_handle *h =
 		(struct linux_thread_handle *)handle_mem.value;
 	h->stack = stack_mem.value;
-	h->clear_tid = 0;
+	/* Non-zero until the child exits.  The kernel stores the tid here when
+	   the child first runs and clears it on exit; storing the tid from the
+	   parent after clone() would resurrect it if the child already exited. */
+	h->clear_tid = -1;
 
-	void *stack_top = (void *)((char *)stack_mem.value + THREAD_STACK_SIZE);
+	/* The allocation is only 8-byte aligned; the SysV ABI needs a 16-byte
+	   aligned stack or SSE spills (movaps) fault in the child. */
+	void *stack_top =
+		(void *)(((uintptr_t)stack_mem.value + THREAD_STACK_SIZE) &
+				 ~(uintptr_t)15);
 
 	/* Store fn/arg on child's own stack so child can access them
 	   without depending on parent's stack frame (which may use
@@ -136,7 +143,6 @@ int arch_thread_create(void (*fn)(void *), void *arg, void **out_handle)
 	}
 
 	h->tid = (int)tid;
-	h->clear_tid = (int)tid;
 	*out_handle = h;
 	return 0;
 }
@@ -149,9 +155,9 @@ void arch_thread_join(void *handle)
 
 	struct linux_thread_handle *h = (struct linux_thread_handle *)handle;
 
-	int tid = h->tid;
-	if (tid > 0) {
-		while (__atomic_load_n(&h->clear_tid, __ATOMIC_ACQUIRE) != 0) {
+	if (h->tid > 0) {
+		int tid;
+		while ((tid = __atomic_load_n(&h->clear_tid, __ATOMIC_ACQUIRE)) != 0) {
 			futex_wait(&h->clear_tid, tid);
 		}
 	}
@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <time.h>
 
 uint64_t fun_timing_now_ns(void)
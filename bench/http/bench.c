@@ -0,0 +1,364 @@
+/*
+ * HTTP benchmark — parser throughput and loopback keep-alive serving.
+ *
+ * 1. Parser: many pipelined requests in one buffer, parsed with
+ *    fun_http_next; reports ns per request.
+ * 2. Loopback: a single-threaded load generator (raw non-blocking client
+ *    sockets, BENCH_CONNECTIONS connections, BENCH_PIPELINE requests in
+ *    flight on each) against server connections driven by
+ *    fun_network_tcp_receive_at_least + fun_http + fun_http_response_send.
+ *    Reports requests/second and p50/p99 latency.
+ *
+ * Both sides share one thread: the connection pool is not thread-safe.
+ */
+
+#include "fundamental/console/console.h"
+#include "fundamental/http/http.h"
+#include "fundamental/timing/timing.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_PARSE_REQUESTS 1024
+#define BENCH_PARSE_ROUNDS 200
+#define BENCH_CONNECTIONS 8
+#define BENCH_PIPELINE 16
+#define BENCH_DURATION_NS 2000000000ULL
+#define BENCH_LATENCY_BUCKETS 10000 /* 1 us each; last bucket is overflow */
+
+static const char REQUEST[] = "GET /ping HTTP/1.1\r\n"
+							  "Host: bench\r\n"
+							  "User-Agent: fundamental-bench\r\n"
+							  "Accept: */*\r\n"
+							  "\r\n";
+#define REQUEST_BYTES (sizeof(REQUEST) - 1)
+
+static const char RESPONSE_BODY[] = "pong";
+#define RESPONSE_BODY_BYTES (sizeof(RESPONSE_BODY) - 1)
+
+/* Must match what fun_http_response_send produces for the handler below */
+static const char EXPECTED_RESPONSE[] = "HTTP/1.1 200 OK\r\n"
+										"Content-Type: text/plain\r\n"
+										"Content-Length: 4\r\n"
+										"Connection: keep-alive\r\n"
+										"\r\n"
+										"pong";
+#define RESPONSE_BYTES (sizeof(EXPECTED_RESPONSE) - 1)
+
+static void print_u64(String label, uint64_t value, String unit)
+{
+	char num[32];
+	fun_string_from_int((int64_t)value, 10, num, sizeof(num));
+	fun_console_write(label);
+	fun_console_write(num);
+	fun_console_write_line(unit);
+}
+
+/* ================================================================
+ * Raw client sockets
+ * ================================================================ */
+
+#ifdef _WIN32
+
+typedef SOCKET BenchSocket;
+
+static void bench_socket_startup(void)
+{
+	WSADATA wd;
+	WSAStartup(MAKEWORD(2, 2), &wd);
+}
+
+static void bench_set_nonblocking(BenchSocket s)
+{
+	u_long mode = 1;
+	ioctlsocket(s, FIONBIO, &mode);
+}
+
+static void bench_close(BenchSocket s)
+{
+	closesocket(s);
+}
+
+static int bench_would_block(void)
+{
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+#else /* POSIX */
+
+typedef int BenchSocket;
+
+static void bench_socket_startup(void)
+{
+}
+
+static void bench_set_nonblocking(BenchSocket s)
+{
+	fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void bench_close(BenchSocket s)
+{
+	close(s);
+}
+
+static int bench_would_block(void)
+{
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+#endif /* _WIN32 */
+
+/* ================================================================
+ * 1. Parser throughput
+ * ================================================================ */
+
+static char g_pipelined[BENCH_PARSE_REQUESTS * REQUEST_BYTES];
+
+static void bench_parser(void)
+{
+	for (size_t i = 0; i < BENCH_PARSE_REQUESTS; i++)
+		for (size_t j = 0; j < REQUEST_BYTES; j++)
+			g_pipelined[i * REQUEST_BYTES + j] = REQUEST[j];
+
+	FunHttpState state;
+	FunHttpRequest request;
+	uint64_t parsed = 0;
+
+	uint64_t start = fun_timing_now_ns();
+	for (int round = 0; round < BENCH_PARSE_ROUNDS; round++) {
+		fun_http_init(&state, g_pipelined, sizeof(g_pipelined));
+		for (;;) {
+			if (fun_error_is_error(fun_http_next(&state, &request)) ||
+				request.type != FUN_HTTP_REQUEST)
+				break;
+			parsed++;
+		}
+	}
+	uint64_t elapsed = fun_timing_now_ns() - start;
+
+	fun_console_write_line("parser:");
+	print_u64("  requests parsed: ", parsed, "");
+	print_u64("  ns per request:  ", elapsed / (parsed ? parsed : 1), "");
+	print_u64("  MB/s:            ",
+			  (parsed * REQUEST_BYTES * 1000) / (elapsed ? elapsed : 1), "");
+}
+
+/* ================================================================
+ * 2. Loopback keep-alive serving
+ * ================================================================ */
+
+typedef struct {
+	BenchSocket sock;
+	uint64_t sent_at[BENCH_PIPELINE]; /* ring of in-flight send times */
+	size_t head;
+	size_t in_flight;
+	size_t response_bytes; /* bytes of the current response seen so far */
+} BenchClient;
+
+typedef struct {
+	TcpNetworkConnection conn;
+	AsyncResult recv;
+	NetworkBuffer view;
+	size_t leftover; /* buffered bytes of an incomplete request */
+} BenchServer;
+
+static BenchClient g_clients[BENCH_CONNECTIONS];
+static BenchServer g_servers[BENCH_CONNECTIONS];
+static uint64_t g_latency[BENCH_LATENCY_BUCKETS];
+static uint64_t g_completed;
+
+static int open_connections(void)
+{
+	BenchSocket listener = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(listener, (struct sockaddr *)&addr, sizeof(addr));
+	listen(listener, BENCH_CONNECTIONS);
+#ifdef _WIN32
+	int len = sizeof(addr);
+#else
+	socklen_t len = sizeof(addr);
+#endif
+	getsockname(listener, (struct sockaddr *)&addr, &len);
+
+	for (int i = 0; i < BENCH_CONNECTIONS; i++) {
+		BenchSocket c = socket(AF_INET, SOCK_STREAM, 0);
+		int one = 1;
+		setsockopt(c, IPPROTO_TCP, TCP_NODELAY, (const char *)&one,
+				   sizeof(one));
+		if (connect(c, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+			return 0;
+		bench_set_nonblocking(c);
+
+		BenchSocket s = accept(listener, NULL, NULL);
+		setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char *)&one,
+				   sizeof(one));
+		bench_set_nonblocking(s);
+
+		g_clients[i].sock = c;
+		g_servers[i].conn = fun_network_tcp_register_connection((intptr_t)s);
+		if (!g_servers[i].conn)
+			return 0;
+		g_servers[i].leftover = 0;
+		g_servers[i].recv = fun_network_tcp_receive_at_least(
+			g_servers[i].conn, 1, &g_servers[i].view);
+	}
+	bench_close(listener);
+	return 1;
+}
+
+static void client_send(BenchClient *client, uint64_t now)
+{
+	while (client->in_flight < BENCH_PIPELINE) {
+		if (send(client->sock, REQUEST, REQUEST_BYTES, 0) !=
+			(int)REQUEST_BYTES)
+			return; /* socket buffer full: retry next iteration */
+		client->sent_at[(client->head + client->in_flight) % BENCH_PIPELINE] =
+			now;
+		client->in_flight++;
+	}
+}
+
+static void client_receive(BenchClient *client)
+{
+	char buf[16384];
+	for (;;) {
+		int n = (int)recv(client->sock, buf, sizeof(buf), 0);
+		if (n <= 0) {
+			if (n < 0 && !bench_would_block())
+				client->in_flight = 0;
+			return;
+		}
+		uint64_t now = fun_timing_now_ns();
+		client->response_bytes += (size_t)n;
+		while (client->response_bytes >= RESPONSE_BYTES &&
+			   client->in_flight > 0) {
+			client->response_bytes -= RESPONSE_BYTES;
+			uint64_t us = (now - client->sent_at[client->head]) / 1000;
+			if (us >= BENCH_LATENCY_BUCKETS)
+				us = BENCH_LATENCY_BUCKETS - 1;
+			g_latency[us]++;
+			client->head = (client->head + 1) % BENCH_PIPELINE;
+			client->in_flight--;
+			g_completed++;
+		}
+	}
+}
+
+/* Answer every complete request in the receive buffer */
+static int server_step(BenchServer *server)
+{
+	AsyncResult *r = &server->recv;
+	if (r->status == ASYNC_PENDING)
+		r->status = r->poll(r);
+	if (r->status == ASYNC_PENDING)
+		return 1;
+	if (r->status == ASYNC_ERROR)
+		return 0;
+
+	FunHttpState state;
+	FunHttpRequest request;
+	fun_http_init(&state, (const char *)server->view.data,
+				  server->view.length);
+	for (;;) {
+		if (fun_error_is_error(fun_http_next(&state, &request)))
+			return 0;
+		if (request.type != FUN_HTTP_REQUEST)
+			break;
+
+		FunHttpResponse response;
+		fun_http_response_init(&response, 200, "OK");
+		fun_http_response_header(&response, "Content-Type", "text/plain");
+		AsyncResult sr =
+			fun_http_response_send(&response, server->conn, RESPONSE_BODY,
+								   RESPONSE_BODY_BYTES, request.keep_alive);
+		fun_async_await(&sr, -1);
+		if (sr.status != ASYNC_COMPLETED)
+			return 0;
+	}
+
+	uint64_t consumed = fun_http_consumed(&state);
+	fun_network_tcp_consume(server->conn, consumed);
+
+	/* Wait for at least one byte beyond a partial request */
+	server->leftover = server->view.length - consumed;
+	server->recv = fun_network_tcp_receive_at_least(
+		server->conn, server->leftover + 1, &server->view);
+	return 1;
+}
+
+static uint64_t latency_percentile(uint64_t total, uint64_t per_mille)
+{
+	uint64_t rank = (total * per_mille + 999) / 1000;
+	uint64_t seen = 0;
+	for (uint64_t i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+		seen += g_latency[i];
+		if (seen >= rank)
+			return i;
+	}
+	return BENCH_LATENCY_BUCKETS - 1;
+}
+
+static void bench_loopback(void)
+{
+	bench_socket_startup();
+	if (!open_connections()) {
+		fun_console_write_line("loopback: connection setup failed");
+		return;
+	}
+
+	uint64_t start = fun_timing_now_ns();
+	uint64_t now = start;
+	while (now - start < BENCH_DURATION_NS) {
+		for (int i = 0; i < BENCH_CONNECTIONS; i++) {
+			client_send(&g_clients[i], now);
+			if (!server_step(&g_servers[i])) {
+				fun_console_write_line("loopback: server error");
+				return;
+			}
+			client_receive(&g_clients[i]);
+		}
+		now = fun_timing_now_ns();
+	}
+	uint64_t elapsed = now - start;
+
+	fun_console_write_line("loopback keep-alive:");
+	print_u64("  connections:     ", BENCH_CONNECTIONS, "");
+	print_u64("  pipeline depth:  ", BENCH_PIPELINE, "");
+	print_u64("  requests:        ", g_completed, "");
+	print_u64("  requests/s:      ",
+			  g_completed * 1000000000ULL / (elapsed ? elapsed : 1), "");
+	print_u64("  p50 latency:     ", latency_percentile(g_completed, 500),
+			  " us");
+	print_u64("  p99 latency:     ", latency_percentile(g_completed, 990),
+			  " us");
+
+	for (int i = 0; i < BENCH_CONNECTIONS; i++) {
+		bench_close(g_clients[i].sock);
+		fun_network_tcp_close(g_servers[i].conn);
+	}
+}
+
+int main(void)
+{
+	bench_parser();
+	bench_loopback();
+	return 0;
+}
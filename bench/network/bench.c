@@ -0,0 +1,582 @@
+/*
+ * Network benchmark — loopback throughput and latency of the network
+ * stack.
+ *
+ * The server runs on the main thread: connections arrive through
+ * fun_network_tcp_listen / fun_network_udp_listen and are then served
+ * by a non-blocking loop over the fundamental network API.  The load
+ * generator is BENCH_CLIENTS closed-loop clients, one per thread-pool
+ * worker, on plain blocking sockets (so they never touch the network
+ * module's connection table, which is not thread-safe).
+ *
+ * Scenarios:
+ *   echo  — 64-byte messages echoed back (receive_some + send)
+ *   rpc   — 32-byte length-prefixed requests, 128-byte framed replies
+ *           (NetworkFramer)
+ *   bulk  — 256 KiB uploads acknowledged with 8 bytes
+ *   udp   — 64-byte datagrams echoed with fun_network_udp_send
+ *
+ * Reported per scenario: requests/s, MB/s of request payload,
+ * p50/p99/p999 round-trip latency, and server-thread CPU per request.
+ */
+
+#include "fundamental/console/console.h"
+#include "fundamental/network/frame.h"
+#include "fundamental/network/server.h"
+#include "fundamental/thread_pool/thread_pool.h"
+#include "fundamental/timing/timing.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_CLIENTS 8
+#define BENCH_DURATION_NS 2000000000ULL
+#define BENCH_LATENCY_BUCKETS 20000 /* 1 us each; last bucket is overflow */
+#define BENCH_MAX_WIRE_BYTES (256 * 1024)
+#define BENCH_UDP_TIMEOUT_MS 100
+
+#define SCENARIO_ECHO 0
+#define SCENARIO_RPC 1
+#define SCENARIO_BULK 2
+#define SCENARIO_UDP 3
+
+typedef struct {
+	String name;
+	int kind; /* SCENARIO_* */
+	size_t request_bytes; /* payload bytes per request */
+	size_t response_bytes; /* payload bytes per reply */
+} BenchScenario;
+
+static const BenchScenario SCENARIOS[] = {
+	{ "echo", SCENARIO_ECHO, 64, 64 },
+	{ "rpc", SCENARIO_RPC, 32, 128 },
+	{ "bulk", SCENARIO_BULK, BENCH_MAX_WIRE_BYTES, 8 },
+	{ "udp", SCENARIO_UDP, 64, 64 },
+};
+#define SCENARIO_COUNT (sizeof(SCENARIOS) / sizeof(SCENARIOS[0]))
+
+/* Bytes on the wire: rpc adds the 4-byte frame header */
+static size_t wire_bytes(const BenchScenario *scenario, size_t payload)
+{
+	return scenario->kind == SCENARIO_RPC ?
+			   payload + NETWORK_FRAME_HEADER_BYTES :
+			   payload;
+}
+
+static void print_u64(String label, uint64_t value, String unit)
+{
+	char num[32];
+	fun_string_from_int((int64_t)value, 10, num, sizeof(num));
+	fun_console_write(label);
+	fun_console_write(num);
+	fun_console_write_line(unit);
+}
+
+/* ================================================================
+ * Platform glue for the load generator
+ * ================================================================ */
+
+#ifdef _WIN32
+
+typedef SOCKET BenchSocket;
+#define BENCH_INVALID_SOCKET INVALID_SOCKET
+
+static void bench_socket_startup(void)
+{
+	WSADATA wd;
+	WSAStartup(MAKEWORD(2, 2), &wd);
+}
+
+static void bench_close(BenchSocket s)
+{
+	closesocket(s);
+}
+
+static void bench_set_recv_timeout(BenchSocket s, int ms)
+{
+	DWORD tv = (DWORD)ms;
+	setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof(tv));
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+	FILETIME created, exited, kernel, user;
+	GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user);
+	uint64_t k = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	uint64_t u = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (k + u) * 100;
+}
+
+#else /* POSIX */
+
+typedef int BenchSocket;
+#define BENCH_INVALID_SOCKET (-1)
+
+static void bench_socket_startup(void)
+{
+}
+
+static void bench_close(BenchSocket s)
+{
+	close(s);
+}
+
+static void bench_set_recv_timeout(BenchSocket s, int ms)
+{
+	struct timeval tv;
+	tv.tv_sec = ms / 1000;
+	tv.tv_usec = (ms % 1000) * 1000;
+	setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* _WIN32 */
+
+static int send_all(BenchSocket s, const char *data, size_t len)
+{
+	while (len > 0) {
+		int n = (int)send(s, data, (int)len, 0);
+		if (n <= 0)
+			return 0;
+		data += n;
+		len -= (size_t)n;
+	}
+	return 1;
+}
+
+static int recv_all(BenchSocket s, char *data, size_t len)
+{
+	while (len > 0) {
+		int n = (int)recv(s, data, (int)len, 0);
+		if (n <= 0)
+			return 0;
+		data += n;
+		len -= (size_t)n;
+	}
+	return 1;
+}
+
+/* ================================================================
+ * Load generator
+ * ================================================================ */
+
+typedef struct {
+	const BenchScenario *scenario;
+	uint16_t port;
+	uint64_t deadline_ns;
+	uint64_t completed;
+	uint64_t lost; /* udp only */
+	uint64_t latency[BENCH_LATENCY_BUCKETS];
+	char request[BENCH_MAX_WIRE_BYTES + NETWORK_FRAME_HEADER_BYTES];
+	char response[BENCH_MAX_WIRE_BYTES + NETWORK_FRAME_HEADER_BYTES];
+} BenchClient;
+
+typedef struct {
+	BenchClient *client;
+} BenchClientTask;
+
+static BenchClient g_clients[BENCH_CLIENTS];
+static volatile int g_clients_done;
+
+static void record_latency(BenchClient *client, uint64_t ns)
+{
+	uint64_t us = ns / 1000;
+	if (us >= BENCH_LATENCY_BUCKETS)
+		us = BENCH_LATENCY_BUCKETS - 1;
+	client->latency[us]++;
+}
+
+static void client_prepare_request(BenchClient *client)
+{
+	const BenchScenario *scenario = client->scenario;
+	char *payload = client->request;
+	if (scenario->kind == SCENARIO_RPC) {
+		uint32_t n = (uint32_t)scenario->request_bytes;
+		client->request[0] = (char)(n >> 24);
+		client->request[1] = (char)(n >> 16);
+		client->request[2] = (char)(n >> 8);
+		client->request[3] = (char)n;
+		payload += NETWORK_FRAME_HEADER_BYTES;
+	}
+	for (size_t i = 0; i < scenario->request_bytes; i++)
+		payload[i] = (char)('a' + i % 26);
+}
+
+static void client_run_tcp(BenchClient *client, struct sockaddr_in *addr)
+{
+	const BenchScenario *scenario = client->scenario;
+	size_t request_len = wire_bytes(scenario, scenario->request_bytes);
+	size_t response_len = wire_bytes(scenario, scenario->response_bytes);
+
+	BenchSocket s = socket(AF_INET, SOCK_STREAM, 0);
+	int one = 1;
+	setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+	if (connect(s, (struct sockaddr *)addr, sizeof(*addr)) != 0) {
+		bench_close(s);
+		return;
+	}
+
+	while (fun_timing_now_ns() < client->deadline_ns) {
+		uint64_t start = fun_timing_now_ns();
+		if (!send_all(s, client->request, request_len) ||
+			!recv_all(s, client->response, response_len))
+			break;
+		record_latency(client, fun_timing_now_ns() - start);
+		client->completed++;
+	}
+	bench_close(s);
+}
+
+static void client_run_udp(BenchClient *client, struct sockaddr_in *addr)
+{
+	const BenchScenario *scenario = client->scenario;
+	BenchSocket s = socket(AF_INET, SOCK_DGRAM, 0);
+	bench_set_recv_timeout(s, BENCH_UDP_TIMEOUT_MS);
+
+	while (fun_timing_now_ns() < client->deadline_ns) {
+		uint64_t start = fun_timing_now_ns();
+		sendto(s, client->request, (int)scenario->request_bytes, 0,
+			   (struct sockaddr *)addr, sizeof(*addr));
+		int n = (int)recv(s, client->response, sizeof(client->response), 0);
+		if (n != (int)scenario->response_bytes) {
+			client->lost++;
+			continue;
+		}
+		record_latency(client, fun_timing_now_ns() - start);
+		client->completed++;
+	}
+	bench_close(s);
+}
+
+static void client_main(void *arg)
+{
+	BenchClient *client = ((BenchClientTask *)arg)->client;
+
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(client->port);
+
+	client_prepare_request(client);
+	if (client->scenario->kind == SCENARIO_UDP)
+		client_run_udp(client, &addr);
+	else
+		client_run_tcp(client, &addr);
+
+	__atomic_add_fetch(&g_clients_done, 1, __ATOMIC_RELEASE);
+}
+
+static int start_clients(const BenchScenario *scenario, uint16_t port,
+						 ThreadPool *out_pool)
+{
+	voidResult created = fun_thread_pool_create(BENCH_CLIENTS, out_pool);
+	if (fun_error_is_error(created.error))
+		return 0;
+
+	g_clients_done = 0;
+	uint64_t deadline = fun_timing_now_ns() + BENCH_DURATION_NS;
+	for (int i = 0; i < BENCH_CLIENTS; i++) {
+		BenchClient *client = &g_clients[i];
+		fun_memory_fill(client->latency, sizeof(client->latency), 0);
+		client->scenario = scenario;
+		client->port = port;
+		client->deadline_ns = deadline;
+		client->completed = 0;
+		client->lost = 0;
+
+		BenchClientTask task = { client };
+		WorkItem item = { &task, sizeof(task), client_main };
+		if (fun_error_is_error(fun_thread_pool_submit(*out_pool, &item).error))
+			return 0;
+	}
+	return 1;
+}
+
+static int clients_finished(void)
+{
+	return __atomic_load_n(&g_clients_done, __ATOMIC_ACQUIRE) == BENCH_CLIENTS;
+}
+
+/* ================================================================
+ * TCP server
+ * ================================================================ */
+
+typedef struct {
+	TcpNetworkConnection conn;
+	NetworkFramer framer;
+	AsyncResult op;
+	NetworkBuffer view;
+	size_t bulk_received; /* bytes toward the next acknowledgement */
+	int open;
+} BenchConn;
+
+typedef struct {
+	const BenchScenario *scenario;
+	BenchConn conns[BENCH_CLIENTS];
+	int accepted;
+} BenchServer;
+
+static BenchServer g_server;
+static char g_reply[BENCH_MAX_WIRE_BYTES];
+
+static void conn_arm(BenchServer *server, BenchConn *c)
+{
+	if (server->scenario->kind == SCENARIO_RPC)
+		c->op = fun_network_frame_receive(c->framer, &c->view);
+	else
+		c->op = fun_network_tcp_receive_some(c->conn, &c->view);
+}
+
+static void on_tcp_accept(TcpNetworkConnection conn, Memory server_state)
+{
+	BenchServer *server = (BenchServer *)server_state;
+	if (server->accepted == BENCH_CLIENTS) {
+		fun_network_tcp_close(conn);
+		return;
+	}
+	BenchConn *c = &server->conns[server->accepted++];
+	c->conn = conn;
+	c->framer = (NetworkFramer)0;
+	c->bulk_received = 0;
+	c->open = 1;
+	if (server->scenario->kind == SCENARIO_RPC)
+		fun_network_frame_create(conn, BENCH_MAX_WIRE_BYTES, 0, &c->framer);
+	conn_arm(server, c);
+}
+
+static void conn_close(BenchConn *c)
+{
+	if (c->framer)
+		fun_network_frame_free(c->framer);
+	fun_network_tcp_close(c->conn);
+	c->open = 0;
+}
+
+static int conn_reply(BenchServer *server, BenchConn *c)
+{
+	const BenchScenario *scenario = server->scenario;
+	AsyncResult sr;
+
+	switch (scenario->kind) {
+	case SCENARIO_ECHO:
+		sr = fun_network_tcp_send(c->conn, c->view.data, c->view.length);
+		fun_async_await(&sr, -1);
+		fun_network_tcp_consume(c->conn, c->view.length);
+		break;
+	case SCENARIO_RPC:
+		fun_network_frame_queue(c->framer, g_reply, scenario->response_bytes);
+		sr = fun_network_frame_flush(c->framer);
+		fun_async_await(&sr, -1);
+		break;
+	default: /* SCENARIO_BULK */
+		fun_network_tcp_consume(c->conn, c->view.length);
+		c->bulk_received += c->view.length;
+		sr.status = ASYNC_COMPLETED;
+		while (c->bulk_received >= scenario->request_bytes &&
+			   sr.status == ASYNC_COMPLETED) {
+			c->bulk_received -= scenario->request_bytes;
+			sr = fun_network_tcp_send(c->conn, g_reply,
+									  scenario->response_bytes);
+			fun_async_await(&sr, -1);
+		}
+		break;
+	}
+	return sr.status == ASYNC_COMPLETED;
+}
+
+/* Serve every connection until all clients have disconnected */
+static void serve_tcp(BenchServer *server)
+{
+	int open = server->accepted;
+	while (open > 0) {
+		for (int i = 0; i < server->accepted; i++) {
+			BenchConn *c = &server->conns[i];
+			if (!c->open)
+				continue;
+			AsyncResult *op = &c->op;
+			if (op->status == ASYNC_PENDING)
+				op->status = op->poll(op);
+			if (op->status == ASYNC_PENDING)
+				continue;
+			if (op->status == ASYNC_ERROR || !conn_reply(server, c)) {
+				conn_close(c);
+				open--;
+				continue;
+			}
+			conn_arm(server, c);
+		}
+	}
+}
+
+static int run_tcp(const BenchScenario *scenario, uint64_t *out_cpu_ns)
+{
+	NetworkAddress any;
+	fun_memory_fill(&any, sizeof(any), 0);
+	any.family = NETWORK_ADDRESS_IPV4;
+	any.bytes[0] = 127;
+	any.bytes[3] = 1;
+
+	fun_memory_fill(&g_server, sizeof(g_server), 0);
+	g_server.scenario = scenario;
+
+	NetworkServerConfig config;
+	fun_network_tcp_server_config(any, (Memory)&g_server, &config);
+	AsyncResult listen = fun_network_tcp_listen(config, on_tcp_accept);
+	if (listen.status == ASYNC_ERROR)
+		return 0;
+	uint16_t port = 0;
+	fun_network_server_get_port(config, &port);
+
+	ThreadPool pool;
+	if (!start_clients(scenario, port, &pool))
+		return 0;
+
+	/* Accept every client first, then serve without accept timeouts */
+	while (g_server.accepted < BENCH_CLIENTS && !clients_finished())
+		listen.status = listen.poll(&listen);
+
+	uint64_t cpu_start = thread_cpu_ns();
+	serve_tcp(&g_server);
+	*out_cpu_ns = thread_cpu_ns() - cpu_start;
+
+	fun_thread_pool_destroy(pool);
+	fun_network_server_stop(config);
+	listen.status = listen.poll(&listen);
+	fun_network_server_config_free(config);
+	return 1;
+}
+
+/* ================================================================
+ * UDP server
+ * ================================================================ */
+
+static char g_udp_buffer[2048];
+
+static void on_udp_datagram(NetworkAddress source, NetworkBuffer buffer,
+							Memory server_state)
+{
+	(void)server_state;
+	fun_network_udp_send(source, buffer.data, buffer.length);
+}
+
+static int run_udp(const BenchScenario *scenario, uint64_t *out_cpu_ns)
+{
+	NetworkAddress any;
+	fun_memory_fill(&any, sizeof(any), 0);
+	any.family = NETWORK_ADDRESS_IPV4;
+	any.bytes[0] = 127;
+	any.bytes[3] = 1;
+
+	NetworkServerConfig config;
+	fun_network_udp_server_config(any, (Memory)0, g_udp_buffer,
+								  sizeof(g_udp_buffer), &config);
+	AsyncResult listen = fun_network_udp_listen(config, on_udp_datagram);
+	if (listen.status == ASYNC_ERROR)
+		return 0;
+	uint16_t port = 0;
+	fun_network_server_get_port(config, &port);
+
+	ThreadPool pool;
+	if (!start_clients(scenario, port, &pool))
+		return 0;
+
+	uint64_t cpu_start = thread_cpu_ns();
+	while (!clients_finished())
+		listen.status = listen.poll(&listen);
+	*out_cpu_ns = thread_cpu_ns() - cpu_start;
+
+	fun_thread_pool_destroy(pool);
+	fun_network_server_stop(config);
+	listen.status = listen.poll(&listen);
+	fun_network_server_config_free(config);
+	return 1;
+}
+
+/* ================================================================
+ * Reporting
+ * ================================================================ */
+
+static uint64_t g_latency[BENCH_LATENCY_BUCKETS];
+
+static uint64_t latency_percentile(uint64_t total, uint64_t per_mille)
+{
+	uint64_t rank = (total * per_mille + 999) / 1000;
+	uint64_t seen = 0;
+	for (uint64_t i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+		seen += g_latency[i];
+		if (seen >= rank)
+			return i;
+	}
+	return BENCH_LATENCY_BUCKETS - 1;
+}
+
+static void report(const BenchScenario *scenario, uint64_t cpu_ns)
+{
+	uint64_t completed = 0;
+	uint64_t lost = 0;
+	fun_memory_fill(g_latency, sizeof(g_latency), 0);
+	for (int i = 0; i < BENCH_CLIENTS; i++) {
+		completed += g_clients[i].completed;
+		lost += g_clients[i].lost;
+		for (int b = 0; b < BENCH_LATENCY_BUCKETS; b++)
+			g_latency[b] += g_clients[i].latency[b];
+	}
+	uint64_t per_sec = completed * 1000000000ULL / BENCH_DURATION_NS;
+
+	fun_console_write(scenario->name);
+	fun_console_write_line(":");
+	print_u64("  requests/s:        ", per_sec, "");
+	print_u64("  request MB/s:      ",
+			  per_sec * scenario->request_bytes / 1000000, "");
+	print_u64("  p50 latency:       ", latency_percentile(completed, 500),
+			  " us");
+	print_u64("  p99 latency:       ", latency_percentile(completed, 990),
+			  " us");
+	print_u64("  p999 latency:      ", latency_percentile(completed, 999),
+			  " us");
+	print_u64("  server CPU/req:    ", cpu_ns / (completed ? completed : 1),
+			  " ns");
+	if (scenario->kind == SCENARIO_UDP)
+		print_u64("  lost datagrams:    ", lost, "");
+}
+
+int main(void)
+{
+	bench_socket_startup();
+	for (size_t i = 0; i < sizeof(g_reply); i++)
+		g_reply[i] = (char)('A' + i % 26);
+
+	for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+		const BenchScenario *scenario = &SCENARIOS[i];
+		uint64_t cpu_ns = 0;
+		int ok = scenario->kind == SCENARIO_UDP ? run_udp(scenario, &cpu_ns) :
+												  run_tcp(scenario, &cpu_ns);
+		if (!ok) {
+			fun_console_write(scenario->name);
+			fun_console_write_line(": setup failed");
+			continue;
+		}
+		report(scenario, cpu_ns);
+	}
+	return 0;
+}
@@ -0,0 +1,50 @@
+#!/bin/bash
+# Build script for network benchmark - Linux AMD64
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$SCRIPT_DIR/../.."
+
+# Compiler flags
+CC=gcc
+CFLAGS="-I$PROJECT_ROOT/include -Wall -Wextra -O2"
+
+# Source files
+SOURCES=(
+    "$SCRIPT_DIR/bench.c"
+    "$PROJECT_ROOT/src/network/frame.c"
+    "$PROJECT_ROOT/src/network/server/server.c"
+    "$PROJECT_ROOT/arch/network/server/linux-amd64/server.c"
+    "$PROJECT_ROOT/src/network/network.c"
+    "$PROJECT_ROOT/arch/network/linux-amd64/network.c"
+    "$PROJECT_ROOT/src/async/async.c"
+    "$PROJECT_ROOT/arch/async/linux-amd64/async.c"
+    "$PROJECT_ROOT/src/config/config.c"
+    "$PROJECT_ROOT/src/config/iniParser.c"
+    "$PROJECT_ROOT/src/config/cliParser.c"
+    "$PROJECT_ROOT/arch/config/linux-amd64/env.c"
+    "$PROJECT_ROOT/src/filesystem/path.c"
+    "$PROJECT_ROOT/src/filesystem/file_exists.c"
+    "$PROJECT_ROOT/src/filesystem/directory.c"
+    "$PROJECT_ROOT/arch/filesystem/linux-amd64/path.c"
+    "$PROJECT_ROOT/arch/filesystem/linux-amd64/file_exists.c"
+    "$PROJECT_ROOT/arch/filesystem/linux-amd64/directory.c"
+    "$PROJECT_ROOT/src/hashmap/hashmap.c"
+    "$PROJECT_ROOT/arch/memory/linux-amd64/memory.c"
+    "$PROJECT_ROOT/src/string/stringOperations.c"
+    "$PROJECT_ROOT/src/string/stringValidation.c"
+    "$PROJECT_ROOT/src/string/stringConversion.c"
+    "$PROJECT_ROOT/arch/timing/linux-amd64/timing.c"
+    "$PROJECT_ROOT/src/thread_pool/thread_pool.c"
+    "$PROJECT_ROOT/arch/thread_pool/linux-amd64/thread_pool.c"
+    "$PROJECT_ROOT/arch/sync/linux-amd64/sync.c"
+    "$PROJECT_ROOT/src/console/console.c"
+    "$PROJECT_ROOT/arch/console/linux-amd64/console.c"
+)
+
+# Build
+echo "Building network benchmark..."
+$CC $CFLAGS "${SOURCES[@]}" -o "$SCRIPT_DIR/bench"
+
+echo "Build successful!"
@@ -13,6 +13,10 @@ gcc --std=c17 -Os -I ../../include demo.c \
     ../../arch/file/linux-amd64/fileRead.c \
     ../../arch/file/linux-amd64/fileReadMmap.c \
     ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
     ../../src/string/stringOperations.c \
     ../../src/string/stringConversion.c \
     ../../src/string/stringValidation.c \
@@ -13,6 +13,9 @@ set SOURCES=^
     %PROJECT_ROOT%\arch\file\windows-amd64\fileRead.c ^
     %PROJECT_ROOT%\arch\file\windows-amd64\fileReadMmap.c ^
     %PROJECT_ROOT%\arch\file\windows-amd64\fileReadRing.c ^
+    %PROJECT_ROOT%\arch\file\windows-amd64\fileRing.c ^
+    %PROJECT_ROOT%\arch\file\windows-amd64\fileDirect.c ^
+    %PROJECT_ROOT%\arch\file\windows-amd64\fileAdaptive.c ^
     %PROJECT_ROOT%\src\stream\streamFile.c ^
     %PROJECT_ROOT%\src\stream\streamLifecycle.c ^
     %PROJECT_ROOT%\src\stream\streamFlow.c ^
@@ -3,6 +3,9 @@ gcc --std=c17 -Os -I ../../../include inspect_gguf.c ^
     ../../../arch/file/windows-amd64/fileRead.c ^
     ../../../arch/file/windows-amd64/fileReadMmap.c ^
     ../../../arch/file/windows-amd64/fileReadRing.c ^
+    ../../../arch/file/windows-amd64/fileRing.c ^
+    ../../../arch/file/windows-amd64/fileDirect.c ^
+    ../../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../../src/async/async.c ^
     ../../../arch/async/windows-amd64/async.c ^
     ../../../src/console/console.c ^
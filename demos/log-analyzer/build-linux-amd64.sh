@@ -6,9 +6,14 @@ gcc --std=c17 -Os -I ../../include demo.c \
     ../../arch/file/linux-amd64/fileRead.c \
     ../../arch/file/linux-amd64/fileReadMmap.c \
     ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
     ../../src/stream/streamFile.c \
     ../../src/stream/streamLifecycle_linux.c \
     ../../src/stream/streamFlow.c \
+    ../../src/stream/streamRecord.c \
     ../../arch/stream/linux-amd64/streamOpen.c \
     ../../arch/stream/linux-amd64/streamRead.c \
     ../../arch/stream/linux-amd64/streamWrite.c \
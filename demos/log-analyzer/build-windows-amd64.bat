@@ -5,6 +5,7 @@ REM Dependencies: file (read), string, console, hashmap, memory, async
 gcc --std=c17 -Os -I ../../include demo.c ^
     ../../src/stream/streamFile.c ^
     ../../src/stream/streamFlow.c ^
+    ../../src/stream/streamRecord.c ^
     ../../src/stream/streamLifecycle.c ^
     ../../arch/stream/windows-amd64/streamOpen.c ^
     ../../arch/stream/windows-amd64/streamRead.c ^
@@ -12,6 +13,9 @@ gcc --std=c17 -Os -I ../../include demo.c ^
     ../../arch/file/windows-amd64/fileRead.c ^
     ../../arch/file/windows-amd64/fileReadMmap.c ^
     ../../arch/file/windows-amd64/fileReadRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../src/string/stringOperations.c ^
     ../../src/string/stringConversion.c ^
     ../../src/string/stringTemplate.c ^
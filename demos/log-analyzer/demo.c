@@ -1,5 +1,5 @@
 // Log Analyzer Demo - Fundamental Library
-// Proper streaming implementation with chunked reading
+// Streaming implementation with line iteration over chunked reads
 
 #include "fundamental/console/console.h"
 #include "fundamental/string/string.h"
@@ -76,55 +76,6 @@ static void parse_log_line(String line, LogStats *stats)
 	}
 }
 
-static void parse_chunk(char *buffer, uint64_t bytes_read, LogStats *stats,
-						char *carry_over, uint64_t *carry_len,
-						uint64_t carry_max)
-{
-	uint64_t line_start = 0;
-
-	for (uint64_t i = 0; i < bytes_read; i++) {
-		if (buffer[i] == '\n' || buffer[i] == '\r') {
-			if (i > line_start || *carry_len > 0) {
-				char line_buf[8192];
-				uint64_t line_len = 0;
-
-				if (*carry_len > 0) {
-					fun_memory_copy(carry_over, line_buf, *carry_len);
-					line_len = *carry_len;
-					*carry_len = 0;
-				}
-
-				uint64_t chunk_len = i - line_start;
-				if (line_len + chunk_len < carry_max) {
-					fun_memory_copy(&buffer[line_start], &line_buf[line_len],
-									chunk_len);
-					line_len += chunk_len;
-					line_buf[line_len] = '\0';
-
-					if (line_len > 0) {
-						parse_log_line(line_buf, stats);
-					}
-				}
-			}
-			line_start = i + 1;
-			if (buffer[i] == '\r' && i + 1 < bytes_read &&
-				buffer[i + 1] == '\n') {
-				line_start++;
-				i++;
-			}
-		}
-	}
-
-	if (line_start < bytes_read) {
-		uint64_t remaining = bytes_read - line_start;
-		if (*carry_len + remaining < carry_max) {
-			fun_memory_copy(&buffer[line_start], &carry_over[*carry_len],
-							remaining);
-			*carry_len += remaining;
-		}
-	}
-}
-
 int main(int argc, char **argv)
 {
 	if (argc < 2 || fun_string_compare(argv[1], "--help") == 0) {
@@ -161,29 +112,30 @@ int main(int argc, char **argv)
 	FileStream *stream = (FileStream *)open_result.state;
 
 	LogStats stats = { 0 };
-	char carry_over[8192] = { 0 };
-	uint64_t carry_len = 0;
+	char scratch[8192];
+	StreamRecordReader reader = { .stream = stream,
+								  .scratch = scratch,
+								  .scratch_size = sizeof(scratch) };
 
-	while (!fun_stream_is_end_of_stream(stream)) {
-		uint64_t bytes_read = 0;
-		AsyncResult read_result = fun_stream_read(stream, &bytes_read);
-		fun_async_await(&read_result, -1);
+	for (;;) {
+		StreamRecord line = { 0 };
+		AsyncResult next = fun_stream_next_line(&reader, &line);
+		fun_async_await(&next, -1);
 
-		if (fun_error_is_error(read_result.error)) {
+		if (fun_error_is_error(next.error) || !line.data) {
 			break;
 		}
 
-		if (bytes_read > 0) {
-			parse_chunk((char *)buffer, bytes_read, &stats, carry_over,
-						&carry_len, sizeof(carry_over));
+		// parse_log_line wants a terminated string; lines point into the
+		// stream buffer
+		char line_buf[8192];
+		if (line.length > 0 && line.length < sizeof(line_buf)) {
+			fun_memory_copy(line.data, line_buf, line.length);
+			line_buf[line.length] = '\0';
+			parse_log_line(line_buf, &stats);
 		}
 	}
 
-	if (carry_len > 0) {
-		carry_over[carry_len] = '\0';
-		parse_log_line(carry_over, &stats);
-	}
-
 	fun_stream_destroy(stream);
 	fun_memory_free(&buffer);
 
@@ -21,6 +21,10 @@ gcc --std=c17 -Os -I ../../include demo.c \
     ../../arch/file/linux-amd64/fileWrite.c \
     ../../arch/file/linux-amd64/fileWriteMmap.c \
     ../../arch/file/linux-amd64/fileWriteRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
     ../../arch/console/linux-amd64/console.c \
     ../../arch/memory/linux-amd64/memory.c \
     ../../arch/shutdown/linux-amd64/atomic.c \
@@ -21,6 +21,9 @@ gcc --std=c17 -Os -I ../../include demo.c ^
     ../../arch/file/windows-amd64/fileWrite.c ^
     ../../arch/file/windows-amd64/fileWriteMmap.c ^
     ../../arch/file/windows-amd64/fileWriteRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../arch/console/windows-amd64/console.c ^
     ../../arch/memory/windows-amd64/memory.c ^
     ../../arch/shutdown/windows-amd64/atomic.c ^
@@ -21,6 +21,21 @@
 #define ERROR_CODE_PATH_TOO_LONG 13
 #define ERROR_CODE_INTEGER_OVERFLOW 14
 #define ERROR_CODE_LOCK_TIMEOUT 15
+#define ERROR_CODE_FILE_RING_BUSY 16
+#define ERROR_CODE_FILE_RING_INVALID_DEPTH 17
+#define ERROR_CODE_FILE_HANDLE_MODE 18
+#define ERROR_CODE_FILE_CACHE_BUSY 19
+#define ERROR_CODE_FILE_CACHE_INVALID_CAPACITY 20
+#define ERROR_CODE_FILE_UNEXPECTED_EOF 21
+#define ERROR_CODE_FILE_RING_INVALID_BUFFER 22
+#define ERROR_CODE_FILE_VIEW_INVALID_FLAGS 23
+#define ERROR_CODE_FILE_APPENDER_BUSY 24
+#define ERROR_CODE_FILE_INVALID_PREALLOCATION 25
+#define ERROR_CODE_FILE_INVALID_CALIBRATION 26
+#define ERROR_CODE_FILE_COPY_SAME_FILE 27
+#define ERROR_CODE_FILE_TOO_MANY_SEGMENTS 28
+#define ERROR_CODE_FILE_CACHE_UNSUPPORTED 29
+#define ERROR_CODE_FILE_COPY_OVERLAP 30
 #define ERROR_CODE_CONFIG_KEY_NOT_FOUND 220
 #define ERROR_CODE_CONFIG_PARSE_ERROR 221
 #define ERROR_CODE_CONFIG_INVALID_APP_NAME 222
@@ -40,6 +55,10 @@
 
 #define ERROR_CODE_ASYNC_TIMEOUT 242
 
+#define ERROR_CODE_NETWORK_FRAME_TOO_LARGE 243
+#define ERROR_CODE_NETWORK_BACKPRESSURE 244
+#define ERROR_CODE_NETWORK_CLIENT_POOL_BUSY 245
+
 #define ERROR_CODE_THREAD_POOL_INVALID_SIZE 250
 #define ERROR_CODE_THREAD_POOL_CREATE_FAILED 251
 #define ERROR_CODE_THREAD_POOL_FULL 252
@@ -55,6 +74,17 @@
 #define ERROR_CODE_JSON_TYPE_MISMATCH 279
 #define ERROR_CODE_JSON_INCOMPLETE 280
 
+#define ERROR_CODE_HTTP_PARSE_ERROR 290
+#define ERROR_CODE_HTTP_TOO_MANY_HEADERS 291
+#define ERROR_CODE_HTTP_UNSUPPORTED 292
+#define ERROR_CODE_HTTP_INVALID_HEADER 293
+
+#define ERROR_CODE_STREAM_INVALID_BUFFER_COUNT 300
+#define ERROR_CODE_STREAM_CORRUPT_FRAME 301
+#define ERROR_CODE_STREAM_BLOCK_TOO_LARGE 302
+#define ERROR_CODE_STREAM_NOT_SEEKABLE 303
+#define ERROR_CODE_STREAM_INVALID_INDEX 304
+
 typedef struct {
 	uint16_t code;
 	const char *message;
@@ -129,6 +159,52 @@ static ErrorResult ERROR_RESULT_INTEGER_OVERFLOW = {
 };
 static ErrorResult ERROR_RESULT_LOCK_TIMEOUT = { ERROR_CODE_LOCK_TIMEOUT,
 												 "File lock timed out" };
+static ErrorResult ERROR_RESULT_FILE_RING_BUSY = {
+	ERROR_CODE_FILE_RING_BUSY, "File ring has operations in flight"
+};
+static ErrorResult ERROR_RESULT_FILE_RING_INVALID_DEPTH = {
+	ERROR_CODE_FILE_RING_INVALID_DEPTH, "File ring depth out of range"
+};
+static ErrorResult ERROR_RESULT_FILE_HANDLE_MODE = {
+	ERROR_CODE_FILE_HANDLE_MODE, "File handle not opened for this operation"
+};
+static ErrorResult ERROR_RESULT_FILE_CACHE_BUSY = {
+	ERROR_CODE_FILE_CACHE_BUSY, "File cache has descriptors in use"
+};
+static ErrorResult ERROR_RESULT_FILE_CACHE_INVALID_CAPACITY = {
+	ERROR_CODE_FILE_CACHE_INVALID_CAPACITY, "File cache capacity out of range"
+};
+static ErrorResult ERROR_RESULT_FILE_UNEXPECTED_EOF = {
+	ERROR_CODE_FILE_UNEXPECTED_EOF, "Unexpected end of file"
+};
+static ErrorResult ERROR_RESULT_FILE_RING_INVALID_BUFFER = {
+	ERROR_CODE_FILE_RING_INVALID_BUFFER, "Buffer cannot be registered"
+};
+static ErrorResult ERROR_RESULT_FILE_VIEW_INVALID_FLAGS = {
+	ERROR_CODE_FILE_VIEW_INVALID_FLAGS, "Conflicting file view flags"
+};
+static ErrorResult ERROR_RESULT_FILE_APPENDER_BUSY = {
+	ERROR_CODE_FILE_APPENDER_BUSY, "File appender has appends in flight"
+};
+static ErrorResult ERROR_RESULT_FILE_INVALID_PREALLOCATION = {
+	ERROR_CODE_FILE_INVALID_PREALLOCATION, "Preallocation chunk out of range"
+};
+static ErrorResult ERROR_RESULT_FILE_INVALID_CALIBRATION = {
+	ERROR_CODE_FILE_INVALID_CALIBRATION, "Invalid mode in calibration table"
+};
+static ErrorResult ERROR_RESULT_FILE_COPY_SAME_FILE = {
+	ERROR_CODE_FILE_COPY_SAME_FILE, "Source and destination are the same file"
+};
+static ErrorResult ERROR_RESULT_FILE_TOO_MANY_SEGMENTS = {
+	ERROR_CODE_FILE_TOO_MANY_SEGMENTS, "More than FILE_MAX_SEGMENTS segments"
+};
+static ErrorResult ERROR_RESULT_FILE_CACHE_UNSUPPORTED = {
+	ERROR_CODE_FILE_CACHE_UNSUPPORTED,
+	"File cache not supported on this platform"
+};
+static ErrorResult ERROR_RESULT_FILE_COPY_OVERLAP = {
+	ERROR_CODE_FILE_COPY_OVERLAP, "Copy ranges overlap within one file"
+};
 static ErrorResult ERROR_RESULT_CONFIG_KEY_NOT_FOUND = {
 	ERROR_CODE_CONFIG_KEY_NOT_FOUND, "Configuration key not found"
 };
@@ -175,6 +251,16 @@ static ErrorResult ERROR_RESULT_NETWORK_SERVER_WRONG_CONFIG_TYPE = {
 	ERROR_CODE_NETWORK_SERVER_WRONG_CONFIG_TYPE,
 	"Config type does not match listen function"
 };
+static ErrorResult ERROR_RESULT_NETWORK_FRAME_TOO_LARGE = {
+	ERROR_CODE_NETWORK_FRAME_TOO_LARGE, "Frame exceeds maximum frame size"
+};
+static ErrorResult ERROR_RESULT_NETWORK_BACKPRESSURE = {
+	ERROR_CODE_NETWORK_BACKPRESSURE, "Send queue full; flush before queueing"
+};
+static ErrorResult ERROR_RESULT_NETWORK_CLIENT_POOL_BUSY = {
+	ERROR_CODE_NETWORK_CLIENT_POOL_BUSY,
+	"Client pool has connections checked out or connecting"
+};
 static ErrorResult ERROR_RESULT_ASYNC_TIMEOUT = { ERROR_CODE_ASYNC_TIMEOUT,
 												  "Async operation timed out" };
 static ErrorResult ERROR_RESULT_THREAD_POOL_INVALID_SIZE = {
@@ -215,6 +301,35 @@ static ErrorResult ERROR_RESULT_JSON_TYPE_MISMATCH = {
 };
 static ErrorResult ERROR_RESULT_JSON_INCOMPLETE = { ERROR_CODE_JSON_INCOMPLETE,
 													"Need more data" };
+static ErrorResult ERROR_RESULT_HTTP_PARSE_ERROR = {
+	ERROR_CODE_HTTP_PARSE_ERROR, "Malformed HTTP request"
+};
+static ErrorResult ERROR_RESULT_HTTP_TOO_MANY_HEADERS = {
+	ERROR_CODE_HTTP_TOO_MANY_HEADERS, "Too many HTTP headers"
+};
+static ErrorResult ERROR_RESULT_HTTP_UNSUPPORTED = {
+	ERROR_CODE_HTTP_UNSUPPORTED, "Unsupported HTTP feature"
+};
+static ErrorResult ERROR_RESULT_HTTP_INVALID_HEADER = {
+	ERROR_CODE_HTTP_INVALID_HEADER, "Header name or value not allowed"
+};
+
+static ErrorResult ERROR_RESULT_STREAM_INVALID_BUFFER_COUNT = {
+	ERROR_CODE_STREAM_INVALID_BUFFER_COUNT,
+	"Multi-buffer streams need 2 to 8 buffers"
+};
+static ErrorResult ERROR_RESULT_STREAM_CORRUPT_FRAME = {
+	ERROR_CODE_STREAM_CORRUPT_FRAME, "Corrupt compressed stream frame"
+};
+static ErrorResult ERROR_RESULT_STREAM_BLOCK_TOO_LARGE = {
+	ERROR_CODE_STREAM_BLOCK_TOO_LARGE, "Compressed blocks hold at most 4 MiB"
+};
+static ErrorResult ERROR_RESULT_STREAM_NOT_SEEKABLE = {
+	ERROR_CODE_STREAM_NOT_SEEKABLE, "Append streams cannot seek"
+};
+static ErrorResult ERROR_RESULT_STREAM_INVALID_INDEX = {
+	ERROR_CODE_STREAM_INVALID_INDEX, "Invalid stream index file"
+};
 
 #pragma GCC diagnostic pop
 
@@ -9,10 +9,19 @@
 // File I/O Core Types
 // ------------------------------------------------------------------
 
+/*
+ * FILE_MODE_DIRECT bypasses the page cache (O_DIRECT on Linux,
+ * FILE_FLAG_NO_BUFFERING on Windows) so streaming a multi-GB file does
+ * not evict pages other readers depend on.  Transfers whose file offset,
+ * buffer address and length are multiples of fun_file_direct_alignment()
+ * go straight to the caller's buffer; unaligned heads and tails pass
+ * through an internal bounce buffer.  Never chosen by FILE_MODE_AUTO.
+ */
 typedef enum {
 	FILE_MODE_AUTO,
 	FILE_MODE_MMAP,
 	FILE_MODE_RING_BASED,
+	FILE_MODE_DIRECT,
 } FileMode;
 
 /*
@@ -38,6 +47,7 @@ typedef struct {
 	float iops_ema; // exponential moving average of ops/sec
 	float bytes_ema; // exponential moving average of bytes/sec
 	uint64_t last_op_ns; // monotonic timestamp of last completed op (ns)
+	uint64_t next_offset; // end of the last AUTO request, to spot seeks
 } FileAdaptiveState;
 
 typedef struct Read {
@@ -47,6 +57,7 @@ typedef struct Read {
 	uint64_t offset; // OPTIONAL - Default 0
 	FileMode mode; // OPTIONAL - Default AUTO
 	FileAdaptiveState *adaptive; // OPTIONAL - Pass to enable adaptive switching
+	ErrorResult *batch_error; // OPTIONAL - Outcome in fun_read_files_batch
 } Read;
 
 typedef struct Write {
@@ -84,10 +95,37 @@ typedef struct Append {
  *   .adaptive       OPTIONAL - EMA state for adaptive switching
  * }
  *
+ * With FILE_MODE_DIRECT, .output may point inside a larger allocation
+ * (its capacity is not checked) so that an aligned slice can be passed.
+ *
  * @return AsyncResult with operation status
  */
 AsyncResult fun_read_file_in_memory(Read parameters);
 
+/**
+ * Read many slices, possibly from many files, as one operation
+ *
+ * All reads go to the shared I/O ring together: one submission for the
+ * whole batch (or as much of it as the ring depth allows), and one
+ * AsyncResult that completes when every read has finished.  Reads naming
+ * the same file_path share one open descriptor.  Use this for scatter
+ * reads at queue depth 32-256; raise the depth with
+ * fun_file_ring_set_depth to match.
+ *
+ * Each Read is interpreted as for fun_read_file_in_memory, except that
+ * .mode and .adaptive are ignored (the batch always uses the ring) and
+ * .output may point anywhere inside a larger allocation: its capacity is
+ * not checked.  When .batch_error is set it receives that read's own
+ * outcome; one failing read does not stop the others.
+ *
+ * @param reads  Array of n reads; must stay valid until completion.
+ * @param n      Number of reads (0 completes immediately).
+ *
+ * @return AsyncResult; on ASYNC_ERROR, .error is the first failed read's
+ *         error in array order.
+ */
+AsyncResult fun_read_files_batch(Read *reads, size_t n);
+
 /**
  * Write exact number of bytes to file
  *
@@ -123,6 +161,464 @@ AsyncResult fun_write_memory_to_file(Write parameters);
  */
 AsyncResult fun_append_memory_to_file(Append parameters);
 
+// ------------------------------------------------------------------
+// Gather Writes
+// ------------------------------------------------------------------
+
+/*
+ * Write a record kept in several buffers (header, payload, footer) with
+ * one system call and no staging copy: pwritev / writev, or with
+ * FILE_MODE_RING_BASED one IORING_OP_WRITEV on the shared ring.  Short
+ * writes resume at the segment where they stopped.  An append of up to
+ * FILE_MAX_SEGMENTS segments lands at the end of the file in one piece
+ * unless the kernel reports a short write.
+ */
+#define FILE_MAX_SEGMENTS 1024
+
+typedef struct FileSegment {
+	Memory data; // REQUIRED unless bytes is 0
+	uint64_t bytes;
+} FileSegment;
+
+typedef struct WriteVector {
+	String file_path; // REQUIRED - Created if missing, never truncated
+	const FileSegment *segments; // REQUIRED - Valid until completion
+	uint32_t segment_count; // REQUIRED - At most FILE_MAX_SEGMENTS
+	uint64_t offset; // OPTIONAL - Default 0
+	FileMode mode; // OPTIONAL - RING_BASED uses the ring, others pwritev
+	FileDurabilityMode durability_mode; // OPTIONAL - Default ASYNC
+} WriteVector;
+
+typedef struct AppendVector {
+	String file_path; // REQUIRED - Created if missing
+	const FileSegment *segments; // REQUIRED - Valid until completion
+	uint32_t segment_count; // REQUIRED - At most FILE_MAX_SEGMENTS
+	FileMode mode; // OPTIONAL - RING_BASED uses the ring, others writev
+	FileDurabilityMode durability_mode; // OPTIONAL - Default ASYNC
+} AppendVector;
+
+/* Write the segments back to back starting at .offset. */
+AsyncResult fun_write_vector_to_file(WriteVector parameters);
+
+/* Append the segments back to back at the end of the file. */
+AsyncResult fun_append_vector_to_file(AppendVector parameters);
+
+// ------------------------------------------------------------------
+// Server-Side Copy
+// ------------------------------------------------------------------
+
+/*
+ * Copies that never pass the data through user memory: copy_file_range
+ * on Linux (a reflink on btrfs and XFS, a server-side copy on NFS 4.2),
+ * falling back to sendfile across filesystems or on older kernels;
+ * CopyFileExW on Windows.  On Linux each poll moves at most
+ * FILE_COPY_STEP_BYTES, so a large copy does not stall other results
+ * awaited alongside it; CopyFileExW finishes within one poll.
+ */
+#define FILE_COPY_STEP_BYTES (64ULL << 20)
+
+typedef struct FileCopy {
+	String source_path; // REQUIRED - File to copy from
+	String destination_path; // REQUIRED - Created if missing
+	uint64_t source_offset; // RANGE ONLY - Default 0
+	uint64_t destination_offset; // RANGE ONLY - Default 0
+	uint64_t bytes; // RANGE ONLY - Exact bytes to copy
+	FileDurabilityMode durability_mode; // OPTIONAL - Default ASYNC
+	uint64_t *bytes_copied; // OPTIONAL - Progress, updated on every poll
+} FileCopy;
+
+/*
+ * Replace the destination with a copy of the whole source file.
+ *
+ * Fails with ERROR_CODE_FILE_COPY_SAME_FILE, leaving the file intact,
+ * when both paths name the same file.
+ */
+AsyncResult fun_file_copy(FileCopy parameters);
+
+/*
+ * Copy .bytes from .source_offset to .destination_offset, keeping the
+ * rest of the destination.  Fails with ERROR_CODE_FILE_UNEXPECTED_EOF if
+ * the source ends first.  Ranges within one file must not overlap: that
+ * fails with ERROR_CODE_FILE_COPY_OVERLAP before anything is written.
+ */
+AsyncResult fun_file_copy_range(FileCopy parameters);
+
+// ------------------------------------------------------------------
+// Adaptive Mode Calibration
+// ------------------------------------------------------------------
+
+/*
+ * FILE_MODE_AUTO picks between FILE_MODE_MMAP and FILE_MODE_RING_BASED.
+ * Once calibrated, it looks the choice up by operation, access pattern and
+ * request size; cells still holding FILE_MODE_AUTO fall back to the
+ * FileAdaptiveState rule (ring when the op rate stays above 50/s, else
+ * mmap).
+ *
+ * The pattern is sequential when a request starts where the previous AUTO
+ * request on the same FileAdaptiveState ended, and random otherwise.
+ * Appends, and requests without adaptive state, count as sequential.
+ *
+ * Size buckets, by bytes per request:
+ *   0: up to 16 KiB   1: up to 256 KiB   2: up to 4 MiB   3: larger
+ *
+ * File size is deliberately not a key.  Both modes only touch the
+ * requested range (mmap maps a window around it, the ring reads just it),
+ * so their cost does not grow with the rest of the file, and the mode is
+ * chosen before the file is opened, so keying on it would cost a stat per
+ * request.
+ */
+typedef enum {
+	FILE_ACCESS_READ,
+	FILE_ACCESS_WRITE,
+	FILE_ACCESS_APPEND,
+	FILE_ACCESS_COUNT,
+} FileAccess;
+
+typedef enum {
+	FILE_PATTERN_SEQUENTIAL,
+	FILE_PATTERN_RANDOM,
+	FILE_PATTERN_COUNT,
+} FilePattern;
+
+#define FILE_SIZE_BUCKET_COUNT 4
+
+typedef struct FileCalibration {
+	FileMode mode[FILE_ACCESS_COUNT][FILE_PATTERN_COUNT]
+				 [FILE_SIZE_BUCKET_COUNT];
+	/* mean ns per operation; 0 where not measured or the mode failed */
+	uint64_t mmap_ns[FILE_ACCESS_COUNT][FILE_PATTERN_COUNT]
+					[FILE_SIZE_BUCKET_COUNT];
+	uint64_t ring_ns[FILE_ACCESS_COUNT][FILE_PATTERN_COUNT]
+					[FILE_SIZE_BUCKET_COUNT];
+} FileCalibration;
+
+/*
+ * Time every operation in both modes at one size per bucket on this
+ * machine, install the winners as the FILE_MODE_AUTO table, and copy the
+ * table to out_calibration (may be NULL).  Reads and writes are timed at
+ * advancing and at scattered offsets across a file several requests long;
+ * reads start from storage, not the page cache, where the platform can
+ * evict.  Appends fill both pattern rows.  Takes under a second; run it
+ * once at startup or when the storage changes.
+ *
+ * @param scratch_path  File to benchmark on, on the storage of interest;
+ *                      created or overwritten, and left empty for the
+ *                      caller to delete.
+ * @return              OK; the first failure when neither mode works.
+ */
+ErrorResult fun_file_calibrate(String scratch_path,
+							   FileCalibration *out_calibration);
+
+/*
+ * Install a table saved from an earlier fun_file_calibrate, so later runs
+ * skip the benchmark.  NULL restores the uncalibrated behaviour.  Modes
+ * other than MMAP, RING_BASED and AUTO are rejected with
+ * ERROR_CODE_FILE_INVALID_CALIBRATION.
+ */
+ErrorResult fun_file_set_calibration(const FileCalibration *calibration);
+
+// ------------------------------------------------------------------
+// Shared I/O Ring
+// ------------------------------------------------------------------
+
+/*
+ * FILE_MODE_RING_BASED operations share one process-wide I/O ring
+ * (io_uring on Linux, IoRing on Windows), created on first use and kept
+ * until exit, so a ring read costs one submission rather than a ring
+ * setup and teardown.
+ */
+#define FILE_RING_DEFAULT_DEPTH 64
+#define FILE_RING_MAX_DEPTH 4096
+
+/*
+ * Set the submission queue depth of the shared ring.
+ *
+ * Call before the first ring-based operation.  On Linux an idle ring is
+ * rebuilt at the new depth on next use; while operations are in flight
+ * (or, on Windows, once the ring exists) the call fails with
+ * ERROR_CODE_FILE_RING_BUSY.
+ *
+ * @param depth  1..FILE_RING_MAX_DEPTH; rounded up to a power of two.
+ * @return       OK; ERROR_CODE_FILE_RING_INVALID_DEPTH when out of range;
+ *               ERROR_CODE_FILE_RING_BUSY as above.
+ */
+ErrorResult fun_file_ring_set_depth(uint32_t depth);
+
+#define FILE_RING_MAX_REGISTERED_BUFFERS 1024
+#define FILE_RING_MAX_REGISTERED_BUFFER_SIZE (1ULL << 30)
+
+/*
+ * Register long-lived buffers (typically a pool of Read.output buffers)
+ * with the shared ring, pinning them once instead of on every operation.
+ *
+ * Afterwards every ring-based read or write whose memory lies entirely
+ * inside a registered buffer uses the fixed-buffer form of the operation
+ * (IORING_OP_READ_FIXED / WRITE_FIXED on Linux); other memory keeps
+ * working as before.  A new call replaces the previous set.  The buffers
+ * must stay allocated until fun_file_ring_unregister_buffers().
+ *
+ * Descriptors held by the descriptor cache (fun_file_cache_set_capacity)
+ * are likewise registered as fixed files on Linux.
+ *
+ * @param buffers  count buffer addresses.
+ * @param sizes    count sizes, each 1..FILE_RING_MAX_REGISTERED_BUFFER_SIZE.
+ * @param count    1..FILE_RING_MAX_REGISTERED_BUFFERS.
+ * @return         OK; ERROR_CODE_FILE_RING_INVALID_BUFFER for a bad count
+ *                 or size; ERROR_CODE_FILE_RING_BUSY while ring operations
+ *                 are in flight (Linux; on Windows the caller must ensure
+ *                 none are); other codes when the system refuses (for
+ *                 example the locked-memory limit).
+ */
+ErrorResult fun_file_ring_register_buffers(const Memory *buffers,
+										   const uint64_t *sizes,
+										   uint32_t count);
+
+/*
+ * Stop using the registered buffers so they may be freed.  Fails with
+ * ERROR_CODE_FILE_RING_BUSY while ring operations are in flight.
+ */
+ErrorResult fun_file_ring_unregister_buffers(void);
+
+// ------------------------------------------------------------------
+// Direct I/O
+// ------------------------------------------------------------------
+
+/*
+ * Alignment FILE_MODE_DIRECT needs for the zero-copy path: the system
+ * page size, a multiple of every common logical block size.  A read or
+ * write whose file offset, buffer address and length are all multiples
+ * of it moves no bytes through the bounce buffer.  Note that
+ * fun_memory_allocate does not return aligned memory; allocate one
+ * alignment more than needed and round the address up.
+ */
+uint64_t fun_file_direct_alignment(void);
+
+// ------------------------------------------------------------------
+// Mapped Views
+// ------------------------------------------------------------------
+
+/*
+ * A FileView maps a byte range of a file into memory so a parser can run
+ * directly on the page cache instead of copying the range into its own
+ * buffer first (as FILE_MODE_MMAP reads do).  The view stays valid after
+ * the file is closed, renamed or deleted, until fun_file_unmap_view.
+ * Truncating the file underneath a view makes access past the new end
+ * fault; do not view files another process may shrink.
+ *
+ * FILE_VIEW_SEQUENTIAL / _RANDOM / _WILLNEED are access-pattern hints
+ * (madvise on Linux; open flags and PrefetchVirtualMemory on Windows).
+ * FILE_VIEW_POPULATE faults every page in up front (MAP_POPULATE),
+ * trading a slower map for no page faults while parsing.
+ * FILE_VIEW_PRIVATE makes the view writable copy-on-write, for parsers
+ * that modify their input in place; writes never reach the file.
+ */
+typedef enum {
+	FILE_VIEW_SEQUENTIAL = 1 << 0,
+	FILE_VIEW_RANDOM = 1 << 1,
+	FILE_VIEW_WILLNEED = 1 << 2,
+	FILE_VIEW_POPULATE = 1 << 3,
+	FILE_VIEW_PRIVATE = 1 << 4,
+} FileViewFlags;
+
+typedef struct FileView {
+	const char *data; // First byte of the requested range
+	uint64_t length; // Bytes readable at data
+	void *mapping; // Internal; NULL for an empty view
+} FileView;
+
+/*
+ * Map [offset, offset + length) of a file.
+ *
+ * @param file_path  File to map.
+ * @param offset     Start of the range; need not be aligned.
+ * @param length     Bytes to map; 0 maps to the end of the file (an
+ *                   empty file or offset at the end gives an empty view).
+ * @param flags      FileViewFlags; SEQUENTIAL and RANDOM are exclusive.
+ * @param out_view   Receives the view.
+ * @return           OK; ERROR_CODE_FILE_UNEXPECTED_EOF when the range
+ *                   extends past the end of the file;
+ *                   ERROR_CODE_FILE_VIEW_INVALID_FLAGS; system errors.
+ */
+ErrorResult fun_file_map_view(String file_path, uint64_t offset,
+							  uint64_t length, uint32_t flags,
+							  FileView *out_view);
+
+/* Release a view; its data pointer is invalid afterwards. */
+ErrorResult fun_file_unmap_view(FileView *view);
+
+// ------------------------------------------------------------------
+// Open File Handles
+// ------------------------------------------------------------------
+
+/*
+ * The path-based calls above open and close the file on every call.  A
+ * FileHandle keeps it open, so repeated reads, writes and appends to one
+ * file (a log appender, a record store) cost one system call each.  These
+ * calls are synchronous.
+ */
+typedef enum {
+	FILE_OPEN_READ = 1 << 0, /* read access */
+	FILE_OPEN_WRITE = 1 << 1, /* write access; creates a missing file */
+	FILE_OPEN_APPEND = 1 << 2, /* writes go to end of file (implies WRITE) */
+	FILE_OPEN_TRUNCATE = 1 << 3, /* empty the file on open (needs WRITE) */
+	FILE_OPEN_PREALLOCATE = 1 << 4, /* grow in chunks (needs APPEND) */
+} FileOpenFlags;
+
+/*
+ * FILE_OPEN_PREALLOCATE: for sustained appends by a single writer.  The
+ * file grows by the preallocation chunk at a time (fallocate, so extents
+ * stay large and metadata changes are rare) and appends are copied into a
+ * shared mapping of the current chunk, which slides forward as it fills.
+ * fun_file_handle_size reports the appended size; the file itself is
+ * trimmed to it by fun_file_close.  Until then, and after a crash, other
+ * readers see up to one chunk of zero bytes past the data.
+ *
+ * On Windows the chunk is reserved with FileAllocationInfo, which does not
+ * change the file size, and appends are written as usual.
+ */
+#define FILE_PREALLOCATION_DEFAULT_CHUNK (64ULL << 20)
+#define FILE_PREALLOCATION_MAX_CHUNK (1ULL << 30)
+
+/*
+ * Set the growth chunk for handles opened afterwards with
+ * FILE_OPEN_PREALLOCATE (default FILE_PREALLOCATION_DEFAULT_CHUNK).
+ *
+ * @param bytes  1..FILE_PREALLOCATION_MAX_CHUNK; rounded up to the page size.
+ * @return       OK; ERROR_CODE_FILE_INVALID_PREALLOCATION when out of range.
+ */
+ErrorResult fun_file_set_preallocation_chunk(uint64_t bytes);
+
+/*
+ * Opaque handle to an open file.
+ * Initialised by fun_file_open(); released with fun_file_close().
+ */
+typedef struct FileHandle {
+	void *state; /* implementation-specific data; NULL means not open */
+} FileHandle;
+
+/*
+ * Open a file and keep it open until fun_file_close().
+ *
+ * @param filePath   Path of the file.
+ * @param flags      Combination of FileOpenFlags; at least READ, WRITE or
+ *                   APPEND.
+ * @param outHandle  Receives the handle on success.
+ * @return           OK; ERROR_CODE_FILE_HANDLE_MODE for invalid flags
+ *                   (including PREALLOCATE without APPEND); other error
+ *                   codes on system failures.
+ */
+ErrorResult fun_file_open(String filePath, uint32_t flags,
+						  FileHandle *outHandle);
+
+/*
+ * Read exactly bytes_to_read bytes at offset into output.
+ * Fails with ERROR_CODE_FILE_UNEXPECTED_EOF if the file ends first.
+ */
+ErrorResult fun_file_read_at(FileHandle handle, Memory output,
+							 uint64_t bytes_to_read, uint64_t offset);
+
+/*
+ * Write exactly bytes_to_write bytes from input at offset, growing the
+ * file as needed.  Not available on handles opened with FILE_OPEN_APPEND
+ * (ERROR_CODE_FILE_HANDLE_MODE).
+ */
+ErrorResult fun_file_write_at(FileHandle handle, Memory input,
+							  uint64_t bytes_to_write, uint64_t offset);
+
+/*
+ * Append exactly bytes_to_append bytes from input to the end of the file.
+ * Requires a handle opened with FILE_OPEN_APPEND.
+ */
+ErrorResult fun_file_append(FileHandle handle, Memory input,
+							uint64_t bytes_to_append);
+
+/* Current size of the file in bytes (appended bytes for PREALLOCATE). */
+CanReturnError(uint64_t) fun_file_handle_size(FileHandle handle);
+
+/* Flush written data and metadata to storage (fsync / FlushFileBuffers). */
+ErrorResult fun_file_sync(FileHandle handle);
+
+/*
+ * Close the file and clear handle->state, first trimming a PREALLOCATE
+ * handle's file to its appended size.  Passing a handle whose .state is
+ * NULL returns an error without crashing.
+ */
+ErrorResult fun_file_close(FileHandle *handle);
+
+// ------------------------------------------------------------------
+// Descriptor Cache
+// ------------------------------------------------------------------
+
+/*
+ * Optional LRU cache of open descriptors for the path-based calls, keyed by
+ * path and open mode.  Disabled by default (capacity 0).  When enabled,
+ * reads, mmap writes and appends reuse a cached descriptor instead of
+ * opening the path each time; ring-based writes, which truncate on open,
+ * are never cached.
+ *
+ * A cached descriptor keeps referring to the file it opened: if a path is
+ * removed or replaced behind the cache's back, set the capacity again to
+ * drop every cached descriptor.  Windows has no descriptor cache: only
+ * capacity 0 is accepted there.
+ */
+#define FILE_CACHE_MAX_CAPACITY 1024
+
+/*
+ * Set the number of descriptors the cache may hold, closing every cached
+ * descriptor.  0 disables the cache.
+ *
+ * @return  OK; ERROR_CODE_FILE_CACHE_INVALID_CAPACITY above
+ *          FILE_CACHE_MAX_CAPACITY; ERROR_CODE_FILE_CACHE_BUSY while a
+ *          cached descriptor is in use by an operation;
+ *          ERROR_CODE_FILE_CACHE_UNSUPPORTED for a non-zero capacity on
+ *          Windows.
+ */
+ErrorResult fun_file_cache_set_capacity(uint32_t capacity);
+
+// ------------------------------------------------------------------
+// Group Commit Appender
+// ------------------------------------------------------------------
+
+/*
+ * A FileAppender turns many durable appends into few flushes.  Each
+ * fun_file_appender_append queues the caller's buffer and returns an
+ * AsyncResult; whichever poll finds queued data and no commit running
+ * writes everything queued so far with one gathered write and then one
+ * fdatasync (SYNC) or fsync (FULL), and every append in that commit
+ * completes once its data is durable.  Appends queued while a flush is
+ * running form the next commit, so the flush rate, not the append rate,
+ * bounds the number of flushes.  Appends from several threads may share
+ * an appender; each lands contiguously, in queue order.
+ */
+#define FILE_APPENDER_MAX_BATCH 1024
+
+typedef struct FileAppender {
+	void *state;
+} FileAppender;
+
+/*
+ * Open (creating if needed) a file for group-committed appends.
+ *
+ * @param durability  Flush per commit: ASYNC (none), SYNC or FULL.
+ */
+ErrorResult fun_file_appender_open(String file_path,
+								   FileDurabilityMode durability,
+								   FileAppender *out_appender);
+
+/*
+ * Queue bytes for the next commit.  input must stay valid until the
+ * result completes.  On ASYNC_ERROR the whole commit failed and how much
+ * of it reached the file is unknown.
+ */
+AsyncResult fun_file_appender_append(FileAppender appender, Memory input,
+									 uint64_t bytes_to_append);
+
+/*
+ * Close the appender.  Fails with ERROR_CODE_FILE_APPENDER_BUSY while
+ * appends are still queued or committing; await them first.
+ */
+ErrorResult fun_file_appender_close(FileAppender *appender);
+
 // ------------------------------------------------------------------
 // File Locking
 // ------------------------------------------------------------------
@@ -174,6 +670,45 @@ ErrorResult fun_file_lock_with_timeout(String filePath, uint32_t timeout_ms,
  */
 ErrorResult fun_unlock_file(FileLockHandle lockHandle);
 
+/*
+ * Byte-range locks for processes and threads sharing one data file.
+ *
+ * These are record locks owned by the lock itself rather than by the
+ * process (OFD locks on Linux, LockFileEx on Windows), so two threads of
+ * one process exclude each other like two processes do.  They do not
+ * interact with fun_lock_file.
+ *
+ * A free range is taken on the first poll.  A contended one is waited for
+ * in the kernel (on Linux by a helper thread blocked in F_OFD_SETLKW,
+ * on Windows by an overlapped LockFileEx), so the waiter wakes as soon as
+ * the holder unlocks instead of on the next retry.  Pending polls sleep
+ * at most 1 ms.
+ */
+typedef enum {
+	FILE_LOCK_EXCLUSIVE = 0, /* one holder; needs write access */
+	FILE_LOCK_SHARED, /* any number of holders; blocks EXCLUSIVE */
+} FileLockMode;
+
+#define FILE_LOCK_WAIT_FOREVER UINT32_MAX
+
+typedef struct FileRangeLock {
+	String file_path; // REQUIRED - Existing file
+	uint64_t offset; // OPTIONAL - Default 0
+	uint64_t length; // OPTIONAL - Default 0, to end of file and beyond
+	FileLockMode mode; // OPTIONAL - Default EXCLUSIVE
+	uint32_t timeout_ms; // OPTIONAL - Default 0, one attempt
+	FileLockHandle *out_lock; // REQUIRED - Set when the result completes
+} FileRangeLock;
+
+/*
+ * Lock a byte range.  Fails with ERROR_CODE_LOCK_TIMEOUT when the range
+ * stays held for timeout_ms (FILE_LOCK_WAIT_FOREVER waits indefinitely).
+ */
+AsyncResult fun_file_lock_range(FileRangeLock parameters);
+
+/* Release a range lock and clear lock->state. */
+ErrorResult fun_file_unlock_range(FileLockHandle *lock);
+
 // ------------------------------------------------------------------
 // File Change Notification
 // ------------------------------------------------------------------
@@ -205,3 +740,55 @@ AsyncResult fun_register_file_change_notification(String filePath,
  * Passing NULL returns an error without crashing.
  */
 AsyncResult fun_unregister_file_change_notification(void *state);
+
+/*
+ * Notification hub: many watched paths behind one kernel handle.
+ *
+ * fun_register_file_change_notification costs one inotify instance per
+ * file.  A hub keeps every watch in a single inotify instance behind a
+ * single epoll descriptor, so watching thousands of config or log files
+ * costs one descriptor, and the caller sleeps in the kernel until
+ * something changes.
+ *
+ * Bursts are coalesced: a path is reported once, after it has been quiet
+ * for debounce_ms, however many events it saw.  If the kernel queue
+ * overflows, every watched path is reported.
+ */
+#define FILE_WATCH_PATH_SIZE 512
+#define FILE_WATCH_MAX_PENDING 1024
+
+typedef struct FileWatchHub {
+	void *state;
+} FileWatchHub;
+
+typedef struct FileWatch {
+	String path; // REQUIRED - File or directory
+	FileChangeCallback callback; // REQUIRED - Called with the changed path
+	bool recursive; // OPTIONAL - Default false, directories only
+} FileWatch;
+
+ErrorResult fun_file_watch_hub_open(uint32_t debounce_ms,
+									FileWatchHub *out_hub);
+
+/*
+ * Watch a file, a directory's entries, or with .recursive a whole tree.
+ * Subdirectories created later under a recursive watch are added too.
+ */
+ErrorResult fun_file_watch_hub_add(FileWatchHub hub, FileWatch watch);
+
+/*
+ * Wait up to timeout_ms (-1 forever, 0 not at all) for changes, then run
+ * the callbacks of paths whose debounce interval has passed.  Returns the
+ * number of callbacks run.
+ */
+uint32_tResult fun_file_watch_hub_dispatch(FileWatchHub hub,
+										   int32_t timeout_ms);
+
+/*
+ * Descriptor that becomes readable when dispatch has work: the epoll fd on
+ * Linux, for nesting in an event loop; the I/O completion port on Windows.
+ * Returns -1 for a closed hub.
+ */
+int64_t fun_file_watch_hub_descriptor(FileWatchHub hub);
+
+ErrorResult fun_file_watch_hub_close(FileWatchHub *hub);
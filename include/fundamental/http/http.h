@@ -0,0 +1,139 @@
+#ifndef LIBRARY_HTTP_H
+#define LIBRARY_HTTP_H
+
+#include "../error/error.h"
+#include "../network/network.h"
+#include "../string/string.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * HTTP/1.1 Module — incremental request parser and response writer.
+ *
+ * The parser never allocates or copies: method, target and headers are
+ * views into the caller's buffer (typically a receive view from
+ * fun_network_tcp_receive_some).  Like fun_json_feed, the caller grows
+ * the buffer and calls fun_http_feed; scanning resumes where it stopped.
+ * Several pipelined requests in one buffer are returned one after the
+ * other.
+ *
+ * Bodies are delimited by Content-Length only; Transfer-Encoding is
+ * rejected with ERROR_RESULT_HTTP_UNSUPPORTED.
+ */
+
+#define FUN_HTTP_MAX_HEADERS 32
+#define FUN_HTTP_RESPONSE_HEAD_MAX 512
+
+typedef enum {
+	FUN_HTTP_REQUEST, /* a complete request (head + body) was parsed */
+	FUN_HTTP_INCOMPLETE, /* need more data: feed and call again */
+	FUN_HTTP_END /* buffer fully consumed on a request boundary */
+} FunHttpParseType;
+
+typedef struct {
+	String name;
+	uint64_t name_length;
+	String value; /* leading/trailing whitespace trimmed */
+	uint64_t value_length;
+} FunHttpHeader;
+
+typedef struct {
+	FunHttpParseType type;
+	String method;
+	uint64_t method_length;
+	String target;
+	uint64_t target_length;
+	uint8_t version_minor; /* HTTP/1.x */
+	FunHttpHeader headers[FUN_HTTP_MAX_HEADERS];
+	uint64_t header_count;
+	String body;
+	uint64_t content_length;
+	bool keep_alive;
+} FunHttpRequest;
+
+typedef struct {
+	const char *_data;
+	uint64_t _len;
+	uint64_t _pos; /* start of the next unparsed request */
+	uint64_t _scan; /* end-of-head search resumes here */
+} FunHttpState;
+
+// === Parser ===
+
+/*
+ * Start parsing data[0..len).  data must outlive every request view
+ * returned from it.
+ */
+ErrorResult fun_http_init(FunHttpState *state, const char *data, uint64_t len);
+
+/*
+ * More bytes arrived.  data is the same logical buffer start — it may
+ * have moved (e.g. receive-buffer compaction) but must begin with the
+ * same bytes as before.
+ */
+ErrorResult fun_http_feed(FunHttpState *state, const char *data,
+						  uint64_t new_len);
+
+/*
+ * Parse the next request.  request->type tells whether a request was
+ * produced, more data is needed, or the buffer ended on a boundary.
+ * Malformed input returns ERROR_RESULT_HTTP_PARSE_ERROR; more than
+ * FUN_HTTP_MAX_HEADERS headers returns ERROR_RESULT_HTTP_TOO_MANY_HEADERS.
+ */
+ErrorResult fun_http_next(FunHttpState *state, FunHttpRequest *request);
+
+/*
+ * Bytes of fully parsed requests.  Once their views are no longer needed,
+ * release them from the connection (fun_network_tcp_consume) and
+ * fun_http_init on the remaining bytes.
+ */
+uint64_t fun_http_consumed(const FunHttpState *state);
+
+/* Case-insensitive header lookup; NULL when absent. */
+const FunHttpHeader *fun_http_find_header(const FunHttpRequest *request,
+										  String name);
+
+// === Response writer ===
+
+/*
+ * Status line and headers are formatted into _head inside the struct, and
+ * the body is sent straight from the caller's buffer — head and body go
+ * out in one vectored send, with no allocation.
+ */
+typedef struct {
+	char _head[FUN_HTTP_RESPONSE_HEAD_MAX];
+	uint64_t _head_len;
+	NetworkBuffer _segments[2];
+	bool _overflow;
+} FunHttpResponse;
+
+/*
+ * Start a response with its status line.  CR or LF in reason is rejected
+ * with ERROR_CODE_HTTP_INVALID_HEADER and the response is left untouched.
+ */
+ErrorResult fun_http_response_init(FunHttpResponse *response, uint16_t status,
+								   String reason);
+
+/*
+ * Append a header.  Content-Length and Connection are written by
+ * fun_http_response_send and must not be added here.  An empty name, CR
+ * or LF in either string, or ':' in the name is rejected with
+ * ERROR_CODE_HTTP_INVALID_HEADER and nothing is appended.
+ */
+ErrorResult fun_http_response_header(FunHttpResponse *response, String name,
+									 String value);
+
+/*
+ * Finish the head (Content-Length, Connection) and send head + body.
+ * response and body must remain valid until the AsyncResult completes.
+ * Returns ERROR_RESULT_BUFFER_TOO_SMALL as an ASYNC_ERROR if the head
+ * exceeded FUN_HTTP_RESPONSE_HEAD_MAX.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_http_response_send(FunHttpResponse *response,
+								   TcpNetworkConnection conn, const void *body,
+								   uint64_t body_length, bool keep_alive);
+
+#endif // LIBRARY_HTTP_H
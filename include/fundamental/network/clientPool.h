@@ -0,0 +1,88 @@
+#ifndef LIBRARY_NETWORK_CLIENT_POOL_H
+#define LIBRARY_NETWORK_CLIENT_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../async/async.h"
+#include "../error/error.h"
+#include "network.h"
+
+/*
+ * Network Client Pool Module — keep-alive reuse of outgoing TCP
+ * connections, keyed by remote address.
+ *
+ * Checkout hands out an idle connection to the same address when one is
+ * available and passes a health check (fun_network_tcp_check_alive);
+ * otherwise it connects.  Checkin parks the connection on the idle list
+ * for the next caller instead of closing it, which saves the connect
+ * round trip and leaves no TIME_WAIT socket behind.
+ *
+ * Idle connections older than idle_timeout_ms are closed lazily on
+ * checkout / checkin, or explicitly with fun_network_client_pool_evict_idle.
+ * Timestamps come from the async layer's monotonic clock.
+ *
+ * Pooled connections come from the same fixed connection table as
+ * fun_network_tcp_connect (16 slots), so keep max_per_host small.
+ * Not thread-safe.
+ */
+
+#define NETWORK_CLIENT_POOL_MAX_HOSTS 8
+#define NETWORK_CLIENT_POOL_MAX_PER_HOST 16
+
+struct NetworkClientPool_s;
+typedef struct NetworkClientPool_s *NetworkClientPool;
+
+/*
+ * Create a pool.  max_per_host bounds the connections (idle + checked
+ * out + connecting) to one address, up to NETWORK_CLIENT_POOL_MAX_PER_HOST
+ * (0 = that maximum).  idle_timeout_ms = 0 keeps idle connections until
+ * they fail a health check.
+ */
+CanReturnError(void)
+	fun_network_client_pool_create(size_t max_per_host,
+								   uint32_t idle_timeout_ms,
+								   NetworkClientPool *out_pool);
+
+/*
+ * Close every idle connection and free the pool.  Fails with
+ * ERROR_CODE_NETWORK_CLIENT_POOL_BUSY, freeing nothing, while a
+ * connection is checked out or a checkout has not completed: await
+ * every checkout and check every connection back in first.
+ */
+CanReturnError(void) fun_network_client_pool_free(NetworkClientPool pool);
+
+/*
+ * Get a connection to address.  Completes immediately when a healthy
+ * idle connection is reused; otherwise connects.
+ *
+ * Fails with ERROR_RESULT_NETWORK_BACKPRESSURE when address already has
+ * max_per_host connections, or when NETWORK_CLIENT_POOL_MAX_HOSTS other
+ * addresses are in use.  A checkout abandoned before it completes keeps
+ * its slot, and the pool busy, until it is awaited.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult
+fun_network_client_pool_checkout(NetworkClientPool pool, NetworkAddress address,
+								 OutputTcpNetworkConnection out_conn);
+
+/*
+ * Return a checked-out connection.  With reusable = true it becomes idle
+ * for the next checkout; pass false after an error or a half-read
+ * response, and it is closed.  A connection with unconsumed receive bytes
+ * is always closed.
+ */
+CanReturnError(void) fun_network_client_pool_checkin(NetworkClientPool pool,
+													 TcpNetworkConnection conn,
+													 bool reusable);
+
+/* Close idle connections past the idle timeout.  Returns how many. */
+size_t fun_network_client_pool_evict_idle(NetworkClientPool pool);
+
+/* Idle connections currently parked for address. */
+size_t fun_network_client_pool_idle_count(NetworkClientPool pool,
+										  NetworkAddress address);
+
+#endif /* LIBRARY_NETWORK_CLIENT_POOL_H */
@@ -0,0 +1,89 @@
+#ifndef LIBRARY_NETWORK_FRAME_H
+#define LIBRARY_NETWORK_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../async/async.h"
+#include "../error/error.h"
+#include "../memory/memory.h"
+#include "network.h"
+
+/*
+ * Network Frame Module — length-prefixed binary frames over TCP.
+ *
+ * Wire format: 4-byte big-endian payload length, then the payload.
+ *
+ * Receive: frames that fit in the connection's receive buffer are
+ * returned as views into it (no copy); larger frames are read into one
+ * reusable buffer owned by the framer, grown on demand up to
+ * max_frame_size.
+ *
+ * Send: frames are queued and written together by a single vectored
+ * send on flush.  Queueing past max_queued_bytes (or
+ * NETWORK_FRAME_MAX_QUEUED frames) fails with
+ * ERROR_RESULT_NETWORK_BACKPRESSURE — flush, then retry.
+ *
+ * A TcpNetworkConnection runs one operation at a time, so await each
+ * receive or flush before starting the next.
+ */
+
+#define NETWORK_FRAME_HEADER_BYTES 4
+#define NETWORK_FRAME_MAX_QUEUED 64
+
+struct NetworkFramer_s;
+typedef struct NetworkFramer_s *NetworkFramer;
+
+/*
+ * Create a framer on an established connection.
+ * max_frame_size bounds accepted and queued payloads; max_queued_bytes
+ * bounds the payload bytes waiting for a flush (0 = max_frame_size).
+ * The framer does not own conn; close it separately after freeing.
+ */
+CanReturnError(void)
+	fun_network_frame_create(TcpNetworkConnection conn, size_t max_frame_size,
+							 size_t max_queued_bytes,
+							 NetworkFramer *out_framer);
+
+CanReturnError(void) fun_network_frame_free(NetworkFramer framer);
+
+/*
+ * Receive the next frame.  On ASYNC_COMPLETED frame->data/length describe
+ * the payload; it stays valid until the next receive, release or free.
+ * The previous frame is released automatically.
+ *
+ * A length prefix above max_frame_size fails with
+ * ERROR_RESULT_NETWORK_FRAME_TOO_LARGE; the stream is then unusable.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_frame_receive(NetworkFramer framer,
+									  OutputNetworkBuffer frame);
+
+/* Release the current frame's bytes from the receive buffer. */
+CanReturnError(void) fun_network_frame_release(NetworkFramer framer);
+
+/*
+ * Queue one outgoing frame.  payload is not copied and must stay valid
+ * until the flush that sends it completes.
+ *
+ * Returns ERROR_RESULT_NETWORK_FRAME_TOO_LARGE if length > max_frame_size,
+ * ERROR_RESULT_NETWORK_BACKPRESSURE if the queue is full or a flush is
+ * still in flight.
+ */
+CanReturnError(void) fun_network_frame_queue(NetworkFramer framer,
+											 const void *payload,
+											 size_t length);
+
+/* Payload bytes queued and not yet flushed. */
+size_t fun_network_frame_queued_bytes(NetworkFramer framer);
+
+/*
+ * Send every queued frame in one vectored write.  Completes immediately
+ * when the queue is empty.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_frame_flush(NetworkFramer framer);
+
+#endif /* LIBRARY_NETWORK_FRAME_H */
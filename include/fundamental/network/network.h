@@ -11,7 +11,8 @@
 /*
  * Network Module — simple async TCP/UDP interface.
  *
- * TCP: connect, send, receive_exact, close.
+ * TCP: connect, send, sendv, send_zerocopy, send_file, receive_exact,
+ *      receive_some, receive_at_least, receive_until, peek, consume, close.
  * UDP: fire-and-forget send.
  *
  * All operations return AsyncResult; use fun_async_await() to wait for
@@ -103,6 +104,56 @@ AsyncResult fun_network_tcp_connect(NetworkAddress address,
 AsyncResult fun_network_tcp_send(TcpNetworkConnection conn, const void *data,
 								 size_t length);
 
+/*
+ * Asynchronously send `count` buffers as one logical message using
+ * scatter-gather I/O (sendmsg with iovecs on Linux, WSASend on Windows).
+ * Headers and payloads can be sent without first copying them into a
+ * single contiguous buffer.  buffers[i].length is the number of bytes to
+ * send from buffers[i].data; zero-length entries are skipped.
+ *
+ * The buffers array and every data region must remain valid until the
+ * AsyncResult reaches ASYNC_COMPLETED.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_sendv(TcpNetworkConnection conn,
+								  const NetworkBuffer *buffers, size_t count);
+
+/* Below this size the page-pinning and notification cost of MSG_ZEROCOPY
+ * outweighs the saved copy, so send_zerocopy uses a plain send. */
+#define NETWORK_ZEROCOPY_MIN_BYTES (16 * 1024)
+
+/*
+ * Asynchronously send data without copying it into the kernel (Linux
+ * MSG_ZEROCOPY).  The AsyncResult only reaches ASYNC_COMPLETED once the
+ * kernel has reported, via the socket error queue, that it no longer
+ * references data — the caller may then reuse or free the buffer.
+ *
+ * Zero-copy only pays off for large buffers: sends shorter than
+ * NETWORK_ZEROCOPY_MIN_BYTES, and platforms or kernels without
+ * SO_ZEROCOPY, transparently fall back to fun_network_tcp_send semantics.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_send_zerocopy(TcpNetworkConnection conn,
+										  const void *data, size_t length);
+
+/*
+ * Asynchronously send `length` bytes of the file at file_path, starting at
+ * `offset`, straight from the page cache to the socket (sendfile on Linux).
+ * length = 0 sends everything from offset to end of file.
+ *
+ * The file is opened by this call and closed when the AsyncResult
+ * completes, when the next operation starts on conn, or when the
+ * connection is closed.  A range past the end of the file fails at once
+ * with ERROR_CODE_INDEX_OUT_OF_BOUNDS and nothing is sent.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_send_file(TcpNetworkConnection conn,
+									  const char *file_path, uint64_t offset,
+									  uint64_t length);
+
 /*
  * Asynchronously receive exactly `bytes` bytes into response->data.
  * response->data must point to a buffer of at least `bytes` bytes.
@@ -117,6 +168,80 @@ AsyncResult fun_network_tcp_receive_exact(TcpNetworkConnection conn,
 										  OutputNetworkBuffer response,
 										  size_t bytes);
 
+/* ------------------------------------------------------------------
+ * TCP buffered receive — borrowed views into the connection's staging
+ * buffer.
+ *
+ * These calls do not copy: on completion view->data points into the
+ * connection's internal receive buffer and view->length is the number of
+ * readable bytes.  The bytes stay buffered until released with
+ * fun_network_tcp_consume().  A view is valid until the next receive
+ * call, consume or close on the same connection — parse it (or copy what
+ * must outlive it) before issuing another operation.
+ *
+ * The receive buffer holds network.rx_buf_size bytes (config); a
+ * delimiter that does not appear within that window is reported as
+ * ERROR_RESULT_BUFFER_TOO_SMALL.
+ * ------------------------------------------------------------------ */
+
+/*
+ * Complete as soon as at least one byte is buffered; view covers all
+ * buffered bytes.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_receive_some(TcpNetworkConnection conn,
+										 OutputNetworkBuffer view);
+
+/*
+ * Complete once at least `bytes` bytes are buffered; view covers all
+ * buffered bytes.  `bytes` may not exceed
+ * fun_network_tcp_receive_capacity(conn).
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_receive_at_least(TcpNetworkConnection conn,
+											 size_t bytes,
+											 OutputNetworkBuffer view);
+
+/*
+ * Complete once the delim_len-byte sequence delim is buffered; view covers
+ * everything up to and including the delimiter.  delim must remain valid
+ * until completion.
+ *
+ * Call fun_async_await(&result, timeout_ms) to wait.
+ */
+AsyncResult fun_network_tcp_receive_until(TcpNetworkConnection conn,
+										  const void *delim, size_t delim_len,
+										  OutputNetworkBuffer view);
+
+/*
+ * Synchronously view the bytes already buffered, without touching the
+ * socket.  view->length may be 0.
+ */
+CanReturnError(void)
+	fun_network_tcp_peek(TcpNetworkConnection conn, OutputNetworkBuffer view);
+
+/* Size of the connection's receive buffer — the largest possible view. */
+size_t fun_network_tcp_receive_capacity(TcpNetworkConnection conn);
+
+/*
+ * Release the first `bytes` buffered bytes (typically view->length, or a
+ * parsed prefix of it).  Returns ERROR_CODE_INDEX_OUT_OF_BOUNDS if fewer
+ * bytes are buffered.
+ */
+CanReturnError(void)
+	fun_network_tcp_consume(TcpNetworkConnection conn, size_t bytes);
+
+/*
+ * Check that an idle connection can carry a new request: nothing left
+ * unconsumed in the receive buffer, and the peer has neither closed nor
+ * sent unsolicited bytes.  Returns ERROR_RESULT_NETWORK_INVALID_STATE
+ * for buffered leftovers, ERROR_RESULT_NETWORK_CLOSED otherwise.
+ * Does not block.
+ */
+CanReturnError(void) fun_network_tcp_check_alive(TcpNetworkConnection conn);
+
 /*
  * Close the TCP connection and return the pool slot.
  * After this call, conn must not be used.
@@ -8,9 +8,20 @@
 #include "../memory/memory.h"
 #include "network.h"
 
+#define NETWORK_SERVER_DEFAULT_BACKLOG 128
+
 struct NetworkServerConfig_s;
 typedef struct NetworkServerConfig_s *NetworkServerConfig;
 
+typedef struct {
+	uint64_t accepted; /* connections handed to the listener */
+	/* closed by admission control, or at once because the process was out
+	 * of descriptors; a run of accepts failing for lack of memory counts
+	 * once */
+	uint64_t shed;
+	size_t active; /* accepted and not yet closed via the server */
+} NetworkServerStats;
+
 typedef void (*NetworkTcpListener)(TcpNetworkConnection conn,
 								   Memory server_state);
 typedef void (*NetworkUdpListener)(NetworkAddress source, NetworkBuffer buffer,
@@ -27,6 +38,35 @@ CanReturnError(void)
 
 CanReturnError(void) fun_network_server_config_free(NetworkServerConfig config);
 
+/*
+ * Listen backlog for a TCP config (default NETWORK_SERVER_DEFAULT_BACKLOG;
+ * the kernel caps it at net.core.somaxconn).  Set before listening.
+ */
+CanReturnError(void)
+	fun_network_server_set_backlog(NetworkServerConfig config, int backlog);
+
+/*
+ * Admission control: once max_connections are accepted and not yet
+ * closed through fun_network_server_close_connection, new connections
+ * are closed immediately instead of reaching the listener.
+ * 0 (the default) disables the limit.  Set before listening.
+ */
+CanReturnError(void)
+	fun_network_server_set_max_connections(NetworkServerConfig config,
+										   size_t max_connections);
+
+/*
+ * Close a connection the listener received and free its admission slot.
+ * Use instead of fun_network_tcp_close when max_connections is set.
+ */
+CanReturnError(void)
+	fun_network_server_close_connection(NetworkServerConfig config,
+										TcpNetworkConnection conn);
+
+CanReturnError(void)
+	fun_network_server_get_stats(NetworkServerConfig config,
+								 NetworkServerStats *out_stats);
+
 AsyncResult fun_network_tcp_listen(NetworkServerConfig config,
 								   NetworkTcpListener listener);
 
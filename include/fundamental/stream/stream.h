@@ -33,14 +33,210 @@ AsyncResult fun_stream_open(String file_path, StreamMode mode, Memory buffer,
 							uint64_t buffer_size, FileMode file_mode);
 AsyncResult fun_stream_create_file_read(String file_path, Memory buffer,
 										uint64_t buffer_size, FileMode mode);
+
+/*
+ * Open a read stream that reads ahead while the caller works.  buffer
+ * holds buffer_count slots of buffer_size bytes each (2 to
+ * STREAM_READAHEAD_MAX_BUFFERS); every slot except the one the caller is
+ * processing has a read in flight.  Each fun_stream_read delivers the
+ * next chunk at stream->buffer, which moves from slot to slot, and hands
+ * the previous chunk's slot back for reading.
+ */
+#define STREAM_READAHEAD_MAX_BUFFERS 8
+
+AsyncResult fun_stream_open_readahead(String file_path, Memory buffer,
+									  uint64_t buffer_size,
+									  uint32_t buffer_count);
 AsyncResult fun_stream_destroy(FileStream *stream);
 AsyncResult fun_stream_close(FileStream *stream);
 
+/*
+ * Open a write stream (STREAM_MODE_WRITE or STREAM_MODE_APPEND) that
+ * writes in the background.  buffer holds buffer_count slots of
+ * buffer_size bytes each (2 to STREAM_WRITE_BEHIND_MAX_BUFFERS).
+ * fun_stream_write copies into the current slot and hands a full slot to
+ * the kernel while the next one fills; it stays pending only while every
+ * slot is still being written.  Call fun_stream_flush before closing to
+ * learn whether everything reached the file; close waits for the writes
+ * but cannot report their errors.
+ */
+#define STREAM_WRITE_BEHIND_MAX_BUFFERS 8
+
+AsyncResult fun_stream_open_write_behind(String file_path, StreamMode mode,
+										 Memory buffer, uint64_t buffer_size,
+										 uint32_t buffer_count);
+
 // I/O operations
 AsyncResult fun_stream_read(FileStream *stream, uint64_t *bytes_read);
 AsyncResult fun_stream_write(FileStream *stream, Memory data,
 							 uint64_t data_size);
 
+/*
+ * Write out everything a write-behind stream holds and wait for it;
+ * reports the first failed background write.  Completes at once for
+ * other streams, whose writes are synchronous.
+ */
+AsyncResult fun_stream_flush(FileStream *stream);
+
+/*
+ * Move a read or write stream to position; the next fun_stream_read or
+ * fun_stream_write starts there.  Read streams accept 0 to the file
+ * size, write streams any position.  Readahead streams wait for the
+ * reads in flight and restart from position; write-behind streams flush
+ * first.  ERROR_CODE_STREAM_NOT_SEEKABLE for append streams.  A
+ * StreamRecordReader on the stream must be started afresh afterwards.
+ */
+AsyncResult fun_stream_seek(FileStream *stream, uint64_t position);
+
+// Record iteration
+/*
+ * Split a read stream into records ending in a delimiter.  Records are
+ * returned without the delimiter as views: straight into the stream
+ * buffer when a record lies within one chunk, or into scratch when it
+ * straddles a refill.  A view stays valid until the next call.  Set the
+ * REQUIRED fields, leave the rest zero, and start before the first
+ * fun_stream_read; one call at a time per reader.
+ */
+typedef struct {
+	Memory data; // NULL once the stream is exhausted
+	uint64_t length;
+} StreamRecord;
+
+typedef struct {
+	FileStream *stream; // REQUIRED - Stream opened for reading
+	Memory scratch; // REQUIRED - Holds records that straddle a refill
+	uint64_t scratch_size; // REQUIRED - Longest straddling record
+	uint64_t record_offset; // Status - File offset of the last record
+	uint64_t chunk_start; // Internal - File offset of the current chunk
+	uint64_t chunk_length; // Internal - Bytes in the current chunk
+	uint64_t chunk_offset; // Internal - Next byte to scan
+	uint64_t pending_length; // Internal - Partial record in scratch
+	uint64_t read_bytes; // Internal - Refill result
+	AsyncResult read; // Internal - Refill in flight
+	StreamRecord *record; // Internal - Output of the call in flight
+	char delimiter; // Internal
+	bool strip_carriage_return; // Internal
+	bool reading; // Internal
+	bool finished; // Internal
+} StreamRecordReader;
+
+/*
+ * Next record ending in delimiter.  A last record without one is still
+ * returned.  ERROR_CODE_BUFFER_TOO_SMALL when a straddling record does
+ * not fit in scratch.
+ */
+AsyncResult fun_stream_next_record(StreamRecordReader *reader, char delimiter,
+								   StreamRecord *out_record);
+
+/* Next line, without its "\n" or "\r\n". */
+AsyncResult fun_stream_next_line(StreamRecordReader *reader,
+								 StreamRecord *out_record);
+
+// Position index
+/*
+ * Sparse record index: the file offset of every stride-th record, built
+ * during a first pass from StreamRecordReader.record_offset and saved
+ * next to the file (by convention "<file>.idx").  Finding record N is a
+ * seek to the entry before it plus at most stride - 1 skipped records.
+ * file_size records the size of the file the index describes; compare
+ * it after loading and rebuild when the file has changed.
+ */
+typedef struct {
+	uint64_t *offsets; // REQUIRED - Caller-allocated entries
+	uint64_t capacity; // REQUIRED - Entries offsets can hold
+	uint64_t stride; // REQUIRED - Records per entry; set by load
+	uint64_t count; // Status - Entries filled
+	uint64_t record_count; // Status - Records added
+	uint64_t file_size; // Set before saving - Size of the indexed file
+} StreamIndex;
+
+/* Count the next record; every stride-th one gets an entry. */
+ErrorResult fun_stream_index_add(StreamIndex *index, uint64_t record_offset);
+
+/*
+ * Offset to seek to for record, and how many records to skip from there.
+ * ERROR_CODE_INDEX_OUT_OF_BOUNDS past the last record added.
+ */
+ErrorResult fun_stream_index_find(const StreamIndex *index, uint64_t record,
+								  uint64_t *out_offset, uint64_t *out_skip);
+
+ErrorResult fun_stream_index_save(const StreamIndex *index,
+								  String index_path);
+
+/*
+ * Replace the index with the one in index_path.
+ * ERROR_CODE_STREAM_INVALID_INDEX when it is not a valid index file,
+ * ERROR_CODE_BUFFER_TOO_SMALL when it has more entries than capacity.
+ */
+ErrorResult fun_stream_index_load(StreamIndex *index, String index_path);
+
+// Block compression
+/*
+ * LZ4-style block compression.  A compressed stream is a run of frames,
+ * each holding one block compressed on its own:
+ *
+ *   uint32  stored length, bit 31 set when stored uncompressed
+ *   uint32  uncompressed length
+ *   stored length bytes
+ *
+ * (little-endian).  Frames share no history, so they can be decompressed
+ * in any order, for instance on thread pool workers.
+ */
+#define STREAM_COMPRESS_MAX_BLOCK (4 * 1024 * 1024)
+#define STREAM_COMPRESS_FRAME_HEADER 8
+#define STREAM_COMPRESS_FRAME_BOUND(block_size) \
+	(STREAM_COMPRESS_FRAME_HEADER + (block_size))
+
+/*
+ * Compress source into destination.  ERROR_CODE_BUFFER_TOO_SMALL when
+ * the result would not fit; store such blocks uncompressed.
+ */
+ErrorResult fun_stream_compress_block(Memory source, uint64_t source_size,
+									  Memory destination,
+									  uint64_t destination_size,
+									  uint64_t *out_size);
+ErrorResult fun_stream_decompress_block(Memory source, uint64_t source_size,
+										Memory destination,
+										uint64_t destination_size,
+										uint64_t *out_size);
+
+/*
+ * Frames a write stream.  fun_stream_compress_write collects bytes in
+ * block and writes a frame each time it fills; fun_stream_compress_finish
+ * writes the last, partial block.  Set the REQUIRED fields and leave the
+ * rest zero; one call at a time per writer.
+ */
+typedef struct {
+	FileStream *stream; // REQUIRED - Stream opened for writing
+	Memory block; // REQUIRED - Collects uncompressed bytes
+	uint64_t block_size; // REQUIRED - Up to STREAM_COMPRESS_MAX_BLOCK
+	Memory frame; // REQUIRED - STREAM_COMPRESS_FRAME_BOUND(block_size)
+	uint64_t block_length; // Internal - Bytes collected in block
+	Memory data; // Internal - Rest of the call in flight
+	uint64_t data_size; // Internal
+	AsyncResult write; // Internal - Frame write in flight
+	bool writing; // Internal
+	bool finishing; // Internal
+} StreamCompressWriter;
+
+AsyncResult fun_stream_compress_write(StreamCompressWriter *writer,
+									  Memory data, uint64_t data_size);
+AsyncResult fun_stream_compress_finish(StreamCompressWriter *writer);
+
+/*
+ * Next frame of a compressed read stream, header included, as a view
+ * like fun_stream_next_record; size scratch to
+ * STREAM_COMPRESS_FRAME_BOUND of the writer's block size.  data is NULL
+ * after the last frame.
+ */
+AsyncResult fun_stream_next_frame(StreamRecordReader *reader,
+								  StreamRecord *out_frame);
+
+/* Decompress a frame from fun_stream_next_frame into block. */
+ErrorResult fun_stream_decompress_frame(StreamRecord frame, Memory block,
+										uint64_t block_size,
+										uint64_t *out_length);
+
 // Status and control
 bool fun_stream_can_read(FileStream *stream);
 bool fun_stream_can_write(FileStream *stream, uint64_t requested_size);
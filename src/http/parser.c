@@ -0,0 +1,288 @@
+#include "fundamental/http/http.h"
+
+static inline bool http_is_tchar(char c)
+{
+	if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		(c >= '0' && c <= '9'))
+		return true;
+	switch (c) {
+	case '!':
+	case '#':
+	case '$':
+	case '%':
+	case '&':
+	case '\'':
+	case '*':
+	case '+':
+	case '-':
+	case '.':
+	case '^':
+	case '_':
+	case '`':
+	case '|':
+	case '~':
+		return true;
+	default:
+		return false;
+	}
+}
+
+static inline char http_lower(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+/* Case-insensitive compare of a[0..a_len) against NUL-terminated b */
+static bool http_equals_ci(const char *a, uint64_t a_len, String b)
+{
+	uint64_t i = 0;
+	for (; i < a_len; i++) {
+		if (b[i] == '\0' || http_lower(a[i]) != http_lower(b[i]))
+			return false;
+	}
+	return b[i] == '\0';
+}
+
+/* Does the comma-separated list a[0..a_len) contain token (ci)? */
+static bool http_list_contains(const char *a, uint64_t a_len, String token)
+{
+	uint64_t i = 0;
+	while (i < a_len) {
+		while (i < a_len && (a[i] == ' ' || a[i] == '\t' || a[i] == ','))
+			i++;
+		uint64_t start = i;
+		while (i < a_len && a[i] != ',')
+			i++;
+		uint64_t end = i;
+		while (end > start && (a[end - 1] == ' ' || a[end - 1] == '\t'))
+			end--;
+		if (end > start && http_equals_ci(a + start, end - start, token))
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Find the CRLFCRLF terminating the head that starts at state->_pos.
+ * Returns the offset just past it, or 0 if not buffered yet.
+ */
+static uint64_t http_find_head_end(FunHttpState *state)
+{
+	const char *d = state->_data;
+	uint64_t i = state->_scan > state->_pos ? state->_scan : state->_pos;
+	while (i + 4 <= state->_len) {
+		if (d[i + 3] != '\n') {
+			/* '\n' cannot occur at i+1..i+3 unless d[i+3] is one */
+			i += (d[i + 3] == '\r') ? 1 : 4;
+			continue;
+		}
+		if (d[i] == '\r' && d[i + 1] == '\n' && d[i + 2] == '\r')
+			return i + 4;
+		i++;
+	}
+	state->_scan = i;
+	return 0;
+}
+
+static ErrorResult http_parse_request_line(const char *d, uint64_t *pos,
+										   uint64_t end,
+										   FunHttpRequest *request)
+{
+	uint64_t p = *pos;
+
+	uint64_t start = p;
+	while (p < end && http_is_tchar(d[p]))
+		p++;
+	if (p == start || p >= end || d[p] != ' ')
+		return ERROR_RESULT_HTTP_PARSE_ERROR;
+	request->method = d + start;
+	request->method_length = p - start;
+	p++;
+
+	start = p;
+	while (p < end && (unsigned char)d[p] > ' ' && d[p] != 0x7f)
+		p++;
+	if (p == start || p >= end || d[p] != ' ')
+		return ERROR_RESULT_HTTP_PARSE_ERROR;
+	request->target = d + start;
+	request->target_length = p - start;
+	p++;
+
+	/* "HTTP/1.x\r\n" */
+	if (p + 10 > end || d[p] != 'H' || d[p + 1] != 'T' || d[p + 2] != 'T' ||
+		d[p + 3] != 'P' || d[p + 4] != '/' || d[p + 5] != '1' ||
+		d[p + 6] != '.' || (d[p + 7] != '0' && d[p + 7] != '1') ||
+		d[p + 8] != '\r' || d[p + 9] != '\n')
+		return ERROR_RESULT_HTTP_PARSE_ERROR;
+	request->version_minor = (uint8_t)(d[p + 7] - '0');
+
+	*pos = p + 10;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+static ErrorResult http_parse_headers(const char *d, uint64_t p, uint64_t end,
+									  FunHttpRequest *request)
+{
+	bool have_length = false;
+	bool conn_close = false;
+	bool conn_keep_alive = false;
+
+	/* end points past the final CRLF of the blank line */
+	while (p + 2 < end) {
+		uint64_t start = p;
+		while (p < end && http_is_tchar(d[p]))
+			p++;
+		if (p == start || p >= end || d[p] != ':')
+			return ERROR_RESULT_HTTP_PARSE_ERROR;
+		uint64_t name_len = p - start;
+		p++;
+
+		while (p < end && (d[p] == ' ' || d[p] == '\t'))
+			p++;
+		uint64_t vstart = p;
+		while (p < end && d[p] != '\r') {
+			if (d[p] == '\n')
+				return ERROR_RESULT_HTTP_PARSE_ERROR;
+			p++;
+		}
+		if (p + 1 >= end || d[p + 1] != '\n')
+			return ERROR_RESULT_HTTP_PARSE_ERROR;
+		uint64_t vend = p;
+		while (vend > vstart && (d[vend - 1] == ' ' || d[vend - 1] == '\t'))
+			vend--;
+		p += 2;
+
+		if (request->header_count == FUN_HTTP_MAX_HEADERS)
+			return ERROR_RESULT_HTTP_TOO_MANY_HEADERS;
+		FunHttpHeader *h = &request->headers[request->header_count++];
+		h->name = d + start;
+		h->name_length = name_len;
+		h->value = d + vstart;
+		h->value_length = vend - vstart;
+
+		if (http_equals_ci(h->name, name_len, "content-length")) {
+			if (h->value_length == 0 || h->value_length > 18)
+				return ERROR_RESULT_HTTP_PARSE_ERROR;
+			uint64_t n = 0;
+			for (uint64_t i = 0; i < h->value_length; i++) {
+				char c = h->value[i];
+				if (c < '0' || c > '9')
+					return ERROR_RESULT_HTTP_PARSE_ERROR;
+				n = n * 10 + (uint64_t)(c - '0');
+			}
+			if (have_length && n != request->content_length)
+				return ERROR_RESULT_HTTP_PARSE_ERROR;
+			request->content_length = n;
+			have_length = true;
+		} else if (http_equals_ci(h->name, name_len, "transfer-encoding")) {
+			return ERROR_RESULT_HTTP_UNSUPPORTED;
+		} else if (http_equals_ci(h->name, name_len, "connection")) {
+			if (http_list_contains(h->value, h->value_length, "close"))
+				conn_close = true;
+			if (http_list_contains(h->value, h->value_length, "keep-alive"))
+				conn_keep_alive = true;
+		}
+	}
+
+	if (conn_close)
+		request->keep_alive = false;
+	else if (request->version_minor >= 1)
+		request->keep_alive = true;
+	else
+		request->keep_alive = conn_keep_alive;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+// === Public API ===
+
+ErrorResult fun_http_init(FunHttpState *state, const char *data, uint64_t len)
+{
+	if (state == NULL || (data == NULL && len > 0))
+		return ERROR_RESULT_NULL_POINTER;
+
+	state->_data = data;
+	state->_len = len;
+	state->_pos = 0;
+	state->_scan = 0;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_http_feed(FunHttpState *state, const char *data,
+						  uint64_t new_len)
+{
+	if (state == NULL || (data == NULL && new_len > 0))
+		return ERROR_RESULT_NULL_POINTER;
+	if (new_len < state->_pos)
+		return ERROR_RESULT_HTTP_PARSE_ERROR;
+
+	state->_data = data;
+	state->_len = new_len;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_http_next(FunHttpState *state, FunHttpRequest *request)
+{
+	if (state == NULL || request == NULL)
+		return ERROR_RESULT_NULL_POINTER;
+
+	request->method = NULL;
+	request->method_length = 0;
+	request->target = NULL;
+	request->target_length = 0;
+	request->version_minor = 0;
+	request->header_count = 0;
+	request->body = NULL;
+	request->content_length = 0;
+	request->keep_alive = false;
+
+	if (state->_pos == state->_len) {
+		request->type = FUN_HTTP_END;
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	uint64_t head_end = http_find_head_end(state);
+	if (head_end == 0) {
+		request->type = FUN_HTTP_INCOMPLETE;
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	const char *d = state->_data;
+	uint64_t p = state->_pos;
+	ErrorResult err = http_parse_request_line(d, &p, head_end, request);
+	if (fun_error_is_error(err))
+		return err;
+	err = http_parse_headers(d, p, head_end, request);
+	if (fun_error_is_error(err))
+		return err;
+
+	if (state->_len - head_end < request->content_length) {
+		/* Head is complete; skip rescanning it once the body arrives */
+		state->_scan = head_end - 4;
+		request->type = FUN_HTTP_INCOMPLETE;
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	request->body = request->content_length ? d + head_end : NULL;
+	request->type = FUN_HTTP_REQUEST;
+	state->_pos = head_end + request->content_length;
+	state->_scan = state->_pos;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+uint64_t fun_http_consumed(const FunHttpState *state)
+{
+	return state ? state->_pos : 0;
+}
+
+const FunHttpHeader *fun_http_find_header(const FunHttpRequest *request,
+										  String name)
+{
+	if (request == NULL || name == NULL)
+		return NULL;
+	for (uint64_t i = 0; i < request->header_count; i++) {
+		const FunHttpHeader *h = &request->headers[i];
+		if (http_equals_ci(h->name, h->name_length, name))
+			return h;
+	}
+	return NULL;
+}
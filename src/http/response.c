@@ -0,0 +1,106 @@
+#include "fundamental/http/http.h"
+
+static void http_append(FunHttpResponse *response, const char *s, uint64_t n)
+{
+	if (response->_head_len + n > FUN_HTTP_RESPONSE_HEAD_MAX) {
+		response->_overflow = true;
+		return;
+	}
+	for (uint64_t i = 0; i < n; i++)
+		response->_head[response->_head_len + i] = s[i];
+	response->_head_len += n;
+}
+
+static void http_append_str(FunHttpResponse *response, String s)
+{
+	http_append(response, s, fun_string_length(s));
+}
+
+static void http_append_decimal(FunHttpResponse *response, uint64_t n)
+{
+	char tmp[20];
+	uint64_t len = 0;
+	do {
+		tmp[sizeof(tmp) - 1 - len] = (char)('0' + n % 10);
+		n /= 10;
+		len++;
+	} while (n > 0);
+	http_append(response, tmp + sizeof(tmp) - len, len);
+}
+
+/* No CR or LF, which would end the line early; nor ':' in a name. */
+static bool http_header_text_valid(String s, bool is_name)
+{
+	for (; *s; s++) {
+		if (*s == '\r' || *s == '\n' || (is_name && *s == ':'))
+			return false;
+	}
+	return true;
+}
+
+ErrorResult fun_http_response_init(FunHttpResponse *response, uint16_t status,
+								   String reason)
+{
+	if (response == NULL || reason == NULL)
+		return ERROR_RESULT_NULL_POINTER;
+	if (!http_header_text_valid(reason, false))
+		return ERROR_RESULT_HTTP_INVALID_HEADER;
+
+	response->_head_len = 0;
+	response->_overflow = false;
+	http_append_str(response, "HTTP/1.1 ");
+	http_append_decimal(response, status);
+	http_append_str(response, " ");
+	http_append_str(response, reason);
+	http_append_str(response, "\r\n");
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_http_response_header(FunHttpResponse *response, String name,
+									 String value)
+{
+	if (response == NULL || name == NULL || value == NULL)
+		return ERROR_RESULT_NULL_POINTER;
+	if (name[0] == '\0' || !http_header_text_valid(name, true) ||
+		!http_header_text_valid(value, false))
+		return ERROR_RESULT_HTTP_INVALID_HEADER;
+
+	http_append_str(response, name);
+	http_append_str(response, ": ");
+	http_append_str(response, value);
+	http_append_str(response, "\r\n");
+	return response->_overflow ? ERROR_RESULT_BUFFER_TOO_SMALL :
+								 ERROR_RESULT_NO_ERROR;
+}
+
+AsyncResult fun_http_response_send(FunHttpResponse *response,
+								   TcpNetworkConnection conn, const void *body,
+								   uint64_t body_length, bool keep_alive)
+{
+	AsyncResult result;
+	result.poll = (AsyncPollFn)0;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (response == NULL || conn == NULL || (body == NULL && body_length)) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	http_append_str(response, "Content-Length: ");
+	http_append_decimal(response, body_length);
+	http_append_str(response, keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" :
+										   "\r\nConnection: close\r\n\r\n");
+	if (response->_overflow) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_BUFFER_TOO_SMALL;
+		return result;
+	}
+
+	response->_segments[0].data = response->_head;
+	response->_segments[0].length = response->_head_len;
+	response->_segments[1].data = (void *)body;
+	response->_segments[1].length = body_length;
+	return fun_network_tcp_sendv(conn, response->_segments, 2);
+}
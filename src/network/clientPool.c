@@ -0,0 +1,338 @@
+/*
+ * Network client pool module — keep-alive reuse of outgoing connections.
+ *
+ * Per address, a fixed table of entries moves through
+ * FREE -> CONNECTING -> ACTIVE <-> IDLE -> FREE.  Checkout prefers the
+ * most recently parked idle entry (warmest, furthest from the server's
+ * own idle timeout) and health-checks it before handing it out.
+ *
+ * Built on the public network API plus the async layer's clock.
+ * No OS-specific code lives here.
+ */
+
+#include "fundamental/network/clientPool.h"
+#include "fundamental/memory/memory.h"
+
+/* Arch-layer declaration (implemented per platform in arch/async/) */
+extern unsigned long long arch_async_now_ms(void);
+
+#define POOL_ENTRY_FREE 0
+#define POOL_ENTRY_CONNECTING 1
+#define POOL_ENTRY_ACTIVE 2
+#define POOL_ENTRY_IDLE 3
+
+typedef struct {
+	int state; /* POOL_ENTRY_* */
+	TcpNetworkConnection conn;
+	unsigned long long idle_since_ms;
+	AsyncResult connect_op;
+	OutputTcpNetworkConnection out_conn;
+} PoolEntry;
+
+typedef struct {
+	int used;
+	NetworkAddress address;
+	PoolEntry entries[NETWORK_CLIENT_POOL_MAX_PER_HOST];
+} PoolHost;
+
+struct NetworkClientPool_s {
+	size_t max_per_host;
+	uint32_t idle_timeout_ms;
+	PoolHost hosts[NETWORK_CLIENT_POOL_MAX_HOSTS];
+};
+
+/* ------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------ */
+
+static int address_equals(const NetworkAddress *a, const NetworkAddress *b)
+{
+	if (a->family != b->family || a->port != b->port)
+		return 0;
+	size_t n = (a->family == NETWORK_ADDRESS_IPV6) ? 16 : 4;
+	for (size_t i = 0; i < n; i++)
+		if (a->bytes[i] != b->bytes[i])
+			return 0;
+	return 1;
+}
+
+static void entry_close(PoolEntry *entry)
+{
+	if (entry->conn)
+		fun_network_tcp_close(entry->conn);
+	entry->conn = (TcpNetworkConnection)0;
+	entry->state = POOL_ENTRY_FREE;
+}
+
+static size_t host_live_entries(const PoolHost *host)
+{
+	size_t live = 0;
+	for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++)
+		if (host->entries[i].state != POOL_ENTRY_FREE)
+			live++;
+	return live;
+}
+
+static size_t host_evict_idle(struct NetworkClientPool_s *pool, PoolHost *host,
+							  unsigned long long now)
+{
+	size_t closed = 0;
+	if (pool->idle_timeout_ms == 0)
+		return 0;
+	for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+		PoolEntry *entry = &host->entries[i];
+		if (entry->state == POOL_ENTRY_IDLE &&
+			now - entry->idle_since_ms >= pool->idle_timeout_ms) {
+			entry_close(entry);
+			closed++;
+		}
+	}
+	return closed;
+}
+
+/* Host for address; with create, claims an unused host slot */
+static PoolHost *host_find(struct NetworkClientPool_s *pool,
+						   const NetworkAddress *address, int create)
+{
+	PoolHost *spare = (PoolHost *)0;
+	for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_HOSTS; i++) {
+		PoolHost *host = &pool->hosts[i];
+		if (host->used && host_live_entries(host) == 0)
+			host->used = 0;
+		if (host->used && address_equals(&host->address, address))
+			return host;
+		if (!host->used && !spare)
+			spare = host;
+	}
+	if (!create || !spare)
+		return (PoolHost *)0;
+	spare->used = 1;
+	spare->address = *address;
+	return spare;
+}
+
+/* Most recently parked idle entry that passes the health check */
+static PoolEntry *host_take_idle(PoolHost *host)
+{
+	for (;;) {
+		PoolEntry *best = (PoolEntry *)0;
+		for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+			PoolEntry *entry = &host->entries[i];
+			if (entry->state == POOL_ENTRY_IDLE &&
+				(!best || entry->idle_since_ms > best->idle_since_ms))
+				best = entry;
+		}
+		if (!best)
+			return (PoolEntry *)0;
+		if (fun_error_is_ok(fun_network_tcp_check_alive(best->conn).error)) {
+			best->state = POOL_ENTRY_ACTIVE;
+			return best;
+		}
+		entry_close(best);
+	}
+}
+
+/* ------------------------------------------------------------------
+ * Lifecycle
+ * ------------------------------------------------------------------ */
+
+voidResult fun_network_client_pool_create(size_t max_per_host,
+										  uint32_t idle_timeout_ms,
+										  NetworkClientPool *out_pool)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!out_pool) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (max_per_host == 0 || max_per_host > NETWORK_CLIENT_POOL_MAX_PER_HOST)
+		max_per_host = NETWORK_CLIENT_POOL_MAX_PER_HOST;
+
+	MemoryResult mr = fun_memory_allocate(sizeof(struct NetworkClientPool_s));
+	if (fun_error_is_error(mr.error)) {
+		result.error = mr.error;
+		return result;
+	}
+	fun_memory_fill(mr.value, sizeof(struct NetworkClientPool_s), 0);
+
+	struct NetworkClientPool_s *pool = (struct NetworkClientPool_s *)mr.value;
+	pool->max_per_host = max_per_host;
+	pool->idle_timeout_ms = idle_timeout_ms;
+
+	*out_pool = pool;
+	return result;
+}
+
+voidResult fun_network_client_pool_free(NetworkClientPool pool)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!pool) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	/* A pending checkout polls its entry, so nothing may outlive the pool. */
+	for (size_t h = 0; h < NETWORK_CLIENT_POOL_MAX_HOSTS; h++) {
+		for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+			int state = pool->hosts[h].entries[i].state;
+			if (state == POOL_ENTRY_CONNECTING ||
+				state == POOL_ENTRY_ACTIVE) {
+				result.error = ERROR_RESULT_NETWORK_CLIENT_POOL_BUSY;
+				return result;
+			}
+		}
+	}
+	for (size_t h = 0; h < NETWORK_CLIENT_POOL_MAX_HOSTS; h++) {
+		for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+			PoolEntry *entry = &pool->hosts[h].entries[i];
+			if (entry->state == POOL_ENTRY_IDLE)
+				entry_close(entry);
+		}
+	}
+	Memory mem = (Memory)pool;
+	return fun_memory_free(&mem);
+}
+
+/* ------------------------------------------------------------------
+ * Checkout / checkin
+ * ------------------------------------------------------------------ */
+
+static AsyncStatus poll_pool_connect(AsyncResult *result)
+{
+	PoolEntry *entry = (PoolEntry *)result->state;
+
+	AsyncResult *op = &entry->connect_op;
+	if (op->status == ASYNC_PENDING)
+		op->status = op->poll(op);
+	if (op->status == ASYNC_PENDING) {
+		result->status = ASYNC_PENDING;
+		return ASYNC_PENDING;
+	}
+
+	if (op->status == ASYNC_ERROR) {
+		entry->conn = (TcpNetworkConnection)0;
+		entry->state = POOL_ENTRY_FREE;
+	} else {
+		entry->state = POOL_ENTRY_ACTIVE;
+		*entry->out_conn = entry->conn;
+	}
+	result->status = op->status;
+	result->error = op->error;
+	return result->status;
+}
+
+AsyncResult
+fun_network_client_pool_checkout(NetworkClientPool pool, NetworkAddress address,
+								 OutputTcpNetworkConnection out_conn)
+{
+	AsyncResult result;
+	result.poll = poll_pool_connect;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!pool || !out_conn) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	*out_conn = (TcpNetworkConnection)0;
+
+	PoolHost *host = host_find(pool, &address, 1);
+	if (!host) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NETWORK_BACKPRESSURE;
+		return result;
+	}
+	host_evict_idle(pool, host, arch_async_now_ms());
+
+	PoolEntry *entry = host_take_idle(host);
+	if (entry) {
+		*out_conn = entry->conn;
+		result.status = ASYNC_COMPLETED;
+		return result;
+	}
+
+	if (host_live_entries(host) >= pool->max_per_host) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NETWORK_BACKPRESSURE;
+		return result;
+	}
+	for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+		if (host->entries[i].state == POOL_ENTRY_FREE) {
+			entry = &host->entries[i];
+			break;
+		}
+	}
+
+	entry->state = POOL_ENTRY_CONNECTING;
+	entry->conn = (TcpNetworkConnection)0;
+	entry->out_conn = out_conn;
+	entry->connect_op = fun_network_tcp_connect(address, &entry->conn);
+
+	result.state = (void *)entry;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+voidResult fun_network_client_pool_checkin(NetworkClientPool pool,
+										   TcpNetworkConnection conn,
+										   bool reusable)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!pool || !conn) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	for (size_t h = 0; h < NETWORK_CLIENT_POOL_MAX_HOSTS; h++) {
+		PoolHost *host = &pool->hosts[h];
+		for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++) {
+			PoolEntry *entry = &host->entries[i];
+			if (entry->state != POOL_ENTRY_ACTIVE || entry->conn != conn)
+				continue;
+
+			unsigned long long now = arch_async_now_ms();
+			if (reusable &&
+				fun_error_is_ok(fun_network_tcp_check_alive(conn).error)) {
+				entry->state = POOL_ENTRY_IDLE;
+				entry->idle_since_ms = now;
+			} else {
+				entry_close(entry);
+			}
+			host_evict_idle(pool, host, now);
+			return result;
+		}
+	}
+
+	result.error = ERROR_RESULT_NETWORK_INVALID_STATE;
+	return result;
+}
+
+size_t fun_network_client_pool_evict_idle(NetworkClientPool pool)
+{
+	if (!pool)
+		return 0;
+	size_t closed = 0;
+	unsigned long long now = arch_async_now_ms();
+	for (size_t h = 0; h < NETWORK_CLIENT_POOL_MAX_HOSTS; h++)
+		closed += host_evict_idle(pool, &pool->hosts[h], now);
+	return closed;
+}
+
+size_t fun_network_client_pool_idle_count(NetworkClientPool pool,
+										  NetworkAddress address)
+{
+	if (!pool)
+		return 0;
+	PoolHost *host = host_find(pool, &address, 0);
+	if (!host)
+		return 0;
+	size_t idle = 0;
+	for (size_t i = 0; i < NETWORK_CLIENT_POOL_MAX_PER_HOST; i++)
+		if (host->entries[i].state == POOL_ENTRY_IDLE)
+			idle++;
+	return idle;
+}
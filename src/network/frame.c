@@ -0,0 +1,346 @@
+/*
+ * Network frame module — length-prefixed framing over TcpNetworkConnection.
+ *
+ * Built purely on the public network API: header and small payloads are
+ * read as views (receive_at_least + consume), oversized payloads through
+ * receive_exact into a reusable buffer, and queued frames go out with a
+ * single sendv.
+ *
+ * No OS-specific code lives here.
+ */
+
+#include "fundamental/network/frame.h"
+#include "fundamental/memory/memory.h"
+
+#define FRAME_RX_IDLE 0
+#define FRAME_RX_HEADER 1
+#define FRAME_RX_VIEW 2
+#define FRAME_RX_LARGE 3
+
+struct NetworkFramer_s {
+	TcpNetworkConnection conn;
+	size_t max_frame_size;
+	size_t max_queued_bytes;
+
+	/* Receive side */
+	int rx_state; /* FRAME_RX_* */
+	AsyncResult rx_op; /* in-flight network operation */
+	NetworkBuffer rx_view;
+	OutputNetworkBuffer rx_frame;
+	size_t rx_frame_len;
+	size_t rx_to_release; /* bytes of the current frame still buffered */
+	Memory large_buf; /* reused for frames larger than the rx buffer */
+	size_t large_cap;
+
+	/* Send side */
+	uint8_t headers[NETWORK_FRAME_MAX_QUEUED][NETWORK_FRAME_HEADER_BYTES];
+	NetworkBuffer segments[NETWORK_FRAME_MAX_QUEUED * 2];
+	size_t queued_frames;
+	size_t queued_bytes;
+	int flushing;
+	AsyncResult tx_op;
+};
+
+/* ------------------------------------------------------------------
+ * Lifecycle
+ * ------------------------------------------------------------------ */
+
+voidResult fun_network_frame_create(TcpNetworkConnection conn,
+									size_t max_frame_size,
+									size_t max_queued_bytes,
+									NetworkFramer *out_framer)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!conn || !out_framer) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (max_frame_size == 0 || max_frame_size > 0xFFFFFFFFu) {
+		result.error = ERROR_RESULT_NETWORK_FRAME_TOO_LARGE;
+		return result;
+	}
+
+	MemoryResult mr = fun_memory_allocate(sizeof(struct NetworkFramer_s));
+	if (fun_error_is_error(mr.error)) {
+		result.error = mr.error;
+		return result;
+	}
+	fun_memory_fill(mr.value, sizeof(struct NetworkFramer_s), 0);
+
+	struct NetworkFramer_s *framer = (struct NetworkFramer_s *)mr.value;
+	framer->conn = conn;
+	framer->max_frame_size = max_frame_size;
+	framer->max_queued_bytes = max_queued_bytes ? max_queued_bytes :
+												  max_frame_size;
+	framer->rx_state = FRAME_RX_IDLE;
+	framer->large_buf = (Memory)0;
+
+	*out_framer = framer;
+	return result;
+}
+
+voidResult fun_network_frame_free(NetworkFramer framer)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!framer) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (framer->large_buf)
+		fun_memory_free(&framer->large_buf);
+	Memory mem = (Memory)framer;
+	return fun_memory_free(&mem);
+}
+
+/* ------------------------------------------------------------------
+ * Receive
+ * ------------------------------------------------------------------ */
+
+static uint32_t read_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+		   ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void write_be32(uint32_t v, uint8_t *p)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+static AsyncStatus frame_rx_fail(AsyncResult *result,
+								 struct NetworkFramer_s *framer,
+								 ErrorResult error)
+{
+	framer->rx_state = FRAME_RX_IDLE;
+	result->status = ASYNC_ERROR;
+	result->error = error;
+	return ASYNC_ERROR;
+}
+
+static AsyncStatus frame_rx_done(AsyncResult *result,
+								 struct NetworkFramer_s *framer, void *data)
+{
+	framer->rx_frame->data = data;
+	framer->rx_frame->length = framer->rx_frame_len;
+	framer->rx_state = FRAME_RX_IDLE;
+	result->status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+/* Choose where the payload is read once its length is known */
+static AsyncStatus frame_rx_begin_payload(AsyncResult *result,
+										  struct NetworkFramer_s *framer)
+{
+	size_t len = framer->rx_frame_len;
+
+	if (len == 0)
+		return frame_rx_done(result, framer, (void *)0);
+
+	if (len <= fun_network_tcp_receive_capacity(framer->conn)) {
+		framer->rx_state = FRAME_RX_VIEW;
+		framer->rx_op = fun_network_tcp_receive_at_least(framer->conn, len,
+														 &framer->rx_view);
+		return ASYNC_PENDING;
+	}
+
+	/* Oversized: read into the framer's reusable buffer */
+	if (framer->large_cap < len) {
+		MemoryResult mr =
+			framer->large_buf ?
+				fun_memory_reallocate(framer->large_buf, len) :
+				fun_memory_allocate(len);
+		if (fun_error_is_error(mr.error))
+			return frame_rx_fail(result, framer, mr.error);
+		framer->large_buf = mr.value;
+		framer->large_cap = len;
+	}
+	framer->rx_view.data = framer->large_buf;
+	framer->rx_view.length = 0;
+	framer->rx_state = FRAME_RX_LARGE;
+	framer->rx_op =
+		fun_network_tcp_receive_exact(framer->conn, &framer->rx_view, len);
+	return ASYNC_PENDING;
+}
+
+static AsyncStatus poll_frame_receive(AsyncResult *result)
+{
+	struct NetworkFramer_s *framer = (struct NetworkFramer_s *)result->state;
+
+	for (;;) {
+		AsyncResult *op = &framer->rx_op;
+		if (op->status == ASYNC_PENDING)
+			op->status = op->poll(op);
+		if (op->status == ASYNC_PENDING) {
+			result->status = ASYNC_PENDING;
+			return ASYNC_PENDING;
+		}
+		if (op->status == ASYNC_ERROR)
+			return frame_rx_fail(result, framer, op->error);
+
+		if (framer->rx_state == FRAME_RX_HEADER) {
+			uint32_t len = read_be32((const uint8_t *)framer->rx_view.data);
+			fun_network_tcp_consume(framer->conn, NETWORK_FRAME_HEADER_BYTES);
+			if ((size_t)len > framer->max_frame_size)
+				return frame_rx_fail(result, framer,
+									 ERROR_RESULT_NETWORK_FRAME_TOO_LARGE);
+			framer->rx_frame_len = len;
+			if (frame_rx_begin_payload(result, framer) != ASYNC_PENDING)
+				return result->status;
+			continue;
+		}
+
+		if (framer->rx_state == FRAME_RX_VIEW) {
+			framer->rx_to_release = framer->rx_frame_len;
+			return frame_rx_done(result, framer, framer->rx_view.data);
+		}
+
+		/* FRAME_RX_LARGE: receive_exact already drained the rx buffer */
+		return frame_rx_done(result, framer, framer->large_buf);
+	}
+}
+
+AsyncResult fun_network_frame_receive(NetworkFramer framer,
+									  OutputNetworkBuffer frame)
+{
+	AsyncResult result;
+	result.poll = poll_frame_receive;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!framer || !frame) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	fun_network_frame_release(framer);
+
+	framer->rx_frame = frame;
+	framer->rx_frame_len = 0;
+	frame->data = (void *)0;
+	frame->length = 0;
+
+	framer->rx_state = FRAME_RX_HEADER;
+	framer->rx_op = fun_network_tcp_receive_at_least(
+		framer->conn, NETWORK_FRAME_HEADER_BYTES, &framer->rx_view);
+
+	result.state = (void *)framer;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+voidResult fun_network_frame_release(NetworkFramer framer)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!framer) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (framer->rx_to_release > 0) {
+		result = fun_network_tcp_consume(framer->conn, framer->rx_to_release);
+		framer->rx_to_release = 0;
+	}
+	return result;
+}
+
+/* ------------------------------------------------------------------
+ * Send
+ * ------------------------------------------------------------------ */
+
+voidResult fun_network_frame_queue(NetworkFramer framer, const void *payload,
+								   size_t length)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!framer || (!payload && length > 0)) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (length > framer->max_frame_size) {
+		result.error = ERROR_RESULT_NETWORK_FRAME_TOO_LARGE;
+		return result;
+	}
+	/* An empty queue always accepts one frame so progress is possible */
+	if (framer->flushing ||
+		framer->queued_frames == NETWORK_FRAME_MAX_QUEUED ||
+		(framer->queued_frames > 0 &&
+		 framer->queued_bytes + length > framer->max_queued_bytes)) {
+		result.error = ERROR_RESULT_NETWORK_BACKPRESSURE;
+		return result;
+	}
+
+	size_t i = framer->queued_frames;
+	write_be32((uint32_t)length, framer->headers[i]);
+	framer->segments[i * 2].data = framer->headers[i];
+	framer->segments[i * 2].length = NETWORK_FRAME_HEADER_BYTES;
+	framer->segments[i * 2 + 1].data = (void *)payload;
+	framer->segments[i * 2 + 1].length = length;
+	framer->queued_frames++;
+	framer->queued_bytes += length;
+	return result;
+}
+
+size_t fun_network_frame_queued_bytes(NetworkFramer framer)
+{
+	return framer ? framer->queued_bytes : 0;
+}
+
+static AsyncStatus poll_frame_flush(AsyncResult *result)
+{
+	struct NetworkFramer_s *framer = (struct NetworkFramer_s *)result->state;
+
+	AsyncResult *op = &framer->tx_op;
+	if (op->status == ASYNC_PENDING)
+		op->status = op->poll(op);
+	if (op->status == ASYNC_PENDING) {
+		result->status = ASYNC_PENDING;
+		return ASYNC_PENDING;
+	}
+
+	framer->flushing = 0;
+	framer->queued_frames = 0;
+	framer->queued_bytes = 0;
+	result->status = op->status;
+	result->error = op->error;
+	return result->status;
+}
+
+AsyncResult fun_network_frame_flush(NetworkFramer framer)
+{
+	AsyncResult result;
+	result.poll = poll_frame_flush;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!framer) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (framer->flushing) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NETWORK_INVALID_STATE;
+		return result;
+	}
+	if (framer->queued_frames == 0) {
+		result.status = ASYNC_COMPLETED;
+		return result;
+	}
+
+	framer->flushing = 1;
+	framer->tx_op = fun_network_tcp_sendv(framer->conn, framer->segments,
+										  framer->queued_frames * 2);
+
+	result.state = (void *)framer;
+	result.status = ASYNC_PENDING;
+	return result;
+}
@@ -4,8 +4,10 @@
  * Implements:
  *   - NetworkAddress parse / format
  *   - Connection pool management
- *   - Async poll functions for connect, send, receive_exact
- *   - Public API: fun_network_tcp_connect/send/receive_exact/close/udp_send
+ *   - Async poll functions for connect, send, sendv, send_zerocopy,
+ *     send_file, receive_exact
+ *   - Public API: fun_network_tcp_connect/send/sendv/send_zerocopy/
+ *     send_file/receive_exact/check_alive/close/udp_send
  *
  * No OS-specific code lives here.  Platform logic is in arch/network/.
  */
@@ -26,8 +28,20 @@ int fun_network_arch_tcp_connect(NetworkAddress addr, intptr_t *out_fd);
 int fun_network_arch_tcp_poll_connect(intptr_t fd);
 int fun_network_arch_tcp_send(intptr_t fd, const void *data, size_t len,
 							  size_t *sent);
+int fun_network_arch_tcp_sendv(intptr_t fd, const NetworkBuffer *buffers,
+							   size_t count, size_t first_offset, size_t *sent);
+int fun_network_arch_tcp_enable_zerocopy(intptr_t fd);
+int fun_network_arch_tcp_send_zerocopy(intptr_t fd, const void *data,
+									   size_t len, size_t *sent);
+int fun_network_arch_tcp_reap_zerocopy(intptr_t fd, size_t *completed);
+int fun_network_arch_file_open(const char *path, intptr_t *out_fd,
+							   uint64_t *out_size);
+int fun_network_arch_tcp_send_file(intptr_t fd, intptr_t file_fd,
+								   uint64_t offset, size_t len, size_t *sent);
+void fun_network_arch_file_close(intptr_t file_fd);
 int fun_network_arch_tcp_recv(intptr_t fd, void *data, size_t len,
 							  size_t *received);
+int fun_network_arch_tcp_check_alive(intptr_t fd);
 void fun_network_arch_tcp_close_fd(intptr_t fd);
 int fun_network_arch_udp_send(NetworkAddress addr, const void *data,
 							  size_t len);
@@ -395,6 +409,18 @@ voidResult fun_network_address_to_string(NetworkAddress address, char *out_buf,
 #define CONN_OP_CONNECT 1
 #define CONN_OP_SEND 2
 #define CONN_OP_RECV_EXACT 3
+#define CONN_OP_SENDV 4
+#define CONN_OP_SEND_ZEROCOPY 5
+#define CONN_OP_SEND_FILE 6
+#define CONN_OP_RECV_SOME 7
+#define CONN_OP_RECV_UNTIL 8
+
+#define ZEROCOPY_UNKNOWN 0
+#define ZEROCOPY_ENABLED 1
+#define ZEROCOPY_UNSUPPORTED -1
+
+/* Largest chunk handed to a single sendfile call */
+#define NETWORK_SEND_FILE_CHUNK (1024 * 1024)
 
 struct TcpNetworkConnection_s {
 	intptr_t fd; /* socket fd; -1 = not connected */
@@ -404,6 +430,7 @@ struct TcpNetworkConnection_s {
 	size_t rx_len; /* bytes of valid data in rx_buf */
 	size_t rx_cap; /* total capacity of rx_buf */
 	int op_type; /* current op: CONN_OP_* */
+	int zerocopy; /* ZEROCOPY_*: SO_ZEROCOPY state of fd */
 	union {
 		struct {
 			OutputTcpNetworkConnection out_conn;
@@ -413,11 +440,38 @@ struct TcpNetworkConnection_s {
 			size_t total;
 			size_t sent;
 		} send;
+		struct {
+			const NetworkBuffer *buffers;
+			size_t count;
+			size_t index; /* first buffer not yet fully sent */
+			size_t offset; /* bytes of buffers[index] already sent */
+		} sendv;
+		struct {
+			const void *data;
+			size_t total;
+			size_t sent;
+			size_t pending; /* zero-copy sends not yet notified */
+		} send_zerocopy;
+		struct {
+			intptr_t file_fd;
+			uint64_t offset; /* next file offset to send */
+			uint64_t remaining;
+		} send_file;
 		struct {
 			OutputNetworkBuffer response;
 			size_t bytes;
 			size_t received;
 		} recv_exact;
+		struct {
+			OutputNetworkBuffer view;
+			size_t min_bytes;
+		} recv_some;
+		struct {
+			OutputNetworkBuffer view;
+			const uint8_t *delim;
+			size_t delim_len;
+			size_t scanned; /* bytes past rx_head already searched */
+		} recv_until;
 	} op;
 };
 
@@ -460,6 +514,7 @@ static void pool_init(void)
 		conn_pool[i].rx_len = 0;
 		conn_pool[i].rx_cap = 0;
 		conn_pool[i].op_type = CONN_OP_NONE;
+		conn_pool[i].zerocopy = ZEROCOPY_UNKNOWN;
 	}
 	pool_ready = 1;
 }
@@ -474,16 +529,33 @@ static struct TcpNetworkConnection_s *pool_acquire(void)
 			conn_pool[i].rx_head = 0;
 			conn_pool[i].rx_len = 0;
 			conn_pool[i].op_type = CONN_OP_NONE;
+			conn_pool[i].zerocopy = ZEROCOPY_UNKNOWN;
 			return &conn_pool[i];
 		}
 	}
 	return (struct TcpNetworkConnection_s *)0;
 }
 
+/*
+ * Make op_type the connection's current op.  A send_file abandoned before
+ * completion still owns its file descriptor, so close it before the union
+ * is reused.
+ */
+static void conn_op_begin(struct TcpNetworkConnection_s *conn, int op_type)
+{
+	if (conn->op_type == CONN_OP_SEND_FILE &&
+		conn->op.send_file.file_fd != -1) {
+		fun_network_arch_file_close(conn->op.send_file.file_fd);
+		conn->op.send_file.file_fd = -1;
+	}
+	conn->op_type = op_type;
+}
+
 static void pool_release(struct TcpNetworkConnection_s *conn)
 {
 	if (!conn)
 		return;
+	conn_op_begin(conn, CONN_OP_NONE);
 	if (conn->fd != -1) {
 		fun_network_arch_tcp_close_fd(conn->fd);
 		conn->fd = -1;
@@ -496,6 +568,7 @@ static void pool_release(struct TcpNetworkConnection_s *conn)
 	conn->rx_len = 0;
 	conn->rx_cap = 0;
 	conn->op_type = CONN_OP_NONE;
+	conn->zerocopy = ZEROCOPY_UNKNOWN;
 	conn->in_use = 0;
 }
 
@@ -575,6 +648,279 @@ static AsyncStatus poll_send(AsyncResult *result)
 	return ASYNC_COMPLETED;
 }
 
+static AsyncStatus poll_sendv(AsyncResult *result)
+{
+	struct TcpNetworkConnection_s *conn =
+		(struct TcpNetworkConnection_s *)result->state;
+
+	const NetworkBuffer *buffers = conn->op.sendv.buffers;
+	size_t count = conn->op.sendv.count;
+	size_t index = conn->op.sendv.index;
+	size_t offset = conn->op.sendv.offset;
+
+	for (;;) {
+		/* Skip fully-sent and empty segments */
+		while (index < count && offset >= buffers[index].length) {
+			index++;
+			offset = 0;
+		}
+		if (index >= count)
+			break;
+
+		size_t chunk = 0;
+		int rc = fun_network_arch_tcp_sendv(conn->fd, buffers + index,
+											count - index, offset, &chunk);
+		if (rc == 1) {
+			/* Would-block */
+			conn->op.sendv.index = index;
+			conn->op.sendv.offset = offset;
+			result->status = ASYNC_PENDING;
+			return ASYNC_PENDING;
+		}
+		if (rc == -1) {
+			conn->op_type = CONN_OP_NONE;
+			result->status = ASYNC_ERROR;
+			result->error = ERROR_RESULT_NETWORK_SEND_FAILED;
+			return ASYNC_ERROR;
+		}
+
+		/* Advance the cursor across however many segments were consumed */
+		offset += chunk;
+		while (index < count && offset >= buffers[index].length) {
+			offset -= buffers[index].length;
+			index++;
+		}
+	}
+
+	conn->op.sendv.index = index;
+	conn->op.sendv.offset = 0;
+	conn->op_type = CONN_OP_NONE;
+	result->status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+static AsyncStatus poll_send_zerocopy(AsyncResult *result)
+{
+	struct TcpNetworkConnection_s *conn =
+		(struct TcpNetworkConnection_s *)result->state;
+
+	const uint8_t *data = (const uint8_t *)conn->op.send_zerocopy.data;
+	size_t total = conn->op.send_zerocopy.total;
+	size_t sent = conn->op.send_zerocopy.sent;
+
+	while (sent < total) {
+		size_t chunk = 0;
+		int rc = fun_network_arch_tcp_send_zerocopy(conn->fd, data + sent,
+													total - sent, &chunk);
+		if (rc == 1)
+			break; /* would-block: reap notifications, retry next poll */
+		if (rc == -1) {
+			conn->op_type = CONN_OP_NONE;
+			result->status = ASYNC_ERROR;
+			result->error = ERROR_RESULT_NETWORK_SEND_FAILED;
+			return ASYNC_ERROR;
+		}
+		sent += chunk;
+		conn->op.send_zerocopy.pending++;
+	}
+	conn->op.send_zerocopy.sent = sent;
+
+	/* The buffer is only released once every send has been notified */
+	if (conn->op.send_zerocopy.pending > 0) {
+		size_t completed = 0;
+		if (fun_network_arch_tcp_reap_zerocopy(conn->fd, &completed) != 0) {
+			conn->op_type = CONN_OP_NONE;
+			result->status = ASYNC_ERROR;
+			result->error = ERROR_RESULT_NETWORK_SEND_FAILED;
+			return ASYNC_ERROR;
+		}
+		if (completed > conn->op.send_zerocopy.pending)
+			completed = conn->op.send_zerocopy.pending;
+		conn->op.send_zerocopy.pending -= completed;
+	}
+
+	if (sent < total || conn->op.send_zerocopy.pending > 0) {
+		result->status = ASYNC_PENDING;
+		return ASYNC_PENDING;
+	}
+
+	conn->op_type = CONN_OP_NONE;
+	result->status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+static AsyncStatus send_file_finish(AsyncResult *result,
+									struct TcpNetworkConnection_s *conn,
+									ErrorResult error)
+{
+	fun_network_arch_file_close(conn->op.send_file.file_fd);
+	conn->op.send_file.file_fd = -1;
+	conn->op_type = CONN_OP_NONE;
+	result->error = error;
+	result->status = fun_error_is_ok(error) ? ASYNC_COMPLETED : ASYNC_ERROR;
+	return result->status;
+}
+
+static AsyncStatus poll_send_file(AsyncResult *result)
+{
+	struct TcpNetworkConnection_s *conn =
+		(struct TcpNetworkConnection_s *)result->state;
+
+	while (conn->op.send_file.remaining > 0) {
+		size_t want = NETWORK_SEND_FILE_CHUNK;
+		if ((uint64_t)want > conn->op.send_file.remaining)
+			want = (size_t)conn->op.send_file.remaining;
+
+		size_t chunk = 0;
+		int rc = fun_network_arch_tcp_send_file(conn->fd,
+												conn->op.send_file.file_fd,
+												conn->op.send_file.offset,
+												want, &chunk);
+		if (rc == 1) {
+			/* Would-block */
+			result->status = ASYNC_PENDING;
+			return ASYNC_PENDING;
+		}
+		if (rc == -1 || chunk == 0) {
+			/* Error, or file ended before offset + length */
+			return send_file_finish(result, conn,
+									ERROR_RESULT_NETWORK_SEND_FAILED);
+		}
+		conn->op.send_file.offset += chunk;
+		conn->op.send_file.remaining -= chunk;
+	}
+
+	return send_file_finish(result, conn, ERROR_RESULT_NO_ERROR);
+}
+
+/*
+ * Move the rx_len valid bytes to the front of rx_buf in one overlapping
+ * copy.  Invalidates views previously returned by receive_some/until/peek.
+ */
+static void rx_compact(struct TcpNetworkConnection_s *conn)
+{
+	if (conn->rx_head == 0)
+		return;
+	if (conn->rx_len > 0) {
+		uint8_t *buf = (uint8_t *)conn->rx_buf;
+		voidResult cr = fun_memory_copy((Memory)(buf + conn->rx_head),
+										(Memory)buf, conn->rx_len);
+		(void)cr;
+	}
+	conn->rx_head = 0;
+}
+
+#define RX_FILL_OK 0
+#define RX_FILL_WOULD_BLOCK 1
+#define RX_FILL_ERROR -1
+#define RX_FILL_CLOSED -2
+#define RX_FILL_FULL -3
+
+/*
+ * Append whatever the socket has to the tail of rx_buf, compacting first
+ * if the tail is exhausted.  Returns RX_FILL_*.
+ */
+static int rx_fill(struct TcpNetworkConnection_s *conn)
+{
+	if (conn->rx_head + conn->rx_len == conn->rx_cap)
+		rx_compact(conn);
+	size_t space = conn->rx_cap - conn->rx_head - conn->rx_len;
+	if (space == 0)
+		return RX_FILL_FULL;
+
+	uint8_t *tail = (uint8_t *)conn->rx_buf + conn->rx_head + conn->rx_len;
+	size_t got = 0;
+	int rc = fun_network_arch_tcp_recv(conn->fd, tail, space, &got);
+	if (rc == 1)
+		return RX_FILL_WOULD_BLOCK;
+	if (rc == -1)
+		return RX_FILL_ERROR;
+	if (got == 0)
+		return RX_FILL_CLOSED;
+	conn->rx_len += got;
+	return RX_FILL_OK;
+}
+
+static AsyncStatus recv_view_fail(AsyncResult *result,
+								  struct TcpNetworkConnection_s *conn,
+								  int fill_rc)
+{
+	conn->op_type = CONN_OP_NONE;
+	result->status = ASYNC_ERROR;
+	if (fill_rc == RX_FILL_FULL)
+		result->error = ERROR_RESULT_BUFFER_TOO_SMALL;
+	else if (fill_rc == RX_FILL_CLOSED)
+		result->error = ERROR_RESULT_NETWORK_CLOSED;
+	else
+		result->error = ERROR_RESULT_NETWORK_RECEIVE_FAILED;
+	return ASYNC_ERROR;
+}
+
+static AsyncStatus poll_recv_some(AsyncResult *result)
+{
+	struct TcpNetworkConnection_s *conn =
+		(struct TcpNetworkConnection_s *)result->state;
+
+	while (conn->rx_len < conn->op.recv_some.min_bytes) {
+		int rc = rx_fill(conn);
+		if (rc == RX_FILL_WOULD_BLOCK) {
+			result->status = ASYNC_PENDING;
+			return ASYNC_PENDING;
+		}
+		if (rc != RX_FILL_OK)
+			return recv_view_fail(result, conn, rc);
+	}
+
+	conn->op.recv_some.view->data = (uint8_t *)conn->rx_buf + conn->rx_head;
+	conn->op.recv_some.view->length = conn->rx_len;
+	conn->op_type = CONN_OP_NONE;
+	result->status = ASYNC_COMPLETED;
+	result->error = ERROR_RESULT_NO_ERROR;
+	return ASYNC_COMPLETED;
+}
+
+static AsyncStatus poll_recv_until(AsyncResult *result)
+{
+	struct TcpNetworkConnection_s *conn =
+		(struct TcpNetworkConnection_s *)result->state;
+
+	const uint8_t *delim = conn->op.recv_until.delim;
+	size_t delim_len = conn->op.recv_until.delim_len;
+
+	for (;;) {
+		/* Resume the scan where the previous poll stopped */
+		const uint8_t *buf = (const uint8_t *)conn->rx_buf + conn->rx_head;
+		size_t i = conn->op.recv_until.scanned;
+		while (i + delim_len <= conn->rx_len) {
+			if (buf[i] == delim[0]) {
+				size_t k = 1;
+				while (k < delim_len && buf[i + k] == delim[k])
+					k++;
+				if (k == delim_len) {
+					conn->op.recv_until.view->data = (void *)buf;
+					conn->op.recv_until.view->length = i + delim_len;
+					conn->op_type = CONN_OP_NONE;
+					result->status = ASYNC_COMPLETED;
+					result->error = ERROR_RESULT_NO_ERROR;
+					return ASYNC_COMPLETED;
+				}
+			}
+			i++;
+		}
+		conn->op.recv_until.scanned = i;
+
+		int rc = rx_fill(conn);
+		if (rc == RX_FILL_WOULD_BLOCK) {
+			result->status = ASYNC_PENDING;
+			return ASYNC_PENDING;
+		}
+		if (rc != RX_FILL_OK)
+			return recv_view_fail(result, conn, rc);
+	}
+}
+
 static AsyncStatus poll_recv_exact(AsyncResult *result)
 {
 	struct TcpNetworkConnection_s *conn =
@@ -613,13 +959,7 @@ static AsyncStatus poll_recv_exact(AsyncResult *result)
 	/* Compact rx_buf if needed to make space at the tail */
 	size_t space = conn->rx_cap - conn->rx_head - conn->rx_len;
 	if (space == 0) {
-		/* Compact: move rx_len bytes to front */
-		if (conn->rx_head > 0 && conn->rx_len > 0) {
-			uint8_t *buf = (uint8_t *)conn->rx_buf;
-			for (size_t i = 0; i < conn->rx_len; i++)
-				buf[i] = buf[conn->rx_head + i];
-			conn->rx_head = 0;
-		}
+		rx_compact(conn);
 		space = conn->rx_cap - conn->rx_len;
 	}
 
@@ -739,7 +1079,7 @@ AsyncResult fun_network_tcp_send(TcpNetworkConnection conn, const void *data,
 		return result;
 	}
 
-	conn->op_type = CONN_OP_SEND;
+	conn_op_begin(conn, CONN_OP_SEND);
 	conn->op.send.data = data;
 	conn->op.send.total = length;
 	conn->op.send.sent = 0;
@@ -749,6 +1089,111 @@ AsyncResult fun_network_tcp_send(TcpNetworkConnection conn, const void *data,
 	return result;
 }
 
+AsyncResult fun_network_tcp_sendv(TcpNetworkConnection conn,
+								  const NetworkBuffer *buffers, size_t count)
+{
+	AsyncResult result;
+	result.poll = poll_sendv;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!conn || (!buffers && count > 0)) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!buffers[i].data && buffers[i].length > 0) {
+			result.status = ASYNC_ERROR;
+			result.error = ERROR_RESULT_NULL_POINTER;
+			return result;
+		}
+	}
+
+	conn_op_begin(conn, CONN_OP_SENDV);
+	conn->op.sendv.buffers = buffers;
+	conn->op.sendv.count = count;
+	conn->op.sendv.index = 0;
+	conn->op.sendv.offset = 0;
+
+	result.state = (void *)conn;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+AsyncResult fun_network_tcp_send_zerocopy(TcpNetworkConnection conn,
+										  const void *data, size_t length)
+{
+	if (!conn || !data || length < NETWORK_ZEROCOPY_MIN_BYTES)
+		return fun_network_tcp_send(conn, data, length);
+
+	/* SO_ZEROCOPY is enabled lazily, once per connection */
+	if (conn->zerocopy == ZEROCOPY_UNKNOWN) {
+		conn->zerocopy = fun_network_arch_tcp_enable_zerocopy(conn->fd) == 0 ?
+							 ZEROCOPY_ENABLED :
+							 ZEROCOPY_UNSUPPORTED;
+	}
+	if (conn->zerocopy != ZEROCOPY_ENABLED)
+		return fun_network_tcp_send(conn, data, length);
+
+	AsyncResult result;
+	result.poll = poll_send_zerocopy;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	conn_op_begin(conn, CONN_OP_SEND_ZEROCOPY);
+	conn->op.send_zerocopy.data = data;
+	conn->op.send_zerocopy.total = length;
+	conn->op.send_zerocopy.sent = 0;
+	conn->op.send_zerocopy.pending = 0;
+
+	result.state = (void *)conn;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+AsyncResult fun_network_tcp_send_file(TcpNetworkConnection conn,
+									  const char *file_path, uint64_t offset,
+									  uint64_t length)
+{
+	AsyncResult result;
+	result.poll = poll_send_file;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!conn || !file_path) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+
+	intptr_t file_fd = -1;
+	uint64_t file_size = 0;
+	if (fun_network_arch_file_open(file_path, &file_fd, &file_size) != 0) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_PATH_INVALID;
+		return result;
+	}
+
+	if (offset > file_size || (length > 0 && length > file_size - offset)) {
+		fun_network_arch_file_close(file_fd);
+		result.status = ASYNC_ERROR;
+		result.error = fun_error_result(ERROR_CODE_INDEX_OUT_OF_BOUNDS,
+										"File range exceeds file size");
+		return result;
+	}
+	if (length == 0)
+		length = file_size - offset;
+
+	conn_op_begin(conn, CONN_OP_SEND_FILE);
+	conn->op.send_file.file_fd = file_fd;
+	conn->op.send_file.offset = offset;
+	conn->op.send_file.remaining = length;
+
+	result.state = (void *)conn;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
 AsyncResult fun_network_tcp_receive_exact(TcpNetworkConnection conn,
 										  OutputNetworkBuffer response,
 										  size_t bytes)
@@ -764,7 +1209,7 @@ AsyncResult fun_network_tcp_receive_exact(TcpNetworkConnection conn,
 		return result;
 	}
 
-	conn->op_type = CONN_OP_RECV_EXACT;
+	conn_op_begin(conn, CONN_OP_RECV_EXACT);
 	conn->op.recv_exact.response = response;
 	conn->op.recv_exact.bytes = bytes;
 	conn->op.recv_exact.received = 0;
@@ -774,6 +1219,132 @@ AsyncResult fun_network_tcp_receive_exact(TcpNetworkConnection conn,
 	return result;
 }
 
+AsyncResult fun_network_tcp_receive_some(TcpNetworkConnection conn,
+										 OutputNetworkBuffer view)
+{
+	return fun_network_tcp_receive_at_least(conn, 1, view);
+}
+
+AsyncResult fun_network_tcp_receive_at_least(TcpNetworkConnection conn,
+											 size_t bytes,
+											 OutputNetworkBuffer view)
+{
+	AsyncResult result;
+	result.poll = poll_recv_some;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!conn || !view) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (bytes > conn->rx_cap) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_BUFFER_TOO_SMALL;
+		return result;
+	}
+
+	conn_op_begin(conn, CONN_OP_RECV_SOME);
+	conn->op.recv_some.view = view;
+	conn->op.recv_some.min_bytes = bytes;
+	view->data = (void *)0;
+	view->length = 0;
+
+	result.state = (void *)conn;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+AsyncResult fun_network_tcp_receive_until(TcpNetworkConnection conn,
+										  const void *delim, size_t delim_len,
+										  OutputNetworkBuffer view)
+{
+	AsyncResult result;
+	result.poll = poll_recv_until;
+	result.state = (void *)0;
+	result.error = ERROR_RESULT_NO_ERROR;
+
+	if (!conn || !delim || !view) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (delim_len == 0 || delim_len > conn->rx_cap) {
+		result.status = ASYNC_ERROR;
+		result.error = ERROR_RESULT_BUFFER_TOO_SMALL;
+		return result;
+	}
+
+	conn_op_begin(conn, CONN_OP_RECV_UNTIL);
+	conn->op.recv_until.view = view;
+	conn->op.recv_until.delim = (const uint8_t *)delim;
+	conn->op.recv_until.delim_len = delim_len;
+	conn->op.recv_until.scanned = 0;
+	view->data = (void *)0;
+	view->length = 0;
+
+	result.state = (void *)conn;
+	result.status = ASYNC_PENDING;
+	return result;
+}
+
+voidResult fun_network_tcp_peek(TcpNetworkConnection conn,
+								OutputNetworkBuffer view)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!conn || !view) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	view->data = (uint8_t *)conn->rx_buf + conn->rx_head;
+	view->length = conn->rx_len;
+	return result;
+}
+
+size_t fun_network_tcp_receive_capacity(TcpNetworkConnection conn)
+{
+	return conn ? conn->rx_cap : 0;
+}
+
+voidResult fun_network_tcp_consume(TcpNetworkConnection conn, size_t bytes)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!conn) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (bytes > conn->rx_len) {
+		result.error = fun_error_result(ERROR_CODE_INDEX_OUT_OF_BOUNDS,
+										"Consume exceeds buffered bytes");
+		return result;
+	}
+	conn->rx_head += bytes;
+	conn->rx_len -= bytes;
+	if (conn->rx_len == 0)
+		conn->rx_head = 0;
+	return result;
+}
+
+voidResult fun_network_tcp_check_alive(TcpNetworkConnection conn)
+{
+	voidResult result;
+	result.error = ERROR_RESULT_NO_ERROR;
+	if (!conn) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (conn->rx_len > 0) {
+		result.error = ERROR_RESULT_NETWORK_INVALID_STATE;
+		return result;
+	}
+	if (conn->fd == -1 || fun_network_arch_tcp_check_alive(conn->fd) != 0)
+		result.error = ERROR_RESULT_NETWORK_CLOSED;
+	return result;
+}
+
 voidResult fun_network_tcp_close(TcpNetworkConnection conn)
 {
 	voidResult result;
@@ -5,7 +5,8 @@
 int fun_network_server_arch_tcp_setup(struct NetworkServerConfig_s *config);
 int fun_network_server_arch_udp_setup(struct NetworkServerConfig_s *config);
 int fun_network_server_arch_tcp_accept(struct NetworkServerConfig_s *config,
-									   int timeout_ms, intptr_t *out_fd);
+									   int timeout_ms, intptr_t *out_fds,
+									   size_t max_fds, size_t *out_count);
 int fun_network_server_arch_udp_recv(struct NetworkServerConfig_s *config,
 									 int timeout_ms, NetworkAddress *source,
 									 size_t *received);
@@ -26,23 +27,35 @@ static AsyncStatus server_tcp_poll(AsyncResult *result)
 		return ASYNC_COMPLETED;
 	}
 
-	intptr_t fd = -1;
-	int rc = fun_network_server_arch_tcp_accept(config, 500, &fd);
+	/* Drain the accept queue: one readiness wait, then a batch */
+	intptr_t fds[NETWORK_SERVER_ACCEPT_BATCH];
+	size_t count = 0;
+	int rc = fun_network_server_arch_tcp_accept(
+		config, 500, fds, NETWORK_SERVER_ACCEPT_BATCH, &count);
 	if (rc < 0) {
 		fun_network_server_arch_close(config);
 		result->status = ASYNC_ERROR;
 		result->error = ERROR_RESULT_NETWORK_SERVER_BIND_FAILED;
 		return ASYNC_ERROR;
 	}
-	if (rc > 0 && fd >= 0) {
-		TcpNetworkConnection conn = fun_network_tcp_register_connection(fd);
-		if (conn) {
-			NetworkTcpListener l = (NetworkTcpListener)config->listener;
-			l(conn, config->server_state);
-		} else {
-			int res_rc = fun_network_server_arch_close_connection(fd);
-			(void)res_rc;
+	for (size_t i = 0; i < count; i++) {
+		/* Admission control: shed instead of queueing behind the limit */
+		if (config->max_connections &&
+			config->active >= config->max_connections) {
+			fun_network_server_arch_close_connection(fds[i]);
+			config->shed++;
+			continue;
 		}
+		TcpNetworkConnection conn = fun_network_tcp_register_connection(fds[i]);
+		if (!conn) {
+			fun_network_server_arch_close_connection(fds[i]);
+			config->shed++;
+			continue;
+		}
+		config->active++;
+		config->accepted++;
+		NetworkTcpListener l = (NetworkTcpListener)config->listener;
+		l(conn, config->server_state);
 	}
 
 	result->status = ASYNC_PENDING;
@@ -106,7 +119,14 @@ CanReturnError(void)
 	config->recv_buffer = (void *)0;
 	config->recv_buffer_size = 0;
 	config->listen_fd = -1;
+	config->spare_fd = -1;
+	config->accept_starved = 0;
 	config->stop_flag = 0;
+	config->backlog = NETWORK_SERVER_DEFAULT_BACKLOG;
+	config->max_connections = 0;
+	config->active = 0;
+	config->accepted = 0;
+	config->shed = 0;
 
 	*out_config = (NetworkServerConfig)config;
 	result.error = ERROR_RESULT_NO_ERROR;
@@ -144,7 +164,14 @@ CanReturnError(void)
 	config->recv_buffer = buffer;
 	config->recv_buffer_size = buffer_size;
 	config->listen_fd = -1;
+	config->spare_fd = -1;
+	config->accept_starved = 0;
 	config->stop_flag = 0;
+	config->backlog = NETWORK_SERVER_DEFAULT_BACKLOG;
+	config->max_connections = 0;
+	config->active = 0;
+	config->accepted = 0;
+	config->shed = 0;
 
 	*out_config = (NetworkServerConfig)config;
 	result.error = ERROR_RESULT_NO_ERROR;
@@ -165,6 +192,71 @@ CanReturnError(void) fun_network_server_config_free(NetworkServerConfig config)
 	return result;
 }
 
+CanReturnError(void)
+	fun_network_server_set_backlog(NetworkServerConfig config, int backlog)
+{
+	voidResult result;
+	if (!config) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (config->listen_fd != -1 || config->server_type != NETWORK_SERVER_TCP) {
+		result.error = ERROR_RESULT_NETWORK_INVALID_STATE;
+		return result;
+	}
+	config->backlog = backlog > 0 ? backlog : NETWORK_SERVER_DEFAULT_BACKLOG;
+	result.error = ERROR_RESULT_NO_ERROR;
+	return result;
+}
+
+CanReturnError(void)
+	fun_network_server_set_max_connections(NetworkServerConfig config,
+										   size_t max_connections)
+{
+	voidResult result;
+	if (!config) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (config->listen_fd != -1 || config->server_type != NETWORK_SERVER_TCP) {
+		result.error = ERROR_RESULT_NETWORK_INVALID_STATE;
+		return result;
+	}
+	config->max_connections = max_connections;
+	result.error = ERROR_RESULT_NO_ERROR;
+	return result;
+}
+
+CanReturnError(void)
+	fun_network_server_close_connection(NetworkServerConfig config,
+										TcpNetworkConnection conn)
+{
+	voidResult result;
+	if (!config || !conn) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	if (config->active > 0)
+		config->active--;
+	return fun_network_tcp_close(conn);
+}
+
+CanReturnError(void)
+	fun_network_server_get_stats(NetworkServerConfig config,
+								 NetworkServerStats *out_stats)
+{
+	voidResult result;
+	if (!config || !out_stats) {
+		result.error = ERROR_RESULT_NULL_POINTER;
+		return result;
+	}
+	out_stats->accepted = config->accepted;
+	out_stats->shed = config->shed;
+	out_stats->active = config->active;
+	result.error = ERROR_RESULT_NO_ERROR;
+	return result;
+}
+
 AsyncResult fun_network_tcp_listen(NetworkServerConfig config,
 								   NetworkTcpListener listener)
 {
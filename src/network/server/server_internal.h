@@ -6,6 +6,9 @@
 #define NETWORK_SERVER_TCP 1
 #define NETWORK_SERVER_UDP 2
 
+/* Connections accepted per readiness event, at most */
+#define NETWORK_SERVER_ACCEPT_BATCH 32
+
 struct NetworkServerConfig_s {
 	NetworkAddress address;
 	Memory server_state;
@@ -13,8 +16,18 @@ struct NetworkServerConfig_s {
 	void *recv_buffer;
 	size_t recv_buffer_size;
 	intptr_t listen_fd;
+	/* TCP: descriptor held back so a connection can still be accepted
+	 * and closed when the process runs out (-1 when not held) */
+	intptr_t spare_fd;
+	/* accept is failing for lack of memory; shed counted once per run */
+	int accept_starved;
 	volatile int stop_flag;
 	void *listener;
+	int backlog;
+	size_t max_connections; /* 0 = unlimited */
+	size_t active;
+	uint64_t accepted;
+	uint64_t shed;
 };
 
 #endif
@@ -0,0 +1,530 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/memory/memory.h"
+
+#include <stdint.h>
+
+/*
+ * LZ4 block format: each sequence is a token (literal count in the high
+ * nibble, match length - 4 in the low one, 15 meaning more length bytes
+ * follow, each adding up to 255), the literals, a two-byte offset back
+ * into the output and the extra match length bytes.  The last sequence
+ * is literals only.
+ */
+#define COMPRESS_MIN_MATCH 4
+#define COMPRESS_LAST_LITERALS 5 // Trailing bytes always sent as literals
+#define COMPRESS_MATCH_LIMIT 12 // No match starts this close to the end
+#define COMPRESS_MAX_OFFSET 65535
+#define COMPRESS_HASH_BITS 12
+#define COMPRESS_SKIP_SHIFT 6 // Search speeds up on incompressible input
+
+#define FRAME_STORED 0x80000000U
+
+static uint32_t read32(const uint8_t *p)
+{
+	uint32_t value;
+	__builtin_memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint64_t read64(const uint8_t *p)
+{
+	uint64_t value;
+	__builtin_memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static void write32(uint8_t *p, uint32_t value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	p[2] = (uint8_t)(value >> 16);
+	p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t read32_le(const uint8_t *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+		   (uint32_t)p[3] << 24;
+}
+
+static uint32_t hash32(uint32_t value)
+{
+	return (value * 2654435761U) >> (32 - COMPRESS_HASH_BITS);
+}
+
+/* Forward copy of non-overlapping bytes, eight at a time. */
+static void copy_bytes(uint8_t *destination, const uint8_t *source,
+					   uint64_t count)
+{
+	while (count >= 8) {
+		__builtin_memcpy(destination, source, 8);
+		destination += 8;
+		source += 8;
+		count -= 8;
+	}
+	while (count--)
+		*destination++ = *source++;
+}
+
+/* Bytes needed for the extra length of a nibble that saturated. */
+static uint64_t length_bytes(uint64_t length)
+{
+	return length >= 15 ? (length - 15) / 255 + 1 : 0;
+}
+
+static uint8_t *write_length(uint8_t *out, uint64_t length)
+{
+	for (length -= 15; length >= 255; length -= 255)
+		*out++ = 255;
+	*out++ = (uint8_t)length;
+	return out;
+}
+
+/* Emit a sequence; match_length 0 marks the final, literal-only one. */
+static uint8_t *write_sequence(uint8_t *out, const uint8_t *out_end,
+							   const uint8_t *literals,
+							   uint64_t literal_length, uint32_t offset,
+							   uint64_t match_length)
+{
+	uint64_t match_code = match_length ? match_length - COMPRESS_MIN_MATCH : 0;
+	uint64_t needed = 1 + length_bytes(literal_length) + literal_length;
+	if (match_length)
+		needed += 2 + length_bytes(match_code);
+	if (needed > (uint64_t)(out_end - out))
+		return NULL;
+
+	uint8_t *token = out++;
+	*token = (uint8_t)((literal_length < 15 ? literal_length : 15) << 4);
+	if (literal_length >= 15)
+		out = write_length(out, literal_length);
+	copy_bytes(out, literals, literal_length);
+	out += literal_length;
+	if (!match_length)
+		return out;
+
+	*out++ = (uint8_t)offset;
+	*out++ = (uint8_t)(offset >> 8);
+	*token |= (uint8_t)(match_code < 15 ? match_code : 15);
+	if (match_code >= 15)
+		out = write_length(out, match_code);
+	return out;
+}
+
+ErrorResult fun_stream_compress_block(Memory source, uint64_t source_size,
+									  Memory destination,
+									  uint64_t destination_size,
+									  uint64_t *out_size)
+{
+	if (!source || !destination || !out_size)
+		return ERROR_RESULT_NULL_POINTER;
+	if (source_size > STREAM_COMPRESS_MAX_BLOCK)
+		return ERROR_RESULT_STREAM_BLOCK_TOO_LARGE;
+
+	const uint8_t *base = (const uint8_t *)source;
+	const uint8_t *end = base + source_size;
+	const uint8_t *anchor = base;
+	uint8_t *out = (uint8_t *)destination;
+	const uint8_t *out_end = out + destination_size;
+
+	if (source_size > COMPRESS_MATCH_LIMIT) {
+		/* Positions in a block fit 32 bits; 0 doubles as "empty". */
+		uint32_t table[1 << COMPRESS_HASH_BITS] = { 0 };
+		const uint8_t *match_limit = end - COMPRESS_MATCH_LIMIT;
+		const uint8_t *extend_limit = end - COMPRESS_LAST_LITERALS;
+		const uint8_t *in = base + 1;
+
+		while (in < match_limit) {
+			uint32_t hash = hash32(read32(in));
+			const uint8_t *candidate = base + table[hash];
+			table[hash] = (uint32_t)(in - base);
+			if (in - candidate > COMPRESS_MAX_OFFSET ||
+				read32(candidate) != read32(in)) {
+				in += 1 + ((uint64_t)(in - anchor) >> COMPRESS_SKIP_SHIFT);
+				continue;
+			}
+
+			while (in > anchor && candidate > base && in[-1] == candidate[-1]) {
+				in--;
+				candidate--;
+			}
+			const uint8_t *match_end = in + COMPRESS_MIN_MATCH;
+			const uint8_t *reference = candidate + COMPRESS_MIN_MATCH;
+			while (match_end + 8 <= extend_limit) {
+				uint64_t difference = read64(match_end) ^ read64(reference);
+				if (difference) {
+					match_end += __builtin_ctzll(difference) >> 3;
+					goto matched;
+				}
+				match_end += 8;
+				reference += 8;
+			}
+			while (match_end < extend_limit && *match_end == *reference) {
+				match_end++;
+				reference++;
+			}
+		matched:
+			out = write_sequence(out, out_end, anchor, (uint64_t)(in - anchor),
+								 (uint32_t)(in - candidate),
+								 (uint64_t)(match_end - in));
+			if (!out)
+				return ERROR_RESULT_BUFFER_TOO_SMALL;
+			in = anchor = match_end;
+			if (in < match_limit)
+				table[hash32(read32(in - 2))] = (uint32_t)(in - 2 - base);
+		}
+	}
+
+	out = write_sequence(out, out_end, anchor, (uint64_t)(end - anchor), 0, 0);
+	if (!out)
+		return ERROR_RESULT_BUFFER_TOO_SMALL;
+	*out_size = (uint64_t)(out - (uint8_t *)destination);
+	return ERROR_RESULT_NO_ERROR;
+}
+
+/* Add the extra length bytes after a saturated nibble. */
+static bool read_length(const uint8_t **in, const uint8_t *in_end,
+						uint64_t *length)
+{
+	uint8_t byte;
+	do {
+		if (*in >= in_end)
+			return false;
+		byte = *(*in)++;
+		*length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+ErrorResult fun_stream_decompress_block(Memory source, uint64_t source_size,
+										Memory destination,
+										uint64_t destination_size,
+										uint64_t *out_size)
+{
+	if (!source || !destination || !out_size)
+		return ERROR_RESULT_NULL_POINTER;
+
+	const uint8_t *in = (const uint8_t *)source;
+	const uint8_t *in_end = in + source_size;
+	uint8_t *start = (uint8_t *)destination;
+	uint8_t *out = start;
+	uint8_t *out_end = start + destination_size;
+
+	for (;;) {
+		if (in >= in_end)
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		uint8_t token = *in++;
+
+		uint64_t literal_length = token >> 4;
+		if (literal_length == 15 && !read_length(&in, in_end, &literal_length))
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		if (literal_length > (uint64_t)(in_end - in))
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		if (literal_length > (uint64_t)(out_end - out))
+			return ERROR_RESULT_BUFFER_TOO_SMALL;
+		copy_bytes(out, in, literal_length);
+		in += literal_length;
+		out += literal_length;
+		if (in == in_end)
+			break;
+
+		if (in_end - in < 2)
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		uint64_t offset = (uint64_t)in[0] | (uint64_t)in[1] << 8;
+		in += 2;
+		if (offset == 0 || offset > (uint64_t)(out - start))
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+
+		uint64_t match_length = token & 15;
+		if (match_length == 15 && !read_length(&in, in_end, &match_length))
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		match_length += COMPRESS_MIN_MATCH;
+		if (match_length > (uint64_t)(out_end - out))
+			return ERROR_RESULT_BUFFER_TOO_SMALL;
+
+		/* Short offsets repeat bytes just written, so copy one by one. */
+		const uint8_t *match = out - offset;
+		if (offset >= 8) {
+			copy_bytes(out, match, match_length);
+		} else {
+			for (uint64_t i = 0; i < match_length; i++)
+				out[i] = match[i];
+		}
+		out += match_length;
+	}
+
+	*out_size = (uint64_t)(out - start);
+	return ERROR_RESULT_NO_ERROR;
+}
+
+// ------------------------------------------------------------------
+// Frames
+// ------------------------------------------------------------------
+
+/* Compress the collected block into writer->frame; returns its length. */
+static uint64_t build_frame(StreamCompressWriter *writer)
+{
+	uint8_t *frame = (uint8_t *)writer->frame;
+	uint64_t stored = 0;
+	ErrorResult compressed = fun_stream_compress_block(
+		writer->block, writer->block_length,
+		frame + STREAM_COMPRESS_FRAME_HEADER, writer->block_length, &stored);
+
+	uint32_t stored_field = (uint32_t)stored;
+	if (fun_error_is_error(compressed) || stored >= writer->block_length) {
+		/* Incompressible: storing it is smaller and faster to read. */
+		copy_bytes(frame + STREAM_COMPRESS_FRAME_HEADER,
+				   (const uint8_t *)writer->block, writer->block_length);
+		stored = writer->block_length;
+		stored_field = (uint32_t)stored | FRAME_STORED;
+	}
+	write32(frame, stored_field);
+	write32(frame + 4, (uint32_t)writer->block_length);
+	return STREAM_COMPRESS_FRAME_HEADER + stored;
+}
+
+/* Fill the block and write frames until the call's data is taken. */
+static AsyncStatus compress_step(StreamCompressWriter *writer,
+								 ErrorResult *error)
+{
+	for (;;) {
+		if (writer->writing) {
+			AsyncResult *write = &writer->write;
+			if (write->status == ASYNC_PENDING)
+				write->status = write->poll(write);
+			if (write->status == ASYNC_PENDING)
+				return ASYNC_PENDING;
+			writer->writing = false;
+			if (write->status == ASYNC_ERROR) {
+				writer->data_size = 0;
+				*error = write->error;
+				return ASYNC_ERROR;
+			}
+		}
+
+		uint64_t space = writer->block_size - writer->block_length;
+		uint64_t count = writer->data_size < space ? writer->data_size : space;
+		copy_bytes((uint8_t *)writer->block + writer->block_length,
+				   (const uint8_t *)writer->data, count);
+		writer->block_length += count;
+		writer->data = (uint8_t *)writer->data + count;
+		writer->data_size -= count;
+
+		bool last = writer->finishing && writer->data_size == 0 &&
+					writer->block_length > 0;
+		if (writer->block_length < writer->block_size && !last)
+			return ASYNC_COMPLETED;
+
+		uint64_t frame_length = build_frame(writer);
+		writer->block_length = 0;
+		writer->write =
+			fun_stream_write(writer->stream, writer->frame, frame_length);
+		writer->writing = true;
+	}
+}
+
+static AsyncStatus poll_stream_compress(AsyncResult *result)
+{
+	StreamCompressWriter *writer = (StreamCompressWriter *)result->state;
+	return compress_step(writer, &result->error);
+}
+
+static AsyncResult start_compress(StreamCompressWriter *writer, Memory data,
+								  uint64_t data_size, bool finishing)
+{
+	if (!writer || !writer->stream || !writer->block || !writer->frame ||
+		(!data && data_size > 0)) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+	if (writer->block_size == 0 ||
+		writer->block_size > STREAM_COMPRESS_MAX_BLOCK) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_STREAM_BLOCK_TOO_LARGE };
+	}
+
+	writer->data = data;
+	writer->data_size = data_size;
+	writer->finishing = finishing;
+
+	/* Writes that fit in the block complete without allocating. */
+	AsyncResult result = { .poll = poll_stream_compress,
+						   .state = writer,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = compress_step(writer, &result.error);
+	return result;
+}
+
+AsyncResult fun_stream_compress_write(StreamCompressWriter *writer,
+									  Memory data, uint64_t data_size)
+{
+	return start_compress(writer, data, data_size, false);
+}
+
+AsyncResult fun_stream_compress_finish(StreamCompressWriter *writer)
+{
+	return start_compress(writer, NULL, 0, true);
+}
+
+/* Whole frame length from its header, or 0 when it cannot be valid. */
+static uint64_t frame_length(const uint8_t *header)
+{
+	uint64_t stored = read32_le(header) & ~FRAME_STORED;
+	if (stored > STREAM_COMPRESS_MAX_BLOCK)
+		return 0;
+	return STREAM_COMPRESS_FRAME_HEADER + stored;
+}
+
+/* Scan and refill until a whole frame is available or the stream ends. */
+static AsyncStatus frame_step(StreamRecordReader *reader, ErrorResult *error)
+{
+	FileStream *stream = reader->stream;
+	uint8_t *scratch = (uint8_t *)reader->scratch;
+
+	for (;;) {
+		if (reader->reading) {
+			AsyncResult *read = &reader->read;
+			if (read->status == ASYNC_PENDING)
+				read->status = read->poll(read);
+			if (read->status == ASYNC_PENDING)
+				return ASYNC_PENDING;
+			reader->reading = false;
+			if (read->status == ASYNC_ERROR) {
+				*error = read->error;
+				return ASYNC_ERROR;
+			}
+			reader->chunk_length = reader->read_bytes;
+			reader->chunk_offset = 0;
+			if (reader->read_bytes == 0)
+				reader->finished = true;
+		}
+
+		if (reader->finished) {
+			if (reader->pending_length > 0) {
+				/* The stream ends inside a frame. */
+				*error = ERROR_RESULT_STREAM_CORRUPT_FRAME;
+				return ASYNC_ERROR;
+			}
+			*reader->record = (StreamRecord){ 0 };
+			return ASYNC_COMPLETED;
+		}
+
+		const uint8_t *chunk =
+			(const uint8_t *)stream->buffer + reader->chunk_offset;
+		uint64_t available = reader->chunk_length - reader->chunk_offset;
+		if (reader->pending_length == 0 &&
+			available >= STREAM_COMPRESS_FRAME_HEADER) {
+			uint64_t length = frame_length(chunk);
+			if (length == 0) {
+				*error = ERROR_RESULT_STREAM_CORRUPT_FRAME;
+				return ASYNC_ERROR;
+			}
+			if (length <= available) {
+				*reader->record =
+					(StreamRecord){ .data = (Memory)chunk, .length = length };
+				reader->chunk_offset += length;
+				return ASYNC_COMPLETED;
+			}
+		}
+
+		/* The frame straddles a refill: gather it in scratch. */
+		uint64_t needed = STREAM_COMPRESS_FRAME_HEADER;
+		if (reader->pending_length >= STREAM_COMPRESS_FRAME_HEADER) {
+			needed = frame_length(scratch);
+			if (needed == 0) {
+				*error = ERROR_RESULT_STREAM_CORRUPT_FRAME;
+				return ASYNC_ERROR;
+			}
+		}
+		if (needed > reader->scratch_size) {
+			*error = ERROR_RESULT_BUFFER_TOO_SMALL;
+			return ASYNC_ERROR;
+		}
+		uint64_t count = needed - reader->pending_length;
+		if (count > available)
+			count = available;
+		copy_bytes(scratch + reader->pending_length, chunk, count);
+		reader->pending_length += count;
+		reader->chunk_offset += count;
+
+		if (reader->pending_length >= STREAM_COMPRESS_FRAME_HEADER &&
+			reader->pending_length == frame_length(scratch)) {
+			*reader->record = (StreamRecord){
+				.data = reader->scratch, .length = reader->pending_length
+			};
+			reader->pending_length = 0;
+			return ASYNC_COMPLETED;
+		}
+		if (reader->chunk_offset < reader->chunk_length)
+			continue;
+
+		if (fun_stream_is_end_of_stream(stream)) {
+			reader->finished = true;
+			continue;
+		}
+		reader->read = fun_stream_read(stream, &reader->read_bytes);
+		reader->reading = true;
+	}
+}
+
+static AsyncStatus poll_stream_frame(AsyncResult *result)
+{
+	StreamRecordReader *reader = (StreamRecordReader *)result->state;
+	return frame_step(reader, &result->error);
+}
+
+AsyncResult fun_stream_next_frame(StreamRecordReader *reader,
+								  StreamRecord *out_frame)
+{
+	if (!reader || !reader->stream || !reader->scratch || !out_frame) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	reader->record = out_frame;
+
+	/* Frames inside the current chunk complete without allocating. */
+	AsyncResult result = { .poll = poll_stream_frame,
+						   .state = reader,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = frame_step(reader, &result.error);
+	return result;
+}
+
+ErrorResult fun_stream_decompress_frame(StreamRecord frame, Memory block,
+										uint64_t block_size,
+										uint64_t *out_length)
+{
+	if (!frame.data || !block || !out_length)
+		return ERROR_RESULT_NULL_POINTER;
+
+	const uint8_t *header = (const uint8_t *)frame.data;
+	if (frame.length < STREAM_COMPRESS_FRAME_HEADER ||
+		frame_length(header) != frame.length)
+		return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+	uint32_t stored_field = read32_le(header);
+	uint64_t length = read32_le(header + 4);
+	uint64_t stored = frame.length - STREAM_COMPRESS_FRAME_HEADER;
+	if (length > STREAM_COMPRESS_MAX_BLOCK)
+		return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+	if (length > block_size)
+		return ERROR_RESULT_BUFFER_TOO_SMALL;
+
+	const uint8_t *payload = header + STREAM_COMPRESS_FRAME_HEADER;
+	if (stored_field & FRAME_STORED) {
+		if (stored != length)
+			return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+		copy_bytes((uint8_t *)block, payload, length);
+		*out_length = length;
+		return ERROR_RESULT_NO_ERROR;
+	}
+
+	uint64_t decompressed = 0;
+	ErrorResult error = fun_stream_decompress_block(
+		(Memory)payload, stored, block, length, &decompressed);
+	if (fun_error_is_error(error) || decompressed != length)
+		return ERROR_RESULT_STREAM_CORRUPT_FRAME;
+	*out_length = length;
+	return ERROR_RESULT_NO_ERROR;
+}
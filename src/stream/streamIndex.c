@@ -0,0 +1,123 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+
+#include <stdint.h>
+
+/* "FSIX", then the version; entries follow the header. */
+#define STREAM_INDEX_MAGIC 0x58495346U
+#define STREAM_INDEX_VERSION 1
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t stride;
+	uint64_t count;
+	uint64_t record_count;
+	uint64_t file_size;
+} StreamIndexHeader;
+
+/* Entries needed for record_count records. */
+static uint64_t index_entries(uint64_t record_count, uint64_t stride)
+{
+	return record_count / stride + (record_count % stride != 0);
+}
+
+ErrorResult fun_stream_index_add(StreamIndex *index, uint64_t record_offset)
+{
+	if (!index || !index->offsets)
+		return ERROR_RESULT_NULL_POINTER;
+	if (index->stride == 0)
+		return ERROR_RESULT_STREAM_INVALID_INDEX;
+
+	if (index->record_count % index->stride == 0) {
+		if (index->count >= index->capacity)
+			return ERROR_RESULT_BUFFER_TOO_SMALL;
+		index->offsets[index->count++] = record_offset;
+	}
+	index->record_count++;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_stream_index_find(const StreamIndex *index, uint64_t record,
+								  uint64_t *out_offset, uint64_t *out_skip)
+{
+	if (!index || !index->offsets || !out_offset || !out_skip)
+		return ERROR_RESULT_NULL_POINTER;
+	if (index->stride == 0 || record >= index->record_count)
+		return fun_error_result(ERROR_CODE_INDEX_OUT_OF_BOUNDS,
+								"Record is not in the index");
+
+	*out_offset = index->offsets[record / index->stride];
+	*out_skip = record % index->stride;
+	return ERROR_RESULT_NO_ERROR;
+}
+
+ErrorResult fun_stream_index_save(const StreamIndex *index, String index_path)
+{
+	if (!index || !index->offsets || !index_path)
+		return ERROR_RESULT_NULL_POINTER;
+
+	StreamIndexHeader header = { .magic = STREAM_INDEX_MAGIC,
+								 .version = STREAM_INDEX_VERSION,
+								 .stride = index->stride,
+								 .count = index->count,
+								 .record_count = index->record_count,
+								 .file_size = index->file_size };
+	FileHandle handle = { 0 };
+	ErrorResult error = fun_file_open(
+		index_path, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle);
+	if (fun_error_is_error(error))
+		return error;
+
+	error = fun_file_write_at(handle, &header, sizeof(header), 0);
+	if (fun_error_is_ok(error) && index->count > 0) {
+		error = fun_file_write_at(handle, index->offsets,
+								  index->count * sizeof(uint64_t),
+								  sizeof(header));
+	}
+	ErrorResult close_error = fun_file_close(&handle);
+	return fun_error_is_error(error) ? error : close_error;
+}
+
+ErrorResult fun_stream_index_load(StreamIndex *index, String index_path)
+{
+	if (!index || !index->offsets || !index_path)
+		return ERROR_RESULT_NULL_POINTER;
+
+	FileHandle handle = { 0 };
+	ErrorResult error = fun_file_open(index_path, FILE_OPEN_READ, &handle);
+	if (fun_error_is_error(error))
+		return error;
+
+	StreamIndexHeader header;
+	error = fun_file_read_at(handle, &header, sizeof(header), 0);
+	if (fun_error_is_ok(error) &&
+		(header.magic != STREAM_INDEX_MAGIC ||
+		 header.version != STREAM_INDEX_VERSION || header.stride == 0 ||
+		 header.count != index_entries(header.record_count, header.stride)))
+		error = ERROR_RESULT_STREAM_INVALID_INDEX;
+	if (fun_error_is_ok(error) && header.count > index->capacity)
+		error = ERROR_RESULT_BUFFER_TOO_SMALL;
+	if (fun_error_is_ok(error) && header.count > 0) {
+		error = fun_file_read_at(handle, index->offsets,
+								 header.count * sizeof(uint64_t),
+								 sizeof(header));
+		if (fun_error_is_error(error)) {
+			/* The entries are partly overwritten: leave an empty index. */
+			index->count = 0;
+			index->record_count = 0;
+		}
+	}
+	fun_file_close(&handle);
+
+	if (error.code == ERROR_CODE_FILE_UNEXPECTED_EOF)
+		return ERROR_RESULT_STREAM_INVALID_INDEX;
+	if (fun_error_is_error(error))
+		return error;
+
+	index->stride = header.stride;
+	index->count = header.count;
+	index->record_count = header.record_count;
+	index->file_size = header.file_size;
+	return ERROR_RESULT_NO_ERROR;
+}
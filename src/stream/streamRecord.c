@@ -0,0 +1,190 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/memory/memory.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * First delimiter in [start, end), or NULL.  SSE2 is part of the x86-64
+ * baseline, so it needs no build flags; elsewhere eight bytes are tested
+ * at a time in a general-purpose register.
+ */
+static const char *find_delimiter(const char *start, const char *end,
+								  char delimiter)
+{
+#if defined(__SSE2__)
+	__m128i pattern = _mm_set1_epi8(delimiter);
+	while (end - start >= 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)start);
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+		if (mask)
+			return start + __builtin_ctz((unsigned int)mask);
+		start += 16;
+	}
+#else
+	/*
+	 * A byte of word ^ pattern is zero where the delimiter is.  Borrows
+	 * only flag bytes above a real match, so the lowest flag is exact
+	 * (little-endian targets).
+	 */
+	uint64_t pattern = 0x0101010101010101ULL * (uint8_t)delimiter;
+	while (end - start >= 8) {
+		uint64_t word;
+		__builtin_memcpy(&word, start, sizeof(word));
+		word ^= pattern;
+		uint64_t found =
+			(word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+		if (found)
+			return start + (__builtin_ctzll(found) >> 3);
+		start += 8;
+	}
+#endif
+	for (; start < end; start++) {
+		if (*start == delimiter)
+			return start;
+	}
+	return NULL;
+}
+
+static bool record_carry(StreamRecordReader *reader, const char *bytes,
+						 uint64_t length)
+{
+	if (length == 0)
+		return true;
+	if (length > reader->scratch_size - reader->pending_length)
+		return false;
+	fun_memory_copy((Memory)bytes,
+					(char *)reader->scratch + reader->pending_length, length);
+	reader->pending_length += length;
+	return true;
+}
+
+static void record_emit(StreamRecordReader *reader, const char *data,
+						uint64_t length)
+{
+	if (reader->strip_carriage_return && length > 0 &&
+		data[length - 1] == '\r')
+		length--;
+	*reader->record = (StreamRecord){ .data = (Memory)data, .length = length };
+}
+
+/* Scan and refill until a record is found or the stream ends. */
+static AsyncStatus record_step(StreamRecordReader *reader, ErrorResult *error)
+{
+	FileStream *stream = reader->stream;
+
+	for (;;) {
+		if (reader->reading) {
+			AsyncResult *read = &reader->read;
+			if (read->status == ASYNC_PENDING)
+				read->status = read->poll(read);
+			if (read->status == ASYNC_PENDING)
+				return ASYNC_PENDING;
+			reader->reading = false;
+			if (read->status == ASYNC_ERROR) {
+				*error = read->error;
+				return ASYNC_ERROR;
+			}
+			reader->chunk_start =
+				stream->current_position - reader->read_bytes;
+			reader->chunk_length = reader->read_bytes;
+			reader->chunk_offset = 0;
+			if (reader->read_bytes == 0)
+				reader->finished = true;
+		}
+
+		if (reader->finished) {
+			if (reader->pending_length > 0) {
+				record_emit(reader, (const char *)reader->scratch,
+							reader->pending_length);
+				reader->pending_length = 0;
+			} else {
+				*reader->record = (StreamRecord){ 0 };
+			}
+			return ASYNC_COMPLETED;
+		}
+
+		/* A record with nothing carried starts here. */
+		if (reader->pending_length == 0)
+			reader->record_offset = reader->chunk_start + reader->chunk_offset;
+
+		const char *chunk = (const char *)stream->buffer + reader->chunk_offset;
+		const char *chunk_end =
+			(const char *)stream->buffer + reader->chunk_length;
+		const char *found =
+			find_delimiter(chunk, chunk_end, reader->delimiter);
+		if (found) {
+			uint64_t length = (uint64_t)(found - chunk);
+			reader->chunk_offset += length + 1;
+			if (reader->pending_length == 0) {
+				record_emit(reader, chunk, length);
+				return ASYNC_COMPLETED;
+			}
+			if (!record_carry(reader, chunk, length)) {
+				*error = ERROR_RESULT_BUFFER_TOO_SMALL;
+				return ASYNC_ERROR;
+			}
+			record_emit(reader, (const char *)reader->scratch,
+						reader->pending_length);
+			reader->pending_length = 0;
+			return ASYNC_COMPLETED;
+		}
+
+		/* The chunk ends inside a record: keep its head and refill. */
+		if (!record_carry(reader, chunk, (uint64_t)(chunk_end - chunk))) {
+			*error = ERROR_RESULT_BUFFER_TOO_SMALL;
+			return ASYNC_ERROR;
+		}
+		reader->chunk_offset = reader->chunk_length;
+
+		if (fun_stream_is_end_of_stream(stream)) {
+			reader->finished = true;
+			continue;
+		}
+		reader->read = fun_stream_read(stream, &reader->read_bytes);
+		reader->reading = true;
+	}
+}
+
+static AsyncStatus poll_stream_record(AsyncResult *result)
+{
+	StreamRecordReader *reader = (StreamRecordReader *)result->state;
+	return record_step(reader, &result->error);
+}
+
+static AsyncResult start_record(StreamRecordReader *reader, char delimiter,
+								bool strip_carriage_return,
+								StreamRecord *out_record)
+{
+	if (!reader || !reader->stream || !out_record) {
+		return (AsyncResult){ .status = ASYNC_ERROR,
+							  .error = ERROR_RESULT_NULL_POINTER };
+	}
+
+	reader->record = out_record;
+	reader->delimiter = delimiter;
+	reader->strip_carriage_return = strip_carriage_return;
+
+	/* Records inside the current chunk complete without allocating. */
+	AsyncResult result = { .poll = poll_stream_record,
+						   .state = reader,
+						   .status = ASYNC_PENDING,
+						   .error = ERROR_RESULT_NO_ERROR };
+	result.status = record_step(reader, &result.error);
+	return result;
+}
+
+AsyncResult fun_stream_next_record(StreamRecordReader *reader, char delimiter,
+								   StreamRecord *out_record)
+{
+	return start_record(reader, delimiter, false, out_record);
+}
+
+AsyncResult fun_stream_next_line(StreamRecordReader *reader,
+								 StreamRecord *out_record)
+{
+	return start_record(reader, '\n', true, out_record);
+}
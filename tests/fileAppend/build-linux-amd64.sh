@@ -10,6 +10,14 @@ gcc \
     ../../arch/file/linux-amd64/fileRead.c \
     ../../arch/file/linux-amd64/fileReadMmap.c \
     ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
     -o test
 
 strip --strip-unneeded test
\ No newline at end of file
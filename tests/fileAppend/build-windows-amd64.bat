@@ -9,6 +9,9 @@ gcc ^
     ../../arch/file/windows-amd64/fileRead.c ^
     ../../arch/file/windows-amd64/fileReadMmap.c ^
     ../../arch/file/windows-amd64/fileReadRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../arch/memory/windows-amd64/memory.c ^
     ../../src/async/async.c ^
     ../../arch/async/windows-amd64/async.c ^
@@ -0,0 +1,126 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define APPENDER_TEST_FILE "test_file_appender.txt"
+#define APPENDS 64
+
+static bool truncate_test_file(void)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			APPENDER_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	return fun_error_is_ok(fun_file_close(&handle));
+}
+
+/* A burst of durable appends commits together and lands in order. */
+bool test_fun_file_appender_group_commit(void)
+{
+	if (!truncate_test_file())
+		return false;
+
+	FileAppender appender = { 0 };
+	if (fun_error_is_error(fun_file_appender_open(
+			APPENDER_TEST_FILE, FILE_DURABILITY_SYNC, &appender)))
+		return false;
+
+	static char records[APPENDS][4];
+	AsyncResult appends[APPENDS];
+	AsyncResult *pending[APPENDS];
+	for (int i = 0; i < APPENDS; i++) {
+		records[i][0] = (char)('0' + i / 10);
+		records[i][1] = (char)('0' + i % 10);
+		records[i][2] = ',';
+		appends[i] = fun_file_appender_append(appender, records[i], 3);
+		pending[i] = &appends[i];
+	}
+
+	/* Queued appends keep the appender open. */
+	bool success = fun_file_appender_close(&appender).code ==
+				   ERROR_CODE_FILE_APPENDER_BUSY;
+
+	fun_async_await_all(pending, APPENDS, -1);
+	for (int i = 0; i < APPENDS; i++)
+		success = success && appends[i].status == ASYNC_COMPLETED;
+
+	AsyncResult empty = fun_file_appender_append(appender, records[0], 0);
+	success = success && empty.status == ASYNC_COMPLETED &&
+			  fun_error_is_ok(fun_file_appender_close(&appender)) &&
+			  !appender.state;
+
+	FileHandle handle = { 0 };
+	char contents[APPENDS * 3];
+	success = success &&
+			  fun_error_is_ok(
+				  fun_file_open(APPENDER_TEST_FILE, FILE_OPEN_READ, &handle)) &&
+			  fun_error_is_ok(
+				  fun_file_read_at(handle, contents, sizeof(contents), 0));
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) &&
+			  size.value == sizeof(contents);
+	fun_file_close(&handle);
+
+	for (int i = 0; i < APPENDS && success; i++)
+		success = fun_memory_compare(contents + i * 3, records[i], 3).value ==
+				  0;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_appender_group_commit passed");
+	return success;
+}
+
+/* Appends queued after a commit started form the next commit. */
+bool test_fun_file_appender_successive_commits(void)
+{
+	FileAppender appender = { 0 };
+	if (fun_error_is_error(fun_file_appender_open(
+			APPENDER_TEST_FILE, FILE_DURABILITY_FULL, &appender)))
+		return false;
+
+	bool success = true;
+	for (int i = 0; i < 8 && success; i++) {
+		AsyncResult first = fun_file_appender_append(appender, "ab", 2);
+		AsyncResult second = fun_file_appender_append(appender, "c\n", 2);
+		fun_async_await(&second, -1);
+		fun_async_await(&first, -1);
+		success = first.status == ASYNC_COMPLETED &&
+				  second.status == ASYNC_COMPLETED;
+	}
+
+	success = success && fun_error_is_ok(fun_file_appender_close(&appender));
+
+	FileHandle handle = { 0 };
+	char tail[4];
+	success = success &&
+			  fun_error_is_ok(
+				  fun_file_open(APPENDER_TEST_FILE, FILE_OPEN_READ, &handle)) &&
+			  fun_error_is_ok(fun_file_read_at(handle, tail, 4,
+											   APPENDS * 3 + 7 * 4)) &&
+			  fun_memory_compare(tail, "abc\n", 4).value == 0;
+	fun_file_close(&handle);
+
+	if (success)
+		fun_console_write_line(
+			"✓ fun_file_appender_successive_commits passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file appender module tests:");
+
+	if (!test_fun_file_appender_group_commit()) {
+		fun_console_write_line("Group commit test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_appender_successive_commits()) {
+		fun_console_write_line("Successive commits test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file appender tests passed!");
+	return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+gcc \
+    --std=c17 -Os \
+    -I ../../include \
+    test.c \
+    ../../arch/file/linux-amd64/fileCalibrate.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
+    ../../arch/file/linux-amd64/fileRead.c \
+    ../../arch/file/linux-amd64/fileReadMmap.c \
+    ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileWrite.c \
+    ../../arch/file/linux-amd64/fileWriteMmap.c \
+    ../../arch/file/linux-amd64/fileWriteRing.c \
+    ../../arch/file/linux-amd64/fileAppend.c \
+    ../../arch/file/linux-amd64/fileHandle.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/memory/linux-amd64/memory.c \
+    ../../src/async/async.c \
+    ../../arch/async/linux-amd64/async.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
+    -o test
+
+strip --strip-unneeded test
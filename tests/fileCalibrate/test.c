@@ -0,0 +1,123 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define CALIBRATE_TEST_FILE "test_file_calibrate.bin"
+#define AUTO_TEST_FILE "test_file_calibrate_auto.txt"
+
+static bool mode_is_valid(FileMode mode)
+{
+	return mode == FILE_MODE_MMAP || mode == FILE_MODE_RING_BASED;
+}
+
+/* Every cell gets a winner, and the winner is the faster mode measured. */
+bool test_fun_file_calibrate(void)
+{
+	FileCalibration calibration = { 0 };
+	if (fun_error_is_error(
+			fun_file_calibrate(CALIBRATE_TEST_FILE, &calibration)))
+		return false;
+
+	bool success = true;
+	for (int access = 0; access < FILE_ACCESS_COUNT; access++) {
+		for (int pattern = 0; pattern < FILE_PATTERN_COUNT; pattern++) {
+			for (int bucket = 0; bucket < FILE_SIZE_BUCKET_COUNT; bucket++) {
+				FileMode mode = calibration.mode[access][pattern][bucket];
+				uint64_t mmap_ns = calibration.mmap_ns[access][pattern][bucket];
+				uint64_t ring_ns = calibration.ring_ns[access][pattern][bucket];
+				success = success && mode_is_valid(mode) &&
+						  (mmap_ns || ring_ns);
+				if (mode == FILE_MODE_MMAP && ring_ns)
+					success = success && mmap_ns <= ring_ns;
+				if (mode == FILE_MODE_RING_BASED && mmap_ns)
+					success = success && ring_ns < mmap_ns;
+			}
+		}
+	}
+
+	/* Appends have no offset, so both pattern rows hold one measurement. */
+	uint64_t(*append_ns)[FILE_SIZE_BUCKET_COUNT] =
+		calibration.mmap_ns[FILE_ACCESS_APPEND];
+	for (int bucket = 0; bucket < FILE_SIZE_BUCKET_COUNT; bucket++)
+		success = success && append_ns[FILE_PATTERN_RANDOM][bucket] ==
+								 append_ns[FILE_PATTERN_SEQUENTIAL][bucket];
+
+	/* The scratch file is left empty. */
+	FileHandle handle = { 0 };
+	success = success && fun_error_is_ok(fun_file_open(
+							 CALIBRATE_TEST_FILE, FILE_OPEN_READ, &handle));
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) && size.value == 0;
+	fun_file_close(&handle);
+
+	if (success)
+		fun_console_write_line("✓ fun_file_calibrate passed");
+	return success;
+}
+
+/* FILE_MODE_AUTO keeps working whatever the table says. */
+bool test_fun_file_set_calibration(void)
+{
+	FileCalibration calibration = { 0 };
+	for (int access = 0; access < FILE_ACCESS_COUNT; access++)
+		for (int pattern = 0; pattern < FILE_PATTERN_COUNT; pattern++)
+			for (int bucket = 0; bucket < FILE_SIZE_BUCKET_COUNT; bucket++)
+				calibration.mode[access][pattern][bucket] =
+					FILE_MODE_RING_BASED;
+	calibration.mode[FILE_ACCESS_READ][FILE_PATTERN_RANDOM][0] =
+		FILE_MODE_DIRECT;
+
+	ErrorResult invalid = fun_file_set_calibration(&calibration);
+	bool success = invalid.code == ERROR_CODE_FILE_INVALID_CALIBRATION;
+
+	calibration.mode[FILE_ACCESS_READ][FILE_PATTERN_RANDOM][0] =
+		FILE_MODE_MMAP;
+	success = success &&
+			  fun_error_is_ok(fun_file_set_calibration(&calibration));
+
+	AsyncResult write = fun_write_memory_to_file(
+		(Write){ .file_path = AUTO_TEST_FILE,
+				 .input = "calibrated",
+				 .bytes_to_write = 10 });
+	fun_async_await(&write, -1);
+
+	MemoryResult buffer = fun_memory_allocate(10);
+	success = success && write.status == ASYNC_COMPLETED &&
+			  fun_error_is_ok(buffer.error);
+	if (success) {
+		AsyncResult read = fun_read_file_in_memory(
+			(Read){ .file_path = AUTO_TEST_FILE,
+					.output = buffer.value,
+					.bytes_to_read = 10 });
+		fun_async_await(&read, -1);
+		success = read.status == ASYNC_COMPLETED &&
+				  fun_memory_compare(buffer.value, "calibrated", 10).value ==
+					  0;
+		fun_memory_free(&buffer.value);
+	}
+
+	success = success && fun_error_is_ok(fun_file_set_calibration(NULL));
+
+	if (success)
+		fun_console_write_line("✓ fun_file_set_calibration passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file calibration module tests:");
+
+	if (!test_fun_file_calibrate()) {
+		fun_console_write_line("Calibration test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_set_calibration()) {
+		fun_console_write_line("Calibration table test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file calibration tests passed!");
+	return 0;
+}
@@ -0,0 +1,170 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define SOURCE_TEST_FILE "test_file_copy_source.bin"
+#define DESTINATION_TEST_FILE "test_file_copy_destination.bin"
+#define COPY_TEST_BYTES (3 * 1024 * 1024 + 17)
+
+static bool write_test_file(String path, Memory content, uint64_t length,
+							uint64_t offset)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			path, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	bool success =
+		fun_error_is_ok(fun_file_write_at(handle, content, length, offset));
+	return fun_error_is_ok(fun_file_close(&handle)) && success;
+}
+
+static bool file_matches(String path, Memory expected, uint64_t length,
+						 uint64_t offset, Memory scratch)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(path, FILE_OPEN_READ, &handle)))
+		return false;
+	bool success =
+		fun_error_is_ok(fun_file_read_at(handle, scratch, length, offset)) &&
+		fun_memory_compare(scratch, expected, length).value == 0;
+	fun_file_close(&handle);
+	return success;
+}
+
+bool test_fun_file_copy(void)
+{
+	MemoryResult content = fun_memory_allocate(COPY_TEST_BYTES);
+	MemoryResult scratch = fun_memory_allocate(COPY_TEST_BYTES);
+	if (fun_error_is_error(content.error) || fun_error_is_error(scratch.error))
+		return false;
+	for (uint64_t i = 0; i < COPY_TEST_BYTES; i++)
+		((char *)content.value)[i] = (char)(i * 31 + 7);
+
+	/* A longer destination is replaced, not overwritten in place. */
+	bool success = write_test_file(SOURCE_TEST_FILE, content.value,
+								   COPY_TEST_BYTES, 0) &&
+				   write_test_file(DESTINATION_TEST_FILE, content.value,
+								   COPY_TEST_BYTES, 1000);
+
+	uint64_t bytes_copied = 0;
+	AsyncResult copy = fun_file_copy(
+		(FileCopy){ .source_path = SOURCE_TEST_FILE,
+					.destination_path = DESTINATION_TEST_FILE,
+					.durability_mode = FILE_DURABILITY_SYNC,
+					.bytes_copied = &bytes_copied });
+	fun_async_await(&copy, -1);
+	success = success && copy.status == ASYNC_COMPLETED &&
+			  bytes_copied == COPY_TEST_BYTES &&
+			  file_matches(DESTINATION_TEST_FILE, content.value,
+						   COPY_TEST_BYTES, 0, scratch.value);
+
+	FileHandle handle = { 0 };
+	success = success && fun_error_is_ok(fun_file_open(
+							 DESTINATION_TEST_FILE, FILE_OPEN_READ, &handle));
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && size.value == COPY_TEST_BYTES;
+	fun_file_close(&handle);
+
+	/* Copying a file onto itself must not truncate it first. */
+	AsyncResult self = fun_file_copy(
+		(FileCopy){ .source_path = SOURCE_TEST_FILE,
+					.destination_path = SOURCE_TEST_FILE });
+	fun_async_await(&self, -1);
+	success = success && self.status == ASYNC_ERROR &&
+			  self.error.code == ERROR_CODE_FILE_COPY_SAME_FILE &&
+			  file_matches(SOURCE_TEST_FILE, content.value, COPY_TEST_BYTES, 0,
+						   scratch.value);
+
+	fun_memory_free(&content.value);
+	fun_memory_free(&scratch.value);
+	if (success)
+		fun_console_write_line("✓ fun_file_copy passed");
+	return success;
+}
+
+bool test_fun_file_copy_range(void)
+{
+	char expected[12] = { 0 };
+	for (int i = 0; i < 12; i++)
+		expected[i] = (char)((100 + i) * 31 + 7);
+	char scratch[12];
+
+	/* The rest of the destination is kept around the copied range. */
+	uint64_t bytes_copied = 0;
+	AsyncResult range = fun_file_copy_range(
+		(FileCopy){ .source_path = SOURCE_TEST_FILE,
+					.destination_path = DESTINATION_TEST_FILE,
+					.source_offset = 100,
+					.destination_offset = 5,
+					.bytes = 12,
+					.bytes_copied = &bytes_copied });
+	fun_async_await(&range, -1);
+
+	char head[5];
+	for (int i = 0; i < 5; i++)
+		head[i] = (char)(i * 31 + 7);
+	bool success = range.status == ASYNC_COMPLETED && bytes_copied == 12 &&
+				   file_matches(DESTINATION_TEST_FILE, expected, 12, 5,
+								scratch) &&
+				   file_matches(DESTINATION_TEST_FILE, head, 5, 0, scratch);
+
+	/* A range running past the source is an error. */
+	AsyncResult past_end = fun_file_copy_range(
+		(FileCopy){ .source_path = SOURCE_TEST_FILE,
+					.destination_path = DESTINATION_TEST_FILE,
+					.source_offset = COPY_TEST_BYTES - 4,
+					.bytes = 8 });
+	fun_async_await(&past_end, -1);
+	success = success && past_end.status == ASYNC_ERROR &&
+			  past_end.error.code == ERROR_CODE_FILE_UNEXPECTED_EOF;
+
+	/* Within one file: overlapping ranges are refused untouched, others
+	 * copy. */
+	AsyncResult overlap = fun_file_copy_range(
+		(FileCopy){ .source_path = DESTINATION_TEST_FILE,
+					.destination_path = DESTINATION_TEST_FILE,
+					.source_offset = 5,
+					.destination_offset = 9,
+					.bytes = 12 });
+	fun_async_await(&overlap, -1);
+	success = success && overlap.status == ASYNC_ERROR &&
+			  overlap.error.code == ERROR_CODE_FILE_COPY_OVERLAP &&
+			  file_matches(DESTINATION_TEST_FILE, expected, 12, 5, scratch);
+	AsyncResult within = fun_file_copy_range(
+		(FileCopy){ .source_path = DESTINATION_TEST_FILE,
+					.destination_path = DESTINATION_TEST_FILE,
+					.source_offset = 5,
+					.destination_offset = 40,
+					.bytes = 12 });
+	fun_async_await(&within, -1);
+	success = success && within.status == ASYNC_COMPLETED &&
+			  file_matches(DESTINATION_TEST_FILE, expected, 12, 40, scratch);
+
+	AsyncResult missing = fun_file_copy_range(
+		(FileCopy){ .destination_path = DESTINATION_TEST_FILE, .bytes = 1 });
+	success = success && missing.status == ASYNC_ERROR &&
+			  missing.error.code == ERROR_CODE_NULL_POINTER;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_copy_range passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file copy module tests:");
+
+	if (!test_fun_file_copy()) {
+		fun_console_write_line("Whole file copy test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_copy_range()) {
+		fun_console_write_line("Range copy test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file copy tests passed!");
+	return 0;
+}
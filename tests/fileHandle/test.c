@@ -0,0 +1,255 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define HANDLE_TEST_FILE "test_file_handle.txt"
+#define APPEND_TEST_FILE "test_file_handle_append.txt"
+#define CACHE_TEST_FILE "test_file_handle_cache.txt"
+#define PREALLOCATE_TEST_FILE "test_file_handle_preallocate.txt"
+
+bool test_fun_file_handle_write_read_at(void)
+{
+	FileHandle handle = { 0 };
+	ErrorResult open_result = fun_file_open(
+		HANDLE_TEST_FILE, FILE_OPEN_READ | FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE,
+		&handle);
+	if (fun_error_is_error(open_result))
+		return false;
+
+	bool success =
+		fun_error_is_ok(fun_file_write_at(handle, "world", 5, 6)) &&
+		fun_error_is_ok(fun_file_write_at(handle, "hello ", 6, 0));
+
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) && size.value == 11;
+
+	char buffer[16] = { 0 };
+	success = success &&
+			  fun_error_is_ok(fun_file_read_at(handle, buffer, 11, 0)) &&
+			  fun_memory_compare(buffer, "hello world", 11).value == 0;
+
+	/* Reading past the end is an error, not a short read. */
+	ErrorResult eof = fun_file_read_at(handle, buffer, 4, 9);
+	success = success && eof.code == ERROR_CODE_FILE_UNEXPECTED_EOF;
+
+	success = success && fun_error_is_ok(fun_file_sync(handle)) &&
+			  fun_error_is_ok(fun_file_close(&handle)) && !handle.state;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_handle_write_read_at passed");
+	return success;
+}
+
+bool test_fun_file_handle_append(void)
+{
+	FileHandle handle = { 0 };
+	ErrorResult open_result = fun_file_open(
+		APPEND_TEST_FILE,
+		FILE_OPEN_READ | FILE_OPEN_APPEND | FILE_OPEN_TRUNCATE, &handle);
+	if (fun_error_is_error(open_result))
+		return false;
+
+	bool success = true;
+	for (int i = 0; i < 100 && success; i++)
+		success = fun_error_is_ok(fun_file_append(handle, "line\n", 5));
+
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) && size.value == 500;
+
+	char buffer[5];
+	success = success &&
+			  fun_error_is_ok(fun_file_read_at(handle, buffer, 5, 495)) &&
+			  fun_memory_compare(buffer, "line\n", 5).value == 0;
+
+	/* Positional writes are rejected on an append handle. */
+	ErrorResult write_result = fun_file_write_at(handle, "x", 1, 0);
+	success = success && write_result.code == ERROR_CODE_FILE_HANDLE_MODE;
+
+	fun_file_close(&handle);
+
+	ErrorResult null_close = fun_file_close(&handle);
+	success = success && null_close.code == ERROR_CODE_NULL_POINTER;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_handle_append passed");
+	return success;
+}
+
+bool test_fun_file_handle_invalid_flags(void)
+{
+	FileHandle handle = { 0 };
+	bool success =
+		fun_file_open(HANDLE_TEST_FILE, 0, &handle).code ==
+			ERROR_CODE_FILE_HANDLE_MODE &&
+		fun_file_open(HANDLE_TEST_FILE, FILE_OPEN_READ | FILE_OPEN_TRUNCATE,
+					  &handle)
+				.code == ERROR_CODE_FILE_HANDLE_MODE &&
+		!handle.state;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_handle_invalid_flags passed");
+	return success;
+}
+
+/* Path-based appends and reads through the descriptor cache. */
+bool test_fun_file_cache(void)
+{
+	if (fun_file_cache_set_capacity(FILE_CACHE_MAX_CAPACITY + 1).code !=
+		ERROR_CODE_FILE_CACHE_INVALID_CAPACITY)
+		return false;
+#ifdef _WIN32
+	/* No descriptor cache on Windows: only disabling it is accepted. */
+	bool unsupported = fun_file_cache_set_capacity(4).code ==
+						   ERROR_CODE_FILE_CACHE_UNSUPPORTED &&
+					   fun_error_is_ok(fun_file_cache_set_capacity(0));
+	if (unsupported)
+		fun_console_write_line("✓ fun_file_cache passed");
+	return unsupported;
+#endif
+	if (fun_error_is_error(fun_file_cache_set_capacity(4)))
+		return false;
+
+	FileHandle truncate = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			CACHE_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &truncate)))
+		return false;
+	fun_file_close(&truncate);
+
+	MemoryResult line = fun_memory_allocate(8);
+	MemoryResult contents = fun_memory_allocate(8 * 50);
+	if (fun_error_is_error(line.error) || fun_error_is_error(contents.error))
+		return false;
+	fun_memory_copy("record\n", line.value, 8);
+
+	bool success = true;
+	for (int i = 0; i < 50 && success; i++) {
+		Append params = { .file_path = CACHE_TEST_FILE,
+						  .input = line.value,
+						  .bytes_to_append = 7,
+						  .mode = i % 2 ? FILE_MODE_RING_BASED :
+										  FILE_MODE_MMAP };
+		AsyncResult append = fun_append_memory_to_file(params);
+		fun_async_await(&append, -1);
+		success = append.status == ASYNC_COMPLETED;
+	}
+
+	for (int i = 0; i < 50 && success; i++) {
+		Read params = { .file_path = CACHE_TEST_FILE,
+						.output = contents.value,
+						.bytes_to_read = 7,
+						.offset = (uint64_t)i * 7,
+						.mode = i % 2 ? FILE_MODE_RING_BASED :
+										FILE_MODE_MMAP };
+		AsyncResult read = fun_read_file_in_memory(params);
+		fun_async_await(&read, -1);
+		success = read.status == ASYNC_COMPLETED &&
+				  fun_memory_compare(contents.value, "record\n", 7).value ==
+					  0;
+	}
+
+	/* Nothing is in use, so the cache can be dropped. */
+	success = success && fun_error_is_ok(fun_file_cache_set_capacity(0));
+
+	fun_memory_free(&line.value);
+	fun_memory_free(&contents.value);
+
+	if (success)
+		fun_console_write_line("✓ fun_file_cache passed");
+	return success;
+}
+
+/* A one-page chunk makes 3000 bytes of appends slide the window often. */
+bool test_fun_file_handle_preallocate(void)
+{
+	bool success =
+		fun_file_set_preallocation_chunk(0).code ==
+			ERROR_CODE_FILE_INVALID_PREALLOCATION &&
+		fun_file_set_preallocation_chunk(FILE_PREALLOCATION_MAX_CHUNK + 1)
+				.code == ERROR_CODE_FILE_INVALID_PREALLOCATION &&
+		fun_error_is_ok(fun_file_set_preallocation_chunk(1));
+
+	FileHandle handle = { 0 };
+	ErrorResult mode = fun_file_open(
+		PREALLOCATE_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_PREALLOCATE,
+		&handle);
+	success = success && mode.code == ERROR_CODE_FILE_HANDLE_MODE;
+
+	success = success &&
+			  fun_error_is_ok(fun_file_open(
+				  PREALLOCATE_TEST_FILE,
+				  FILE_OPEN_READ | FILE_OPEN_APPEND | FILE_OPEN_TRUNCATE |
+					  FILE_OPEN_PREALLOCATE,
+				  &handle));
+	for (int i = 0; i < 1000 && success; i++)
+		success = fun_error_is_ok(fun_file_append(handle, "ab\n", 3));
+
+	/* The size is what was appended, not what was allocated. */
+	uint64_tResult size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) && size.value == 3000;
+
+	char buffer[3];
+	ErrorResult eof = fun_file_read_at(handle, buffer, 3, 2999);
+	success = success && eof.code == ERROR_CODE_FILE_UNEXPECTED_EOF &&
+			  fun_error_is_ok(fun_file_read_at(handle, buffer, 3, 2997)) &&
+			  fun_memory_compare(buffer, "ab\n", 3).value == 0 &&
+			  fun_error_is_ok(fun_file_sync(handle));
+	fun_file_close(&handle);
+
+	/* Closing trims the file; reopening carries on after the data. */
+	success = success &&
+			  fun_error_is_ok(fun_file_open(
+				  PREALLOCATE_TEST_FILE,
+				  FILE_OPEN_READ | FILE_OPEN_APPEND | FILE_OPEN_PREALLOCATE,
+				  &handle)) &&
+			  fun_error_is_ok(fun_file_append(handle, "end", 3));
+	fun_file_close(&handle);
+
+	success = success && fun_error_is_ok(fun_file_open(
+							 PREALLOCATE_TEST_FILE, FILE_OPEN_READ, &handle));
+	size = fun_file_handle_size(handle);
+	success = success && fun_error_is_ok(size.error) && size.value == 3003 &&
+			  fun_error_is_ok(fun_file_read_at(handle, buffer, 3, 2997)) &&
+			  fun_memory_compare(buffer, "ab\n", 3).value == 0 &&
+			  fun_error_is_ok(fun_file_read_at(handle, buffer, 3, 3000)) &&
+			  fun_memory_compare(buffer, "end", 3).value == 0;
+	fun_file_close(&handle);
+
+	fun_file_set_preallocation_chunk(FILE_PREALLOCATION_DEFAULT_CHUNK);
+	if (success)
+		fun_console_write_line("✓ fun_file_handle_preallocate passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file handle module tests:");
+
+	if (!test_fun_file_handle_write_read_at()) {
+		fun_console_write_line("Write/read at offset test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_handle_append()) {
+		fun_console_write_line("Handle append test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_handle_invalid_flags()) {
+		fun_console_write_line("Invalid flags test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_cache()) {
+		fun_console_write_line("Descriptor cache test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_handle_preallocate()) {
+		fun_console_write_line("Preallocation test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file handle tests passed!");
+	return 0;
+}
@@ -5,7 +5,7 @@ set INCLUDES=-I../../include
 set SOURCES=test.c
 set ARCH_FILES=../../arch/file/windows-amd64/fileLock.c 
 set DEPENDENCIES=../../arch/memory/windows-amd64/memory.c ../../src/async/async.c ../../arch/async/windows-amd64/async.c
-set OTHER_DEPS=../../arch/file/windows-amd64/fileRead.c ../../arch/file/windows-amd64/fileReadMmap.c ../../arch/file/windows-amd64/fileReadRing.c
+set OTHER_DEPS=../../arch/file/windows-amd64/fileRead.c ../../arch/file/windows-amd64/fileReadMmap.c ../../arch/file/windows-amd64/fileReadRing.c ../../arch/file/windows-amd64/fileRing.c ../../arch/file/windows-amd64/fileDirect.c ../../arch/file/windows-amd64/fileAdaptive.c
 set STRING_DEPS=../../src/string/stringOperations.c ../../src/string/stringConversion.c ../../src/string/stringTemplate.c
 set CONSOLE_DEPS=../../src/console/console.c ../../arch/console/windows-amd64/console.c
 set OUTPUT=test.exe
@@ -0,0 +1,18 @@
+#!/bin/sh
+gcc \
+    --std=c17 -Os \
+    -I ../../include \
+    test.c \
+    ../../arch/file/linux-amd64/fileRangeLock.c \
+    ../../arch/file/linux-amd64/fileHandle.c \
+    ../../arch/thread_pool/linux-amd64/thread_pool.c \
+    ../../arch/memory/linux-amd64/memory.c \
+    ../../src/async/async.c \
+    ../../arch/async/linux-amd64/async.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
+    -o test
+
+strip --strip-unneeded test
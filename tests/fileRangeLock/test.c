@@ -0,0 +1,128 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define RANGE_LOCK_TEST_FILE "test_file_range_lock.bin"
+
+static bool create_test_file(void)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(RANGE_LOCK_TEST_FILE,
+										 FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE,
+										 &handle)))
+		return false;
+	bool success = fun_error_is_ok(fun_file_write_at(handle, "0123456789", 10,
+													 0));
+	return fun_error_is_ok(fun_file_close(&handle)) && success;
+}
+
+static AsyncResult lock_range(uint64_t offset, uint64_t length,
+							  FileLockMode mode, uint32_t timeout_ms,
+							  FileLockHandle *out_lock)
+{
+	AsyncResult lock = fun_file_lock_range(
+		(FileRangeLock){ .file_path = RANGE_LOCK_TEST_FILE,
+						 .offset = offset,
+						 .length = length,
+						 .mode = mode,
+						 .timeout_ms = timeout_ms,
+						 .out_lock = out_lock });
+	fun_async_await(&lock, -1);
+	return lock;
+}
+
+bool test_fun_file_lock_range(void)
+{
+	FileLockHandle first = { 0 };
+	FileLockHandle second = { 0 };
+	FileLockHandle third = { 0 };
+
+	/* Readers share a range. */
+	bool success =
+		lock_range(0, 10, FILE_LOCK_SHARED, 0, &first).status ==
+			ASYNC_COMPLETED &&
+		lock_range(0, 10, FILE_LOCK_SHARED, 0, &second).status ==
+			ASYNC_COMPLETED;
+
+	/* A writer conflicts with them, even inside the same process. */
+	AsyncResult writer = lock_range(5, 1, FILE_LOCK_EXCLUSIVE, 0, &third);
+	success = success && writer.status == ASYNC_ERROR &&
+			  writer.error.code == ERROR_CODE_LOCK_TIMEOUT && !third.state;
+
+	success = success && fun_error_is_ok(fun_file_unlock_range(&first)) &&
+			  fun_error_is_ok(fun_file_unlock_range(&second)) && !first.state;
+
+	/* Disjoint exclusive ranges do not. */
+	success = success &&
+			  lock_range(0, 5, FILE_LOCK_EXCLUSIVE, 0, &first).status ==
+				  ASYNC_COMPLETED &&
+			  lock_range(5, 0, FILE_LOCK_EXCLUSIVE, 0, &second).status ==
+				  ASYNC_COMPLETED;
+	success = success && fun_error_is_ok(fun_file_unlock_range(&first)) &&
+			  fun_error_is_ok(fun_file_unlock_range(&second));
+
+	if (success)
+		fun_console_write_line("✓ fun_file_lock_range passed");
+	return success;
+}
+
+bool test_fun_file_lock_range_wait(void)
+{
+	FileLockHandle holder = { 0 };
+	FileLockHandle waiter = { 0 };
+	bool success = lock_range(0, 0, FILE_LOCK_EXCLUSIVE, 0, &holder).status ==
+				   ASYNC_COMPLETED;
+
+	/* A waiter gives up once its timeout passes. */
+	AsyncResult expired = lock_range(0, 10, FILE_LOCK_SHARED, 20, &waiter);
+	success = success && expired.status == ASYNC_ERROR &&
+			  expired.error.code == ERROR_CODE_LOCK_TIMEOUT;
+
+	/* A pending waiter gets the range as soon as the holder lets go. */
+	AsyncResult pending = fun_file_lock_range(
+		(FileRangeLock){ .file_path = RANGE_LOCK_TEST_FILE,
+						 .mode = FILE_LOCK_EXCLUSIVE,
+						 .timeout_ms = FILE_LOCK_WAIT_FOREVER,
+						 .out_lock = &waiter });
+	for (int i = 0; i < 3; i++)
+		pending.status = pending.poll(&pending);
+	success = success && pending.status == ASYNC_PENDING;
+
+	success = success && fun_error_is_ok(fun_file_unlock_range(&holder));
+	fun_async_await(&pending, -1);
+	success = success && pending.status == ASYNC_COMPLETED && waiter.state &&
+			  fun_error_is_ok(fun_file_unlock_range(&waiter));
+
+	AsyncResult missing = fun_file_lock_range(
+		(FileRangeLock){ .file_path = RANGE_LOCK_TEST_FILE });
+	success = success && missing.status == ASYNC_ERROR &&
+			  missing.error.code == ERROR_CODE_NULL_POINTER;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_lock_range waiting passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file range lock module tests:");
+
+	if (!create_test_file()) {
+		fun_console_write_line("Could not create range lock test file");
+		return 1;
+	}
+
+	if (!test_fun_file_lock_range()) {
+		fun_console_write_line("Range lock test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_lock_range_wait()) {
+		fun_console_write_line("Range lock waiting test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file range lock tests passed!");
+	return 0;
+}
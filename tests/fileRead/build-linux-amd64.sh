@@ -6,12 +6,18 @@ gcc \
     ../../arch/file/linux-amd64/fileReadMmap.c \
     ../../arch/file/linux-amd64/fileRead.c \
     ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
+    ../../arch/file/linux-amd64/fileReadBatch.c \
     ../../arch/memory/linux-amd64/memory.c \
     ../../src/string/stringOperations.c \
     ../../src/string/stringConversion.c \
     ../../src/string/stringTemplate.c \
     ../../src/async/async.c \
     ../../arch/async/linux-amd64/async.c \
+    -pthread \
     -o test
 
 strip --strip-unneeded test
\ No newline at end of file
@@ -7,6 +7,10 @@ gcc ^
     test.c ^
     ../../arch/file/windows-amd64/fileReadMmap.c ^
     ../../arch/file/windows-amd64/fileReadRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
+    ../../arch/file/windows-amd64/fileReadBatch.c ^
     ../../arch/file/windows-amd64/fileRead.c ^
     ../../arch/memory/windows-amd64/memory.c ^
     ../../src/string/stringOperations.c ^
@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200112L
 #include <assert.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -6,6 +7,8 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <string.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "fundamental/file/file.h"
 #include "fundamental/memory/memory.h"
@@ -211,6 +214,425 @@ static bool test_fun_read_file_buffer_too_small(void)
 	return success;
 }
 
+/* Several ring reads in flight at once on the shared ring; each must get
+ * its own completion back. */
+static bool test_fun_read_file_ring_concurrent(void)
+{
+	char content[4096];
+	for (size_t i = 0; i < sizeof(content); i++)
+		content[i] = (char)('a' + i % 26);
+
+	if (!create_test_file(TEST_FILENAME, content, sizeof(content)))
+		return false;
+
+	enum { READS = 8, CHUNK = 512 };
+	MemoryResult bufs[READS];
+	AsyncResult results[READS];
+	AsyncResult *pending[READS];
+
+	for (int i = 0; i < READS; i++) {
+		bufs[i] = fun_memory_allocate(CHUNK);
+		if (fun_error_is_error(bufs[i].error)) {
+			unlink(TEST_FILENAME);
+			return false;
+		}
+		Read params = { .file_path = TEST_FILENAME,
+						.output = bufs[i].value,
+						.bytes_to_read = CHUNK,
+						/* reversed order so completions interleave */
+						.offset = (uint64_t)(READS - 1 - i) * CHUNK,
+						.mode = FILE_MODE_RING_BASED };
+		results[i] = fun_read_file_in_memory(params);
+		pending[i] = &results[i];
+	}
+	fun_async_await_all(pending, READS, -1);
+
+	bool success = true;
+	for (int i = 0; i < READS; i++) {
+		if (results[i].status != ASYNC_COMPLETED ||
+			memcmp(bufs[i].value, content + (READS - 1 - i) * CHUNK,
+				   CHUNK) != 0)
+			success = false;
+		fun_memory_free(&bufs[i].value);
+	}
+	unlink(TEST_FILENAME);
+
+	if (success)
+		printf("%s test_fun_read_file_ring_concurrent\n", GREEN_CHECK);
+	return success;
+}
+
+/* Several threads reaping on the shared ring at once.  Each reads its own
+ * FIFO, so its reads complete only as a writer thread feeds it and the
+ * readers really wait; a reader whose completion another thread drained
+ * must still see it, not sleep on. */
+enum { RING_THREADS = 4, RING_THREAD_READS = 250, RING_THREAD_CHUNK = 64 };
+
+static int ring_thread_fifos[RING_THREADS];
+
+static void ring_thread_path(uintptr_t id, char *path)
+{
+	memcpy(path, "test_ring_fifo_0.tmp", sizeof("test_ring_fifo_0.tmp"));
+	path[15] = (char)('0' + id);
+}
+
+static void ring_thread_chunk(uintptr_t id, int round, char *chunk)
+{
+	for (int i = 0; i < RING_THREAD_CHUNK; i++)
+		chunk[i] = (char)('A' + (id * 7 + (uintptr_t)round + i) % 26);
+}
+
+static void *ring_thread_writer(void *arg)
+{
+	(void)arg;
+	char chunk[RING_THREAD_CHUNK];
+	struct timespec pause = { .tv_nsec = 20000 };
+	for (int round = 0; round < RING_THREAD_READS; round++) {
+		for (uintptr_t id = 0; id < RING_THREADS; id++) {
+			ring_thread_chunk(id, round, chunk);
+			if (write(ring_thread_fifos[id], chunk, sizeof(chunk)) !=
+				(ssize_t)sizeof(chunk))
+				return (void *)1;
+			nanosleep(&pause, NULL);
+		}
+	}
+	return NULL;
+}
+
+static void *ring_thread_reads(void *arg)
+{
+	uintptr_t id = (uintptr_t)arg;
+	char path[sizeof("test_ring_fifo_0.tmp")];
+	char expected[RING_THREAD_CHUNK];
+	ring_thread_path(id, path);
+	MemoryResult buffer = fun_memory_allocate(RING_THREAD_CHUNK);
+	if (fun_error_is_error(buffer.error))
+		return (void *)1;
+	uintptr_t failures = 0;
+
+	for (int round = 0; round < RING_THREAD_READS && !failures; round++) {
+		Read params = { .file_path = path,
+						.output = buffer.value,
+						.bytes_to_read = RING_THREAD_CHUNK,
+						.mode = FILE_MODE_RING_BASED };
+		AsyncResult result = fun_read_file_in_memory(params);
+		fun_async_await(&result, -1);
+		ring_thread_chunk(id, round, expected);
+		if (result.status != ASYNC_COMPLETED ||
+			memcmp(buffer.value, expected, RING_THREAD_CHUNK) != 0)
+			failures++;
+	}
+	fun_memory_free(&buffer.value);
+	return (void *)failures;
+}
+
+static bool test_fun_read_file_ring_threads(void)
+{
+	char path[sizeof("test_ring_fifo_0.tmp")];
+	int opened = 0;
+	/* Opened read-write so neither side blocks in open. */
+	for (; opened < RING_THREADS; opened++) {
+		ring_thread_path((uintptr_t)opened, path);
+		unlink(path);
+		if (mkfifo(path, 0644) != 0)
+			break;
+		ring_thread_fifos[opened] = open(path, O_RDWR);
+		if (ring_thread_fifos[opened] < 0) {
+			unlink(path);
+			break;
+		}
+	}
+
+	/* Every round fits in the pipe buffer, so the writer never blocks on a
+	 * reader that gave up. */
+	pthread_t writer;
+	pthread_t readers[RING_THREADS];
+	int started = 0;
+	bool success = opened == RING_THREADS &&
+				   pthread_create(&writer, NULL, ring_thread_writer, NULL) == 0;
+	for (; success && started < RING_THREADS; started++) {
+		if (pthread_create(&readers[started], NULL, ring_thread_reads,
+						   (void *)(uintptr_t)started) != 0)
+			break;
+	}
+	bool writer_started = success;
+	success = success && started == RING_THREADS;
+
+	for (int i = 0; i < started; i++) {
+		void *failures = NULL;
+		pthread_join(readers[i], &failures);
+		if (failures != NULL)
+			success = false;
+	}
+	if (writer_started) {
+		void *failed = NULL;
+		pthread_join(writer, &failed);
+		success = success && failed == NULL;
+	}
+	for (int i = 0; i < opened; i++) {
+		close(ring_thread_fifos[i]);
+		ring_thread_path((uintptr_t)i, path);
+		unlink(path);
+	}
+
+	if (success)
+		printf("%s test_fun_read_file_ring_threads\n", GREEN_CHECK);
+	return success;
+}
+
+static bool test_fun_file_ring_set_depth(void)
+{
+	if (fun_file_ring_set_depth(0).code != ERROR_CODE_FILE_RING_INVALID_DEPTH)
+		return false;
+	if (fun_file_ring_set_depth(FILE_RING_MAX_DEPTH + 1).code !=
+		ERROR_CODE_FILE_RING_INVALID_DEPTH)
+		return false;
+	/* The ring is idle here, so it is rebuilt at the new depth. */
+	if (fun_error_is_error(fun_file_ring_set_depth(8)))
+		return false;
+
+	const char *content = "ring depth";
+	size_t len = strlen(content);
+	if (!create_test_file(TEST_FILENAME, content, len))
+		return false;
+
+	MemoryResult buf = fun_memory_allocate(len);
+	if (fun_error_is_error(buf.error)) {
+		unlink(TEST_FILENAME);
+		return false;
+	}
+	Read params = { .file_path = TEST_FILENAME,
+					.output = buf.value,
+					.bytes_to_read = len,
+					.mode = FILE_MODE_RING_BASED };
+	AsyncResult result = fun_read_file_in_memory(params);
+	fun_async_await(&result, -1);
+
+	bool success = result.status == ASYNC_COMPLETED &&
+				   memcmp(buf.value, content, len) == 0;
+
+	fun_memory_free(&buf.value);
+	unlink(TEST_FILENAME);
+	fun_file_ring_set_depth(FILE_RING_DEFAULT_DEPTH);
+
+	if (success)
+		printf("%s test_fun_file_ring_set_depth\n", GREEN_CHECK);
+	return success;
+}
+
+/* 256 scattered slices of one file into one buffer: more reads than the
+ * default ring depth, so the batch is submitted over several polls. */
+static bool test_fun_read_files_batch_scatter(void)
+{
+	enum { SLICES = 256, SLICE = 64 };
+	static char content[SLICES * SLICE];
+	for (size_t i = 0; i < sizeof(content); i++)
+		content[i] = (char)(i * 7 + i / SLICE);
+
+	if (!create_test_file(TEST_FILENAME, content, sizeof(content)))
+		return false;
+
+	MemoryResult buf = fun_memory_allocate(sizeof(content));
+	if (fun_error_is_error(buf.error)) {
+		unlink(TEST_FILENAME);
+		return false;
+	}
+
+	/* Slice i of the buffer receives file slice (i * 37) % SLICES. */
+	static Read reads[SLICES];
+	static ErrorResult errors[SLICES];
+	for (size_t i = 0; i < SLICES; i++) {
+		reads[i] = (Read){ .file_path = TEST_FILENAME,
+						   .output = (char *)buf.value + i * SLICE,
+						   .bytes_to_read = SLICE,
+						   .offset = ((i * 37) % SLICES) * SLICE,
+						   .batch_error = &errors[i] };
+	}
+
+	AsyncResult result = fun_read_files_batch(reads, SLICES);
+	fun_async_await(&result, -1);
+
+	bool success = result.status == ASYNC_COMPLETED;
+	for (size_t i = 0; success && i < SLICES; i++) {
+		if (fun_error_is_error(errors[i]) ||
+			memcmp((char *)buf.value + i * SLICE,
+				   content + ((i * 37) % SLICES) * SLICE, SLICE) != 0)
+			success = false;
+	}
+
+	fun_memory_free(&buf.value);
+	unlink(TEST_FILENAME);
+
+	if (success)
+		printf("%s test_fun_read_files_batch_scatter\n", GREEN_CHECK);
+	return success;
+}
+
+/* A missing file and a read past EOF fail on their own; the rest of the
+ * batch still completes. */
+static bool test_fun_read_files_batch_partial_failure(void)
+{
+	const char *content = "0123456789";
+	if (!create_test_file(TEST_FILENAME, content, 10))
+		return false;
+
+	char out[3][8];
+	ErrorResult errors[3];
+	Read reads[3] = {
+		{ .file_path = "missing_batch_file.tmp",
+		  .output = out[0],
+		  .bytes_to_read = 4,
+		  .batch_error = &errors[0] },
+		{ .file_path = TEST_FILENAME,
+		  .output = out[1],
+		  .bytes_to_read = 4,
+		  .offset = 8,
+		  .batch_error = &errors[1] },
+		{ .file_path = TEST_FILENAME,
+		  .output = out[2],
+		  .bytes_to_read = 4,
+		  .offset = 2,
+		  .batch_error = &errors[2] },
+	};
+
+	AsyncResult result = fun_read_files_batch(reads, 3);
+	fun_async_await(&result, -1);
+
+	bool success = result.status == ASYNC_ERROR &&
+				   result.error.code == errors[0].code &&
+				   fun_error_is_error(errors[0]) &&
+				   fun_error_is_error(errors[1]) &&
+				   fun_error_is_ok(errors[2]) &&
+				   memcmp(out[2], "2345", 4) == 0;
+
+	unlink(TEST_FILENAME);
+
+	if (success)
+		printf("%s test_fun_read_files_batch_partial_failure\n",
+			   GREEN_CHECK);
+	return success;
+}
+
+/* Ring reads into a registered pool (whole buffers and slices) and
+ * through a cached, fixed-file descriptor return the same bytes. */
+static bool test_fun_file_ring_register_buffers(void)
+{
+	enum { POOL = 4, SLOT = 4096 };
+	static char content[POOL * SLOT];
+	for (size_t i = 0; i < sizeof(content); i++)
+		content[i] = (char)(i * 13 + 5);
+	if (!create_test_file(TEST_FILENAME, content, sizeof(content)))
+		return false;
+
+	Memory pool[POOL];
+	uint64_t sizes[POOL];
+	for (int i = 0; i < POOL; i++) {
+		MemoryResult buf = fun_memory_allocate(SLOT);
+		if (fun_error_is_error(buf.error))
+			return false;
+		pool[i] = buf.value;
+		sizes[i] = SLOT;
+	}
+
+	bool success =
+		fun_file_ring_register_buffers(pool, sizes, 0).code ==
+			ERROR_CODE_FILE_RING_INVALID_BUFFER &&
+		fun_error_is_ok(fun_file_ring_register_buffers(pool, sizes, POOL)) &&
+		fun_error_is_ok(fun_file_cache_set_capacity(8));
+
+	for (int i = 0; i < POOL && success; i++) {
+		Read params = { .file_path = TEST_FILENAME,
+						.output = pool[i],
+						.bytes_to_read = SLOT,
+						.offset = (uint64_t)(POOL - 1 - i) * SLOT,
+						.mode = FILE_MODE_RING_BASED };
+		AsyncResult result = fun_read_file_in_memory(params);
+		fun_async_await(&result, -1);
+		success = result.status == ASYNC_COMPLETED &&
+				  memcmp(pool[i], content + (POOL - 1 - i) * SLOT, SLOT) == 0;
+	}
+
+	/* Slices inside a registered buffer use it too. */
+	Read reads[4];
+	for (int i = 0; i < 4; i++)
+		reads[i] = (Read){ .file_path = TEST_FILENAME,
+						   .output = (char *)pool[0] + i * 1024,
+						   .bytes_to_read = 1024,
+						   .offset = (uint64_t)i * 1024 + 7 };
+	AsyncResult batch = fun_read_files_batch(reads, 4);
+	fun_async_await(&batch, -1);
+	success = success && batch.status == ASYNC_COMPLETED &&
+			  memcmp(pool[0], content + 7, SLOT) == 0;
+
+	success = success && fun_error_is_ok(fun_file_cache_set_capacity(0)) &&
+			  fun_error_is_ok(fun_file_ring_unregister_buffers());
+
+	for (int i = 0; i < POOL; i++)
+		fun_memory_free(&pool[i]);
+	unlink(TEST_FILENAME);
+
+	if (success)
+		printf("%s test_fun_file_ring_register_buffers\n", GREEN_CHECK);
+	return success;
+}
+
+static bool direct_read(Memory output, uint64_t len, uint64_t offset)
+{
+	Read params = { .file_path = TEST_FILENAME,
+					.output = output,
+					.bytes_to_read = len,
+					.offset = offset,
+					.mode = FILE_MODE_DIRECT };
+	AsyncResult result = fun_read_file_in_memory(params);
+	fun_async_await(&result, -1);
+	return result.status == ASYNC_COMPLETED;
+}
+
+/* Bounced unaligned reads, a zero-copy aligned slice, and EOF. */
+static bool test_fun_read_file_direct(void)
+{
+	uint64_t alignment = fun_file_direct_alignment();
+	if (alignment > 4096)
+		return false;
+	char content[3 * 4096];
+	for (size_t i = 0; i < sizeof(content); i++)
+		content[i] = (char)('a' + i % 23);
+	if (!create_test_file(TEST_FILENAME, content, 3 * alignment))
+		return false;
+
+	MemoryResult buf = fun_memory_allocate(3 * alignment);
+	if (fun_error_is_error(buf.error)) {
+		unlink(TEST_FILENAME);
+		return false;
+	}
+	char *aligned = (char *)(((uintptr_t)buf.value + alignment - 1) &
+							 ~(uintptr_t)(alignment - 1));
+
+	bool success = direct_read(buf.value, alignment + 10, 5) &&
+				   memcmp(buf.value, content + 5, alignment + 10) == 0;
+	success = success && direct_read(aligned, alignment, alignment) &&
+			  memcmp(aligned, content + alignment, alignment) == 0;
+	success = success && direct_read(buf.value, 7, 3 * alignment - 7) &&
+			  memcmp(buf.value, content + 3 * alignment - 7, 7) == 0;
+
+	Read past_end = { .file_path = TEST_FILENAME,
+					  .output = buf.value,
+					  .bytes_to_read = 16,
+					  .offset = 3 * alignment - 8,
+					  .mode = FILE_MODE_DIRECT };
+	AsyncResult result = fun_read_file_in_memory(past_end);
+	fun_async_await(&result, -1);
+	success = success && result.status == ASYNC_ERROR &&
+			  result.error.code == ERROR_CODE_FILE_UNEXPECTED_EOF;
+
+	fun_memory_free(&buf.value);
+	unlink(TEST_FILENAME);
+
+	if (success)
+		printf("%s test_fun_read_file_direct\n", GREEN_CHECK);
+	return success;
+}
+
 int main(void)
 {
 	printf("Running file read module tests:\n");
@@ -226,6 +648,20 @@ int main(void)
 		failures++;
 	if (!test_fun_read_file_buffer_too_small())
 		failures++;
+	if (!test_fun_read_file_ring_concurrent())
+		failures++;
+	if (!test_fun_read_file_ring_threads())
+		failures++;
+	if (!test_fun_file_ring_set_depth())
+		failures++;
+	if (!test_fun_read_files_batch_scatter())
+		failures++;
+	if (!test_fun_read_files_batch_partial_failure())
+		failures++;
+	if (!test_fun_file_ring_register_buffers())
+		failures++;
+	if (!test_fun_read_file_direct())
+		failures++;
 
 	if (failures == 0) {
 		printf("All file read tests passed!\n");
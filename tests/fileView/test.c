@@ -0,0 +1,120 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/json/json.h"
+#include "fundamental/console/console.h"
+
+#define VIEW_TEST_FILE "test_file_view.json"
+#define EMPTY_TEST_FILE "test_file_view_empty.txt"
+#define VIEW_TEST_JSON "{\"name\": \"sponza\", \"meshes\": 103}"
+#define VIEW_TEST_JSON_LENGTH 33
+
+static bool write_test_file(String path, String content, uint64_t length)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			path, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	bool success = length == 0 || fun_error_is_ok(fun_file_write_at(
+										  handle, (Memory)content, length, 0));
+	return fun_error_is_ok(fun_file_close(&handle)) && success;
+}
+
+/* The JSON tokenizer runs straight on the mapped page cache. */
+bool test_fun_file_map_view_json(void)
+{
+	if (!write_test_file(VIEW_TEST_FILE, VIEW_TEST_JSON,
+						 VIEW_TEST_JSON_LENGTH))
+		return false;
+
+	FileView view = { 0 };
+	ErrorResult map_result = fun_file_map_view(
+		VIEW_TEST_FILE, 0, 0, FILE_VIEW_SEQUENTIAL | FILE_VIEW_POPULATE,
+		&view);
+	if (fun_error_is_error(map_result))
+		return false;
+
+	int64_tResult meshes = fun_json_query_int(view.data, view.length, "meshes");
+	bool success = view.length == VIEW_TEST_JSON_LENGTH &&
+				   fun_error_is_ok(meshes.error) && meshes.value == 103;
+
+	success = success && fun_error_is_ok(fun_file_unmap_view(&view)) &&
+			  !view.mapping && !view.data;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_map_view_json passed");
+	return success;
+}
+
+bool test_fun_file_map_view_range(void)
+{
+	FileView view = { 0 };
+	bool success = fun_error_is_ok(fun_file_map_view(
+		VIEW_TEST_FILE, 10, 6, FILE_VIEW_RANDOM | FILE_VIEW_WILLNEED, &view));
+	success = success && view.length == 6 &&
+			  fun_memory_compare((Memory)view.data, "sponza", 6).value == 0;
+	fun_file_unmap_view(&view);
+
+	/* Past the end is an error, not a view that faults on access. */
+	ErrorResult past_end =
+		fun_file_map_view(VIEW_TEST_FILE, 30, 5, 0, &view);
+	success = success && past_end.code == ERROR_CODE_FILE_UNEXPECTED_EOF;
+
+	ErrorResult conflicting = fun_file_map_view(
+		VIEW_TEST_FILE, 0, 0, FILE_VIEW_SEQUENTIAL | FILE_VIEW_RANDOM, &view);
+	success = success &&
+			  conflicting.code == ERROR_CODE_FILE_VIEW_INVALID_FLAGS;
+
+	/* An empty file maps to an empty view that needs no mapping. */
+	success = success && write_test_file(EMPTY_TEST_FILE, "", 0) &&
+			  fun_error_is_ok(
+				  fun_file_map_view(EMPTY_TEST_FILE, 0, 0, 0, &view)) &&
+			  view.length == 0 && !view.mapping &&
+			  fun_error_is_ok(fun_file_unmap_view(&view));
+
+	if (success)
+		fun_console_write_line("✓ fun_file_map_view_range passed");
+	return success;
+}
+
+/* Private views are writable; the file keeps its contents. */
+bool test_fun_file_map_view_private(void)
+{
+	FileView view = { 0 };
+	if (fun_error_is_error(fun_file_map_view(VIEW_TEST_FILE, 0, 0,
+											 FILE_VIEW_PRIVATE, &view)))
+		return false;
+	((char *)view.data)[0] = '[';
+	fun_file_unmap_view(&view);
+
+	bool success = fun_error_is_ok(
+					   fun_file_map_view(VIEW_TEST_FILE, 0, 1, 0, &view)) &&
+				   view.data[0] == '{';
+	fun_file_unmap_view(&view);
+
+	if (success)
+		fun_console_write_line("✓ fun_file_map_view_private passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file view module tests:");
+
+	if (!test_fun_file_map_view_json()) {
+		fun_console_write_line("JSON view test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_map_view_range()) {
+		fun_console_write_line("View range test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_map_view_private()) {
+		fun_console_write_line("Private view test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file view tests passed!");
+	return 0;
+}
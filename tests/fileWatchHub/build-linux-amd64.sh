@@ -0,0 +1,21 @@
+#!/bin/sh
+gcc \
+    --std=c17 -Os \
+    -I ../../include \
+    test.c \
+    ../../arch/file/linux-amd64/fileWatchHub.c \
+    ../../arch/file/linux-amd64/fileHandle.c \
+    ../../src/filesystem/directory.c \
+    ../../src/filesystem/path.c \
+    ../../src/filesystem/walk.c \
+    ../../arch/filesystem/linux-amd64/directory.c \
+    ../../arch/filesystem/linux-amd64/path.c \
+    ../../arch/memory/linux-amd64/memory.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
+    ../../src/string/stringValidation.c \
+    -o test
+
+strip --strip-unneeded test
@@ -0,0 +1,24 @@
+@ECHO OFF
+
+REM Compile
+gcc ^
+    --std=c17 -Os ^
+    -I ../../include ^
+    test.c ^
+    ../../arch/file/windows-amd64/fileWatchHub.c ^
+    ../../arch/file/windows-amd64/fileHandle.c ^
+    ../../src/filesystem/directory.c ^
+    ../../src/filesystem/path.c ^
+    ../../arch/filesystem/windows-amd64/directory.c ^
+    ../../arch/filesystem/windows-amd64/path.c ^
+    ../../arch/memory/windows-amd64/memory.c ^
+    ../../src/console/console.c ^
+    ../../arch/console/windows-amd64/console.c ^
+    ../../src/string/stringConversion.c ^
+    ../../src/string/stringOperations.c ^
+    ../../src/string/stringValidation.c ^
+    -lkernel32 -ladvapi32 ^
+    -o test.exe
+
+REM Strip unnecessary symbols
+strip --strip-unneeded test.exe
@@ -0,0 +1,172 @@
+#include "fundamental/file/file.h"
+#include "fundamental/filesystem/filesystem.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/console/console.h"
+
+#define WATCH_TEST_DIRECTORY "test_watch_hub"
+#define WATCH_TEST_CONFIG WATCH_TEST_DIRECTORY "/config.txt"
+#define WATCH_TEST_TREE WATCH_TEST_DIRECTORY "/tree"
+#define WATCH_TEST_DEEP WATCH_TEST_TREE "/deep"
+#define WATCH_TEST_NEW WATCH_TEST_TREE "/new"
+#define WATCH_TEST_DEBOUNCE_MS 30
+
+static uint32_t change_count;
+static char last_change[FILE_WATCH_PATH_SIZE];
+
+static void record_change(String filePath)
+{
+	size_t length = 0;
+	while (filePath[length] && length < FILE_WATCH_PATH_SIZE - 1)
+		length++;
+	fun_memory_copy((Memory)filePath, last_change, length);
+	last_change[length] = '\0';
+	change_count++;
+}
+
+static bool same_path(const char *a, const char *b)
+{
+	while (*a && *a == *b) {
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+static void create_directory(const char *path)
+{
+	char buffer[FILE_WATCH_PATH_SIZE];
+	size_t length = 0;
+	while (path[length]) {
+		buffer[length] = path[length];
+		length++;
+	}
+	buffer[length] = '\0';
+	const char *components[16];
+	Path parsed = { .components = components };
+	if (fun_error_is_ok(fun_path_from_string(buffer, &parsed)))
+		fun_filesystem_create_directory(parsed);
+}
+
+static bool touch(String path, const char *content, uint64_t length)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			path, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	bool success = fun_error_is_ok(
+		fun_file_write_at(handle, (Memory)content, length, 0));
+	return fun_error_is_ok(fun_file_close(&handle)) && success;
+}
+
+/* Dispatch until a debounce interval has certainly passed. */
+static uint32_t settle(FileWatchHub hub)
+{
+	uint32_t fired = 0;
+	for (int i = 0; i < 4; i++) {
+		uint32_tResult result =
+			fun_file_watch_hub_dispatch(hub, WATCH_TEST_DEBOUNCE_MS * 2);
+		if (fun_error_is_error(result.error))
+			return 0;
+		fired += result.value;
+	}
+	return fired;
+}
+
+bool test_fun_file_watch_hub(void)
+{
+	create_directory(WATCH_TEST_DIRECTORY);
+	create_directory(WATCH_TEST_TREE);
+	create_directory(WATCH_TEST_DEEP);
+	bool success = touch(WATCH_TEST_CONFIG, "a", 1);
+
+	FileWatchHub hub = { 0 };
+	success = success && fun_error_is_ok(fun_file_watch_hub_open(
+							 WATCH_TEST_DEBOUNCE_MS, &hub));
+	success = success && fun_file_watch_hub_descriptor(hub) >= 0;
+	success = success &&
+			  fun_error_is_ok(fun_file_watch_hub_add(
+				  hub, (FileWatch){ .path = WATCH_TEST_CONFIG,
+									.callback = record_change })) &&
+			  fun_error_is_ok(fun_file_watch_hub_add(
+				  hub, (FileWatch){ .path = WATCH_TEST_TREE "/",
+									.callback = record_change,
+									.recursive = true }));
+	if (!success)
+		return false;
+
+	/* A burst of writes to one file is reported once. */
+	change_count = 0;
+	for (int i = 0; i < 10; i++)
+		success = success && touch(WATCH_TEST_CONFIG, "config", 6);
+	success = success && settle(hub) == 1 && change_count == 1 &&
+			  same_path(last_change, WATCH_TEST_CONFIG);
+
+	/* Files that were in the tree before the watch are covered. */
+	change_count = 0;
+	success = success && touch(WATCH_TEST_DEEP "/log.txt", "line", 4) &&
+			  settle(hub) >= 1 &&
+			  same_path(last_change, WATCH_TEST_DEEP "/log.txt");
+
+	/* So are directories created afterwards. */
+	create_directory(WATCH_TEST_NEW);
+	settle(hub);
+	change_count = 0;
+	success = success && touch(WATCH_TEST_NEW "/log.txt", "line", 4) &&
+			  settle(hub) == 1 && change_count == 1 &&
+			  same_path(last_change, WATCH_TEST_NEW "/log.txt");
+
+	/* Nothing changed, nothing reported. */
+	change_count = 0;
+	uint32_tResult idle = fun_file_watch_hub_dispatch(hub, 0);
+	success = success && fun_error_is_ok(idle.error) && idle.value == 0 &&
+			  change_count == 0;
+
+	success = fun_error_is_ok(fun_file_watch_hub_close(&hub)) && success &&
+			  !hub.state && fun_file_watch_hub_descriptor(hub) == -1;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_watch_hub passed");
+	return success;
+}
+
+bool test_fun_file_watch_hub_errors(void)
+{
+	FileWatchHub hub = { 0 };
+	bool success = fun_file_watch_hub_open(0, NULL).code ==
+				   ERROR_CODE_NULL_POINTER;
+	success = success && fun_error_is_ok(fun_file_watch_hub_open(0, &hub));
+	success = success &&
+			  fun_file_watch_hub_add(hub, (FileWatch){ .path = "x" }).code ==
+				  ERROR_CODE_NULL_POINTER &&
+			  fun_error_is_error(fun_file_watch_hub_add(
+				  hub, (FileWatch){ .path = WATCH_TEST_DIRECTORY "/missing",
+									.callback = record_change })) &&
+			  fun_file_watch_hub_add(
+				  hub, (FileWatch){ .path = WATCH_TEST_CONFIG,
+									.callback = record_change,
+									.recursive = true })
+					  .code == ERROR_CODE_NOT_DIRECTORY;
+	success = fun_error_is_ok(fun_file_watch_hub_close(&hub)) && success;
+
+	if (success)
+		fun_console_write_line("✓ fun_file_watch_hub errors passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running file watch hub module tests:");
+
+	if (!test_fun_file_watch_hub()) {
+		fun_console_write_line("Watch hub test failed");
+		return 1;
+	}
+
+	if (!test_fun_file_watch_hub_errors()) {
+		fun_console_write_line("Watch hub error test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All file watch hub tests passed!");
+	return 0;
+}
@@ -6,6 +6,10 @@ gcc \
     ../../arch/file/linux-amd64/fileWriteMmap.c \
     ../../arch/file/linux-amd64/fileWrite.c \
     ../../arch/file/linux-amd64/fileWriteRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
     ../../arch/memory/linux-amd64/memory.c \
     ../../src/string/stringOperations.c \
     ../../src/string/stringConversion.c \
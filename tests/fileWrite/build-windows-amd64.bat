@@ -7,6 +7,9 @@ gcc ^
     test.c ^
     ../../arch/file/windows-amd64/fileWriteMmap.c ^
     ../../arch/file/windows-amd64/fileWriteRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../arch/file/windows-amd64/fileWrite.c ^
     ../../arch/memory/windows-amd64/memory.c ^
     ../../src/string/stringOperations.c ^
@@ -122,6 +122,81 @@ static bool test_fun_write_memory_to_file_offset(void)
 	return success;
 }
 
+static bool direct_write(uint64_t offset, const void *data, uint64_t len,
+						 FileDurabilityMode durability)
+{
+	Write params = { .file_path = TEST_FILENAME,
+					 .input = (Memory)data,
+					 .bytes_to_write = len,
+					 .offset = offset,
+					 .mode = FILE_MODE_DIRECT,
+					 .durability_mode = durability };
+	AsyncResult result = fun_write_memory_to_file(params);
+	fun_async_await(&result, -1);
+	return result.status == ASYNC_COMPLETED;
+}
+
+/* Unaligned head and tail, an aligned zero-copy chunk, and growth. */
+static bool test_fun_write_memory_to_file_direct(void)
+{
+	uint64_t alignment = fun_file_direct_alignment();
+	if (alignment > 4096)
+		return false;
+	MemoryResult buf = fun_memory_allocate(4 * alignment);
+	if (fun_error_is_error(buf.error))
+		return false;
+	char *aligned = (char *)(((uintptr_t)buf.value + alignment - 1) &
+							 ~(uintptr_t)(alignment - 1));
+
+	int fd = open(TEST_FILENAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		fun_memory_free(&buf.value);
+		return false;
+	}
+	char expected[3 * 4096 + 32];
+	uint64_t size = 2 * alignment + 100;
+	memset(expected, 'a', size);
+	bool success = write(fd, expected, size) == (ssize_t)size;
+	close(fd);
+
+	/* Straddles a block boundary without covering either block. */
+	memset(aligned, 'b', alignment + 1);
+	success = success && direct_write(100, aligned + 1, alignment,
+									  FILE_DURABILITY_ASYNC);
+	memset(expected + 100, 'b', alignment);
+
+	/* Aligned offset, address and length: no bounce buffer. */
+	memset(aligned, 'c', alignment);
+	success = success && direct_write(2 * alignment, aligned, alignment,
+									  FILE_DURABILITY_SYNC);
+	memset(expected + 2 * alignment, 'c', alignment);
+	size = 3 * alignment;
+
+	/* Growth past the last block must not leave block padding behind. */
+	success = success && direct_write(size + 20, "tail", 4,
+									  FILE_DURABILITY_ASYNC);
+	memset(expected + size, 0, 20);
+	memcpy(expected + size + 20, "tail", 4);
+	size += 24;
+
+	if (success) {
+		char actual[sizeof(expected)];
+		fd = open(TEST_FILENAME, O_RDONLY);
+		ssize_t rd = fd < 0 ? -1 : read(fd, actual, sizeof(actual));
+		if (fd >= 0)
+			close(fd);
+		success = rd == (ssize_t)size && memcmp(actual, expected, size) == 0;
+	}
+
+	fun_memory_free(&buf.value);
+	unlink(TEST_FILENAME);
+
+	if (success) {
+		printf("%s test_fun_write_memory_to_file_direct\n", GREEN_CHECK);
+	}
+	return success;
+}
+
 int main(void)
 {
 	printf("Running file write module tests:\n");
@@ -131,6 +206,8 @@ int main(void)
 		failures++;
 	if (!test_fun_write_memory_to_file_offset())
 		failures++;
+	if (!test_fun_write_memory_to_file_direct())
+		failures++;
 
 	if (failures == 0) {
 		printf("All file write tests passed!\n");
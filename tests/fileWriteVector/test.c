@@ -0,0 +1,134 @@
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define VECTOR_TEST_FILE "test_file_write_vector.bin"
+
+static bool file_matches(Memory expected, uint64_t length)
+{
+	char scratch[64];
+	FileHandle handle = { 0 };
+	if (length > sizeof(scratch) ||
+		fun_error_is_error(
+			fun_file_open(VECTOR_TEST_FILE, FILE_OPEN_READ, &handle)))
+		return false;
+	/* The file must hold exactly length bytes. */
+	bool success =
+		fun_error_is_ok(fun_file_read_at(handle, scratch, length, 0)) &&
+		fun_memory_compare(scratch, expected, length).value == 0 &&
+		fun_file_read_at(handle, scratch, 1, length).code ==
+			ERROR_CODE_FILE_UNEXPECTED_EOF;
+	fun_file_close(&handle);
+	return success;
+}
+
+static bool truncate_test_file(void)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			VECTOR_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	return fun_error_is_ok(fun_file_close(&handle));
+}
+
+static bool test_vector_mode(FileMode mode)
+{
+	FileSegment record[] = { { "head:", 5 },
+							 { NULL, 0 },
+							 { "payload", 7 },
+							 { ";\n", 2 } };
+	bool success = truncate_test_file();
+
+	AsyncResult append = fun_append_vector_to_file(
+		(AppendVector){ .file_path = VECTOR_TEST_FILE,
+						.segments = record,
+						.segment_count = 4,
+						.mode = mode });
+	fun_async_await(&append, -1);
+	success = success && append.status == ASYNC_COMPLETED;
+	append = fun_append_vector_to_file(
+		(AppendVector){ .file_path = VECTOR_TEST_FILE,
+						.segments = record,
+						.segment_count = 4,
+						.mode = mode,
+						.durability_mode = FILE_DURABILITY_SYNC });
+	fun_async_await(&append, -1);
+	success = success && append.status == ASYNC_COMPLETED &&
+			  file_matches("head:payload;\nhead:payload;\n", 28);
+
+	/* A positioned write overwrites in place and never truncates. */
+	FileSegment patch[] = { { "HE", 2 }, { "AD", 2 } };
+	AsyncResult write = fun_write_vector_to_file(
+		(WriteVector){ .file_path = VECTOR_TEST_FILE,
+					   .segments = patch,
+					   .segment_count = 2,
+					   .offset = 14,
+					   .mode = mode,
+					   .durability_mode = FILE_DURABILITY_FULL });
+	fun_async_await(&write, -1);
+	success = success && write.status == ASYNC_COMPLETED &&
+			  file_matches("head:payload;\nHEAD:payload;\n", 28);
+
+	return success;
+}
+
+bool test_fun_write_vector_to_file(void)
+{
+	bool success = test_vector_mode(FILE_MODE_AUTO) &&
+				   test_vector_mode(FILE_MODE_RING_BASED);
+
+	if (success)
+		fun_console_write_line("✓ fun_write_vector_to_file passed");
+	return success;
+}
+
+bool test_fun_write_vector_to_file_errors(void)
+{
+	FileSegment broken[] = { { "ok", 2 }, { NULL, 3 } };
+	AsyncResult missing = fun_append_vector_to_file(
+		(AppendVector){ .file_path = VECTOR_TEST_FILE,
+						.segments = broken,
+						.segment_count = 2 });
+	bool success = missing.status == ASYNC_ERROR &&
+				   missing.error.code == ERROR_CODE_NULL_POINTER;
+
+	AsyncResult too_many = fun_write_vector_to_file(
+		(WriteVector){ .file_path = VECTOR_TEST_FILE,
+					   .segments = broken,
+					   .segment_count = FILE_MAX_SEGMENTS + 1 });
+	success = success && too_many.status == ASYNC_ERROR &&
+			  too_many.error.code == ERROR_CODE_FILE_TOO_MANY_SEGMENTS;
+
+	FileSegment huge[] = { { "a", UINT64_MAX }, { "b", 1 } };
+	AsyncResult overflow = fun_write_vector_to_file((WriteVector){
+		.file_path = VECTOR_TEST_FILE, .segments = huge, .segment_count = 2 });
+	success = success && overflow.status == ASYNC_ERROR &&
+			  overflow.error.code == ERROR_CODE_INTEGER_OVERFLOW;
+
+	AsyncResult empty = fun_append_vector_to_file(
+		(AppendVector){ .file_path = VECTOR_TEST_FILE });
+	success = success && empty.status == ASYNC_COMPLETED;
+
+	if (success)
+		fun_console_write_line("✓ fun_write_vector_to_file errors passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running vectored file write tests:");
+
+	if (!test_fun_write_vector_to_file()) {
+		fun_console_write_line("Vectored write test failed");
+		return 1;
+	}
+
+	if (!test_fun_write_vector_to_file_errors()) {
+		fun_console_write_line("Vectored write error test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All vectored file write tests passed!");
+	return 0;
+}
@@ -7,7 +7,16 @@ gcc \
     ../../arch/file/linux-amd64/fileWriteMmap.c \
     ../../arch/file/linux-amd64/fileWriteRing.c \
     ../../arch/file/linux-amd64/fileAppend.c \
+    ../../arch/file/linux-amd64/fileRead.c \
+    ../../arch/file/linux-amd64/fileReadMmap.c \
+    ../../arch/file/linux-amd64/fileReadRing.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileDirect.c \
+    ../../arch/file/linux-amd64/fileAdaptive.c \
     ../../arch/memory/linux-amd64/memory.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
     ../../src/string/stringOperations.c \
     ../../src/string/stringConversion.c \
     ../../src/string/stringTemplate.c \
@@ -10,6 +10,9 @@ gcc ^
     ../../arch/file/windows-amd64/fileWriteMmap.c ^
     ../../arch/file/windows-amd64/fileWrite.c ^
     ../../arch\file\windows-amd64\fileAppend.c ^
+    ../../arch\file\windows-amd64\fileRing.c ^
+    ../../arch\file\windows-amd64\fileDirect.c ^
+    ../../arch\file\windows-amd64\fileAdaptive.c ^
     ../../arch\file\windows-amd64\fileLock.c ^
     ../../src\string\stringOperations.c ^
     ../../src\string\stringConversion.c ^
@@ -0,0 +1,376 @@
+#include "fundamental/http/http.h"
+#include "fundamental/console/console.h"
+#include <stdbool.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define GREEN_CHECK "\033[0;32m✓\033[0m"
+#define RED_CROSS "\033[0;31m✗\033[0m"
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static void print_test_result(const char *test_name, int passed)
+{
+	if (passed) {
+		fun_console_write(GREEN_CHECK);
+		fun_console_write(" ");
+		fun_console_write_line(test_name);
+		tests_passed++;
+	} else {
+		fun_console_write(RED_CROSS);
+		fun_console_write(" ");
+		fun_console_write_line(test_name);
+		tests_failed++;
+	}
+}
+
+static bool view_equals(String view, uint64_t len, String expected)
+{
+	uint64_t i = 0;
+	for (; i < len; i++)
+		if (expected[i] == '\0' || view[i] != expected[i])
+			return false;
+	return expected[i] == '\0';
+}
+
+// === Parser ===
+
+static void test_parse_simple_get(void)
+{
+	const char data[] = "GET /health HTTP/1.1\r\n"
+						"Host: localhost\r\n"
+						"User-Agent:  probe/1.0  \r\n"
+						"\r\n";
+	FunHttpState state;
+	FunHttpRequest req;
+	fun_http_init(&state, data, sizeof(data) - 1);
+	ErrorResult r = fun_http_next(&state, &req);
+
+	bool ok = !fun_error_is_error(r) && req.type == FUN_HTTP_REQUEST &&
+			  view_equals(req.method, req.method_length, "GET") &&
+			  view_equals(req.target, req.target_length, "/health") &&
+			  req.version_minor == 1 && req.header_count == 2 &&
+			  view_equals(req.headers[1].value, req.headers[1].value_length,
+						  "probe/1.0") &&
+			  req.content_length == 0 && req.body == NULL && req.keep_alive &&
+			  fun_http_consumed(&state) == sizeof(data) - 1;
+
+	r = fun_http_next(&state, &req);
+	ok = ok && !fun_error_is_error(r) && req.type == FUN_HTTP_END;
+
+	print_test_result("fun_http_next simple GET", ok);
+}
+
+static void test_parse_incremental(void)
+{
+	const char data[] = "POST /rpc HTTP/1.1\r\n"
+						"Content-Length: 5\r\n"
+						"\r\n"
+						"hello";
+	uint64_t total = sizeof(data) - 1;
+	FunHttpState state;
+	FunHttpRequest req;
+	bool ok = true;
+
+	/* Feed three bytes at a time; only the final feed completes */
+	fun_http_init(&state, data, 0);
+	for (uint64_t len = 3; len < total; len += 3) {
+		fun_http_feed(&state, data, len);
+		ErrorResult r = fun_http_next(&state, &req);
+		if (fun_error_is_error(r) || req.type != FUN_HTTP_INCOMPLETE)
+			ok = false;
+	}
+	fun_http_feed(&state, data, total);
+	ErrorResult r = fun_http_next(&state, &req);
+	ok = ok && !fun_error_is_error(r) && req.type == FUN_HTTP_REQUEST &&
+		 req.content_length == 5 && view_equals(req.body, 5, "hello");
+
+	print_test_result("fun_http_feed incremental request", ok);
+}
+
+static void test_parse_pipelined(void)
+{
+	const char data[] = "GET /a HTTP/1.1\r\n\r\n"
+						"PUT /b HTTP/1.1\r\nContent-Length: 2\r\n\r\nok"
+						"GET /c HTTP/1.1\r\n";
+	FunHttpState state;
+	FunHttpRequest req;
+	fun_http_init(&state, data, sizeof(data) - 1);
+
+	bool ok = true;
+	ErrorResult r = fun_http_next(&state, &req);
+	ok = ok && !fun_error_is_error(r) && req.type == FUN_HTTP_REQUEST &&
+		 view_equals(req.target, req.target_length, "/a");
+	r = fun_http_next(&state, &req);
+	ok = ok && !fun_error_is_error(r) && req.type == FUN_HTTP_REQUEST &&
+		 view_equals(req.target, req.target_length, "/b") &&
+		 view_equals(req.body, req.content_length, "ok");
+	uint64_t consumed = fun_http_consumed(&state);
+	r = fun_http_next(&state, &req);
+	ok = ok && !fun_error_is_error(r) && req.type == FUN_HTTP_INCOMPLETE &&
+		 fun_http_consumed(&state) == consumed &&
+		 view_equals(data + consumed, sizeof(data) - 1 - consumed,
+					 "GET /c HTTP/1.1\r\n");
+
+	print_test_result("fun_http_next pipelined requests", ok);
+}
+
+static void test_keep_alive_rules(void)
+{
+	const char http10[] = "GET / HTTP/1.0\r\n\r\n";
+	const char http10_ka[] = "GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n";
+	const char http11_close[] =
+		"GET / HTTP/1.1\r\nConnection: upgrade, close\r\n\r\n";
+	FunHttpState state;
+	FunHttpRequest req;
+	bool ok = true;
+
+	fun_http_init(&state, http10, sizeof(http10) - 1);
+	fun_http_next(&state, &req);
+	ok = ok && req.type == FUN_HTTP_REQUEST && !req.keep_alive;
+
+	fun_http_init(&state, http10_ka, sizeof(http10_ka) - 1);
+	fun_http_next(&state, &req);
+	ok = ok && req.type == FUN_HTTP_REQUEST && req.keep_alive;
+
+	fun_http_init(&state, http11_close, sizeof(http11_close) - 1);
+	fun_http_next(&state, &req);
+	ok = ok && req.type == FUN_HTTP_REQUEST && !req.keep_alive;
+
+	print_test_result("fun_http_next keep-alive rules", ok);
+}
+
+static void test_parse_errors(void)
+{
+	const char bad_line[] = "GET /x HTTP/2.0\r\n\r\n";
+	const char bad_header[] = "GET / HTTP/1.1\r\nNo colon here\r\n\r\n";
+	const char chunked[] =
+		"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+	const char bad_length[] = "POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n";
+	FunHttpState state;
+	FunHttpRequest req;
+	bool ok = true;
+
+	fun_http_init(&state, bad_line, sizeof(bad_line) - 1);
+	ok = ok && fun_http_next(&state, &req).code == ERROR_CODE_HTTP_PARSE_ERROR;
+
+	fun_http_init(&state, bad_header, sizeof(bad_header) - 1);
+	ok = ok && fun_http_next(&state, &req).code == ERROR_CODE_HTTP_PARSE_ERROR;
+
+	fun_http_init(&state, chunked, sizeof(chunked) - 1);
+	ok = ok && fun_http_next(&state, &req).code == ERROR_CODE_HTTP_UNSUPPORTED;
+
+	fun_http_init(&state, bad_length, sizeof(bad_length) - 1);
+	ok = ok && fun_http_next(&state, &req).code == ERROR_CODE_HTTP_PARSE_ERROR;
+
+	print_test_result("fun_http_next malformed input", ok);
+}
+
+static void test_too_many_headers(void)
+{
+	char data[64 + (FUN_HTTP_MAX_HEADERS + 1) * 6];
+	uint64_t len = 0;
+	const char *line = "GET / HTTP/1.1\r\n";
+	while (*line)
+		data[len++] = *line++;
+	for (int i = 0; i <= FUN_HTTP_MAX_HEADERS; i++) {
+		data[len++] = 'X';
+		data[len++] = ':';
+		data[len++] = ' ';
+		data[len++] = '1';
+		data[len++] = '\r';
+		data[len++] = '\n';
+	}
+	data[len++] = '\r';
+	data[len++] = '\n';
+
+	FunHttpState state;
+	FunHttpRequest req;
+	fun_http_init(&state, data, len);
+	print_test_result("fun_http_next too many headers",
+					  fun_http_next(&state, &req).code ==
+						  ERROR_CODE_HTTP_TOO_MANY_HEADERS);
+}
+
+static void test_find_header(void)
+{
+	const char data[] = "GET / HTTP/1.1\r\nX-Request-Id: 42\r\n\r\n";
+	FunHttpState state;
+	FunHttpRequest req;
+	fun_http_init(&state, data, sizeof(data) - 1);
+	fun_http_next(&state, &req);
+
+	const FunHttpHeader *h = fun_http_find_header(&req, "x-request-id");
+	bool ok = h != NULL && view_equals(h->value, h->value_length, "42") &&
+			  fun_http_find_header(&req, "x-request") == NULL;
+	print_test_result("fun_http_find_header case-insensitive", ok);
+}
+
+// === Response writer ===
+
+#ifdef _WIN32
+typedef SOCKET test_socket;
+#define close_socket closesocket
+#else
+typedef int test_socket;
+#define close_socket close
+#endif
+
+static void test_response_send(void)
+{
+#ifdef _WIN32
+	WSADATA wd;
+	WSAStartup(MAKEWORD(2, 2), &wd);
+#endif
+	test_socket server = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	listen(server, 1);
+#ifdef _WIN32
+	int alen = sizeof(addr);
+#else
+	socklen_t alen = sizeof(addr);
+#endif
+	getsockname(server, (struct sockaddr *)&addr, &alen);
+
+	NetworkAddress target;
+	for (int i = 0; i < NETWORK_ADDRESS_MAX_BYTES; i++)
+		target.bytes[i] = 0;
+	target.family = NETWORK_ADDRESS_IPV4;
+	target.bytes[0] = 127;
+	target.bytes[3] = 1;
+	target.port = ntohs(addr.sin_port);
+
+	TcpNetworkConnection conn = (TcpNetworkConnection)0;
+	AsyncResult cr = fun_network_tcp_connect(target, &conn);
+	fun_async_await(&cr, 3000);
+	test_socket peer = accept(server, NULL, NULL);
+
+	FunHttpResponse response;
+	fun_http_response_init(&response, 200, "OK");
+	fun_http_response_header(&response, "Content-Type", "text/plain");
+	AsyncResult sr = fun_http_response_send(&response, conn, "ok", 2, true);
+	fun_async_await(&sr, 3000);
+
+	const char expected[] = "HTTP/1.1 200 OK\r\n"
+							"Content-Type: text/plain\r\n"
+							"Content-Length: 2\r\n"
+							"Connection: keep-alive\r\n"
+							"\r\n"
+							"ok";
+	char got[sizeof(expected)];
+	int n = 0;
+	while (n < (int)sizeof(expected) - 1) {
+		int r = (int)recv(peer, got + n, (int)sizeof(expected) - 1 - n, 0);
+		if (r <= 0)
+			break;
+		n += r;
+	}
+
+	bool ok = cr.status == ASYNC_COMPLETED && sr.status == ASYNC_COMPLETED &&
+			  n == (int)sizeof(expected) - 1 &&
+			  view_equals(got, (uint64_t)n, expected);
+
+	fun_network_tcp_close(conn);
+	close_socket(peer);
+	close_socket(server);
+	print_test_result("fun_http_response_send head + body", ok);
+}
+
+static void test_response_overflow(void)
+{
+	char value[FUN_HTTP_RESPONSE_HEAD_MAX + 1];
+	for (int i = 0; i < FUN_HTTP_RESPONSE_HEAD_MAX; i++)
+		value[i] = 'v';
+	value[FUN_HTTP_RESPONSE_HEAD_MAX] = '\0';
+
+	FunHttpResponse response;
+	fun_http_response_init(&response, 200, "OK");
+	ErrorResult r = fun_http_response_header(&response, "X-Big", value);
+	print_test_result("fun_http_response_header overflow",
+					  r.code == ERROR_CODE_BUFFER_TOO_SMALL);
+}
+
+static void test_response_header_injection(void)
+{
+	FunHttpResponse response;
+	fun_http_response_init(&response, 200, "OK");
+	uint64_t head_len = response._head_len;
+
+	bool ok =
+		fun_http_response_header(&response, "X-A", "1\r\nSet-Cookie: x")
+				.code == ERROR_CODE_HTTP_INVALID_HEADER &&
+		fun_http_response_header(&response, "X-A", "1\nX-B: 2").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		fun_http_response_header(&response, "X-A\r\nX-B", "2").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		fun_http_response_header(&response, "X-A: 1", "2").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		fun_http_response_header(&response, "", "2").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		response._head_len == head_len &&
+		/* ':' is fine in a value */
+		fun_http_response_header(&response, "Location", "http://h:8080/")
+				.code == ERROR_CODE_NO_ERROR;
+	print_test_result("fun_http_response_header rejects CR, LF and ':'", ok);
+}
+
+static void test_response_reason_injection(void)
+{
+	FunHttpResponse response;
+	fun_http_response_init(&response, 200, "OK");
+	uint64_t head_len = response._head_len;
+
+	bool ok =
+		fun_http_response_init(&response, 200, "OK\r\nSet-Cookie: x").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		fun_http_response_init(&response, 200, "OK\nX-B: 2").code ==
+			ERROR_CODE_HTTP_INVALID_HEADER &&
+		response._head_len == head_len &&
+		/* ':' is fine in a reason phrase */
+		fun_http_response_init(&response, 418, "Teapot: short and stout")
+				.code == ERROR_CODE_NO_ERROR;
+	print_test_result("fun_http_response_init rejects CR and LF in reason",
+					  ok);
+}
+
+int main(void)
+{
+	fun_console_write_line("=== HTTP Tests ===");
+
+	test_parse_simple_get();
+	test_parse_incremental();
+	test_parse_pipelined();
+	test_keep_alive_rules();
+	test_parse_errors();
+	test_too_many_headers();
+	test_find_header();
+	test_response_send();
+	test_response_overflow();
+	test_response_header_injection();
+	test_response_reason_injection();
+
+	fun_console_write_line("");
+	if (tests_failed == 0) {
+		fun_console_write_line("All tests passed.");
+		return 0;
+	}
+	fun_console_write_line("Some tests FAILED.");
+	return 1;
+}
@@ -341,14 +341,31 @@ void test_fun_memory_copy()
 		return;
 	}
 
-	// Test 6: NULL destination
+	// Test 6: Overlapping copies spanning several words, both directions
+	for (int shift = 1; shift <= 9; shift++) {
+		char ahead[40];
+		char behind[40];
+		for (int i = 0; i < 40; i++)
+			ahead[i] = behind[i] = (char)('A' + i);
+		fun_memory_copy(ahead, ahead + shift, 29);
+		fun_memory_copy(behind + shift, behind, 29);
+		for (int i = 0; i < 29; i++) {
+			if (ahead[shift + i] != (char)('A' + i) ||
+				behind[i] != (char)('A' + shift + i)) {
+				fun_console_write_line("FAIL: assertion");
+				return;
+			}
+		}
+	}
+
+	// Test 7: NULL destination
 	result = fun_memory_copy(NULL, src1, sizeof(src1));
 	if (result.error.code == 0) {
 		fun_console_write_line("FAIL: ASSERT_ERROR");
 		return;
 	}
 
-	// Test 7: NULL source
+	// Test 8: NULL source
 	result = fun_memory_copy(dest1, NULL, sizeof(src1));
 	if (result.error.code == 0) {
 		fun_console_write_line("FAIL: ASSERT_ERROR");
@@ -0,0 +1,401 @@
+#include "fundamental/console/console.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "fundamental/network/clientPool.h"
+
+#define GREEN_CHECK "\033[0;32m✓\033[0m"
+
+static void print_ok(const char *name)
+{
+	fun_console_write(GREEN_CHECK);
+	fun_console_write(" ");
+	fun_console_write_line(name);
+}
+
+/* ================================================================
+ * Loopback upstream: a non-blocking listener the tests accept from
+ * by hand, so they can count how many real connects happened.
+ * ================================================================ */
+
+#ifdef _WIN32
+
+typedef SOCKET TestSocket;
+#define TEST_INVALID_SOCKET INVALID_SOCKET
+
+static TestSocket open_listener(uint16_t *port)
+{
+	WSADATA wd;
+	WSAStartup(MAKEWORD(2, 2), &wd);
+	SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(s, (struct sockaddr *)&addr, sizeof(addr));
+	listen(s, 16);
+	int len = sizeof(addr);
+	getsockname(s, (struct sockaddr *)&addr, &len);
+	u_long mode = 1;
+	ioctlsocket(s, FIONBIO, &mode);
+	*port = ntohs(addr.sin_port);
+	return s;
+}
+
+static void close_socket(TestSocket s)
+{
+	closesocket(s);
+}
+
+static void sleep_ms(int ms)
+{
+	Sleep((DWORD)ms);
+}
+
+#else /* POSIX */
+
+typedef int TestSocket;
+#define TEST_INVALID_SOCKET (-1)
+
+static TestSocket open_listener(uint16_t *port)
+{
+	int s = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(s, (struct sockaddr *)&addr, sizeof(addr));
+	listen(s, 16);
+	socklen_t len = sizeof(addr);
+	getsockname(s, (struct sockaddr *)&addr, &len);
+	fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+	*port = ntohs(addr.sin_port);
+	return s;
+}
+
+static void close_socket(TestSocket s)
+{
+	close(s);
+}
+
+static void sleep_ms(int ms)
+{
+	usleep((useconds_t)ms * 1000);
+}
+
+#endif /* _WIN32 */
+
+/* Accept one pending connection; TEST_INVALID_SOCKET if none arrived */
+static TestSocket try_accept(TestSocket listener)
+{
+	for (int i = 0; i < 50; i++) {
+		TestSocket c = accept(listener, NULL, NULL);
+		if (c != TEST_INVALID_SOCKET)
+			return c;
+		sleep_ms(2);
+	}
+	return TEST_INVALID_SOCKET;
+}
+
+static NetworkAddress loopback_address(uint16_t port)
+{
+	NetworkAddress addr;
+	for (int i = 0; i < NETWORK_ADDRESS_MAX_BYTES; i++)
+		addr.bytes[i] = 0;
+	addr.family = NETWORK_ADDRESS_IPV4;
+	addr.bytes[0] = 127;
+	addr.bytes[3] = 1;
+	addr.port = port;
+	return addr;
+}
+
+static int checkout(NetworkClientPool pool, NetworkAddress addr,
+					TcpNetworkConnection *conn)
+{
+	AsyncResult r = fun_network_client_pool_checkout(pool, addr, conn);
+	fun_async_await(&r, 3000);
+	return r.status == ASYNC_COMPLETED;
+}
+
+/* ================================================================
+ * 1. test_reuse_idle_connection
+ *    A checked-in connection is handed out again without a new connect.
+ * ================================================================ */
+
+static void test_reuse_idle_connection(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(4, 0, &pool);
+
+	TcpNetworkConnection first;
+	if (!checkout(pool, addr, &first)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	TestSocket upstream = try_accept(listener);
+	if (!(upstream != TEST_INVALID_SOCKET)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_checkin(pool, first, true);
+	if (!(fun_network_client_pool_idle_count(pool, addr) == 1)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	TcpNetworkConnection second;
+	if (!checkout(pool, addr, &second) || !(second == first) ||
+		!(fun_network_client_pool_idle_count(pool, addr) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	/* No second connect reached the upstream */
+	if (!(accept(listener, NULL, NULL) == TEST_INVALID_SOCKET)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_checkin(pool, second, true);
+	fun_network_client_pool_free(pool);
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_reuse_idle_connection");
+}
+
+/* ================================================================
+ * 2. test_health_check_on_checkout
+ *    An idle connection the upstream closed is dropped, and checkout
+ *    connects afresh.
+ * ================================================================ */
+
+static void test_health_check_on_checkout(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(4, 0, &pool);
+
+	TcpNetworkConnection conn;
+	checkout(pool, addr, &conn);
+	TestSocket upstream = try_accept(listener);
+	fun_network_client_pool_checkin(pool, conn, true);
+
+	close_socket(upstream);
+	sleep_ms(20);
+
+	if (!checkout(pool, addr, &conn)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	upstream = try_accept(listener);
+	if (!(upstream != TEST_INVALID_SOCKET)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_checkin(pool, conn, false);
+	if (!(fun_network_client_pool_idle_count(pool, addr) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_free(pool);
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_health_check_on_checkout");
+}
+
+/* ================================================================
+ * 3. test_max_per_host
+ *    Checkouts beyond max_per_host fail with backpressure.
+ * ================================================================ */
+
+static void test_max_per_host(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(1, 0, &pool);
+
+	TcpNetworkConnection a, b;
+	checkout(pool, addr, &a);
+	TestSocket upstream = try_accept(listener);
+
+	AsyncResult r = fun_network_client_pool_checkout(pool, addr, &b);
+	if (!(r.status == ASYNC_ERROR) ||
+		!(r.error.code == ERROR_CODE_NETWORK_BACKPRESSURE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* Once returned, the same connection serves the next caller */
+	fun_network_client_pool_checkin(pool, a, true);
+	if (!checkout(pool, addr, &b) || !(b == a)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_checkin(pool, b, true);
+	fun_network_client_pool_free(pool);
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_max_per_host");
+}
+
+/* ================================================================
+ * 4. test_idle_timeout
+ *    Idle connections past the timeout are evicted.
+ * ================================================================ */
+
+static void test_idle_timeout(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(4, 30, &pool);
+
+	TcpNetworkConnection conn;
+	checkout(pool, addr, &conn);
+	TestSocket upstream = try_accept(listener);
+	fun_network_client_pool_checkin(pool, conn, true);
+
+	if (!(fun_network_client_pool_evict_idle(pool) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(60);
+	if (!(fun_network_client_pool_evict_idle(pool) == 1) ||
+		!(fun_network_client_pool_idle_count(pool, addr) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_free(pool);
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_idle_timeout");
+}
+
+/* ================================================================
+ * 5. test_unsolicited_data_not_reused
+ *    A connection with bytes the caller never read is closed on
+ *    checkin rather than parked.
+ * ================================================================ */
+
+static void test_unsolicited_data_not_reused(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(4, 0, &pool);
+
+	TcpNetworkConnection conn;
+	checkout(pool, addr, &conn);
+	TestSocket upstream = try_accept(listener);
+	send(upstream, "late", 4, 0);
+	sleep_ms(20);
+
+	fun_network_client_pool_checkin(pool, conn, true);
+	if (!(fun_network_client_pool_idle_count(pool, addr) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_free(pool);
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_unsolicited_data_not_reused");
+}
+
+/* ================================================================
+ * 6. test_free_refused_while_busy
+ *    The pool is not freed under a pending checkout or a connection
+ *    still checked out.
+ * ================================================================ */
+
+static void test_free_refused_while_busy(void)
+{
+	uint16_t port;
+	TestSocket listener = open_listener(&port);
+	NetworkAddress addr = loopback_address(port);
+
+	NetworkClientPool pool;
+	fun_network_client_pool_create(4, 0, &pool);
+
+	TcpNetworkConnection conn;
+	AsyncResult r = fun_network_client_pool_checkout(pool, addr, &conn);
+	if (!(r.status == ASYNC_PENDING) ||
+		!(fun_network_client_pool_free(pool).error.code ==
+		  ERROR_CODE_NETWORK_CLIENT_POOL_BUSY)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_async_await(&r, 3000);
+	TestSocket upstream = try_accept(listener);
+	if (!(r.status == ASYNC_COMPLETED) ||
+		!(fun_network_client_pool_free(pool).error.code ==
+		  ERROR_CODE_NETWORK_CLIENT_POOL_BUSY)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_client_pool_checkin(pool, conn, true);
+	if (!fun_error_is_ok(fun_network_client_pool_free(pool).error)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	close_socket(upstream);
+	close_socket(listener);
+
+	print_ok("test_free_refused_while_busy");
+}
+
+/* ================================================================
+ * main
+ * ================================================================ */
+
+int main(void)
+{
+	test_reuse_idle_connection();
+	test_health_check_on_checkout();
+	test_max_per_host();
+	test_idle_timeout();
+	test_unsolicited_data_not_reused();
+	test_free_refused_while_busy();
+
+	fun_console_write_line("");
+	fun_console_write_line("All tests passed.");
+	return 0;
+}
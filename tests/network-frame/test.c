@@ -0,0 +1,349 @@
+#include "fundamental/console/console.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "fundamental/network/frame.h"
+
+#define GREEN_CHECK "\033[0;32m\u2713\033[0m"
+
+static void print_ok(const char *name)
+{
+	fun_console_write(GREEN_CHECK);
+	fun_console_write(" ");
+	fun_console_write_line(name);
+}
+
+/* ================================================================
+ * Loopback pair: client via fun_network_tcp_connect, server side via
+ * accept + fun_network_tcp_register_connection.
+ * ================================================================ */
+
+#ifdef _WIN32
+
+static intptr_t g_listener;
+
+static uint16_t start_listener(void)
+{
+	WSADATA wd;
+	WSAStartup(MAKEWORD(2, 2), &wd);
+	SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(s, (struct sockaddr *)&addr, sizeof(addr));
+	listen(s, 1);
+	int len = sizeof(addr);
+	getsockname(s, (struct sockaddr *)&addr, &len);
+	g_listener = (intptr_t)s;
+	return ntohs(addr.sin_port);
+}
+
+static intptr_t accept_nonblocking(void)
+{
+	SOCKET c = accept((SOCKET)g_listener, NULL, NULL);
+	u_long mode = 1;
+	ioctlsocket(c, FIONBIO, &mode);
+	closesocket((SOCKET)g_listener);
+	return (intptr_t)c;
+}
+
+#else /* POSIX */
+
+static intptr_t g_listener;
+
+static uint16_t start_listener(void)
+{
+	int s = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	bind(s, (struct sockaddr *)&addr, sizeof(addr));
+	listen(s, 1);
+	socklen_t len = sizeof(addr);
+	getsockname(s, (struct sockaddr *)&addr, &len);
+	g_listener = s;
+	return ntohs(addr.sin_port);
+}
+
+static intptr_t accept_nonblocking(void)
+{
+	int c = accept((int)g_listener, NULL, NULL);
+	fcntl(c, F_SETFL, fcntl(c, F_GETFL, 0) | O_NONBLOCK);
+	close((int)g_listener);
+	return c;
+}
+
+#endif /* _WIN32 */
+
+static int connect_pair(TcpNetworkConnection *client,
+						TcpNetworkConnection *server)
+{
+	NetworkAddress addr;
+	for (int i = 0; i < NETWORK_ADDRESS_MAX_BYTES; i++)
+		addr.bytes[i] = 0;
+	addr.family = NETWORK_ADDRESS_IPV4;
+	addr.bytes[0] = 127;
+	addr.bytes[3] = 1;
+	addr.port = start_listener();
+
+	AsyncResult cr = fun_network_tcp_connect(addr, client);
+	fun_async_await(&cr, 3000);
+	if (cr.status != ASYNC_COMPLETED)
+		return 0;
+	*server = fun_network_tcp_register_connection(accept_nonblocking());
+	return *server != (TcpNetworkConnection)0;
+}
+
+static int frame_equals(NetworkBuffer frame, const char *expected, size_t n)
+{
+	if (frame.length != n)
+		return 0;
+	const char *data = (const char *)frame.data;
+	for (size_t i = 0; i < n; i++)
+		if (data[i] != expected[i])
+			return 0;
+	return 1;
+}
+
+/* ================================================================
+ * 1. test_small_frames_round_trip
+ *    Three queued frames (one empty) go out in one flush and come back
+ *    as views.
+ * ================================================================ */
+
+static void test_small_frames_round_trip(void)
+{
+	TcpNetworkConnection client, server;
+	if (!connect_pair(&client, &server)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	NetworkFramer tx, rx;
+	fun_network_frame_create(client, 1024, 0, &tx);
+	fun_network_frame_create(server, 1024, 0, &rx);
+
+	fun_network_frame_queue(tx, "alpha", 5);
+	fun_network_frame_queue(tx, "", 0);
+	fun_network_frame_queue(tx, "gamma!", 6);
+	if (!(fun_network_frame_queued_bytes(tx) == 11)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	AsyncResult fr = fun_network_frame_flush(tx);
+	fun_async_await(&fr, 3000);
+	if (!(fr.status == ASYNC_COMPLETED) ||
+		!(fun_network_frame_queued_bytes(tx) == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	NetworkBuffer frame;
+	AsyncResult rr = fun_network_frame_receive(rx, &frame);
+	fun_async_await(&rr, 3000);
+	if (!(rr.status == ASYNC_COMPLETED) || !frame_equals(frame, "alpha", 5)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	rr = fun_network_frame_receive(rx, &frame);
+	fun_async_await(&rr, 3000);
+	if (!(rr.status == ASYNC_COMPLETED) || !(frame.length == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	rr = fun_network_frame_receive(rx, &frame);
+	fun_async_await(&rr, 3000);
+	if (!(rr.status == ASYNC_COMPLETED) || !frame_equals(frame, "gamma!", 6)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* Small frames are views into the connection's receive buffer */
+	NetworkBuffer peeked;
+	fun_network_tcp_peek(server, &peeked);
+	if (!(peeked.data == frame.data)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	fun_network_frame_release(rx);
+	fun_network_tcp_peek(server, &peeked);
+	if (!(peeked.length == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_frame_free(tx);
+	fun_network_frame_free(rx);
+	fun_network_tcp_close(client);
+	fun_network_tcp_close(server);
+
+	print_ok("test_small_frames_round_trip");
+}
+
+/* ================================================================
+ * 2. test_large_frame
+ *    A payload bigger than the receive buffer takes the reusable-buffer
+ *    path and arrives intact.
+ * ================================================================ */
+
+#define LARGE_FRAME_BYTES 20000
+
+static char g_large_out[LARGE_FRAME_BYTES];
+
+static void test_large_frame(void)
+{
+	TcpNetworkConnection client, server;
+	if (!connect_pair(&client, &server)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	if (!(fun_network_tcp_receive_capacity(server) < LARGE_FRAME_BYTES)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	for (int i = 0; i < LARGE_FRAME_BYTES; i++)
+		g_large_out[i] = (char)(i * 31);
+
+	NetworkFramer tx, rx;
+	fun_network_frame_create(client, LARGE_FRAME_BYTES, 0, &tx);
+	fun_network_frame_create(server, LARGE_FRAME_BYTES, 0, &rx);
+
+	fun_network_frame_queue(tx, g_large_out, LARGE_FRAME_BYTES);
+	AsyncResult fr = fun_network_frame_flush(tx);
+	NetworkBuffer frame;
+	AsyncResult rr = fun_network_frame_receive(rx, &frame);
+
+	/* Drive both ends together: the frame exceeds the socket buffers */
+	AsyncResult *both[2] = { &fr, &rr };
+	fun_async_await_all(both, 2, 3000);
+	if (!(fr.status == ASYNC_COMPLETED) || !(rr.status == ASYNC_COMPLETED) ||
+		!frame_equals(frame, g_large_out, LARGE_FRAME_BYTES)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_frame_free(tx);
+	fun_network_frame_free(rx);
+	fun_network_tcp_close(client);
+	fun_network_tcp_close(server);
+
+	print_ok("test_large_frame");
+}
+
+/* ================================================================
+ * 3. test_frame_too_large
+ *    Oversized frames are rejected on queue and on receive.
+ * ================================================================ */
+
+static void test_frame_too_large(void)
+{
+	TcpNetworkConnection client, server;
+	if (!connect_pair(&client, &server)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	NetworkFramer tx, rx;
+	fun_network_frame_create(client, 64, 0, &tx);
+	fun_network_frame_create(server, 4, 0, &rx);
+
+	voidResult big = fun_network_frame_queue(tx, g_large_out, 65);
+	if (!(big.error.code == ERROR_CODE_NETWORK_FRAME_TOO_LARGE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_frame_queue(tx, "0123456789", 10);
+	AsyncResult fr = fun_network_frame_flush(tx);
+	fun_async_await(&fr, 3000);
+
+	NetworkBuffer frame;
+	AsyncResult rr = fun_network_frame_receive(rx, &frame);
+	fun_async_await(&rr, 3000);
+	if (!(rr.status == ASYNC_ERROR) ||
+		!(rr.error.code == ERROR_CODE_NETWORK_FRAME_TOO_LARGE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_frame_free(tx);
+	fun_network_frame_free(rx);
+	fun_network_tcp_close(client);
+	fun_network_tcp_close(server);
+
+	print_ok("test_frame_too_large");
+}
+
+/* ================================================================
+ * 4. test_backpressure
+ *    The queue refuses frames past max_queued_bytes until flushed.
+ * ================================================================ */
+
+static void test_backpressure(void)
+{
+	TcpNetworkConnection client, server;
+	if (!connect_pair(&client, &server)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	NetworkFramer tx;
+	fun_network_frame_create(client, 64, 8, &tx);
+
+	voidResult q1 = fun_network_frame_queue(tx, "abcdef", 6);
+	voidResult q2 = fun_network_frame_queue(tx, "ghijkl", 6);
+	if (!(q1.error.code == 0) ||
+		!(q2.error.code == ERROR_CODE_NETWORK_BACKPRESSURE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	AsyncResult fr = fun_network_frame_flush(tx);
+	fun_async_await(&fr, 3000);
+	voidResult q3 = fun_network_frame_queue(tx, "ghijkl", 6);
+	if (!(fr.status == ASYNC_COMPLETED) || !(q3.error.code == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_frame_free(tx);
+	fun_network_tcp_close(client);
+	fun_network_tcp_close(server);
+
+	print_ok("test_backpressure");
+}
+
+/* ================================================================
+ * main
+ * ================================================================ */
+
+int main(void)
+{
+	test_small_frames_round_trip();
+	test_large_frame();
+	test_frame_too_large();
+	test_backpressure();
+
+	fun_console_write_line("");
+	fun_console_write_line("All tests passed.");
+	return 0;
+}
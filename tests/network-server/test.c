@@ -8,6 +8,8 @@
 #else
 #include <pthread.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
 #endif
 
 #define GREEN_CHECK "\033[0;32m\u2713\033[0m"
@@ -895,6 +897,268 @@ void test_udp_null_callback_returns_error()
 	print_test_result(__func__);
 }
 
+/* ----------------------------------------------------------------
+ * Accept batching and admission control
+ * ---------------------------------------------------------------- */
+
+typedef struct {
+	NetworkServerConfig config;
+	TcpNetworkConnection conns[8];
+	int count;
+} AdmissionData;
+
+static void on_tcp_admitted(TcpNetworkConnection conn, Memory state)
+{
+	AdmissionData *d = (AdmissionData *)state;
+	d->conns[d->count++] = conn;
+}
+
+static NetworkAddress loopback_target(uint16_t port)
+{
+	NetworkAddress target;
+	for (int i = 0; i < NETWORK_ADDRESS_MAX_BYTES; i++)
+		target.bytes[i] = 0;
+	target.family = NETWORK_ADDRESS_IPV4;
+	target.bytes[0] = 127;
+	target.bytes[3] = 1;
+	target.port = port;
+	return target;
+}
+
+static int connect_clients(uint16_t port, TcpNetworkConnection *clients,
+						   int n)
+{
+	for (int i = 0; i < n; i++) {
+		AsyncResult cr = fun_network_tcp_connect(loopback_target(port),
+												 &clients[i]);
+		fun_async_await(&cr, 2000);
+		if (cr.status != ASYNC_COMPLETED)
+			return 0;
+	}
+	return 1;
+}
+
+void test_backlog_setters_validate_state()
+{
+	NetworkAddressResult ar = fun_network_address_parse("127.0.0.1:0");
+	char buf[64];
+	NetworkServerConfig udp = NULL;
+	fun_network_udp_server_config(ar.value, (Memory)0, buf, sizeof(buf), &udp);
+	if (!(fun_network_server_set_backlog(udp, 16).error.code ==
+		  ERROR_CODE_NETWORK_INVALID_STATE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	fun_network_server_config_free(udp);
+
+	AdmissionData data = { NULL, { NULL }, 0 };
+	NetworkServerConfig c = NULL;
+	fun_network_tcp_server_config(ar.value, (Memory)&data, &c);
+	if (!(fun_network_server_set_backlog(c, 1024).error.code == 0) ||
+		!(fun_network_server_set_max_connections(c, 4).error.code == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	AsyncResult srv = fun_network_tcp_listen(c, on_tcp_admitted);
+	if (!(srv.status == ASYNC_PENDING)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	/* Too late once listening */
+	if (!(fun_network_server_set_backlog(c, 8).error.code ==
+		  ERROR_CODE_NETWORK_INVALID_STATE)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_server_stop(c);
+	srv.status = srv.poll(&srv);
+	fun_network_server_config_free(c);
+	print_test_result(__func__);
+}
+
+void test_accept_batch_drains_queue()
+{
+	NetworkAddressResult ar = fun_network_address_parse("127.0.0.1:0");
+	AdmissionData data = { NULL, { NULL }, 0 };
+	NetworkServerConfig c = NULL;
+	fun_network_tcp_server_config(ar.value, (Memory)&data, &c);
+	data.config = c;
+	AsyncResult srv = fun_network_tcp_listen(c, on_tcp_admitted);
+	uint16_t port = 0;
+	fun_network_server_get_port(c, &port);
+
+	TcpNetworkConnection clients[5];
+	if (!connect_clients(port, clients, 5)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(50);
+
+	/* A single readiness event accepts every queued connection */
+	srv.status = srv.poll(&srv);
+	if (!(data.count == 5)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	for (int i = 0; i < 5; i++) {
+		fun_network_server_close_connection(c, data.conns[i]);
+		fun_network_tcp_close(clients[i]);
+	}
+	NetworkServerStats stats;
+	fun_network_server_get_stats(c, &stats);
+	if (!(stats.accepted == 5) || !(stats.active == 0) ||
+		!(stats.shed == 0)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_server_stop(c);
+	srv.status = srv.poll(&srv);
+	fun_network_server_config_free(c);
+	print_test_result(__func__);
+}
+
+void test_admission_control_sheds()
+{
+	NetworkAddressResult ar = fun_network_address_parse("127.0.0.1:0");
+	AdmissionData data = { NULL, { NULL }, 0 };
+	NetworkServerConfig c = NULL;
+	fun_network_tcp_server_config(ar.value, (Memory)&data, &c);
+	fun_network_server_set_max_connections(c, 2);
+	AsyncResult srv = fun_network_tcp_listen(c, on_tcp_admitted);
+	uint16_t port = 0;
+	fun_network_server_get_port(c, &port);
+
+	TcpNetworkConnection clients[4];
+	if (!connect_clients(port, clients, 4)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(50);
+	srv.status = srv.poll(&srv);
+
+	NetworkServerStats stats;
+	fun_network_server_get_stats(c, &stats);
+	if (!(data.count == 2) || !(stats.active == 2) || !(stats.shed == 2)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* Shed clients see an immediate close rather than a timeout */
+	NetworkBuffer view;
+	AsyncResult rr = fun_network_tcp_receive_some(clients[3], &view);
+	fun_async_await(&rr, 2000);
+	if (!(rr.status == ASYNC_ERROR) ||
+		rr.error.code == ERROR_CODE_ASYNC_TIMEOUT) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* Closing through the server frees a slot for the next client */
+	fun_network_server_close_connection(c, data.conns[0]);
+	fun_network_tcp_close(clients[3]);
+	if (!connect_clients(port, &clients[3], 1)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(50);
+	srv.status = srv.poll(&srv);
+	fun_network_server_get_stats(c, &stats);
+	if (!(data.count == 3) || !(stats.active == 2) || !(stats.shed == 2)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_server_close_connection(c, data.conns[1]);
+	fun_network_server_close_connection(c, data.conns[2]);
+	for (int i = 0; i < 4; i++)
+		fun_network_tcp_close(clients[i]);
+	fun_network_server_stop(c);
+	srv.status = srv.poll(&srv);
+	fun_network_server_config_free(c);
+	print_test_result(__func__);
+}
+
+#ifndef _WIN32
+/* Running out of descriptors sheds the queued client, not the listener */
+void test_accept_survives_fd_exhaustion()
+{
+	NetworkAddressResult ar = fun_network_address_parse("127.0.0.1:0");
+	AdmissionData data = { NULL, { NULL }, 0 };
+	NetworkServerConfig c = NULL;
+	fun_network_tcp_server_config(ar.value, (Memory)&data, &c);
+	AsyncResult srv = fun_network_tcp_listen(c, on_tcp_admitted);
+	uint16_t port = 0;
+	fun_network_server_get_port(c, &port);
+
+	TcpNetworkConnection clients[2];
+	if (!connect_clients(port, clients, 1)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(50);
+
+	/* Cap descriptors at the lowest free one, so accept gets EMFILE */
+	struct rlimit saved;
+	int lowest_free = dup(0);
+	if (lowest_free < 0 || getrlimit(RLIMIT_NOFILE, &saved) != 0) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	close(lowest_free);
+	struct rlimit capped = { (rlim_t)lowest_free, saved.rlim_max };
+	setrlimit(RLIMIT_NOFILE, &capped);
+	srv.status = srv.poll(&srv);
+	NetworkServerStats stats;
+	fun_network_server_get_stats(c, &stats);
+	bool shed_once = srv.status == ASYNC_PENDING && data.count == 0 &&
+					 stats.shed == 1;
+	/* Nothing is left queued, so polling again sheds nothing more */
+	srv.status = srv.poll(&srv);
+	fun_network_server_get_stats(c, &stats);
+	shed_once = shed_once && srv.status == ASYNC_PENDING && stats.shed == 1;
+	setrlimit(RLIMIT_NOFILE, &saved);
+	if (!shed_once) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* The shed client sees an immediate close rather than a hang */
+	NetworkBuffer view;
+	AsyncResult rr = fun_network_tcp_receive_some(clients[0], &view);
+	fun_async_await(&rr, 2000);
+	if (!(rr.status == ASYNC_ERROR) ||
+		rr.error.code == ERROR_CODE_ASYNC_TIMEOUT) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* With descriptors back, the next client is accepted */
+	if (!connect_clients(port, &clients[1], 1)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	sleep_ms(50);
+	srv.status = srv.poll(&srv);
+	fun_network_server_get_stats(c, &stats);
+	if (!(srv.status == ASYNC_PENDING) || !(data.count == 1) ||
+		!(stats.accepted == 1) || !(stats.shed == 1)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_server_close_connection(c, data.conns[0]);
+	fun_network_tcp_close(clients[0]);
+	fun_network_tcp_close(clients[1]);
+	fun_network_server_stop(c);
+	srv.status = srv.poll(&srv);
+	fun_network_server_config_free(c);
+	print_test_result(__func__);
+}
+#endif
+
 /* ----------------------------------------------------------------
  * Main
  * ---------------------------------------------------------------- */
@@ -941,6 +1205,15 @@ int main(void)
 	test_udp_listen_async_pending();
 	test_udp_null_callback_returns_error();
 
+	fun_console_write_line("");
+	fun_console_write_line("  Accept Batching / Admission Control");
+	test_backlog_setters_validate_state();
+	test_accept_batch_drains_queue();
+	test_admission_control_sheds();
+#ifndef _WIN32
+	test_accept_survives_fd_exhaustion();
+#endif
+
 	fun_console_write_line("");
 	fun_console_write_line("All network-server tests passed.");
 	return 0;
@@ -31,6 +31,9 @@ SOURCES=(
     "$PROJECT_ROOT/arch/memory/linux-amd64/memory.c"
     "$PROJECT_ROOT/src/string/stringOperations.c"
     "$PROJECT_ROOT/src/string/stringValidation.c"
+    "$PROJECT_ROOT/src/string/stringConversion.c"
+    "$PROJECT_ROOT/src/console/console.c"
+    "$PROJECT_ROOT/arch/console/linux-amd64/console.c"
 )
 
 # Build
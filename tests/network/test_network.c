@@ -10,6 +10,7 @@
 #else
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -63,6 +64,39 @@ static void server_send_and_close(const char *data, int n)
 	closesocket(g_server);
 }
 
+/* Accept one client, read exactly n bytes into out, close both sockets */
+static int server_recv_and_close(char *out, int n)
+{
+	SOCKET c = accept(g_server, NULL, NULL);
+	int got = 0;
+	while (got < n) {
+		int r = recv(c, out + got, n - got, 0);
+		if (r <= 0)
+			break;
+		got += r;
+	}
+	closesocket(c);
+	closesocket(g_server);
+	return got;
+}
+
+static int write_temp_file(const char *path, const char *data, int n)
+{
+	HANDLE h = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+						   FILE_ATTRIBUTE_NORMAL, NULL);
+	if (h == INVALID_HANDLE_VALUE)
+		return -1;
+	DWORD written = 0;
+	WriteFile(h, data, (DWORD)n, &written, NULL);
+	CloseHandle(h);
+	return (int)written == n ? 0 : -1;
+}
+
+static void remove_temp_file(const char *path)
+{
+	DeleteFileA(path);
+}
+
 #else /* POSIX */
 
 static int g_server;
@@ -94,8 +128,63 @@ static void server_send_and_close(const char *data, int n)
 	close(g_server);
 }
 
+/* Accept one client, read exactly n bytes into out, close both sockets */
+static int server_recv_and_close(char *out, int n)
+{
+	int c = accept(g_server, NULL, NULL);
+	int got = 0;
+	while (got < n) {
+		int r = (int)recv(c, out + got, (size_t)(n - got), 0);
+		if (r <= 0)
+			break;
+		got += r;
+	}
+	close(c);
+	close(g_server);
+	return got;
+}
+
+static int write_temp_file(const char *path, const char *data, int n)
+{
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return -1;
+	int written = (int)write(fd, data, (size_t)n);
+	close(fd);
+	return written == n ? 0 : -1;
+}
+
+static void remove_temp_file(const char *path)
+{
+	unlink(path);
+}
+
 #endif /* _WIN32 */
 
+static NetworkAddress loopback_address(uint16_t port)
+{
+	NetworkAddress addr;
+	for (int i = 0; i < NETWORK_ADDRESS_MAX_BYTES; i++)
+		addr.bytes[i] = 0;
+	addr.family = NETWORK_ADDRESS_IPV4;
+	addr.bytes[0] = 127;
+	addr.bytes[3] = 1;
+	addr.port = port;
+	return addr;
+}
+
+/* Connect a client to a fresh loopback server; NULL on failure */
+static TcpNetworkConnection connect_loopback(void)
+{
+	uint16_t port = start_server();
+	TcpNetworkConnection conn = (TcpNetworkConnection)0;
+	AsyncResult cr = fun_network_tcp_connect(loopback_address(port), &conn);
+	fun_async_await(&cr, 3000);
+	if (cr.status != ASYNC_COMPLETED)
+		return (TcpNetworkConnection)0;
+	return conn;
+}
+
 /* ================================================================
  * 1. test_address_parse
  * ================================================================ */
@@ -425,6 +514,256 @@ static void test_udp_send(void)
 	print_ok("test_udp_send");
 }
 
+/* ================================================================
+ * 6. test_tcp_sendv
+ *    Gather-send header, empty segment and payload; the server must
+ *    see them as one contiguous stream.
+ * ================================================================ */
+
+static void test_tcp_sendv(void)
+{
+	TcpNetworkConnection conn = connect_loopback();
+	if (!conn) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	NetworkBuffer parts[3];
+	parts[0].data = (void *)"HEAD";
+	parts[0].length = 4;
+	parts[1].data = (void *)0;
+	parts[1].length = 0;
+	parts[2].data = (void *)"PAYLOAD";
+	parts[2].length = 7;
+
+	AsyncResult sr = fun_network_tcp_sendv(conn, parts, 3);
+	fun_async_await(&sr, 3000);
+	if (!(sr.status == ASYNC_COMPLETED)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	char got[11];
+	if (server_recv_and_close(got, 11) != 11) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	const char *expected = "HEADPAYLOAD";
+	for (int i = 0; i < 11; i++) {
+		if (got[i] != expected[i]) {
+			fun_console_write_line("FAIL: check");
+			return;
+		}
+	}
+
+	fun_network_tcp_close(conn);
+
+	print_ok("test_tcp_sendv");
+}
+
+/* ================================================================
+ * 7. test_tcp_send_zerocopy
+ *    Send a buffer above NETWORK_ZEROCOPY_MIN_BYTES; completion means
+ *    the kernel released it, and the server must see every byte.
+ * ================================================================ */
+
+#define ZEROCOPY_TEST_BYTES (NETWORK_ZEROCOPY_MIN_BYTES * 4)
+
+static char g_zerocopy_out[ZEROCOPY_TEST_BYTES];
+static char g_zerocopy_in[ZEROCOPY_TEST_BYTES];
+
+static void test_tcp_send_zerocopy(void)
+{
+	TcpNetworkConnection conn = connect_loopback();
+	if (!conn) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	for (int i = 0; i < ZEROCOPY_TEST_BYTES; i++)
+		g_zerocopy_out[i] = (char)(i * 7);
+
+	AsyncResult sr =
+		fun_network_tcp_send_zerocopy(conn, g_zerocopy_out, ZEROCOPY_TEST_BYTES);
+	fun_async_await(&sr, 3000);
+	if (!(sr.status == ASYNC_COMPLETED)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	if (server_recv_and_close(g_zerocopy_in, ZEROCOPY_TEST_BYTES) !=
+		ZEROCOPY_TEST_BYTES) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	for (int i = 0; i < ZEROCOPY_TEST_BYTES; i++) {
+		if (g_zerocopy_in[i] != g_zerocopy_out[i]) {
+			fun_console_write_line("FAIL: check");
+			return;
+		}
+	}
+
+	fun_network_tcp_close(conn);
+
+	print_ok("test_tcp_send_zerocopy");
+}
+
+/* ================================================================
+ * 8. test_tcp_send_file
+ *    Send a byte range of a file; out-of-range requests are rejected, and
+ *    an abandoned send_file gives its descriptor back.
+ * ================================================================ */
+
+static void test_tcp_send_file(void)
+{
+	const char *path = "test_network_send_file.tmp";
+	if (write_temp_file(path, "0123456789", 10) != 0) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	TcpNetworkConnection conn = connect_loopback();
+	if (!conn) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	AsyncResult bad = fun_network_tcp_send_file(conn, path, 8, 5);
+	if (!(bad.status == ASYNC_ERROR)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+#ifndef _WIN32
+	int lowest_fd = dup(0);
+	close(lowest_fd);
+#endif
+
+	/* Never polled: the next op on conn must close its descriptor. */
+	AsyncResult abandoned = fun_network_tcp_send_file(conn, path, 0, 0);
+	if (!(abandoned.status == ASYNC_PENDING)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	AsyncResult sr = fun_network_tcp_send_file(conn, path, 2, 0);
+	fun_async_await(&sr, 3000);
+	if (!(sr.status == ASYNC_COMPLETED)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+#ifndef _WIN32
+	int probe_fd = dup(0);
+	close(probe_fd);
+	if (probe_fd != lowest_fd) {
+		fun_console_write_line("FAIL: send_file descriptor leaked");
+		return;
+	}
+#endif
+
+	char got[8];
+	if (server_recv_and_close(got, 8) != 8) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	const char *expected = "23456789";
+	for (int i = 0; i < 8; i++) {
+		if (got[i] != expected[i]) {
+			fun_console_write_line("FAIL: check");
+			return;
+		}
+	}
+
+	fun_network_tcp_close(conn);
+	remove_temp_file(path);
+
+	print_ok("test_tcp_send_file");
+}
+
+/* ================================================================
+ * 9. test_tcp_receive_views
+ *    Line-split a stream with receive_until, then drain the remainder
+ *    with peek/receive_some, consuming explicitly.
+ * ================================================================ */
+
+static int view_equals(NetworkBuffer view, const char *expected)
+{
+	const char *data = (const char *)view.data;
+	size_t i = 0;
+	for (; expected[i]; i++) {
+		if (i >= view.length || data[i] != expected[i])
+			return 0;
+	}
+	return i == view.length;
+}
+
+static void test_tcp_receive_views(void)
+{
+	TcpNetworkConnection conn = connect_loopback();
+	if (!conn) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	server_send_and_close("one\r\ntwo\r\ntail", 14);
+
+	NetworkBuffer view;
+	AsyncResult r = fun_network_tcp_receive_until(conn, "\r\n", 2, &view);
+	fun_async_await(&r, 3000);
+	if (!(r.status == ASYNC_COMPLETED) || !view_equals(view, "one\r\n")) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	/* Not consumed yet: the same line is still at the front */
+	NetworkBuffer peeked;
+	fun_network_tcp_peek(conn, &peeked);
+	if (!(peeked.data == view.data) || !(peeked.length >= view.length)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	fun_network_tcp_consume(conn, view.length);
+
+	r = fun_network_tcp_receive_until(conn, "\r\n", 2, &view);
+	fun_async_await(&r, 3000);
+	if (!(r.status == ASYNC_COMPLETED) || !view_equals(view, "two\r\n")) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+	fun_network_tcp_consume(conn, view.length);
+
+	/* The remainder has no delimiter; receive_some hands it over as-is */
+	char tail[4];
+	size_t tail_len = 0;
+	while (tail_len < 4) {
+		r = fun_network_tcp_receive_some(conn, &view);
+		fun_async_await(&r, 3000);
+		if (!(r.status == ASYNC_COMPLETED) || view.length > 4 - tail_len) {
+			fun_console_write_line("FAIL: check");
+			return;
+		}
+		for (size_t i = 0; i < view.length; i++)
+			tail[tail_len++] = ((const char *)view.data)[i];
+		fun_network_tcp_consume(conn, view.length);
+	}
+	if (!(tail[0] == 't' && tail[1] == 'a' && tail[2] == 'i' &&
+		  tail[3] == 'l')) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	voidResult over = fun_network_tcp_consume(conn, 1);
+	if (!(over.error.code == ERROR_CODE_INDEX_OUT_OF_BOUNDS)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	fun_network_tcp_close(conn);
+
+	print_ok("test_tcp_receive_views");
+}
+
 /* ================================================================
  * main
  * ================================================================ */
@@ -436,6 +775,10 @@ int main(void)
 	test_connect_fails();
 	test_tcp_round_trip();
 	test_udp_send();
+	test_tcp_sendv();
+	test_tcp_send_zerocopy();
+	test_tcp_send_file();
+	test_tcp_receive_views();
 
 	fun_console_write_line("");
 	fun_console_write_line("All tests passed.");
@@ -19,6 +19,9 @@ gcc ^
     ../../arch/stream/windows-amd64/streamWrite.c ^
     ../../arch/file/windows-amd64/fileReadMmap.c ^
     ../../arch/file/windows-amd64/fileReadRing.c ^
+    ../../arch/file/windows-amd64/fileRing.c ^
+    ../../arch/file/windows-amd64/fileDirect.c ^
+    ../../arch/file/windows-amd64/fileAdaptive.c ^
     ../../arch/file/windows-amd64/fileRead.c ^
     -lkernel32 ^
     ../../arch/memory/windows-amd64/memory.c ^
@@ -0,0 +1,25 @@
+#!/bin/sh
+gcc \
+    --std=c17 -Os \
+    -I ../../include \
+    test.c \
+    ../../src/stream/streamFile.c \
+    ../../src/stream/streamLifecycle_linux.c \
+    ../../src/stream/streamFlow.c \
+    ../../src/stream/streamCompress.c \
+    ../../arch/stream/linux-amd64/streamOpen.c \
+    ../../arch/stream/linux-amd64/streamRead.c \
+    ../../arch/stream/linux-amd64/streamWrite.c \
+    ../../arch/file/linux-amd64/fileRing.c \
+    ../../arch/file/linux-amd64/fileCache.c \
+    ../../arch/file/linux-amd64/fileHandle.c \
+    ../../arch/memory/linux-amd64/memory.c \
+    ../../src/async/async.c \
+    ../../arch/async/linux-amd64/async.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
+    -o test
+
+strip --strip-unneeded test
@@ -0,0 +1,272 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define COMPRESS_TEST_FILE "test_stream_compress.bin"
+#define COMPRESS_TEST_BYTES (1024 * 1024 + 77)
+#define COMPRESS_BLOCK_BYTES (64 * 1024)
+#define COMPRESS_PIECE_BYTES 3000
+
+static uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+
+static uint8_t random_byte(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+	return (uint8_t)random_state;
+}
+
+/* Log-like text: repeated field names with varying numbers. */
+static void fill_log(char *text, uint64_t length)
+{
+	static const char line[] = "2024-05-01T12:00:00Z\tINFO\trequest=";
+	uint64_t n = 0;
+	for (uint64_t i = 0; i < length;) {
+		for (uint64_t j = 0; j < sizeof(line) - 1 && i < length; j++)
+			text[i++] = line[j];
+		for (uint64_t value = n++ * 7919; i < length; value /= 10) {
+			text[i++] = (char)('0' + value % 10);
+			if (value < 10)
+				break;
+		}
+		if (i < length)
+			text[i++] = '\n';
+	}
+}
+
+static bool round_trip(const uint8_t *source, uint64_t length)
+{
+	static uint8_t compressed[70000];
+	static uint8_t restored[65536];
+	uint64_t compressed_size = 0;
+	uint64_t restored_size = 0;
+	return fun_error_is_ok(fun_stream_compress_block(
+			   (Memory)source, length, compressed, sizeof(compressed),
+			   &compressed_size)) &&
+		   fun_error_is_ok(fun_stream_decompress_block(
+			   compressed, compressed_size, restored, sizeof(restored),
+			   &restored_size)) &&
+		   restored_size == length &&
+		   (length == 0 ||
+			fun_memory_compare(restored, (Memory)source, length).value == 0);
+}
+
+bool test_fun_stream_compress_block(void)
+{
+	static uint8_t data[65536];
+	bool success = round_trip(data, 0) && round_trip((uint8_t *)"abc", 3);
+
+	/* Long runs: overlapping matches and multi-byte lengths. */
+	for (uint64_t i = 0; i < sizeof(data); i++)
+		data[i] = 'x';
+	success = success && round_trip(data, sizeof(data));
+	for (uint64_t i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)"abcdefg"[i % 7];
+	success = success && round_trip(data, sizeof(data));
+
+	/* Incompressible input still round-trips with a larger output. */
+	for (uint64_t i = 0; i < sizeof(data); i++)
+		data[i] = random_byte();
+	success = success && round_trip(data, sizeof(data)) &&
+			  round_trip(data, 4000);
+	uint64_t size = 0;
+	success = success && fun_stream_compress_block(data, sizeof(data), data,
+												   1000, &size)
+								 .code == ERROR_CODE_BUFFER_TOO_SMALL;
+
+	/* Text compresses well. */
+	static uint8_t compressed[70000];
+	fill_log((char *)data, sizeof(data));
+	success = success && round_trip(data, sizeof(data)) &&
+			  fun_error_is_ok(fun_stream_compress_block(
+				  data, sizeof(data), compressed, sizeof(compressed), &size)) &&
+			  size < sizeof(data) / 2;
+
+	/* A match reaching before the start of the output is rejected. */
+	uint8_t corrupt[] = { 0x10, 'a', 0x05, 0x00, 0x00 };
+	success = success && fun_stream_decompress_block(corrupt, sizeof(corrupt),
+													 data, sizeof(data), &size)
+								 .code == ERROR_CODE_STREAM_CORRUPT_FRAME;
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_compress_block passed");
+	return success;
+}
+
+static bool write_compressed(const char *text, bool write_behind)
+{
+	static char stream_buffer[COMPRESS_BLOCK_BYTES * 2];
+	static char block[COMPRESS_BLOCK_BYTES];
+	static char frame[STREAM_COMPRESS_FRAME_BOUND(COMPRESS_BLOCK_BYTES)];
+
+	AsyncResult open =
+		write_behind ?
+			fun_stream_open_write_behind(COMPRESS_TEST_FILE, STREAM_MODE_WRITE,
+										 stream_buffer, COMPRESS_BLOCK_BYTES,
+										 2) :
+			fun_stream_open(COMPRESS_TEST_FILE, STREAM_MODE_WRITE,
+							stream_buffer, sizeof(stream_buffer),
+							FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	if (open.status != ASYNC_COMPLETED)
+		return false;
+	FileStream *stream = (FileStream *)open.state;
+
+	StreamCompressWriter writer = { .stream = stream,
+									.block = block,
+									.block_size = COMPRESS_BLOCK_BYTES,
+									.frame = frame };
+	bool success = true;
+	for (uint64_t offset = 0; success && offset < COMPRESS_TEST_BYTES;) {
+		uint64_t length = COMPRESS_TEST_BYTES - offset;
+		if (length > COMPRESS_PIECE_BYTES)
+			length = COMPRESS_PIECE_BYTES;
+		AsyncResult write =
+			fun_stream_compress_write(&writer, (Memory)(text + offset), length);
+		fun_async_await(&write, -1);
+		success = write.status == ASYNC_COMPLETED;
+		offset += length;
+	}
+	AsyncResult finish = fun_stream_compress_finish(&writer);
+	fun_async_await(&finish, -1);
+	AsyncResult flush = fun_stream_flush(stream);
+	fun_async_await(&flush, -1);
+	success = success && finish.status == ASYNC_COMPLETED &&
+			  flush.status == ASYNC_COMPLETED &&
+			  fun_stream_current_position(stream) < COMPRESS_TEST_BYTES / 2;
+	fun_stream_close(stream);
+	return success;
+}
+
+static bool read_compressed(const char *text, uint64_t chunk_bytes)
+{
+	static char stream_buffer[COMPRESS_BLOCK_BYTES * 2];
+	static char scratch[STREAM_COMPRESS_FRAME_BOUND(COMPRESS_BLOCK_BYTES)];
+	static char block[COMPRESS_BLOCK_BYTES];
+
+	AsyncResult open = fun_stream_create_file_read(
+		COMPRESS_TEST_FILE, stream_buffer, chunk_bytes, FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	if (open.status != ASYNC_COMPLETED)
+		return false;
+	FileStream *stream = (FileStream *)open.state;
+
+	StreamRecordReader reader = { .stream = stream,
+								  .scratch = scratch,
+								  .scratch_size = sizeof(scratch) };
+	bool success = true;
+	uint64_t position = 0;
+	for (;;) {
+		StreamRecord frame = { 0 };
+		AsyncResult next = fun_stream_next_frame(&reader, &frame);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_COMPLETED;
+		if (!success || !frame.data)
+			break;
+
+		uint64_t length = 0;
+		success = fun_error_is_ok(fun_stream_decompress_frame(
+					  frame, block, sizeof(block), &length)) &&
+				  position + length <= COMPRESS_TEST_BYTES &&
+				  fun_memory_compare(block, (Memory)(text + position), length)
+						  .value == 0;
+		position += length;
+		if (!success)
+			break;
+	}
+	fun_stream_close(stream);
+	return success && position == COMPRESS_TEST_BYTES;
+}
+
+bool test_fun_stream_compress_write(void)
+{
+	MemoryResult text = fun_memory_allocate(COMPRESS_TEST_BYTES);
+	if (fun_error_is_error(text.error))
+		return false;
+	fill_log((char *)text.value, COMPRESS_TEST_BYTES);
+
+	/* Small chunks split frames across refills; large ones hold several. */
+	bool success = write_compressed(text.value, false) &&
+				   read_compressed(text.value, 4096) &&
+				   read_compressed(text.value, COMPRESS_BLOCK_BYTES * 2) &&
+				   write_compressed(text.value, true) &&
+				   read_compressed(text.value, 1000);
+
+	fun_memory_free(&text.value);
+	if (success)
+		fun_console_write_line("✓ fun_stream_compress_write passed");
+	return success;
+}
+
+bool test_fun_stream_next_frame_errors(void)
+{
+	/* A file cut short inside a frame is corrupt. */
+	uint8_t header[] = { 100, 0, 0, 0, 100, 0, 0, 0, 'x' };
+	FileHandle handle = { 0 };
+	bool success =
+		fun_error_is_ok(fun_file_open(COMPRESS_TEST_FILE,
+									  FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE,
+									  &handle)) &&
+		fun_error_is_ok(
+			fun_file_write_at(handle, header, sizeof(header), 0));
+	success = fun_error_is_ok(fun_file_close(&handle)) && success;
+
+	char buffer[64];
+	char scratch[256];
+	AsyncResult open = fun_stream_create_file_read(
+		COMPRESS_TEST_FILE, buffer, sizeof(buffer), FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	success = success && open.status == ASYNC_COMPLETED;
+	if (success) {
+		FileStream *stream = (FileStream *)open.state;
+		StreamRecordReader reader = { .stream = stream,
+									  .scratch = scratch,
+									  .scratch_size = sizeof(scratch) };
+		StreamRecord frame = { 0 };
+		AsyncResult next = fun_stream_next_frame(&reader, &frame);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_ERROR &&
+				  next.error.code == ERROR_CODE_STREAM_CORRUPT_FRAME;
+		fun_stream_close(stream);
+	}
+
+	char block[16];
+	StreamCompressWriter writer = { .stream = (FileStream *)buffer,
+									.block = block,
+									.block_size =
+										STREAM_COMPRESS_MAX_BLOCK + 1,
+									.frame = scratch };
+	AsyncResult write = fun_stream_compress_write(&writer, block, 1);
+	success = success && write.status == ASYNC_ERROR &&
+			  write.error.code == ERROR_CODE_STREAM_BLOCK_TOO_LARGE;
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_next_frame errors passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running stream compression tests:");
+
+	if (!test_fun_stream_compress_block()) {
+		fun_console_write_line("Block compression test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_compress_write()) {
+		fun_console_write_line("Compressed stream test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_next_frame_errors()) {
+		fun_console_write_line("Compressed frame error test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All stream compression tests passed!");
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define READAHEAD_TEST_FILE "test_stream_readahead.bin"
+#define READAHEAD_EMPTY_FILE "test_stream_readahead_empty.bin"
+#define READAHEAD_TEST_BYTES (1024 * 1024 + 123)
+#define READAHEAD_SLOT_BYTES (64 * 1024)
+
+static char pattern_byte(uint64_t offset)
+{
+	return (char)(offset * 131 + (offset >> 9));
+}
+
+static bool write_test_file(String path, uint64_t length)
+{
+	MemoryResult content = fun_memory_allocate(length ? length : 1);
+	if (fun_error_is_error(content.error))
+		return false;
+	for (uint64_t i = 0; i < length; i++)
+		((char *)content.value)[i] = pattern_byte(i);
+
+	FileHandle handle = { 0 };
+	bool success =
+		fun_error_is_ok(fun_file_open(
+			path, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)) &&
+		(length == 0 ||
+		 fun_error_is_ok(fun_file_write_at(handle, content.value, length, 0)));
+	success = fun_error_is_ok(fun_file_close(&handle)) && success;
+	fun_memory_free(&content.value);
+	return success;
+}
+
+static FileStream *open_readahead(String path, Memory buffer,
+								  uint32_t buffer_count)
+{
+	AsyncResult open = fun_stream_open_readahead(path, buffer,
+												 READAHEAD_SLOT_BYTES,
+												 buffer_count);
+	fun_async_await(&open, -1);
+	return open.status == ASYNC_COMPLETED ? (FileStream *)open.state : NULL;
+}
+
+static bool scan_file(uint32_t buffer_count)
+{
+	MemoryResult buffer =
+		fun_memory_allocate(READAHEAD_SLOT_BYTES * buffer_count);
+	if (fun_error_is_error(buffer.error))
+		return false;
+	char *slots = (char *)buffer.value;
+
+	FileStream *stream =
+		open_readahead(READAHEAD_TEST_FILE, buffer.value, buffer_count);
+	bool success = stream != NULL;
+	uint64_t position = 0;
+	while (success && fun_stream_can_read(stream)) {
+		uint64_t bytes_read = 0;
+		AsyncResult read = fun_stream_read(stream, &bytes_read);
+		fun_async_await(&read, -1);
+		success = read.status == ASYNC_COMPLETED && bytes_read > 0 &&
+				  bytes_read <= READAHEAD_SLOT_BYTES;
+
+		/* Each chunk sits in one of the slots and continues the file. */
+		char *chunk = (char *)stream->buffer;
+		success = success && chunk >= slots &&
+				  chunk + bytes_read <=
+					  slots + READAHEAD_SLOT_BYTES * buffer_count;
+		for (uint64_t i = 0; success && i < bytes_read; i++)
+			success = chunk[i] == pattern_byte(position + i);
+		position += bytes_read;
+		success = success && fun_stream_current_position(stream) == position;
+	}
+	success = success && position == READAHEAD_TEST_BYTES &&
+			  fun_stream_is_end_of_stream(stream);
+
+	if (stream)
+		fun_stream_close(stream);
+	fun_memory_free(&buffer.value);
+	return success;
+}
+
+bool test_fun_stream_open_readahead(void)
+{
+	bool success = write_test_file(READAHEAD_TEST_FILE,
+								   READAHEAD_TEST_BYTES) &&
+				   scan_file(2) && scan_file(STREAM_READAHEAD_MAX_BUFFERS);
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_open_readahead passed");
+	return success;
+}
+
+bool test_fun_stream_open_readahead_edges(void)
+{
+	MemoryResult buffer = fun_memory_allocate(READAHEAD_SLOT_BYTES * 4);
+	if (fun_error_is_error(buffer.error))
+		return false;
+
+	/* An empty file ends on the first read. */
+	FileStream *stream = NULL;
+	bool success = write_test_file(READAHEAD_EMPTY_FILE, 0);
+	stream = success ? open_readahead(READAHEAD_EMPTY_FILE, buffer.value, 2) :
+					   NULL;
+	uint64_t bytes_read = 1;
+	if (stream) {
+		AsyncResult read = fun_stream_read(stream, &bytes_read);
+		fun_async_await(&read, -1);
+		success = read.status == ASYNC_COMPLETED && bytes_read == 0 &&
+				  fun_stream_is_end_of_stream(stream);
+		fun_stream_close(stream);
+	} else {
+		success = false;
+	}
+
+	/* Closing with reads still in flight waits for them. */
+	stream = open_readahead(READAHEAD_TEST_FILE, buffer.value, 4);
+	if (stream) {
+		AsyncResult read = fun_stream_read(stream, &bytes_read);
+		fun_async_await(&read, -1);
+		success = success && read.status == ASYNC_COMPLETED &&
+				  bytes_read == READAHEAD_SLOT_BYTES;
+		fun_stream_close(stream);
+	} else {
+		success = false;
+	}
+
+	AsyncResult invalid = fun_stream_open_readahead(
+		READAHEAD_TEST_FILE, buffer.value, READAHEAD_SLOT_BYTES, 1);
+	success = success && invalid.status == ASYNC_ERROR &&
+			  invalid.error.code == ERROR_CODE_STREAM_INVALID_BUFFER_COUNT;
+
+	fun_memory_free(&buffer.value);
+	if (success)
+		fun_console_write_line("✓ fun_stream_open_readahead edges passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running stream readahead tests:");
+
+	if (!test_fun_stream_open_readahead()) {
+		fun_console_write_line("Readahead scan test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_open_readahead_edges()) {
+		fun_console_write_line("Readahead edge test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All stream readahead tests passed!");
+	return 0;
+}
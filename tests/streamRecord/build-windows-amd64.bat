@@ -0,0 +1,27 @@
+@ECHO OFF
+
+REM Compile
+gcc ^
+    --std=c17 -Os ^
+    -I ../../include ^
+    test.c ^
+    ../../src/stream/streamFile.c ^
+    ../../src/stream/streamLifecycle.c ^
+    ../../src/stream/streamFlow.c ^
+    ../../src/stream/streamRecord.c ^
+    ../../arch/stream/windows-amd64/streamOpen.c ^
+    ../../arch/stream/windows-amd64/streamRead.c ^
+    ../../arch/stream/windows-amd64/streamWrite.c ^
+    ../../arch/file/windows-amd64/fileHandle.c ^
+    ../../arch/memory/windows-amd64/memory.c ^
+    ../../src/async/async.c ^
+    ../../arch/async/windows-amd64/async.c ^
+    ../../src/console/console.c ^
+    ../../arch/console/windows-amd64/console.c ^
+    ../../src/string/stringConversion.c ^
+    ../../src/string/stringOperations.c ^
+    -lkernel32 -ladvapi32 ^
+    -o test.exe
+
+REM Strip unnecessary symbols
+strip --strip-unneeded test.exe
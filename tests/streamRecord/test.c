@@ -0,0 +1,166 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define RECORD_TEST_FILE "test_stream_record.txt"
+#define RECORD_CHUNK_BYTES 16
+
+static const char RECORD_TEST_CONTENT[] =
+	"first\n"
+	"crlf line\r\n"
+	"\n"
+	"a line long enough to straddle several sixteen byte chunks\n"
+	"last without newline";
+
+static const char *const RECORD_TEST_LINES[] = {
+	"first", "crlf line", "",
+	"a line long enough to straddle several sixteen byte chunks",
+	"last without newline"
+};
+
+static bool write_test_file(void)
+{
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(fun_file_open(
+			RECORD_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)))
+		return false;
+	bool success = fun_error_is_ok(
+		fun_file_write_at(handle, (Memory)RECORD_TEST_CONTENT,
+						  sizeof(RECORD_TEST_CONTENT) - 1, 0));
+	return fun_error_is_ok(fun_file_close(&handle)) && success;
+}
+
+static bool record_equals(StreamRecord record, const char *expected)
+{
+	uint64_t length = 0;
+	while (expected[length])
+		length++;
+	return record.data && record.length == length &&
+		   (length == 0 ||
+			fun_memory_compare(record.data, (Memory)expected, length).value ==
+				0);
+}
+
+static FileStream *open_stream(Memory buffer, bool readahead)
+{
+	AsyncResult open =
+		readahead ? fun_stream_open_readahead(RECORD_TEST_FILE, buffer,
+											  RECORD_CHUNK_BYTES, 2) :
+					fun_stream_create_file_read(RECORD_TEST_FILE, buffer,
+												RECORD_CHUNK_BYTES,
+												FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	return open.status == ASYNC_COMPLETED ? (FileStream *)open.state : NULL;
+}
+
+static bool read_lines(bool readahead)
+{
+	char buffer[RECORD_CHUNK_BYTES * 2];
+	char scratch[128];
+	FileStream *stream = open_stream(buffer, readahead);
+	if (!stream)
+		return false;
+
+	StreamRecordReader reader = { .stream = stream,
+								  .scratch = scratch,
+								  .scratch_size = sizeof(scratch) };
+	bool success = true;
+	for (uint32_t i = 0; success && i < 5; i++) {
+		StreamRecord line = { 0 };
+		AsyncResult next = fun_stream_next_line(&reader, &line);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_COMPLETED &&
+				  record_equals(line, RECORD_TEST_LINES[i]);
+	}
+
+	/* Exhausted, and it stays that way. */
+	for (uint32_t i = 0; success && i < 2; i++) {
+		StreamRecord line = { 0 };
+		AsyncResult next = fun_stream_next_line(&reader, &line);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_COMPLETED && line.data == NULL;
+	}
+
+	fun_stream_close(stream);
+	return success;
+}
+
+bool test_fun_stream_next_line(void)
+{
+	bool success = write_test_file() && read_lines(false) && read_lines(true);
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_next_line passed");
+	return success;
+}
+
+bool test_fun_stream_next_record(void)
+{
+	char buffer[RECORD_CHUNK_BYTES];
+	char scratch[128];
+	FileStream *stream = open_stream(buffer, false);
+	if (!stream)
+		return false;
+
+	/* Records are cut at the delimiter only; newlines stay in them. */
+	StreamRecordReader reader = { .stream = stream,
+								  .scratch = scratch,
+								  .scratch_size = sizeof(scratch) };
+	StreamRecord record = { 0 };
+	AsyncResult next = fun_stream_next_record(&reader, ' ', &record);
+	fun_async_await(&next, -1);
+	bool success = next.status == ASYNC_COMPLETED &&
+				   record_equals(record, "first\ncrlf");
+
+	uint32_t count = 1;
+	while (success && record.data) {
+		next = fun_stream_next_record(&reader, ' ', &record);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_COMPLETED;
+		count += record.data != NULL;
+	}
+	success = success && count == 13;
+	fun_stream_close(stream);
+
+	/* A straddling record longer than scratch is reported. */
+	stream = open_stream(buffer, false);
+	StreamRecordReader small = { .stream = stream,
+								 .scratch = scratch,
+								 .scratch_size = 12 };
+	StreamRecord line = { 0 };
+	for (uint32_t i = 0; success && i < 3; i++) {
+		next = fun_stream_next_line(&small, &line);
+		fun_async_await(&next, -1);
+		success = next.status == ASYNC_COMPLETED;
+	}
+	next = fun_stream_next_line(&small, &line);
+	fun_async_await(&next, -1);
+	success = success && next.status == ASYNC_ERROR &&
+			  next.error.code == ERROR_CODE_BUFFER_TOO_SMALL;
+	if (stream)
+		fun_stream_close(stream);
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_next_record passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running stream record tests:");
+
+	if (!test_fun_stream_next_line()) {
+		fun_console_write_line("Line iteration test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_next_record()) {
+		fun_console_write_line("Record iteration test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All stream record tests passed!");
+	return 0;
+}
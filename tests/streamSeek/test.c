@@ -0,0 +1,302 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define SEEK_TEST_FILE "test_stream_seek.txt"
+#define SEEK_INDEX_FILE "test_stream_seek.txt.idx"
+#define SEEK_RECORDS 2000
+#define SEEK_STRIDE 16
+#define SEEK_CHUNK_BYTES 256
+
+static uint64_t record_offsets[SEEK_RECORDS];
+static uint64_t file_size;
+
+/* "record <n> " */
+static uint64_t format_record(uint64_t n, char *out)
+{
+	static const char prefix[] = "record ";
+	uint64_t length = 0;
+	for (; prefix[length]; length++)
+		out[length] = prefix[length];
+	char digits[20];
+	uint64_t digit_count = 0;
+	do {
+		digits[digit_count++] = (char)('0' + n % 10);
+	} while ((n /= 10) > 0);
+	while (digit_count > 0)
+		out[length++] = digits[--digit_count];
+	out[length++] = ' ';
+	return length;
+}
+
+/* The record, padded with n % 37 dashes so lengths vary. */
+static uint64_t record_text(uint64_t n, char *out)
+{
+	uint64_t length = format_record(n, out);
+	for (uint64_t i = 0; i < n % 37; i++)
+		out[length++] = '-';
+	return length;
+}
+
+static bool write_test_file(void)
+{
+	MemoryResult content = fun_memory_allocate(SEEK_RECORDS * 64);
+	if (fun_error_is_error(content.error))
+		return false;
+	char *text = (char *)content.value;
+	file_size = 0;
+	for (uint64_t n = 0; n < SEEK_RECORDS; n++) {
+		record_offsets[n] = file_size;
+		file_size += record_text(n, text + file_size);
+		text[file_size++] = '\n';
+	}
+
+	FileHandle handle = { 0 };
+	bool success =
+		fun_error_is_ok(fun_file_open(
+			SEEK_TEST_FILE, FILE_OPEN_WRITE | FILE_OPEN_TRUNCATE, &handle)) &&
+		fun_error_is_ok(fun_file_write_at(handle, text, file_size, 0));
+	success = fun_error_is_ok(fun_file_close(&handle)) && success;
+	fun_memory_free(&content.value);
+	return success;
+}
+
+static bool line_is_record(StreamRecord line, uint64_t n)
+{
+	char expected[64];
+	uint64_t length = record_text(n, expected);
+	return line.data && line.length == length &&
+		   fun_memory_compare(line.data, expected, length).value == 0;
+}
+
+static FileStream *open_stream(Memory buffer, bool readahead)
+{
+	AsyncResult open =
+		readahead ? fun_stream_open_readahead(SEEK_TEST_FILE, buffer,
+											  SEEK_CHUNK_BYTES, 3) :
+					fun_stream_create_file_read(SEEK_TEST_FILE, buffer,
+												SEEK_CHUNK_BYTES,
+												FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	return open.status == ASYNC_COMPLETED ? (FileStream *)open.state : NULL;
+}
+
+static bool next_line(StreamRecordReader *reader, StreamRecord *line)
+{
+	AsyncResult next = fun_stream_next_line(reader, line);
+	fun_async_await(&next, -1);
+	return next.status == ASYNC_COMPLETED;
+}
+
+/* First pass: every record's offset is reported; every 16th is kept. */
+static bool build_index(StreamIndex *index)
+{
+	char buffer[SEEK_CHUNK_BYTES];
+	char scratch[64];
+	FileStream *stream = open_stream(buffer, false);
+	if (!stream)
+		return false;
+
+	StreamRecordReader reader = { .stream = stream,
+								  .scratch = scratch,
+								  .scratch_size = sizeof(scratch) };
+	bool success = true;
+	for (uint64_t n = 0; success; n++) {
+		StreamRecord line = { 0 };
+		success = next_line(&reader, &line);
+		if (!line.data) {
+			success = success && n == SEEK_RECORDS;
+			break;
+		}
+		success = success && line_is_record(line, n) &&
+				  reader.record_offset == record_offsets[n] &&
+				  fun_error_is_ok(
+					  fun_stream_index_add(index, reader.record_offset));
+	}
+	index->file_size = fun_stream_current_position(stream);
+	fun_stream_close(stream);
+	return success && index->file_size == file_size;
+}
+
+static bool jump_to_records(const StreamIndex *index, bool readahead)
+{
+	char buffer[SEEK_CHUNK_BYTES * 3];
+	char scratch[64];
+	FileStream *stream = open_stream(buffer, readahead);
+	if (!stream)
+		return false;
+
+	static const uint64_t targets[] = { 1999, 0, 17, 16, 1000, 5, 1998, 31 };
+	bool success = true;
+	for (uint32_t i = 0; success && i < sizeof(targets) / sizeof(*targets);
+		 i++) {
+		uint64_t offset = 0;
+		uint64_t skip = 0;
+		success = fun_error_is_ok(
+			fun_stream_index_find(index, targets[i], &offset, &skip));
+		AsyncResult seek = fun_stream_seek(stream, offset);
+		fun_async_await(&seek, -1);
+		success = success && seek.status == ASYNC_COMPLETED &&
+				  fun_stream_current_position(stream) == offset;
+
+		StreamRecordReader reader = { .stream = stream,
+									  .scratch = scratch,
+									  .scratch_size = sizeof(scratch) };
+		StreamRecord line = { 0 };
+		for (uint64_t s = 0; success && s <= skip; s++)
+			success = next_line(&reader, &line);
+		success = success && line_is_record(line, targets[i]) &&
+				  reader.record_offset == record_offsets[targets[i]];
+	}
+
+	/* Seeking to the end reads nothing; past it is out of bounds. */
+	AsyncResult seek = fun_stream_seek(stream, file_size);
+	fun_async_await(&seek, -1);
+	uint64_t bytes_read = 1;
+	AsyncResult read = fun_stream_read(stream, &bytes_read);
+	fun_async_await(&read, -1);
+	success = success && seek.status == ASYNC_COMPLETED &&
+			  read.status == ASYNC_COMPLETED && bytes_read == 0;
+	seek = fun_stream_seek(stream, file_size + 1);
+	success = success && seek.status == ASYNC_ERROR &&
+			  seek.error.code == ERROR_CODE_INDEX_OUT_OF_BOUNDS;
+
+	fun_stream_close(stream);
+	return success;
+}
+
+bool test_fun_stream_index(void)
+{
+	static uint64_t offsets[SEEK_RECORDS / SEEK_STRIDE + 1];
+	static uint64_t loaded_offsets[SEEK_RECORDS / SEEK_STRIDE + 1];
+	StreamIndex index = { .offsets = offsets,
+						  .capacity = SEEK_RECORDS / SEEK_STRIDE + 1,
+						  .stride = SEEK_STRIDE };
+	bool success =
+		write_test_file() && build_index(&index) &&
+		index.record_count == SEEK_RECORDS &&
+		index.count == (SEEK_RECORDS + SEEK_STRIDE - 1) / SEEK_STRIDE &&
+		fun_error_is_ok(fun_stream_index_save(&index, SEEK_INDEX_FILE));
+
+	/* The stride comes from the file. */
+	StreamIndex loaded = { .offsets = loaded_offsets,
+						   .capacity = SEEK_RECORDS / SEEK_STRIDE + 1 };
+	success = success &&
+			  fun_error_is_ok(
+				  fun_stream_index_load(&loaded, SEEK_INDEX_FILE)) &&
+			  loaded.stride == SEEK_STRIDE && loaded.count == index.count &&
+			  loaded.record_count == SEEK_RECORDS &&
+			  loaded.file_size == file_size &&
+			  fun_memory_compare(loaded_offsets, offsets,
+								 index.count * sizeof(uint64_t))
+					  .value == 0;
+
+	success = success && jump_to_records(&loaded, false) &&
+			  jump_to_records(&loaded, true);
+
+	uint64_t offset = 0;
+	uint64_t skip = 0;
+	success = success && fun_stream_index_find(&loaded, SEEK_RECORDS, &offset,
+											   &skip)
+								 .code == ERROR_CODE_INDEX_OUT_OF_BOUNDS;
+
+	/* Too small for the file, or not an index at all. */
+	StreamIndex small = { .offsets = loaded_offsets, .capacity = 4 };
+	success = success && fun_stream_index_load(&small, SEEK_INDEX_FILE).code ==
+							 ERROR_CODE_BUFFER_TOO_SMALL;
+	success = success && fun_stream_index_load(&loaded, SEEK_TEST_FILE).code ==
+							 ERROR_CODE_STREAM_INVALID_INDEX;
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_index passed");
+	return success;
+}
+
+static bool file_is(String expected, uint64_t length)
+{
+	char content[64];
+	FileHandle handle = { 0 };
+	if (fun_error_is_error(
+			fun_file_open(SEEK_TEST_FILE, FILE_OPEN_READ, &handle)))
+		return false;
+	bool success =
+		fun_error_is_ok(fun_file_read_at(handle, content, length, 0)) &&
+		fun_memory_compare(content, (Memory)expected, length).value == 0 &&
+		fun_file_read_at(handle, content, 1, length).code ==
+			ERROR_CODE_FILE_UNEXPECTED_EOF;
+	fun_file_close(&handle);
+	return success;
+}
+
+static bool overwrite(bool write_behind)
+{
+	char buffer[32];
+	AsyncResult open =
+		write_behind ?
+			fun_stream_open_write_behind(SEEK_TEST_FILE, STREAM_MODE_WRITE,
+										 buffer, 16, 2) :
+			fun_stream_open(SEEK_TEST_FILE, STREAM_MODE_WRITE, buffer,
+							sizeof(buffer), FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	if (open.status != ASYNC_COMPLETED)
+		return false;
+	FileStream *stream = (FileStream *)open.state;
+
+	AsyncResult write = fun_stream_write(stream, "0123456789", 10);
+	fun_async_await(&write, -1);
+	AsyncResult seek = fun_stream_seek(stream, 3);
+	fun_async_await(&seek, -1);
+	bool success = write.status == ASYNC_COMPLETED &&
+				   seek.status == ASYNC_COMPLETED &&
+				   fun_stream_current_position(stream) == 3;
+	write = fun_stream_write(stream, "abc", 3);
+	fun_async_await(&write, -1);
+	AsyncResult flush = fun_stream_flush(stream);
+	fun_async_await(&flush, -1);
+	success = success && write.status == ASYNC_COMPLETED &&
+			  flush.status == ASYNC_COMPLETED;
+	fun_stream_close(stream);
+	return success && file_is("012abc6789", 10);
+}
+
+bool test_fun_stream_seek_write(void)
+{
+	bool success = overwrite(false) && overwrite(true);
+
+	char buffer[16];
+	AsyncResult open = fun_stream_open(SEEK_TEST_FILE, STREAM_MODE_APPEND,
+									   buffer, sizeof(buffer), FILE_MODE_AUTO);
+	fun_async_await(&open, -1);
+	success = success && open.status == ASYNC_COMPLETED;
+	if (open.status == ASYNC_COMPLETED) {
+		FileStream *stream = (FileStream *)open.state;
+		AsyncResult seek = fun_stream_seek(stream, 0);
+		success = success && seek.status == ASYNC_ERROR &&
+				  seek.error.code == ERROR_CODE_STREAM_NOT_SEEKABLE;
+		fun_stream_close(stream);
+	}
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_seek write passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running stream seek tests:");
+
+	if (!test_fun_stream_index()) {
+		fun_console_write_line("Stream index test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_seek_write()) {
+		fun_console_write_line("Stream seek write test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All stream seek tests passed!");
+	return 0;
+}
@@ -0,0 +1,176 @@
+#include "fundamental/stream/stream.h"
+#include "fundamental/file/file.h"
+#include "fundamental/memory/memory.h"
+#include "fundamental/async/async.h"
+#include "fundamental/console/console.h"
+
+#define WRITE_BEHIND_TEST_FILE "test_stream_write_behind.bin"
+#define WRITE_BEHIND_TEST_BYTES (1024 * 1024 + 123)
+#define WRITE_BEHIND_SLOT_BYTES (16 * 1024)
+#define WRITE_BEHIND_PIECE_BYTES 5000
+
+static char pattern_byte(uint64_t offset)
+{
+	return (char)(offset * 131 + (offset >> 9));
+}
+
+/* The file must hold exactly length pattern bytes. */
+static bool file_matches(uint64_t length)
+{
+	MemoryResult content = fun_memory_allocate(length + 1);
+	if (fun_error_is_error(content.error))
+		return false;
+	char *bytes = (char *)content.value;
+
+	FileHandle handle = { 0 };
+	bool success =
+		fun_error_is_ok(fun_file_open(WRITE_BEHIND_TEST_FILE, FILE_OPEN_READ,
+									  &handle)) &&
+		fun_error_is_ok(fun_file_read_at(handle, bytes, length, 0)) &&
+		fun_file_read_at(handle, bytes + length, 1, length).code ==
+			ERROR_CODE_FILE_UNEXPECTED_EOF;
+	fun_file_close(&handle);
+	for (uint64_t i = 0; success && i < length; i++)
+		success = bytes[i] == pattern_byte(i);
+	fun_memory_free(&content.value);
+	return success;
+}
+
+/* Write the pattern from start to end in uneven pieces. */
+static bool write_pattern(FileStream *stream, uint64_t start, uint64_t end)
+{
+	char piece[WRITE_BEHIND_PIECE_BYTES];
+	bool success = true;
+	for (uint64_t offset = start; success && offset < end;) {
+		uint64_t length = end - offset < sizeof(piece) ? end - offset :
+														  sizeof(piece);
+		for (uint64_t i = 0; i < length; i++)
+			piece[i] = pattern_byte(offset + i);
+		AsyncResult write = fun_stream_write(stream, piece, length);
+		fun_async_await(&write, -1);
+		success = write.status == ASYNC_COMPLETED;
+		offset += length;
+		success = success && fun_stream_current_position(stream) == offset;
+	}
+	return success;
+}
+
+static FileStream *open_write_behind(StreamMode mode, Memory buffer,
+									 uint32_t buffer_count)
+{
+	AsyncResult open = fun_stream_open_write_behind(
+		WRITE_BEHIND_TEST_FILE, mode, buffer, WRITE_BEHIND_SLOT_BYTES,
+		buffer_count);
+	fun_async_await(&open, -1);
+	return open.status == ASYNC_COMPLETED ? (FileStream *)open.state : NULL;
+}
+
+static bool write_file(uint32_t buffer_count)
+{
+	MemoryResult buffer =
+		fun_memory_allocate(WRITE_BEHIND_SLOT_BYTES * buffer_count);
+	if (fun_error_is_error(buffer.error))
+		return false;
+
+	FileStream *stream =
+		open_write_behind(STREAM_MODE_WRITE, buffer.value, buffer_count);
+	bool success = stream != NULL &&
+				   write_pattern(stream, 0, WRITE_BEHIND_TEST_BYTES);
+	if (stream) {
+		AsyncResult flush = fun_stream_flush(stream);
+		fun_async_await(&flush, -1);
+		success = success && flush.status == ASYNC_COMPLETED;
+		fun_stream_close(stream);
+	}
+
+	fun_memory_free(&buffer.value);
+	return success && file_matches(WRITE_BEHIND_TEST_BYTES);
+}
+
+bool test_fun_stream_open_write_behind(void)
+{
+	bool success = write_file(2) &&
+				   write_file(STREAM_WRITE_BEHIND_MAX_BUFFERS);
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_open_write_behind passed");
+	return success;
+}
+
+bool test_fun_stream_open_write_behind_append(void)
+{
+	MemoryResult buffer = fun_memory_allocate(WRITE_BEHIND_SLOT_BYTES * 3);
+	if (fun_error_is_error(buffer.error))
+		return false;
+
+	/* Close writes out the partial slot without an explicit flush. */
+	FileStream *stream = open_write_behind(STREAM_MODE_WRITE, buffer.value, 3);
+	bool success = stream != NULL && write_pattern(stream, 0, 100000);
+	if (stream)
+		fun_stream_close(stream);
+	success = success && file_matches(100000);
+
+	/* Appends continue from the end of the existing file. */
+	stream = open_write_behind(STREAM_MODE_APPEND, buffer.value, 3);
+	success = success && stream != NULL &&
+			  fun_stream_current_position(stream) == 100000 &&
+			  write_pattern(stream, 100000, 250001);
+	if (stream) {
+		AsyncResult flush = fun_stream_flush(stream);
+		fun_async_await(&flush, -1);
+		success = success && flush.status == ASYNC_COMPLETED;
+		fun_stream_close(stream);
+	}
+	success = success && file_matches(250001);
+
+	fun_memory_free(&buffer.value);
+	if (success)
+		fun_console_write_line("✓ fun_stream_open_write_behind append passed");
+	return success;
+}
+
+bool test_fun_stream_open_write_behind_errors(void)
+{
+	char buffer[64];
+	AsyncResult invalid = fun_stream_open_write_behind(
+		WRITE_BEHIND_TEST_FILE, STREAM_MODE_WRITE, buffer, 32, 1);
+	bool success = invalid.status == ASYNC_ERROR &&
+				   invalid.error.code ==
+					   ERROR_CODE_STREAM_INVALID_BUFFER_COUNT;
+
+	AsyncResult read_mode = fun_stream_open_write_behind(
+		WRITE_BEHIND_TEST_FILE, STREAM_MODE_READ, buffer, 32, 2);
+	success = success && read_mode.status == ASYNC_ERROR;
+
+	/* Flushing needs a stream. */
+	AsyncResult flush = fun_stream_flush(NULL);
+	success = success && flush.status == ASYNC_ERROR &&
+			  flush.error.code == ERROR_CODE_NULL_POINTER;
+
+	if (success)
+		fun_console_write_line("✓ fun_stream_open_write_behind errors passed");
+	return success;
+}
+
+int main()
+{
+	fun_console_write_line("Running stream write-behind tests:");
+
+	if (!test_fun_stream_open_write_behind()) {
+		fun_console_write_line("Write-behind test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_open_write_behind_append()) {
+		fun_console_write_line("Write-behind append test failed");
+		return 1;
+	}
+
+	if (!test_fun_stream_open_write_behind_errors()) {
+		fun_console_write_line("Write-behind error test failed");
+		return 1;
+	}
+
+	fun_console_write_line("All stream write-behind tests passed!");
+	return 0;
+}
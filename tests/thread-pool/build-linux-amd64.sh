@@ -8,6 +8,10 @@ gcc \
     ../../arch/sync/linux-amd64/sync.c \
     ../../src/thread_pool/thread_pool.c \
     ../../arch/thread_pool/linux-amd64/thread_pool.c \
+    ../../src/console/console.c \
+    ../../arch/console/linux-amd64/console.c \
+    ../../src/string/stringConversion.c \
+    ../../src/string/stringOperations.c \
     -o test
 
 strip --strip-unneeded test
@@ -574,6 +574,51 @@ void test_concurrent_submits()
 #undef CONCURRENT_COUNT
 #undef NUM_SUBMIT_THREADS
 
+/* ================================================================
+   8.15  Joining a thread that exits before clone() returns
+   ================================================================ */
+#define JOIN_RACE_ROUNDS 500
+
+extern int arch_thread_create(void (*fn)(void *), void *arg, void **out_handle);
+extern void arch_thread_join(void *handle);
+
+static volatile int g_join_ran;
+
+static void exit_at_once_fn(void *data)
+{
+	(void)data;
+#ifdef _WIN32
+	InterlockedIncrement((LONG volatile *)&g_join_ran);
+#else
+	__atomic_add_fetch(&g_join_ran, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+void test_join_thread_that_exited()
+{
+	g_join_ran = 0;
+
+	/* Threads that return at once often exit before the parent leaves
+	   arch_thread_create; join must still see them as finished. */
+	for (int i = 0; i < JOIN_RACE_ROUNDS; i++) {
+		void *handle = NULL;
+		if (arch_thread_create(exit_at_once_fn, NULL, &handle) != 0) {
+			fun_console_write_line("FAIL: check");
+			return;
+		}
+		arch_thread_join(handle);
+	}
+
+	if (!(g_join_ran == JOIN_RACE_ROUNDS)) {
+		fun_console_write_line("FAIL: check");
+		return;
+	}
+
+	print_test_result(__func__);
+}
+
+#undef JOIN_RACE_ROUNDS
+
 int main(void)
 {
 	fun_console_write_line("");
@@ -594,6 +639,7 @@ int main(void)
 	test_destroy_null_pool();
 	test_destroy_waits_for_work();
 	test_concurrent_submits();
+	test_join_thread_that_exited();
 
 	fun_console_write_line("");
 	fun_console_write_line("All thread-pool tests passed.");